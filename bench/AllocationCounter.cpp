@@ -0,0 +1,34 @@
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+std::atomic<size_t> allocations{0};
+}
+
+/*
+ * Replaces the global operator new, only the number of allocations is recorded.
+ * Allocations done by C libraries (glib, cairo, ...) with malloc are not counted.
+ */
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+auto AllocationCounter::count() -> size_t { return allocations.load(std::memory_order_relaxed); }
+
+AllocationCounter::Scope::Scope(benchmark::State& state): state(state), start(count()) {}
+
+AllocationCounter::Scope::~Scope() {
+    this->state.counters["allocs"] = benchmark::Counter(static_cast<double>(count() - this->start),
+                                                        benchmark::Counter::kAvgIterations);
+}
@@ -0,0 +1,40 @@
+/*
+ * Xournal++
+ *
+ * Counts the heap allocations of the benchmarks
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include <benchmark/benchmark.h>
+
+namespace AllocationCounter {
+
+/**
+ * Number of calls to operator new since the start of the program
+ */
+size_t count();
+
+/**
+ * @brief Reports the allocations per iteration as counter "allocs"
+ *
+ * Create it before the benchmark loop, the allocations are reported when it goes out of scope.
+ */
+class Scope {
+public:
+    explicit Scope(benchmark::State& state);
+    ~Scope();
+
+private:
+    benchmark::State& state;
+    size_t start;
+};
+
+}  // namespace AllocationCounter
@@ -0,0 +1,169 @@
+#include "BenchDocuments.h"
+
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+
+#include <gdk-pixbuf/gdk-pixbuf.h>
+
+#include "control/xojfile/DocumentGenerator.h"
+#include "control/xojfile/SaveHandler.h"
+#include "model/BackgroundImage.h"
+#include "model/Image.h"
+#include "model/Layer.h"
+#include "model/PageType.h"
+#include "model/Stroke.h"
+#include "model/Text.h"
+#include "model/XojPage.h"
+
+BenchDocument::BenchDocument(): doc(&handler) {}
+
+namespace {
+auto benchDirectory() -> fs::path {
+    static fs::path dir = [] {
+        auto d = fs::temp_directory_path() / "xournalpp-bench";
+        fs::create_directories(d);
+        return d;
+    }();
+    return dir;
+}
+
+/**
+ * A gradient with noise, which compresses like a photo
+ */
+auto encodeNoiseImage(int width, int height, const char* type) -> std::string {
+    GdkPixbuf* pixbuf = gdk_pixbuf_new(GDK_COLORSPACE_RGB, false, 8, width, height);
+    guchar* pixels = gdk_pixbuf_get_pixels(pixbuf);
+    uint32_t state = 1;
+    for (int y = 0; y < height; y++) {
+        guchar* row = pixels + y * gdk_pixbuf_get_rowstride(pixbuf);
+        for (int x = 0; x < width * 3; x++) {
+            state = state * 1664525U + 1013904223U;
+            row[x] = static_cast<guchar>((x / 3 + y) * 255 / (width + height) + (state >> 28U));
+        }
+    }
+
+    gchar* buffer = nullptr;
+    gsize size = 0;
+    gdk_pixbuf_save_to_buffer(pixbuf, &buffer, &size, type, nullptr, nullptr);
+    g_object_unref(pixbuf);
+    std::string data(buffer, size);
+    g_free(buffer);
+    return data;
+}
+}  // namespace
+
+auto BenchDocuments::create(int pages, int strokesPerPage, int pointsPerStroke, unsigned seed)
+        -> std::unique_ptr<BenchDocument> {
+    DocumentGeneratorOptions options;
+    options.seed = seed;
+    options.pages = pages;
+    options.strokesPerLayer = strokesPerPage;
+    options.minPoints = pointsPerStroke;
+    options.maxPoints = pointsPerStroke;
+
+    auto bench = std::make_unique<BenchDocument>();
+    DocumentGenerator(options).generate(&bench->doc);
+    return bench;
+}
+
+auto BenchDocuments::createHighlighted(int pages, int& highlightsPerPage) -> std::unique_ptr<BenchDocument> {
+    auto bench = create(pages);
+
+    highlightsPerPage = 0;
+    for (size_t p = 0; p < bench->doc.getPageCount(); p++) {
+        PageRef page = bench->doc.getPage(p);
+        Layer* layer = (*page->getLayers())[0];
+        int count = 0;
+        // Three marks on every line of the ruling
+        for (double y = 80; y + 12 < page->getHeight(); y += 24) {
+            for (double x = 40; x + 140 < page->getWidth(); x += 180) {
+                auto* stroke = new Stroke();
+                stroke->setToolType(STROKE_TOOL_HIGHLIGHTER);
+                stroke->setColor(Color{0xFFFF00U});
+                stroke->setWidth(12);
+                stroke->setFill(128);
+                for (int i = 0; i <= 10; i++) {
+                    stroke->addPoint(Point(x + i * 14, y));
+                }
+                layer->addElement(stroke);
+                count++;
+            }
+        }
+        highlightsPerPage = count;
+    }
+    return bench;
+}
+
+auto BenchDocuments::createWithText(int pages, int& textsPerPage) -> std::unique_ptr<BenchDocument> {
+    auto bench = create(pages, 20);
+
+    textsPerPage = 0;
+    for (size_t p = 0; p < bench->doc.getPageCount(); p++) {
+        PageRef page = bench->doc.getPage(p);
+        Layer* layer = (*page->getLayers())[0];
+        int count = 0;
+        for (double y = 80; y + 24 < page->getHeight(); y += 24) {
+            auto* text = new Text();
+            text->setText("The quick brown fox jumps over the lazy dog, line " + std::to_string(count + 1));
+            text->getFont().setSize(12);
+            text->setX(40);
+            text->setY(y - 16);
+            layer->addElement(text);
+            count++;
+        }
+        textsPerPage = count;
+    }
+    return bench;
+}
+
+auto BenchDocuments::createWithImages(int pages, int imagesPerPage) -> std::unique_ptr<BenchDocument> {
+    auto bench = create(pages, 20);
+    std::string png = encodeNoiseImage(400, 300, "png");
+
+    // Backgrounds from a file are embedded as they are, they are only read back for the export
+    fs::path photo = tempFile("photo.jpg");
+    {
+        std::string jpeg = encodeNoiseImage(1600, 1200, "jpeg");
+        std::ofstream out(photo, std::ios::binary | std::ios::trunc);
+        out.write(jpeg.data(), static_cast<std::streamsize>(jpeg.size()));
+    }
+
+    for (size_t p = 0; p < bench->doc.getPageCount(); p++) {
+        PageRef page = bench->doc.getPage(p);
+
+        BackgroundImage background;
+        background.loadFile(photo, nullptr);
+        page->setBackgroundType(PageType(PageTypeFormat::Image));
+        page->setBackgroundImage(background);
+
+        Layer* layer = (*page->getLayers())[0];
+        for (int i = 0; i < imagesPerPage; i++) {
+            auto* image = new Image();
+            image->setImage(std::string(png));
+            image->setX(40 + i * 30);
+            image->setY(100 + i * 150);
+            image->setWidth(200);
+            image->setHeight(150);
+            layer->addElement(image);
+        }
+    }
+    return bench;
+}
+
+auto BenchDocuments::fixture(int pages) -> fs::path {
+    static std::mutex mutex;
+    std::lock_guard<std::mutex> lock(mutex);
+
+    fs::path file = benchDirectory() / ("fixture-" + std::to_string(pages) + ".xopp");
+    if (!fs::exists(file)) {
+        auto bench = create(pages);
+        SaveHandler h;
+        h.prepareSave(&bench->doc);
+        h.saveTo(file);
+    }
+    return file;
+}
+
+auto BenchDocuments::tempFile(const std::string& name) -> fs::path { return benchDirectory() / name; }
@@ -0,0 +1,88 @@
+/*
+ * Xournal++
+ *
+ * Fixture documents for the benchmarks
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <memory>
+
+#include "model/Document.h"
+#include "model/DocumentHandler.h"
+
+#include "filesystem.h"
+
+/**
+ * A document with the handler it needs, created in memory
+ */
+class BenchDocument {
+public:
+    BenchDocument();
+
+public:
+    DocumentHandler handler;
+    Document doc;
+};
+
+namespace BenchDocuments {
+
+/**
+ * Strokes on every page of the fixture documents
+ */
+constexpr int STROKES_PER_PAGE = 200;
+
+/**
+ * Points of every stroke of the fixture documents
+ */
+constexpr int POINTS_PER_STROKE = 100;
+
+/**
+ * @brief Create a document with handwriting-like strokes on ruled A4 pages, see DocumentGenerator
+ *
+ * The content only depends on the parameters and the seed, so all runs measure the same document.
+ */
+std::unique_ptr<BenchDocument> create(int pages, int strokesPerPage = STROKES_PER_PAGE,
+                                      int pointsPerStroke = POINTS_PER_STROKE, unsigned seed = 1);
+
+/**
+ * @brief Like create(), with additional rows of filled highlighter strokes on every page, like marked up text
+ *
+ * @return The document, and the number of highlighter strokes per page in highlightsPerPage
+ */
+std::unique_ptr<BenchDocument> createHighlighted(int pages, int& highlightsPerPage);
+
+/**
+ * @brief Like create() with fewer strokes, with a paragraph of text on every line of the ruling, like typed notes
+ *
+ * @return The document, and the number of texts per page in textsPerPage
+ */
+std::unique_ptr<BenchDocument> createWithText(int pages, int& textsPerPage);
+
+/**
+ * @brief Like create() with fewer strokes, with the same photo as background of every page and copies of the same
+ * PNG image on it
+ *
+ * The background is loaded from the same file and the images are decoded separately for every page, as in a document
+ * assembled from copied pages and pasted images, so the export can only share them by their content.
+ */
+std::unique_ptr<BenchDocument> createWithImages(int pages, int imagesPerPage);
+
+/**
+ * @brief Path of a saved fixture document with the given number of pages
+ *
+ * The file is written to the temporary directory on first use.
+ */
+fs::path fixture(int pages);
+
+/**
+ * A temporary file name for benchmark output, removed at exit
+ */
+fs::path tempFile(const std::string& name);
+
+}  // namespace BenchDocuments
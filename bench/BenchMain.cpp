@@ -0,0 +1,27 @@
+/*
+ * Xournal++
+ *
+ * Entry point of the benchmark suite
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "BenchDocuments.h"
+
+auto main(int argc, char** argv) -> int {
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    std::error_code ec;
+    fs::remove_all(BenchDocuments::tempFile(""), ec);
+    return 0;
+}
@@ -0,0 +1,73 @@
+/*
+ * Xournal++
+ *
+ * Benchmarks of the eraser
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "control/ToolHandler.h"
+#include "control/tools/EraseHandler.h"
+#include "gui/Redrawable.h"
+#include "undo/UndoRedoHandler.h"
+
+#include "AllocationCounter.h"
+#include "BenchDocuments.h"
+
+namespace {
+/**
+ * Ignores all redraw requests of the eraser
+ */
+class NullRedrawable: public Redrawable {
+public:
+    void repaintArea(double, double, double, double) override {}
+    void repaintPage() override {}
+    void rerenderPage() override {}
+    void rerenderRect(double, double, double, double) override {}
+    GdkRGBA getSelectionColor() override { return {}; }
+    void deleteViewBuffer() override {}
+    int getX() const override { return 0; }
+    int getY() const override { return 0; }
+};
+}  // namespace
+
+/**
+ * Sweep the eraser across a full page, arg: the eraser type
+ */
+static void BM_Erase(benchmark::State& state) {
+    auto eraserType = static_cast<EraserType>(state.range(0));
+
+    ToolHandler toolHandler(nullptr, nullptr, nullptr);
+    toolHandler.selectTool(TOOL_ERASER);
+    toolHandler.getTool(TOOL_ERASER).setEraserType(eraserType);
+    NullRedrawable view;
+
+    AllocationCounter::Scope allocs(state);
+    for (auto _: state) {
+        state.PauseTiming();
+        auto bench = BenchDocuments::create(1);
+        PageRef page = bench->doc.getPage(0);
+        UndoRedoHandler undo(nullptr);
+        state.ResumeTiming();
+
+        EraseHandler eraser(&undo, &bench->doc, page, &toolHandler, &view);
+        for (double y = 60; y < page->getHeight() - 60; y += 40) {
+            for (double x = 0; x < page->getWidth(); x += 2) {
+                eraser.erase(x, y);
+            }
+        }
+        eraser.finalize();
+
+        state.PauseTiming();
+        bench.reset();
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * BenchDocuments::STROKES_PER_PAGE);
+}
+BENCHMARK(BM_Erase)->Arg(ERASER_TYPE_DEFAULT)->Arg(ERASER_TYPE_DELETE_STROKE)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,138 @@
+/*
+ * Xournal++
+ *
+ * Benchmarks of the PDF and image export
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "control/jobs/ImageExport.h"
+#include "control/jobs/ProgressListener.h"
+#include "pdf/base/XojPdfExportFactory.h"
+
+#include "AllocationCounter.h"
+#include "BenchDocuments.h"
+
+namespace {
+constexpr int IMAGES_PER_PAGE = 4;
+}  // namespace
+
+static void BM_ExportPdf(benchmark::State& state) {
+    auto pages = static_cast<int>(state.range(0));
+    auto bench = BenchDocuments::create(pages);
+    fs::path file = BenchDocuments::tempFile("export.pdf");
+
+    AllocationCounter::Scope allocs(state);
+    for (auto _: state) {
+        std::unique_ptr<XojPdfExport> pdfe(XojPdfExportFactory::createExport(&bench->doc, nullptr));
+        if (!pdfe->createPdf(file, false)) {
+            state.SkipWithError(pdfe->getLastError().c_str());
+            break;
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * pages);
+}
+BENCHMARK(BM_ExportPdf)->Arg(1)->Arg(10)->Unit(benchmark::kMillisecond);
+
+/**
+ * Export all pages as PNG, args: number of pages, number of export jobs
+ */
+static void BM_ExportPng(benchmark::State& state) {
+    auto pages = static_cast<int>(state.range(0));
+    auto jobs = static_cast<int>(state.range(1));
+    auto bench = BenchDocuments::create(pages);
+    fs::path file = BenchDocuments::tempFile("export.png");
+
+    AllocationCounter::Scope allocs(state);
+    for (auto _: state) {
+        PageRangeVector range{new PageRangeEntry(0, pages - 1)};
+        ImageExport imgExport(&bench->doc, file, EXPORT_GRAPHICS_PNG, EXPORT_BACKGROUND_ALL, range);
+        imgExport.setQualityParameter(EXPORT_QUALITY_DPI, 150);
+        imgExport.setJobCount(jobs);
+
+        DummyProgressListener progress;
+        imgExport.exportGraphics(&progress);
+        for (PageRangeEntry* e: range) { delete e; }
+
+        if (!imgExport.getLastErrorMsg().empty()) {
+            state.SkipWithError(imgExport.getLastErrorMsg().c_str());
+            break;
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * pages);
+}
+BENCHMARK(BM_ExportPng)
+        ->ArgNames({"pages", "jobs"})
+        ->Args({1, 1})
+        ->Args({10, 1})
+        ->Args({10, 0})
+        ->Unit(benchmark::kMillisecond)
+        ->UseRealTime();
+
+/**
+ * Export pages with the same photo as background and the same pasted images, args: number of pages. The counter
+ * "bytes" is the size of the output, which grows with every image embedded more than once.
+ */
+static void BM_ExportImagesPdf(benchmark::State& state) {
+    auto pages = static_cast<int>(state.range(0));
+    auto bench = BenchDocuments::createWithImages(pages, IMAGES_PER_PAGE);
+    fs::path file = BenchDocuments::tempFile("images.pdf");
+
+    AllocationCounter::Scope allocs(state);
+    for (auto _: state) {
+        std::unique_ptr<XojPdfExport> pdfe(XojPdfExportFactory::createExport(&bench->doc, nullptr));
+        if (!pdfe->createPdf(file, false)) {
+            state.SkipWithError(pdfe->getLastError().c_str());
+            break;
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * pages);
+    state.counters["bytes"] = static_cast<double>(fs::file_size(file));
+}
+BENCHMARK(BM_ExportImagesPdf)->Arg(1)->Arg(10)->Unit(benchmark::kMillisecond);
+
+/**
+ * Like BM_ExportImagesPdf, as one SVG file per page
+ */
+static void BM_ExportImagesSvg(benchmark::State& state) {
+    auto pages = static_cast<int>(state.range(0));
+    auto bench = BenchDocuments::createWithImages(pages, IMAGES_PER_PAGE);
+    fs::path file = BenchDocuments::tempFile("images.svg");
+
+    AllocationCounter::Scope allocs(state);
+    for (auto _: state) {
+        PageRangeVector range{new PageRangeEntry(0, pages - 1)};
+        ImageExport imgExport(&bench->doc, file, EXPORT_GRAPHICS_SVG, EXPORT_BACKGROUND_ALL, range);
+
+        DummyProgressListener progress;
+        imgExport.exportGraphics(&progress);
+        for (PageRangeEntry* e: range) { delete e; }
+
+        if (!imgExport.getLastErrorMsg().empty()) {
+            state.SkipWithError(imgExport.getLastErrorMsg().c_str());
+            break;
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * pages);
+    uintmax_t bytes = pages == 1 ? fs::file_size(file) : 0;
+    for (int i = 1; pages > 1 && i <= pages; i++) {
+        fs::path pageFile = file;
+        pageFile.replace_extension();
+        bytes += fs::file_size(pageFile += "-" + std::to_string(i) + ".svg");
+    }
+    state.counters["bytes"] = static_cast<double>(bytes);
+}
+BENCHMARK(BM_ExportImagesSvg)->Arg(1)->Arg(10)->Unit(benchmark::kMillisecond);
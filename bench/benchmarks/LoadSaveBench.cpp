@@ -0,0 +1,67 @@
+/*
+ * Xournal++
+ *
+ * Benchmarks of loading and saving documents
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <benchmark/benchmark.h>
+#include <zlib.h>
+
+#include "control/xojfile/LoadHandler.h"
+#include "control/xojfile/SaveHandler.h"
+
+#include "AllocationCounter.h"
+#include "BenchDocuments.h"
+
+static void BM_Load(benchmark::State& state) {
+    auto pages = static_cast<int>(state.range(0));
+    fs::path file = BenchDocuments::fixture(pages);
+
+    AllocationCounter::Scope allocs(state);
+    for (auto _: state) {
+        LoadHandler loader;
+        Document* doc = loader.loadDocument(file);
+        if (doc == nullptr) {
+            state.SkipWithError(loader.getLastError().c_str());
+            break;
+        }
+        benchmark::DoNotOptimize(doc);
+    }
+
+    state.SetItemsProcessed(state.iterations() * pages * BenchDocuments::STROKES_PER_PAGE);
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(fs::file_size(file)));
+}
+BENCHMARK(BM_Load)->Arg(1)->Arg(10)->Arg(50)->Unit(benchmark::kMillisecond);
+
+static void BM_Save(benchmark::State& state) {
+    auto pages = static_cast<int>(state.range(0));
+    auto level = static_cast<int>(state.range(1));
+    auto bench = BenchDocuments::create(pages);
+    fs::path file = BenchDocuments::tempFile("save.xopp");
+
+    AllocationCounter::Scope allocs(state);
+    for (auto _: state) {
+        SaveHandler h;
+        h.setCompression(level);
+        h.prepareSave(&bench->doc);
+        h.saveTo(file);
+        if (!h.getErrorMessage().empty()) {
+            state.SkipWithError(h.getErrorMessage().c_str());
+            break;
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * pages * BenchDocuments::STROKES_PER_PAGE);
+}
+BENCHMARK(BM_Save)
+        ->ArgNames({"pages", "level"})
+        ->Args({1, Z_DEFAULT_COMPRESSION})
+        ->Args({10, Z_DEFAULT_COMPRESSION})
+        ->Args({50, Z_DEFAULT_COMPRESSION})
+        ->Args({50, Z_BEST_SPEED})
+        ->Unit(benchmark::kMillisecond);
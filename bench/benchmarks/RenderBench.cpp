@@ -0,0 +1,128 @@
+/*
+ * Xournal++
+ *
+ * Benchmarks of rendering pages
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <cairo.h>
+
+#include <benchmark/benchmark.h>
+
+#include "view/DocumentView.h"
+
+#include "AllocationCounter.h"
+#include "BenchDocuments.h"
+
+/**
+ * Render a page like the page view does, arg: zoom in percent
+ */
+static void BM_DrawPage(benchmark::State& state) {
+    double zoom = static_cast<double>(state.range(0)) / 100.0;
+    auto bench = BenchDocuments::create(1);
+    PageRef page = bench->doc.getPage(0);
+
+    cairo_surface_t* surface = cairo_image_surface_create(
+            CAIRO_FORMAT_ARGB32, static_cast<int>(page->getWidth() * zoom), static_cast<int>(page->getHeight() * zoom));
+    cairo_t* cr = cairo_create(surface);
+    cairo_scale(cr, zoom, zoom);
+
+    DocumentView view;
+    AllocationCounter::Scope allocs(state);
+    for (auto _: state) {
+        view.drawPage(page, cr, true);
+        cairo_surface_flush(surface);
+    }
+
+    state.SetItemsProcessed(state.iterations() * BenchDocuments::STROKES_PER_PAGE);
+
+    cairo_destroy(cr);
+    cairo_surface_destroy(surface);
+}
+BENCHMARK(BM_DrawPage)->Arg(100)->Arg(200)->Arg(400)->Unit(benchmark::kMillisecond);
+
+/**
+ * Render a page with many filled highlighter strokes, which are drawn through masks, arg: zoom in percent
+ */
+static void BM_DrawHighlightedPage(benchmark::State& state) {
+    double zoom = static_cast<double>(state.range(0)) / 100.0;
+    int highlights = 0;
+    auto bench = BenchDocuments::createHighlighted(1, highlights);
+    PageRef page = bench->doc.getPage(0);
+
+    cairo_surface_t* surface = cairo_image_surface_create(
+            CAIRO_FORMAT_ARGB32, static_cast<int>(page->getWidth() * zoom), static_cast<int>(page->getHeight() * zoom));
+    cairo_t* cr = cairo_create(surface);
+    cairo_scale(cr, zoom, zoom);
+
+    DocumentView view;
+    AllocationCounter::Scope allocs(state);
+    for (auto _: state) {
+        view.drawPage(page, cr, true);
+        cairo_surface_flush(surface);
+    }
+
+    state.SetItemsProcessed(state.iterations() * (BenchDocuments::STROKES_PER_PAGE + highlights));
+
+    cairo_destroy(cr);
+    cairo_surface_destroy(surface);
+}
+BENCHMARK(BM_DrawHighlightedPage)->Arg(100)->Arg(200)->Unit(benchmark::kMillisecond);
+
+/**
+ * Render a page of typed notes, mostly Text elements, arg: zoom in percent
+ */
+static void BM_DrawTextPage(benchmark::State& state) {
+    double zoom = static_cast<double>(state.range(0)) / 100.0;
+    int texts = 0;
+    auto bench = BenchDocuments::createWithText(1, texts);
+    PageRef page = bench->doc.getPage(0);
+
+    cairo_surface_t* surface = cairo_image_surface_create(
+            CAIRO_FORMAT_ARGB32, static_cast<int>(page->getWidth() * zoom), static_cast<int>(page->getHeight() * zoom));
+    cairo_t* cr = cairo_create(surface);
+    cairo_scale(cr, zoom, zoom);
+
+    DocumentView view;
+    AllocationCounter::Scope allocs(state);
+    for (auto _: state) {
+        view.drawPage(page, cr, true);
+        cairo_surface_flush(surface);
+    }
+
+    state.SetItemsProcessed(state.iterations() * texts);
+
+    cairo_destroy(cr);
+    cairo_surface_destroy(surface);
+}
+BENCHMARK(BM_DrawTextPage)->Arg(100)->Arg(200)->Unit(benchmark::kMillisecond);
+
+/**
+ * Render a page while audio strokes are marked, so every stroke without audio is drawn through a mask
+ */
+static void BM_DrawPageMarkAudio(benchmark::State& state) {
+    auto bench = BenchDocuments::create(1);
+    PageRef page = bench->doc.getPage(0);
+
+    cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, static_cast<int>(page->getWidth()),
+                                                          static_cast<int>(page->getHeight()));
+    cairo_t* cr = cairo_create(surface);
+
+    DocumentView view;
+    view.setMarkAudioStroke(true);
+    AllocationCounter::Scope allocs(state);
+    for (auto _: state) {
+        view.drawPage(page, cr, true);
+        cairo_surface_flush(surface);
+    }
+
+    state.SetItemsProcessed(state.iterations() * BenchDocuments::STROKES_PER_PAGE);
+
+    cairo_destroy(cr);
+    cairo_surface_destroy(surface);
+}
+BENCHMARK(BM_DrawPageMarkAudio)->Unit(benchmark::kMillisecond);
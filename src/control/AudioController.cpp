@@ -2,6 +2,10 @@
 
 #include <cinttypes>
 
+#include "gui/PageView.h"
+#include "gui/XournalView.h"
+#include "model/AudioIndex.h"
+
 #include "Util.h"
 #include "XojMsgBox.h"
 #include "i18n.h"
@@ -9,6 +13,18 @@
 using std::string;
 using std::vector;
 
+/**
+ * Interval in milliseconds to check the playback position
+ */
+constexpr guint FOLLOW_INTERVAL = 100;
+
+AudioController::~AudioController() {
+    if (this->followTimeout) {
+        g_source_remove(this->followTimeout);
+        this->followTimeout = 0;
+    }
+}
+
 auto AudioController::startRecording() -> bool {
     if (!this->isRecording()) {
         if (getAudioFolder().empty()) {
@@ -58,11 +74,18 @@ auto AudioController::isRecording() -> bool { return this->audioRecorder->isReco
 
 auto AudioController::isPlaying() -> bool { return this->audioPlayer->isPlaying(); }
 
-auto AudioController::startPlayback(const string& filename, unsigned int timestamp) -> bool {
+auto AudioController::startPlayback(const string& filename, unsigned int timestamp, const string& indexFilename)
+        -> bool {
     this->audioPlayer->stop();
+    stopFollowing();
+
     bool status = this->audioPlayer->start(filename, timestamp);
     if (status) {
         this->control.getWindow()->getToolMenuHandler()->enableAudioPlaybackButtons();
+
+        if (!indexFilename.empty() && this->settings.isFollowAudioPlayback()) {
+            startFollowing(indexFilename, timestamp);
+        }
     }
     return status;
 }
@@ -86,6 +109,84 @@ void AudioController::continuePlayback() {
 void AudioController::stopPlayback() {
     this->control.getWindow()->getToolMenuHandler()->disableAudioPlaybackButtons();
     this->audioPlayer->stop();
+    stopFollowing();
+}
+
+void AudioController::startFollowing(const string& indexFilename, size_t playbackTimestamp) {
+    this->followFilename = indexFilename;
+    this->followTimestamp = playbackTimestamp;
+
+    // Playback was started from an element, only scroll once the playback reaches another page
+    this->followPage = this->control.getAudioIndex()->findPage(this->followFilename, playbackTimestamp);
+    repaintHighlight(playbackTimestamp);
+
+    this->followTimeout = g_timeout_add(FOLLOW_INTERVAL, reinterpret_cast<GSourceFunc>(followPlaybackTimer), this);
+}
+
+void AudioController::stopFollowing() {
+    if (this->followTimeout) {
+        g_source_remove(this->followTimeout);
+        this->followTimeout = 0;
+    }
+    if (this->followFilename.empty()) {
+        return;
+    }
+
+    // The pages are redrawn later, without the highlight
+    repaintHighlight(this->followTimestamp);
+    this->followFilename.clear();
+    this->followTimestamp = 0;
+}
+
+auto AudioController::followPlaybackTimer(AudioController* controller) -> gboolean {
+    if (controller->audioPlayer->hasEnded()) {
+        // The source is removed by returning false
+        controller->followTimeout = 0;
+        controller->stopFollowing();
+        return false;
+    }
+
+    controller->followPlayback();
+    return true;
+}
+
+void AudioController::followPlayback() {
+    size_t playbackTimestamp = this->audioPlayer->getTimestamp();
+    if (playbackTimestamp == this->followTimestamp) {
+        // Paused
+        return;
+    }
+
+    size_t lastTimestamp = this->followTimestamp;
+    this->followTimestamp = playbackTimestamp;
+    repaintHighlight(lastTimestamp);
+    repaintHighlight(playbackTimestamp);
+
+    size_t page = this->control.getAudioIndex()->findPage(this->followFilename, playbackTimestamp);
+    if (page != AudioIndex::npos && page != this->followPage) {
+        this->followPage = page;
+        this->control.getScrollHandler()->scrollToPage(page);
+    }
+}
+
+void AudioController::repaintHighlight(size_t playbackTimestamp) {
+    size_t from = playbackTimestamp > HIGHLIGHT_DURATION ? playbackTimestamp - HIGHLIGHT_DURATION : 0;
+    XournalView* xournal = this->control.getWindow()->getXournal();
+    for (size_t p: this->control.getAudioIndex()->findPages(this->followFilename, from, playbackTimestamp)) {
+        if (XojPageView* view = xournal->getViewFor(p)) {
+            view->repaintPage();
+        }
+    }
+}
+
+auto AudioController::hasHighlight() const -> bool { return !this->followFilename.empty(); }
+
+auto AudioController::getHighlightedBounds(const PageRef& page) const -> std::vector<Rectangle<double>> {
+    if (this->followFilename.empty()) {
+        return {};
+    }
+    size_t from = this->followTimestamp > HIGHLIGHT_DURATION ? this->followTimestamp - HIGHLIGHT_DURATION : 0;
+    return this->control.getAudioIndex()->findElements(page, this->followFilename, from, this->followTimestamp);
 }
 
 auto AudioController::getAudioFilename() const -> string const& { return this->audioFilename; }
@@ -15,11 +15,13 @@
 #include <vector>
 
 #include "gui/toolbarMenubar/ToolMenuHandler.h"
+#include "model/PageRef.h"
 #include "settings/Settings.h"
 #include "util/audio/AudioPlayer.h"
 #include "util/audio/AudioRecorder.h"
 
 #include "Control.h"
+#include "Rectangle.h"
 #include "filesystem.h"
 
 class AudioPlayer;
@@ -28,13 +30,19 @@ class AudioController final {
 public:
     // Todo convert Pointers to reference (changes to control.cpp are necessary)
     AudioController(Settings* settings, Control* control): settings(*settings), control(*control) {}
+    ~AudioController();
 
     bool startRecording();
     bool stopRecording();
     bool isRecording();
 
     bool isPlaying();
-    bool startPlayback(const std::string& filename, unsigned int timestamp);
+
+    /**
+     * @param indexFilename The audio filename as stored in the elements. If set, the view follows the playback
+     *                      and highlights the elements written at the current position.
+     */
+    bool startPlayback(const std::string& filename, unsigned int timestamp, const std::string& indexFilename = "");
     void pausePlayback();
     void continuePlayback();
     void stopPlayback();
@@ -47,6 +55,25 @@ public:
     std::vector<DeviceInfo> getOutputDevices() const;
     std::vector<DeviceInfo> getInputDevices() const;
 
+    /**
+     * @return true while the playback is followed, see getHighlightedBounds()
+     */
+    bool hasHighlight() const;
+
+    /**
+     * @return The bounds of the elements on the page which were written during the last HIGHLIGHT_DURATION before
+     *         the playback position
+     */
+    std::vector<Rectangle<double>> getHighlightedBounds(const PageRef& page) const;
+
+private:
+    void startFollowing(const std::string& indexFilename, size_t playbackTimestamp);
+    void stopFollowing();
+    void followPlayback();
+    void repaintHighlight(size_t playbackTimestamp);
+
+    static gboolean followPlaybackTimer(AudioController* controller);
+
 private:
     Settings& settings;
     Control& control;
@@ -61,4 +88,17 @@ private:
 
     std::string audioFilename;
     size_t timestamp = 0;
+
+    /**
+     * Milliseconds of audio before the playback position whose elements are highlighted
+     */
+    static constexpr size_t HIGHLIGHT_DURATION = 2000;
+
+    /**
+     * The recording which is played, as named in the elements. Empty if the playback is not followed.
+     */
+    std::string followFilename;
+    size_t followTimestamp = 0;
+    size_t followPage = 0;
+    guint followTimeout = 0;
 };
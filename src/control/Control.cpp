@@ -4,6 +4,7 @@
 #include <memory>
 #include <numeric>
 
+#include "gui/PageView.h"
 #include "gui/TextEditor.h"
 #include "gui/XournalView.h"
 #include "gui/XournalppCursor.h"
@@ -11,6 +12,7 @@
 #include "gui/dialog/FillOpacityDialog.h"
 #include "gui/dialog/FormatDialog.h"
 #include "gui/dialog/GotoDialog.h"
+#include "gui/dialog/MemoryReportDialog.h"
 #include "gui/dialog/PageTemplateDialog.h"
 #include "gui/dialog/SelectBackgroundColorDialog.h"
 #include "gui/dialog/SettingsDialog.h"
@@ -24,6 +26,7 @@
 #include "jobs/PdfExportJob.h"
 #include "jobs/SaveJob.h"
 #include "layer/LayerController.h"
+#include "model/AudioIndex.h"
 #include "model/StrokeStyle.h"
 #include "pagetype/PageTypeHandler.h"
 #include "plugin/PluginController.h"
@@ -34,15 +37,18 @@
 #include "undo/InsertUndoAction.h"
 #include "view/TextView.h"
 #include "xojfile/LoadHandler.h"
+#include "xojfile/PageFileReader.h"
 
 #include "CrashHandler.h"
 #include "FullscreenHandler.h"
 #include "LatexController.h"
+#include "PdfCache.h"
 #include "PageBackgroundChangeController.h"
 #include "PathUtil.h"
 #include "PrintHandler.h"
 #include "Stacktrace.h"
 #include "StringUtils.h"
+#include "ThumbnailCache.h"
 #include "UndoRedoController.h"
 #include "Util.h"
 #include "XojMsgBox.h"
@@ -81,12 +87,18 @@ Control::Control(GApplication* gtkApp, GladeSearchpath* gladeSearchPath): gtkApp
 
     this->audioController = new AudioController(this->settings, this);
 
+    this->thumbnailCache =
+            new ThumbnailCache(this->settings->getThumbnailCacheSize(), Util::getCacheSubfolder("thumbnails"));
+
     this->scrollHandler = new ScrollHandler(this);
 
     this->scheduler = new XournalScheduler();
 
     this->doc = new Document(this);
 
+    this->audioIndex = new AudioIndex(this->doc);
+    this->audioIndex->registerListener(this);
+
     // for crashhandling
     setEmergencyDocument(this->doc);
 
@@ -137,6 +149,10 @@ Control::~Control() {
     this->toolHandler = nullptr;
     delete this->sidebar;
     this->sidebar = nullptr;
+    delete this->thumbnailCache;
+    this->thumbnailCache = nullptr;
+    delete this->audioIndex;
+    this->audioIndex = nullptr;
     delete this->doc;
     this->doc = nullptr;
     delete this->searchBar;
@@ -927,6 +943,9 @@ void Control::actionPerformed(ActionType type, ActionGroup group, GdkEvent* even
         case ACTION_ABOUT:
             showAbout();
             break;
+        case ACTION_MEMORY_REPORT:
+            showMemoryReport();
+            break;
 
         case ACTION_NONE:
             // do nothing
@@ -1987,6 +2006,10 @@ auto Control::openFile(fs::path filepath, int scrollToPage, bool forceOpen) -> b
         return loadPdf(filepath, scrollToPage);
     }
 
+    if (PageFileReader::isPageFile(filepath)) {
+        return loadPageFile(filepath, scrollToPage);
+    }
+
     LoadHandler loadHandler;
     Document* loadedDocument = loadHandler.loadDocument(filepath);
     if ((loadedDocument != nullptr && loadHandler.isAttachedPdfMissing()) ||
@@ -2095,6 +2118,39 @@ auto Control::loadPdf(const fs::path& filepath, int scrollToPage) -> bool {
     return an;
 }
 
+auto Control::loadPageFile(fs::path const& filepath, int scrollToPage) -> bool {
+    PageFileReader reader;
+    Document* loadedDocument = reader.loadDocument(filepath);
+    if (!loadedDocument) {
+        string msg = FS(_F("Error opening file \"{1}\"") % filepath.u8string()) + "\n" + reader.getLastError();
+        XojMsgBox::showErrorToUser(getGtkWindow(), msg);
+
+        fileLoaded(scrollToPage);
+        return false;
+    }
+
+    if (!reader.getMissingPdfFilename().empty()) {
+        const fs::path missingFilePath = fs::u8path(reader.getMissingPdfFilename());
+        XojMsgBox::showErrorToUser(
+                getGtkWindow(),
+                FS(_F("The background file {1} could not be found. It might have been moved, renamed or deleted.\nIt "
+                      "was last seen at: {2}") %
+                   missingFilePath.filename().string() % missingFilePath.parent_path().string()));
+    }
+
+    this->closeDocument();
+
+    this->doc->lock();
+    this->doc->clearDocument();
+    *this->doc = *loadedDocument;
+    this->doc->unlock();
+
+    settings->setLastSavePath(filepath.parent_path());
+
+    fileLoaded(scrollToPage);
+    return true;
+}
+
 auto Control::loadXoptTemplate(fs::path const& filepath) -> bool {
     auto contents = Util::readString(filepath);
     if (!contents.has_value()) {
@@ -2538,6 +2594,34 @@ void Control::showAbout() {
     dlg.show(GTK_WINDOW(this->win->getWindow()));
 }
 
+void Control::showMemoryReport() {
+    MemoryReportDialog dlg(this->gladeSearchPath, this);
+    dlg.show(GTK_WINDOW(this->win->getWindow()));
+}
+
+auto Control::createMemoryReport() -> MemoryReport {
+    MemoryReport report;
+
+    this->doc->lock();
+    report.addDocument(this->doc);
+    this->doc->unlock();
+
+    if (this->win) {
+        XournalView* xournal = this->win->getXournal();
+        auto const& views = xournal->getViewPages();
+        for (size_t i = 0; i < views.size(); i++) {
+            report.addPage(i, MemoryCategory::PageBuffers, views[i]->getMemoryFootprint());
+        }
+        report.add(MemoryCategory::PdfCache, xournal->getCache()->getMemoryFootprint());
+    }
+    if (this->sidebar) {
+        report.add(MemoryCategory::Previews, this->sidebar->getMemoryFootprint());
+    }
+    report.add(MemoryCategory::Undo, this->undoRedo->getMemoryFootprint());
+
+    return report;
+}
+
 void Control::clipboardCutCopyEnabled(bool enabled) {
     fireEnableAction(ACTION_CUT, enabled);
     fireEnableAction(ACTION_COPY, enabled);
@@ -2869,6 +2953,10 @@ auto Control::getSearchBar() -> SearchBar* { return this->searchBar; }
 
 auto Control::getAudioController() -> AudioController* { return this->audioController; }
 
+auto Control::getAudioIndex() -> AudioIndex* { return this->audioIndex; }
+
+auto Control::getThumbnailCache() -> ThumbnailCache* { return this->thumbnailCache; }
+
 auto Control::getPageTypes() -> PageTypeHandler* { return this->pageTypes; }
 
 auto Control::getNewPageType() -> PageTypeMenu* { return this->newPageType.get(); }
@@ -29,6 +29,7 @@
 #include "Actions.h"
 #include "AudioController.h"
 #include "ClipboardHandler.h"
+#include "MemoryReport.h"
 #include "PathUtil.h"
 #include "RecentManager.h"
 #include "ScrollHandler.h"
@@ -36,6 +37,8 @@
 
 
 class AudioController;
+class AudioIndex;
+class ThumbnailCache;
 class FullscreenHandler;
 class Sidebar;
 class XojPageView;
@@ -114,6 +117,13 @@ public:
 
     // Menu Help
     void showAbout();
+    void showMemoryReport();
+
+    /**
+     * Collects the memory used by the document, the page views, the caches and the undo stack.
+     * Has to be called from the UI thread.
+     */
+    MemoryReport createMemoryReport();
 
     virtual void actionPerformed(ActionType type, ActionGroup group, GdkEvent* event, GtkMenuItem* menuitem,
                                  GtkToolButton* toolbutton, bool enabled);
@@ -245,6 +255,8 @@ public:
     Sidebar* getSidebar();
     SearchBar* getSearchBar();
     AudioController* getAudioController();
+    AudioIndex* getAudioIndex();
+    ThumbnailCache* getThumbnailCache();
     PageTypeHandler* getPageTypes();
     PageTypeMenu* getNewPageType();
     PageBackgroundChangeController* getPageBackgroundChangeController();
@@ -324,6 +336,7 @@ protected:
 
     bool loadXoptTemplate(fs::path const& filepath);
     bool loadPdf(fs::path const& filepath, int scrollToPage);
+    bool loadPageFile(fs::path const& filepath, int scrollToPage);
 
 private:
     /**
@@ -358,6 +371,16 @@ private:
 
     AudioController* audioController;
 
+    /**
+     * Pages of the audio elements, to follow the audio playback
+     */
+    AudioIndex* audioIndex;
+
+    /**
+     * Persistent cache of rendered page previews, shared by all sidebars
+     */
+    ThumbnailCache* thumbnailCache = nullptr;
+
     ToolbarDragDropHandler* dragDropHandler = nullptr;
 
     GApplication* gtkApp = nullptr;
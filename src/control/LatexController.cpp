@@ -22,17 +22,29 @@
 
 using std::string;
 
+/**
+ * Time in milliseconds without a change before the formula is rendered, so typing does not start a
+ * LaTeX run per keystroke
+ */
+constexpr guint UPDATE_DELAY = 300;
+
 LatexController::LatexController(Control* control):
         control(control),
         settings(control->getSettings()->latexSettings),
         dlg(control->getGladeSearchPath()),
         doc(control->getDocument()),
         texTmpDir(Util::getTmpDirSubfolder("tex")),
-        generator(settings) {
+        generator(settings),
+        cache(Util::getCacheSubfolder("tex")) {
     Util::ensureFolderExists(this->texTmpDir);
+    this->cache.prune(LatexCache::DEFAULT_MAX_SIZE);
 }
 
 LatexController::~LatexController() {
+    if (this->updateTimeout) {
+        g_source_remove(this->updateTimeout);
+        this->updateTimeout = 0;
+    }
     if (updating_cancellable) {
         g_cancellable_cancel(updating_cancellable);
         g_object_unref(updating_cancellable);
@@ -137,6 +149,10 @@ auto LatexController::showTexEditDialog() -> string {
 
     this->dlg.show(GTK_WINDOW(control->getWindow()->getWindow()), isNewFormula);
     g_signal_handler_disconnect(dlg.getTextBuffer(), signalHandler);
+    if (this->updateTimeout) {
+        g_source_remove(this->updateTimeout);
+        this->updateTimeout = 0;
+    }
 
     string result = this->dlg.getFinalTex();
     // If the user cancelled, there is no change in the latex string.
@@ -144,14 +160,37 @@ auto LatexController::showTexEditDialog() -> string {
     return result;
 }
 
+auto LatexController::getTexContents(const string& texString) -> string {
+    return LatexGenerator::templateSub(texString, this->latexTemplate,
+                                       this->control->getToolHandler()->getTool(TOOL_TEXT).getColor());
+}
+
+auto LatexController::showCachedRender(const string& texString) -> bool {
+    auto pdf = this->cache.load(LatexCache::computeKey(this->settings.genCmd, getTexContents(texString)));
+    if (!pdf) {
+        return false;
+    }
+
+    this->lastPreviewedTex = texString;
+    this->isValidTex = true;
+    showRender(texString, std::move(*pdf));
+    return true;
+}
+
 void LatexController::triggerImageUpdate(const string& texString) {
-    if (this->isUpdating()) {
+    if (updating_cancellable) {
+        // onPdfRenderComplete() continues with the latest text
+        return;
+    }
+
+    if (showCachedRender(texString)) {
+        updateStatus();
         return;
     }
 
     this->lastPreviewedTex = texString;
-    const std::string texContents = LatexGenerator::templateSub(
-            texString, this->latexTemplate, this->control->getToolHandler()->getTool(TOOL_TEXT).getColor());
+    const std::string texContents = getTexContents(texString);
+    this->updatingKey = LatexCache::computeKey(this->settings.genCmd, texContents);
     auto result = generator.asyncRun(this->texTmpDir, texContents);
     if (auto* err = std::get_if<LatexGenerator::GenError>(&result)) {
         XojMsgBox::showErrorToUser(this->control->getGtkWindow(), err->message);
@@ -173,7 +212,25 @@ void LatexController::triggerImageUpdate(const string& texString) {
  * text asynchronously.
  */
 void LatexController::handleTexChanged(GtkTextBuffer* buffer, LatexController* self) {
+    // Only the text after the last change is rendered
+    if (self->updateTimeout) {
+        g_source_remove(self->updateTimeout);
+        self->updateTimeout = 0;
+    }
+
+    if (!self->updating_cancellable && self->showCachedRender(self->dlg.getBufferContents())) {
+        self->updateStatus();
+        return;
+    }
+
+    self->updateTimeout = g_timeout_add(UPDATE_DELAY, reinterpret_cast<GSourceFunc>(updateTimer), self);
+    self->updateStatus();
+}
+
+auto LatexController::updateTimer(LatexController* self) -> gboolean {
+    self->updateTimeout = 0;
     self->triggerImageUpdate(self->dlg.getBufferContents());
+    return false;
 }
 
 void LatexController::onPdfRenderComplete(GObject* procObj, GAsyncResult* res, LatexController* self) {
@@ -203,9 +260,12 @@ void LatexController::onPdfRenderComplete(GObject* procObj, GAsyncResult* res, L
     bool shouldUpdate = self->lastPreviewedTex != currentTex;
     if (err == nullptr) {
         self->isValidTex = true;
-        self->temporaryRender = self->loadRendered(currentTex);
-        if (self->temporaryRender != nullptr) {
-            self->dlg.setTempRender(self->temporaryRender->getPdf());
+        if (auto pdf = Util::readString(self->texTmpDir / "tex.pdf", true)) {
+            self->cache.store(self->updatingKey, *pdf);
+            // A newer text is rendered next, the outdated render is not shown
+            if (!shouldUpdate) {
+                self->showRender(self->lastPreviewedTex, std::move(*pdf));
+            }
         }
     }
 
@@ -213,12 +273,12 @@ void LatexController::onPdfRenderComplete(GObject* procObj, GAsyncResult* res, L
     g_clear_object(&proc);
 
     self->updateStatus();
-    if (shouldUpdate) {
+    if (shouldUpdate && !self->updateTimeout) {
         self->triggerImageUpdate(currentTex);
     }
 }
 
-bool LatexController::isUpdating() { return updating_cancellable; }
+bool LatexController::isUpdating() { return updating_cancellable || updateTimeout; }
 
 void LatexController::updateStatus() {
     GtkWidget* okButton = this->dlg.get("texokbutton");
@@ -248,20 +308,21 @@ void LatexController::deleteOldImage() {
     }
 }
 
-auto LatexController::loadRendered(string renderedTex) -> std::unique_ptr<TexImage> {
-    if (!this->isValidTex) {
-        return nullptr;
+void LatexController::showRender(string renderedTex, string pdf) {
+    this->temporaryRender = loadRendered(std::move(renderedTex), std::move(pdf));
+    if (this->temporaryRender != nullptr) {
+        this->dlg.setTempRender(this->temporaryRender->getPdf());
     }
+}
 
-    fs::path pdfPath = texTmpDir / "tex.pdf";
-    auto contents = Util::readString(pdfPath, true);
-    if (!contents) {
+auto LatexController::loadRendered(string renderedTex, string pdf) -> std::unique_ptr<TexImage> {
+    if (!this->isValidTex) {
         return nullptr;
     }
 
     auto img = std::make_unique<TexImage>();
     GError* err{};
-    bool loaded = img->loadData(std::move(*contents), &err);
+    bool loaded = img->loadData(std::move(pdf), &err);
 
     if (err != nullptr) {
         string message = FS(_F("Could not load LaTeX PDF file: {1}") % err->message);
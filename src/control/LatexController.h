@@ -22,6 +22,7 @@
 
 #include "control/settings/LatexSettings.h"
 #include "gui/dialog/LatexDialog.h"
+#include "latex/LatexCache.h"
 #include "latex/LatexGenerator.h"
 #include "model/PageRef.h"
 #include "model/Text.h"
@@ -81,9 +82,21 @@ private:
      * Asynchronously runs the LaTeX command and then updates the TeX image with
      * the given LaTeX string. If the preview is already being updated, then
      * this method will be a no-op.
+     *
+     * A formula which was rendered before is taken from the cache without running the command.
      */
     void triggerImageUpdate(const std::string& texString);
 
+    /**
+     * Shows the cached render of the LaTeX string, if there is one
+     */
+    bool showCachedRender(const std::string& texString);
+
+    /**
+     * Called once the text did not change for UPDATE_DELAY
+     */
+    static gboolean updateTimer(LatexController* self);
+
     /**
      * Show the LaTex Editor dialog, returning the final formula input by the
      * user. If the input was cancelled, the resulting string will be the same
@@ -109,9 +122,19 @@ private:
     bool isUpdating();
 
     /**
-     * Load the preview PDF from disk and create a TexImage object.
+     * Create a TexImage object from the rendered PDF.
+     */
+    std::unique_ptr<TexImage> loadRendered(std::string renderedTex, std::string pdf);
+
+    /**
+     * Show the TexImage of the rendered PDF in the dialog
      */
-    std::unique_ptr<TexImage> loadRendered(std::string renderedTex);
+    void showRender(std::string renderedTex, std::string pdf);
+
+    /**
+     * The contents of the .tex file for the LaTeX string
+     */
+    std::string getTexContents(const std::string& texString);
 
     /**
      * Insert the generated preview TexImage into the current page.
@@ -153,6 +176,16 @@ private:
      */
     GCancellable* updating_cancellable = nullptr;
 
+    /**
+     * The cache key of the preview which is being generated
+     */
+    std::string updatingKey;
+
+    /**
+     * Pending preview update, the text is only rendered once it did not change for a moment
+     */
+    guint updateTimeout = 0;
+
     /**
      * Whether the current TeX string is valid.
      */
@@ -216,4 +249,6 @@ private:
     std::unique_ptr<TexImage> temporaryRender;
 
     LatexGenerator generator;
+
+    LatexCache cache;
 };
@@ -0,0 +1,177 @@
+#include "MemoryReport.h"
+
+#include <iomanip>
+#include <iterator>
+#include <numeric>
+#include <set>
+#include <sstream>
+
+#include "model/Document.h"
+#include "model/Element.h"
+#include "model/Layer.h"
+#include "model/XojPage.h"
+
+namespace {
+auto categoryOf(Element* e) -> MemoryCategory {
+    switch (e->getType()) {
+        case ELEMENT_STROKE:
+            return MemoryCategory::Strokes;
+        case ELEMENT_IMAGE:
+            return MemoryCategory::Images;
+        case ELEMENT_TEXIMAGE:
+            return MemoryCategory::TexImages;
+        case ELEMENT_TEXT:
+        default:
+            return MemoryCategory::Texts;
+    }
+}
+
+constexpr MemoryCategory PAGE_CATEGORIES[] = {MemoryCategory::Strokes,     MemoryCategory::Texts,
+                                              MemoryCategory::Images,      MemoryCategory::TexImages,
+                                              MemoryCategory::Backgrounds, MemoryCategory::PageBuffers};
+}  // namespace
+
+MemoryReport::MemoryReport() = default;
+
+MemoryReport::~MemoryReport() = default;
+
+void MemoryReport::addDocument(Document* doc) {
+    std::set<GdkPixbuf*> backgrounds;
+
+    for (size_t p = 0; p < doc->getPageCount(); p++) {
+        PageRef page = doc->getPage(p);
+
+        // Make sure every page is listed, also empty ones
+        addPage(p, MemoryCategory::Strokes, 0);
+
+        for (Layer* l: *page->getLayers()) {
+            if (!l->isLoaded()) {
+                // Unloaded elements are in the page store, looking at them would load them
+                continue;
+            }
+            for (Element* e: l->getElements()) {
+                addPage(p, categoryOf(e), e->getMemoryFootprint());
+            }
+        }
+
+        BackgroundImage& img = page->getBackgroundImage();
+        if (!img.isEmpty() && backgrounds.insert(img.getPixbuf()).second) {
+            addPage(p, MemoryCategory::Backgrounds, img.getMemoryFootprint());
+        }
+    }
+}
+
+void MemoryReport::add(MemoryCategory category, size_t bytes) {
+    this->totals[static_cast<size_t>(category)] += bytes;
+}
+
+void MemoryReport::addPage(size_t page, MemoryCategory category, size_t bytes) {
+    if (page >= this->pages.size()) {
+        this->pages.resize(page + 1);
+    }
+    this->pages[page][static_cast<size_t>(category)] += bytes;
+    add(category, bytes);
+}
+
+auto MemoryReport::getTotal() const -> size_t {
+    return std::accumulate(this->totals.begin(), this->totals.end(), size_t{0});
+}
+
+auto MemoryReport::getTotal(MemoryCategory category) const -> size_t {
+    return this->totals[static_cast<size_t>(category)];
+}
+
+auto MemoryReport::getPageCount() const -> size_t { return this->pages.size(); }
+
+auto MemoryReport::getPageTotal(size_t page) const -> size_t {
+    if (page >= this->pages.size()) {
+        return 0;
+    }
+    return std::accumulate(this->pages[page].begin(), this->pages[page].end(), size_t{0});
+}
+
+auto MemoryReport::getPageUsage(size_t page, MemoryCategory category) const -> size_t {
+    if (page >= this->pages.size()) {
+        return 0;
+    }
+    return this->pages[page][static_cast<size_t>(category)];
+}
+
+auto MemoryReport::getCategoryName(MemoryCategory category) -> const char* {
+    switch (category) {
+        case MemoryCategory::Strokes:
+            return "strokes";
+        case MemoryCategory::Texts:
+            return "texts";
+        case MemoryCategory::Images:
+            return "images";
+        case MemoryCategory::TexImages:
+            return "teximages";
+        case MemoryCategory::Backgrounds:
+            return "backgrounds";
+        case MemoryCategory::PageBuffers:
+            return "pagebuffers";
+        case MemoryCategory::PdfCache:
+            return "pdfcache";
+        case MemoryCategory::Previews:
+            return "previews";
+        case MemoryCategory::Undo:
+            return "undo";
+    }
+    return "";
+}
+
+auto MemoryReport::formatSize(size_t bytes) -> std::string {
+    const char* units[] = {"B", "KiB", "MiB", "GiB"};
+    auto value = static_cast<double>(bytes);
+    size_t unit = 0;
+    while (value >= 1024 && unit + 1 < std::size(units)) {
+        value /= 1024;
+        unit++;
+    }
+
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(unit == 0 ? 0 : 1) << value << " " << units[unit];
+    return out.str();
+}
+
+void MemoryReport::writeText(std::ostream& out) const {
+    out << "Total" << std::setw(20) << formatSize(getTotal()) << "\n\n";
+    for (size_t c = 0; c < CATEGORY_COUNT; c++) {
+        auto category = static_cast<MemoryCategory>(c);
+        out << std::left << std::setw(13) << getCategoryName(category) << std::right << std::setw(12)
+            << formatSize(getTotal(category)) << "\n";
+    }
+
+    out << "\n" << std::left << std::setw(6) << "page" << std::right << std::setw(12) << "total";
+    for (MemoryCategory category: PAGE_CATEGORIES) {
+        out << std::setw(13) << getCategoryName(category);
+    }
+    out << "\n";
+
+    for (size_t p = 0; p < this->pages.size(); p++) {
+        out << std::left << std::setw(6) << p + 1 << std::right << std::setw(12) << formatSize(getPageTotal(p));
+        for (MemoryCategory category: PAGE_CATEGORIES) {
+            out << std::setw(13) << formatSize(getPageUsage(p, category));
+        }
+        out << "\n";
+    }
+}
+
+void MemoryReport::writeJson(std::ostream& out) const {
+    out << "{\n  \"total\": " << getTotal() << ",\n  \"categories\": {";
+    for (size_t c = 0; c < CATEGORY_COUNT; c++) {
+        auto category = static_cast<MemoryCategory>(c);
+        out << (c == 0 ? "" : ", ") << "\"" << getCategoryName(category) << "\": " << getTotal(category);
+    }
+    out << "},\n  \"pages\": [";
+
+    for (size_t p = 0; p < this->pages.size(); p++) {
+        out << (p == 0 ? "\n" : ",\n") << "    {\"page\": " << p + 1 << ", \"total\": " << getPageTotal(p);
+        for (MemoryCategory category: PAGE_CATEGORIES) {
+            out << ", \"" << getCategoryName(category) << "\": " << getPageUsage(p, category);
+        }
+        out << "}";
+    }
+    out << "\n  ]\n}\n";
+}
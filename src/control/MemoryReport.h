@@ -0,0 +1,119 @@
+/*
+ * Xournal++
+ *
+ * Memory usage per page and per subsystem
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <array>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class Document;
+
+enum class MemoryCategory {
+    /**
+     * Stroke points
+     */
+    Strokes = 0,
+    Texts,
+    /**
+     * Encoded and decoded images
+     */
+    Images,
+    /**
+     * PDF data of LaTeX formulas
+     */
+    TexImages,
+    /**
+     * Pixbufs of image backgrounds, shared backgrounds are counted once
+     */
+    Backgrounds,
+    /**
+     * Rendered buffers of the page views
+     */
+    PageBuffers,
+    /**
+     * Rendered PDF backgrounds of the main view
+     */
+    PdfCache,
+    /**
+     * Sidebar preview buffers and their PDF cache
+     */
+    Previews,
+    /**
+     * Elements and pages which are only held by undo and redo actions
+     */
+    Undo
+};
+
+/**
+ * @brief Collects the footprints reported by MemoryAccountable objects
+ *
+ * The document is added with addDocument(), everything else (views, caches, undo) is added by the caller,
+ * see Control::createMemoryReport(). The report is a snapshot and does not track later changes.
+ */
+class MemoryReport {
+public:
+    static constexpr size_t CATEGORY_COUNT = static_cast<size_t>(MemoryCategory::Undo) + 1;
+
+public:
+    MemoryReport();
+    virtual ~MemoryReport();
+
+public:
+    /**
+     * Adds the elements and backgrounds of all pages, the document needs to be locked by the caller
+     */
+    void addDocument(Document* doc);
+
+    /**
+     * Adds memory which is not assigned to a page
+     */
+    void add(MemoryCategory category, size_t bytes);
+
+    /**
+     * Adds memory of a page, the page list grows as needed
+     */
+    void addPage(size_t page, MemoryCategory category, size_t bytes);
+
+    size_t getTotal() const;
+    size_t getTotal(MemoryCategory category) const;
+
+    size_t getPageCount() const;
+    size_t getPageTotal(size_t page) const;
+    size_t getPageUsage(size_t page, MemoryCategory category) const;
+
+    /**
+     * Writes a human readable table
+     */
+    void writeText(std::ostream& out) const;
+
+    /**
+     * Writes the report as JSON, all sizes in bytes
+     */
+    void writeJson(std::ostream& out) const;
+
+    /**
+     * @return The identifier of the category as used in the JSON and Lua reports, e.g. "strokes"
+     */
+    static const char* getCategoryName(MemoryCategory category);
+
+    /**
+     * @return The size with a binary unit, e.g. "1.5 MiB"
+     */
+    static std::string formatSize(size_t bytes);
+
+private:
+    using Usage = std::array<size_t, CATEGORY_COUNT>;
+
+    Usage totals{};
+    std::vector<Usage> pages;
+};
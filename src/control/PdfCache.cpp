@@ -4,6 +4,8 @@
 #include <cstdio>
 #include <utility>
 
+#include "Tracing.h"
+
 class PdfCacheEntry {
 public:
     /**
@@ -51,6 +53,16 @@ void PdfCache::setRefreshThreshold(double threshold) { this->zoomRefreshThreshol
 
 void PdfCache::setAnyZoomChangeCausesRecache(bool b) { this->zoomClearsCache = b; }
 
+auto PdfCache::getMemoryFootprint() const -> size_t {
+    g_mutex_lock(&this->renderMutex);
+    size_t bytes = 0;
+    for (PdfCacheEntry* e: this->data) {
+        bytes += getSurfaceSize(e->rendered);
+    }
+    g_mutex_unlock(&this->renderMutex);
+    return bytes;
+}
+
 void PdfCache::clearCache() {
     for (PdfCacheEntry* e: this->data) {
         delete e;
@@ -81,6 +93,7 @@ PdfCacheEntry* PdfCache::cache(XojPdfPageSPtr popplerPage, cairo_surface_t* img,
 }
 
 void PdfCache::render(cairo_t* cr, const XojPdfPageSPtr& popplerPage, double zoom) {
+    XOJ_TRACE_SCOPE("PdfCache::render");
     g_mutex_lock(&this->renderMutex);
 
     this->setZoom(zoom);
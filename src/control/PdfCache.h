@@ -20,13 +20,15 @@
 
 #include "pdf/base/XojPdfPage.h"
 
+#include "MemoryAccountable.h"
+
 
 class PdfCacheEntry;
 
-class PdfCache {
+class PdfCache: public MemoryAccountable {
 public:
     PdfCache(int size);
-    virtual ~PdfCache();
+    ~PdfCache() override;
 
 private:
     PdfCache(const PdfCache& cache);
@@ -52,13 +54,18 @@ public:
      */
     void setRefreshThreshold(double percentDifference);
 
+    /**
+     * The size of all cached page renderings
+     */
+    size_t getMemoryFootprint() const override;
+
 private:
     void setZoom(double zoom);
     PdfCacheEntry* lookup(const XojPdfPageSPtr& popplerPage);
     PdfCacheEntry* cache(XojPdfPageSPtr popplerPage, cairo_surface_t* img, double zoom);
 
 private:
-    GMutex renderMutex{};
+    mutable GMutex renderMutex{};
 
     std::list<PdfCacheEntry*> data;
     std::list<PdfCacheEntry*>::size_type size = 0;
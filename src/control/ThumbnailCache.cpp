@@ -0,0 +1,364 @@
+#include "ThumbnailCache.h"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <gdk-pixbuf/gdk-pixbuf.h>
+#include <glib.h>
+
+#include "model/Document.h"
+#include "model/Image.h"
+#include "model/Layer.h"
+#include "model/Stroke.h"
+#include "model/TexImage.h"
+#include "model/Text.h"
+
+/**
+ * Increase if the preview rendering changes, so old previews are not used anymore
+ */
+constexpr int THUMBNAIL_CACHE_VERSION = 1;
+
+/**
+ * Fill level of the cache after eviction, leaves some room so not every store evicts
+ */
+constexpr double THUMBNAIL_CACHE_EVICT_TARGET = 0.9;
+
+namespace {
+/**
+ * Collects everything visible on a page while the document is locked, the hash is computed by finish() after it is
+ * unlocked. Small values are copied. The payload of the elements, that is points, image and TeX data, is only
+ * referenced, as it is replaced instead of modified while it is shared, see CopyOnWrite.
+ */
+class PageHasher {
+public:
+    void addData(const void* data, size_t len) { this->values.append(static_cast<const char*>(data), len); }
+
+    template <typename T>
+    void add(T value) {
+        addData(&value, sizeof(T));
+    }
+
+    void add(const std::string& str) {
+        add(str.size());
+        addData(str.data(), str.size());
+    }
+
+    /**
+     * Adds len bytes at data, which stay valid and unchanged as long as keep is held
+     */
+    void addShared(std::shared_ptr<const void> keep, const void* data, size_t len) {
+        add(len);
+        this->parts.push_back({std::move(this->values), std::move(keep), data, len});
+        this->values.clear();
+    }
+
+    void addShared(const std::shared_ptr<const std::string>& str) {
+        if (str) {
+            addShared(str, str->data(), str->size());
+        } else {
+            add(size_t{0});
+        }
+    }
+
+    void addSurface(cairo_surface_t* surface) {
+        if (surface == nullptr || cairo_surface_get_type(surface) != CAIRO_SURFACE_TYPE_IMAGE) {
+            add(0);
+            return;
+        }
+        cairo_surface_flush(surface);
+        int height = cairo_image_surface_get_height(surface);
+        add(cairo_image_surface_get_width(surface));
+        add(height);
+        add(static_cast<int>(cairo_image_surface_get_format(surface)));
+        addShared(std::shared_ptr<cairo_surface_t>(cairo_surface_reference(surface), &cairo_surface_destroy),
+                  cairo_image_surface_get_data(surface),
+                  static_cast<size_t>(cairo_image_surface_get_stride(surface)) * static_cast<size_t>(height));
+    }
+
+    void addPixbuf(GdkPixbuf* pixbuf) {
+        add(gdk_pixbuf_get_width(pixbuf));
+        add(gdk_pixbuf_get_height(pixbuf));
+        add(gdk_pixbuf_get_rowstride(pixbuf));
+        addShared(std::shared_ptr<GdkPixbuf>(GDK_PIXBUF(g_object_ref(pixbuf)), &g_object_unref),
+                  gdk_pixbuf_read_pixels(pixbuf), gdk_pixbuf_get_byte_length(pixbuf));
+    }
+
+    void addElement(Element* e) {
+        add(static_cast<int>(e->getType()));
+        add(uint32_t(e->getColor()));
+        add(e->getX());
+        add(e->getY());
+
+        switch (e->getType()) {
+            case ELEMENT_STROKE: {
+                auto* s = dynamic_cast<Stroke*>(e);
+                add(s->getWidth());
+                add(s->getFill());
+                add(static_cast<int>(s->getToolType()));
+
+                // The count is always added, so a solid line differs from any dash pattern
+                const double* dashes = nullptr;
+                int dashCount = 0;
+                if (!s->getLineStyle().getDashes(dashes, dashCount)) {
+                    dashCount = 0;
+                }
+                add(dashCount);
+                if (dashCount > 0) {
+                    addData(dashes, sizeof(double) * static_cast<size_t>(dashCount));
+                }
+
+                auto points = s->sharePoints();
+                if (points) {
+                    addShared(points, points->data(), sizeof(Point) * points->size());
+                } else {
+                    add(size_t{0});
+                }
+                break;
+            }
+            case ELEMENT_TEXT: {
+                auto* t = dynamic_cast<Text*>(e);
+                add(t->getFontName());
+                add(t->getFontSize());
+                add(t->getText());
+                break;
+            }
+            case ELEMENT_IMAGE: {
+                auto* img = dynamic_cast<Image*>(e);
+                add(img->getElementWidth());
+                add(img->getElementHeight());
+                if (!img->getEncodedData().empty()) {
+                    addShared(img->shareEncodedData());
+                } else {
+                    addSurface(img->getImage());
+                }
+                break;
+            }
+            case ELEMENT_TEXIMAGE: {
+                auto* tex = dynamic_cast<TexImage*>(e);
+                add(tex->getElementWidth());
+                add(tex->getElementHeight());
+                addShared(tex->shareBinaryData());
+                break;
+            }
+        }
+    }
+
+    /**
+     * Computes the hash, the document does not need to be locked
+     */
+    std::string finish() {
+        GChecksum* checksum = g_checksum_new(G_CHECKSUM_SHA256);
+        for (const Part& part: this->parts) {
+            update(checksum, part.values.data(), part.values.size());
+            update(checksum, part.data, part.len);
+        }
+        update(checksum, this->values.data(), this->values.size());
+        std::string hash = g_checksum_get_string(checksum);
+        g_checksum_free(checksum);
+        return hash;
+    }
+
+private:
+    static void update(GChecksum* checksum, const void* data, size_t len) {
+        // g_checksum_update takes a gssize, split huge buffers
+        const auto* bytes = static_cast<const guchar*>(data);
+        while (len > 0) {
+            size_t chunk = std::min<size_t>(len, G_MAXINT32);
+            g_checksum_update(checksum, bytes, static_cast<gssize>(chunk));
+            bytes += chunk;
+            len -= chunk;
+        }
+    }
+
+private:
+    /**
+     * The values added before a shared buffer, and the buffer
+     */
+    struct Part {
+        std::string values;
+        std::shared_ptr<const void> keep;
+        const void* data;
+        size_t len;
+    };
+
+    std::vector<Part> parts;
+
+    /**
+     * The values added after the last shared buffer
+     */
+    std::string values;
+};
+}  // namespace
+
+ThumbnailCache::ThumbnailCache(int maxSizeMiB, fs::path folder):
+        folder(std::move(folder)), maxSize(static_cast<std::uintmax_t>(std::max(maxSizeMiB, 0)) * 1024 * 1024) {}
+
+ThumbnailCache::~ThumbnailCache() = default;
+
+auto ThumbnailCache::computeKey(Document* doc, const PageRef& page, double zoom, int width, int height)
+        -> std::string {
+    PageHasher hasher;
+    hasher.add(THUMBNAIL_CACHE_VERSION);
+    hasher.add(zoom);
+    hasher.add(width);
+    hasher.add(height);
+
+    doc->lock();
+    hasher.add(page->getWidth());
+    hasher.add(page->getHeight());
+
+    PageType bgType = page->getBackgroundType();
+    hasher.add(static_cast<int>(bgType.format));
+    hasher.add(bgType.config);
+    hasher.add(uint32_t(page->getBackgroundColor()));
+
+    fs::path pdf;
+    if (bgType.isPdfPage()) {
+        pdf = doc->getPdfFilepath();
+        hasher.add(pdf.u8string());
+        hasher.add(page->getPdfPageNr());
+    } else if (bgType.isImagePage()) {
+        GdkPixbuf* pixbuf = page->getBackgroundImage().getPixbuf();
+        if (pixbuf) {
+            hasher.addPixbuf(pixbuf);
+        }
+    }
+
+    for (Layer* l: *page->getLayers()) {
+        if (!l->isVisible()) {
+            hasher.add(false);
+            continue;
+        }
+        hasher.add(true);
+        hasher.add(l->getElements().size());
+        for (Element* e: l->getElements()) {
+            hasher.addElement(e);
+        }
+    }
+    doc->unlock();
+
+    if (!pdf.empty()) {
+        // The PDF is identified by its path, size and modification time, hashing its contents would be too slow
+        std::error_code ec;
+        hasher.add(fs::file_size(pdf, ec));
+        hasher.add(static_cast<int64_t>(fs::last_write_time(pdf, ec).time_since_epoch().count()));
+    }
+
+    return hasher.finish();
+}
+
+auto ThumbnailCache::isEnabled() const -> bool { return this->maxSize > 0; }
+
+auto ThumbnailCache::getCacheFile(const std::string& key) const -> fs::path {
+    return this->folder / (key + ".png");
+}
+
+void ThumbnailCache::initSize() {
+    if (this->sizeKnown) {
+        return;
+    }
+    this->sizeKnown = true;
+
+    std::error_code ec;
+    fs::create_directories(this->folder, ec);
+    for (const auto& entry: fs::directory_iterator(this->folder, ec)) {
+        if (entry.is_regular_file(ec)) {
+            this->currentSize += entry.file_size(ec);
+        }
+    }
+}
+
+auto ThumbnailCache::lookup(const std::string& key, int width, int height) -> cairo_surface_t* {
+    if (this->maxSize == 0) {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(this->cacheMutex);
+    initSize();
+
+    fs::path file = getCacheFile(key);
+    std::error_code ec;
+    if (!fs::exists(file, ec)) {
+        return nullptr;
+    }
+
+    cairo_surface_t* surface = cairo_image_surface_create_from_png(file.u8string().c_str());
+    if (cairo_surface_status(surface) != CAIRO_STATUS_SUCCESS || cairo_image_surface_get_width(surface) != width ||
+        cairo_image_surface_get_height(surface) != height) {
+        // Broken or stale entry
+        cairo_surface_destroy(surface);
+        return nullptr;
+    }
+
+    // Mark as recently used, for the eviction
+    fs::last_write_time(file, fs::file_time_type::clock::now(), ec);
+
+    return surface;
+}
+
+void ThumbnailCache::store(const std::string& key, cairo_surface_t* surface) {
+    if (this->maxSize == 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(this->cacheMutex);
+    initSize();
+
+    fs::path file = getCacheFile(key);
+    fs::path tmpFile = file;
+    tmpFile += ".tmp";
+
+    cairo_surface_flush(surface);
+    if (cairo_surface_write_to_png(surface, tmpFile.u8string().c_str()) != CAIRO_STATUS_SUCCESS) {
+        g_warning("Could not write thumbnail cache file %s", tmpFile.u8string().c_str());
+        return;
+    }
+
+    std::error_code ec;
+    std::uintmax_t oldSize = fs::exists(file, ec) ? fs::file_size(file, ec) : 0;
+    fs::rename(tmpFile, file, ec);
+    if (ec) {
+        fs::remove(tmpFile, ec);
+        return;
+    }
+
+    this->currentSize += fs::file_size(file, ec);
+    this->currentSize -= std::min(oldSize, this->currentSize);
+
+    if (this->currentSize > this->maxSize) {
+        evict();
+    }
+}
+
+void ThumbnailCache::evict() {
+    struct CacheEntry {
+        fs::path path;
+        fs::file_time_type lastUse;
+        std::uintmax_t size;
+    };
+
+    std::vector<CacheEntry> entries;
+    std::error_code ec;
+    this->currentSize = 0;
+    for (const auto& entry: fs::directory_iterator(this->folder, ec)) {
+        if (entry.is_regular_file(ec)) {
+            entries.push_back({entry.path(), entry.last_write_time(ec), entry.file_size(ec)});
+            this->currentSize += entries.back().size;
+        }
+    }
+
+    std::sort(entries.begin(), entries.end(),
+              [](const CacheEntry& a, const CacheEntry& b) { return a.lastUse < b.lastUse; });
+
+    auto target = static_cast<std::uintmax_t>(static_cast<double>(this->maxSize) * THUMBNAIL_CACHE_EVICT_TARGET);
+    for (const CacheEntry& e: entries) {
+        if (this->currentSize <= target) {
+            break;
+        }
+        if (fs::remove(e.path, ec)) {
+            this->currentSize -= std::min(e.size, this->currentSize);
+        }
+    }
+}
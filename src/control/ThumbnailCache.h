@@ -0,0 +1,93 @@
+/*
+ * Xournal++
+ *
+ * Persistent on-disk cache for sidebar page previews
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+#include <cairo.h>
+
+#include "model/PageRef.h"
+
+#include "filesystem.h"
+
+class Document;
+
+/**
+ * Stores rendered page previews as PNG files in the user cache folder, keyed by a hash of
+ * everything which is visible on the page. This way previews of unchanged pages do not need to be
+ * rendered again when a document is reopened, or when the same page appears in another document.
+ *
+ * The cache is size bounded, the least recently used previews are evicted first. There is one cache for all
+ * sidebars, owned by Control, so the bound is global. All methods are thread safe.
+ */
+class ThumbnailCache {
+public:
+    /**
+     * @param maxSizeMiB The maximum size of all cached previews
+     * @param folder The folder of the cached previews
+     */
+    ThumbnailCache(int maxSizeMiB, fs::path folder);
+    virtual ~ThumbnailCache();
+
+private:
+    ThumbnailCache(const ThumbnailCache& cache);
+    void operator=(const ThumbnailCache& cache);
+
+public:
+    /**
+     * Computes the cache key of a page preview. The key covers the page size, the background (including the PDF
+     * page and background images), the visible layers with all their elements and the rendering zoom.
+     *
+     * The document must not be locked. It is locked only while the page is read, the potentially large point and
+     * image data is hashed after it is unlocked.
+     */
+    static std::string computeKey(Document* doc, const PageRef& page, double zoom, int width, int height);
+
+    /**
+     * @return false if the cache size is set to 0
+     */
+    bool isEnabled() const;
+
+    /**
+     * @return A new image surface with the cached preview, or nullptr if there is no (valid) preview of this size
+     */
+    cairo_surface_t* lookup(const std::string& key, int width, int height);
+
+    /**
+     * Stores a rendered preview and evicts old previews if the cache grew too large
+     */
+    void store(const std::string& key, cairo_surface_t* surface);
+
+private:
+    fs::path getCacheFile(const std::string& key) const;
+
+    /**
+     * Creates the cache folder and scans it once to know the current size of the cache
+     */
+    void initSize();
+
+    /**
+     * Removes the least recently used entries until the cache is below its limit
+     */
+    void evict();
+
+private:
+    std::mutex cacheMutex;
+
+    fs::path folder;
+
+    std::uintmax_t maxSize = 0;
+    std::uintmax_t currentSize = 0;
+    bool sizeKnown = false;
+};
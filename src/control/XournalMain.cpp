@@ -1,13 +1,17 @@
 #include "XournalMain.h"
 
 #include <algorithm>
+#include <cerrno>
+#include <fstream>
 #include <memory>
+#include <sstream>
 
 #include <glib/gstdio.h>
 #include <gtk/gtk.h>
 #include <gui/toolbarMenubar/model/ToolbarColorNames.h>
 #include <libintl.h>
 
+#include "control/jobs/BatchExport.h"
 #include "control/jobs/ImageExport.h"
 #include "control/jobs/ProgressListener.h"
 #include "gui/GladeSearchpath.h"
@@ -17,10 +21,15 @@
 #include "pdf/base/XojPdfExportFactory.h"
 #include "undo/EmergencySaveRestore.h"
 #include "xojfile/LoadHandler.h"
+#include "xojfile/PageFileReader.h"
+#include "xojfile/PageFileWriter.h"
+#include "xojfile/SaveHandler.h"
 
 #include "Control.h"
+#include "MemoryReport.h"
 #include "Stacktrace.h"
 #include "StringUtils.h"
+#include "Tracing.h"
 #include "XojMsgBox.h"
 #include "config-dev.h"
 #include "config-paths.h"
@@ -31,6 +40,11 @@
 #if __linux__
 #include <libgen.h>
 #endif
+#ifndef _WIN32
+#include <csignal>
+
+#include <glib-unix.h>
+#endif
 namespace {
 
 constexpr auto APP_FLAGS = GApplicationFlags(G_APPLICATION_SEND_ENVIRONMENT | G_APPLICATION_NON_UNIQUE);
@@ -53,9 +67,9 @@ void checkForErrorlog();
 void checkForEmergencySave(Control* control);
 
 auto exportPdf(const char* input, const char* output, const char* range, ExportBackgroundType exportBackground,
-               bool progressiveMode) -> int;
+               bool progressiveMode, bool keepBackgroundPdf) -> int;
 auto exportImg(const char* input, const char* output, const char* range, int pngDpi, int pngWidth, int pngHeight,
-               ExportBackgroundType exportBackground) -> int;
+               ExportBackgroundType exportBackground, int jobs) -> int;
 
 void initResourcePath(GladeSearchpath* gladePath, const gchar* relativePathAndFile, bool failIfNotFound = true);
 
@@ -238,13 +252,14 @@ void checkForEmergencySave(Control* control) {
  * @param pngWidth Set the width for Png files. Non positive values are ignored
  * @param pngHeight Set the height for Png files. Non positive values are ignored
  * @param exportBackground If EXPORT_BACKGROUND_NONE, the exported image file has transparent background
+ * @param jobs Number of pages exported in parallel, 0 to use one job per processor
  *
  *  The priority is: pngDpi overwrites pngWidth overwrites pngHeight
  *
  * @return 0 on success, -2 on failure opening the input file, -3 on export failure
  */
 auto exportImg(const char* input, const char* output, const char* range, int pngDpi, int pngWidth, int pngHeight,
-               ExportBackgroundType exportBackground) -> int {
+               ExportBackgroundType exportBackground, int jobs) -> int {
     LoadHandler loader;
 
     Document* doc = loader.loadDocument(input);
@@ -270,6 +285,7 @@ auto exportImg(const char* input, const char* output, const char* range, int png
     DummyProgressListener progress;
 
     ImageExport imgExport(doc, path, format, exportBackground, exportRange);
+    imgExport.setJobCount(jobs);
 
     if (format == EXPORT_GRAPHICS_PNG) {
         if (pngDpi > 0) {
@@ -304,11 +320,13 @@ auto exportImg(const char* input, const char* output, const char* range, int png
  * @param exportBackground If EXPORT_BACKGROUND_NONE, the exported pdf file has white background
  * @param progressiveMode If true, then for each xournalpp page, instead of rendering one PDF page, the page layers are
  * rendered one by one to produce as many pages as there are layers.
+ * @param keepBackgroundPdf If true, the annotations are appended to an unchanged copy of the background PDF, if all of
+ * its pages are exported in their order
  *
  * @return 0 on success, -2 on failure opening the input file, -3 on export failure
  */
 auto exportPdf(const char* input, const char* output, const char* range, ExportBackgroundType exportBackground,
-               bool progressiveMode) -> int {
+               bool progressiveMode, bool keepBackgroundPdf) -> int {
     LoadHandler loader;
 
     Document* doc = loader.loadDocument(input);
@@ -318,7 +336,7 @@ auto exportPdf(const char* input, const char* output, const char* range, ExportB
 
     GFile* file = g_file_new_for_commandline_arg(output);
 
-    XojPdfExport* pdfe = XojPdfExportFactory::createExport(doc, nullptr);
+    XojPdfExport* pdfe = XojPdfExportFactory::createExport(doc, nullptr, keepBackgroundPdf);
     pdfe->setExportBackground(exportBackground);
     char* cpath = g_file_get_path(file);
     std::string path = cpath;
@@ -361,6 +379,11 @@ struct XournalMainPrivate {
         g_strfreev(optFilename);
         g_free(pdfFilename);
         g_free(imgFilename);
+        g_free(batchManifest);
+        g_free(batchReport);
+        g_free(traceFilename);
+        g_free(memoryReport);
+        g_free(convertFilename);
     }
 
     gchar** optFilename{};
@@ -372,9 +395,18 @@ struct XournalMainPrivate {
     int exportPngDpi = -1;
     int exportPngWidth = -1;
     int exportPngHeight = -1;
+    int exportJobs = 1;
+    gboolean batchMode = false;
+    gchar* batchManifest{};
+    gchar* batchReport{};
+    gchar* traceFilename{};
+    gchar* memoryReport{};
+    int memoryBudget = 0;
+    gchar* convertFilename{};
     gboolean exportNoBackground = false;
     gboolean exportNoRuling = false;
     gboolean progressiveMode = false;
+    gboolean exportKeepPdf = false;
     std::unique_ptr<GladeSearchpath> gladePath;
     std::unique_ptr<Control> control;
     std::unique_ptr<MainWindow> win;
@@ -585,7 +617,183 @@ void on_startup(GApplication* application, XMPtr app_data) {
     gtk_application_add_window(GTK_APPLICATION(application), GTK_WINDOW(app_data->win->getWindow()));
 }
 
+/**
+ * @brief Convert many files in one process, see BatchExport
+ *
+ * The files are taken from the manifest given with --batch-manifest and, with --batch, from the remaining
+ * command line arguments, which are read as INPUT OUTPUT pairs.
+ *
+ * @return 0 if all files were converted, -2 on invalid arguments, -3 if any conversion failed, -4 if the report
+ *         could not be written
+ */
+auto exportBatch(XMPtr app_data) -> int {
+    BatchExport batch;
+
+    if (app_data->batchManifest && !batch.readManifest(fs::u8path(app_data->batchManifest))) {
+        g_warning("%s", batch.getLastError().c_str());
+        return -2;
+    }
+    if (app_data->batchMode && app_data->optFilename) {
+        gchar** arg = app_data->optFilename;
+        for (; arg[0] && arg[1]; arg += 2) {
+            batch.addEntry(fs::u8path(arg[0]), fs::u8path(arg[1]));
+        }
+        if (arg[0]) {
+            g_warning("%s", FC(_F("Missing output file for \"{1}\"") % arg[0]));
+            return -2;
+        }
+    }
+
+    batch.setExportBackground(app_data->exportNoBackground ? EXPORT_BACKGROUND_NONE :
+                              app_data->exportNoRuling     ? EXPORT_BACKGROUND_UNRULED :
+                                                             EXPORT_BACKGROUND_ALL);
+    batch.setExportRange(app_data->exportRange);
+    batch.setProgressiveMode(app_data->progressiveMode);
+    batch.setKeepBackgroundPdf(app_data->exportKeepPdf);
+    batch.setPngSize(app_data->exportPngDpi, app_data->exportPngWidth, app_data->exportPngHeight);
+    batch.setJobCount(app_data->exportJobs);
+
+    bool success = batch.run();
+
+    std::ostringstream report;
+    batch.writeReport(report);
+    std::string reportText = report.str();
+    if (app_data->batchReport && g_strcmp0(app_data->batchReport, "-") != 0) {
+        GError* err = nullptr;
+        if (!g_file_set_contents(app_data->batchReport, reportText.c_str(), static_cast<gssize>(reportText.size()),
+                                 &err)) {
+            g_warning("%s", FC(_F("Could not write the batch report: {1}") % err->message));
+            g_error_free(err);
+            return -4;
+        }
+    } else {
+        g_print("%s", reportText.c_str());
+    }
+
+    return success ? 0 : -3;
+}
+
+/**
+ * @brief Write the memory report of a loaded document, see MemoryReport
+ *
+ * Only the document itself is accounted, there are no views, caches or undo actions without the GUI.
+ *
+ * @return 0 on success, -2 if the document could not be loaded, -3 if the total exceeds --memory-budget, -4 if the
+ *         report could not be written
+ */
+auto reportMemory(const char* input, XMPtr app_data) -> int {
+    LoadHandler loader;
+    Document* doc = loader.loadDocument(input);
+    if (doc == nullptr) {
+        g_warning("%s", loader.getLastError().c_str());
+        return -2;
+    }
+
+    MemoryReport report;
+    report.addDocument(doc);
+
+    if (strcmp(app_data->memoryReport, "-") != 0) {
+        std::ofstream out(fs::u8path(app_data->memoryReport));
+        if (!out.is_open()) {
+            g_warning("%s", FC(_F("Could not open the memory report \"{1}\": {2}") % app_data->memoryReport %
+                               g_strerror(errno)));
+            return -4;
+        }
+        report.writeJson(out);
+        out.close();
+        if (out.fail()) {
+            g_warning("%s", FC(_F("Could not write the memory report \"{1}\": {2}") % app_data->memoryReport %
+                               g_strerror(errno)));
+            return -4;
+        }
+    } else {
+        report.writeJson(std::cout);
+        if (!std::cout.flush()) {
+            g_warning("%s", FC(_F("Could not write the memory report: {1}") % g_strerror(errno)));
+            return -4;
+        }
+    }
+
+    size_t budget = static_cast<size_t>(std::max(app_data->memoryBudget, 0)) * 1024 * 1024;
+    if (budget > 0 && report.getTotal() > budget) {
+        g_warning("%s", FC(_F("Memory usage of {1} exceeds the budget of {2}") %
+                           MemoryReport::formatSize(report.getTotal()) % MemoryReport::formatSize(budget)));
+        return -3;
+    }
+    return 0;
+}
+
+/**
+ * @brief Convert a document between .xopp and the binary page file format, see PageFileFormat.h
+ *
+ * The format of each file is chosen by its extension.
+ *
+ * @return 0 on success, -2 if the input could not be loaded, -3 if the output could not be written
+ */
+auto convertDocument(const char* input, const char* output) -> int {
+    const fs::path inputPath = fs::u8path(input);
+    const fs::path outputPath = fs::u8path(output);
+
+    LoadHandler loader;
+    PageFileReader reader;
+    const bool fromPageFile = PageFileReader::isPageFile(inputPath);
+    Document* doc = fromPageFile ? reader.loadDocument(inputPath) : loader.loadDocument(inputPath);
+    if (doc == nullptr) {
+        g_warning("%s", (fromPageFile ? reader.getLastError() : loader.getLastError()).c_str());
+        return -2;
+    }
+
+    // Attachments of .xopp files are written next to the document
+    doc->setFilepath(outputPath);
+
+    std::string errorMessage;
+    if (PageFileReader::isPageFile(outputPath)) {
+        PageFileWriter writer;
+        if (!writer.save(doc, outputPath)) {
+            errorMessage = writer.getErrorMessage();
+        }
+    } else {
+        SaveHandler handler;
+        handler.prepareSave(doc);
+        handler.saveTo(outputPath);
+        errorMessage = handler.getErrorMessage();
+    }
+
+    if (!errorMessage.empty()) {
+        g_warning("%s", errorMessage.c_str());
+        return -3;
+    }
+
+    g_message("%s", _("File successfully converted"));
+    return 0;
+}
+
+#ifndef _WIN32
+auto on_dump_trace(gpointer) -> gboolean {
+    Tracing::dump();
+    return G_SOURCE_CONTINUE;
+}
+#endif
+
+/**
+ * Write the trace while running, e.g. `kill -USR1 <pid>`. Without tracing SIGUSR1 keeps its default action.
+ */
+void installTraceDumpHandler() {
+#ifndef _WIN32
+    static bool installed = false;
+    if (Tracing::isEnabled() && !installed) {
+        g_unix_signal_add(SIGUSR1, reinterpret_cast<GSourceFunc>(on_dump_trace), nullptr);
+        installed = true;
+    }
+#endif
+}
+
 auto on_handle_local_options(GApplication*, GVariantDict*, XMPtr app_data) -> gint {
+    if (app_data->traceFilename) {
+        Tracing::enable(fs::u8path(app_data->traceFilename));
+        installTraceDumpHandler();
+    }
+
     if (app_data->showVersion) {
         std::cout << PROJECT_NAME << " " << PROJECT_VERSION << std::endl;
         std::cout << "└──libgtk: " << gtk_get_major_version() << "."  //
@@ -594,19 +802,29 @@ auto on_handle_local_options(GApplication*, GVariantDict*, XMPtr app_data) -> gi
         return 0;
     }
 
+    if (app_data->batchMode || app_data->batchManifest) {
+        return exportBatch(app_data);
+    }
+    if (app_data->memoryReport && app_data->optFilename && *app_data->optFilename) {
+        return reportMemory(*app_data->optFilename, app_data);
+    }
+    if (app_data->convertFilename && app_data->optFilename && *app_data->optFilename) {
+        return convertDocument(*app_data->optFilename, app_data->convertFilename);
+    }
     if (app_data->pdfFilename && app_data->optFilename && *app_data->optFilename) {
         return exportPdf(*app_data->optFilename, app_data->pdfFilename, app_data->exportRange,
                          app_data->exportNoBackground ? EXPORT_BACKGROUND_NONE :
                          app_data->exportNoRuling     ? EXPORT_BACKGROUND_UNRULED :
                                                         EXPORT_BACKGROUND_ALL,
-                         app_data->progressiveMode);
+                         app_data->progressiveMode, app_data->exportKeepPdf);
     }
     if (app_data->imgFilename && app_data->optFilename && *app_data->optFilename) {
         return exportImg(*app_data->optFilename, app_data->imgFilename, app_data->exportRange, app_data->exportPngDpi,
                          app_data->exportPngWidth, app_data->exportPngHeight,
                          app_data->exportNoBackground ? EXPORT_BACKGROUND_NONE :
                          app_data->exportNoRuling     ? EXPORT_BACKGROUND_UNRULED :
-                                                        EXPORT_BACKGROUND_ALL);
+                                                        EXPORT_BACKGROUND_ALL,
+                         app_data->exportJobs);
     }
     return -1;
 }
@@ -623,6 +841,9 @@ void on_shutdown(GApplication*, XMPtr app_data) {
 auto XournalMain::run(int argc, char** argv) -> int {
 
     XournalMainPrivate app_data;
+    Tracing::enableFromEnvironment();
+    installTraceDumpHandler();
+
     GtkApplication* app = gtk_application_new("com.github.xournalpp.xournalpp", APP_FLAGS);
     g_signal_connect(app, "activate", G_CALLBACK(&on_activate), &app_data);
     g_signal_connect(app, "command-line", G_CALLBACK(&on_command_line), &app_data);
@@ -637,6 +858,22 @@ auto XournalMain::run(int argc, char** argv) -> int {
                                        "<input>", nullptr},
                           GOptionEntry{"version", 0, 0, G_OPTION_ARG_NONE, &app_data.showVersion,
                                        _("Get version of xournalpp"), nullptr},
+                          GOptionEntry{"trace", 0, 0, G_OPTION_ARG_FILENAME, &app_data.traceFilename,
+                                       _("Record a performance trace and write it to FILE on exit\n"
+                                         "                                 The trace can be opened in chrome://tracing"),
+                                       "FILE"},
+                          GOptionEntry{"memory-report", 0, 0, G_OPTION_ARG_FILENAME, &app_data.memoryReport,
+                                       _("Write the memory usage of the document per page and category\n"
+                                         "                                 as JSON to FILE, - is the standard output"),
+                                       "FILE"},
+                          GOptionEntry{"memory-budget", 0, 0, G_OPTION_ARG_INT, &app_data.memoryBudget,
+                                       _("Fail if the document uses more than N MiB of memory\n"
+                                         "                                 No effect without --memory-report"),
+                                       "N"},
+                          GOptionEntry{"convert", 0, 0, G_OPTION_ARG_FILENAME, &app_data.convertFilename,
+                                       _("Convert FILE between .xopp and the binary page file format .xopb\n"
+                                         "                                 The format is chosen by the extension"),
+                                       "OUTFILE"},
                           GOptionEntry{nullptr}};  // Must be terminated by a nullptr. See gtk doc
     g_application_add_main_option_entries(G_APPLICATION(app), options.data());
 
@@ -667,6 +904,12 @@ auto XournalMain::run(int argc, char** argv) -> int {
                            "                                 building up the layer stack progressively.\n"
                            "                                 The resulting PDF file can be used for a presentation.\n"),
                          0},
+            GOptionEntry{"export-keep-pdf", 0, 0, G_OPTION_ARG_NONE, &app_data.exportKeepPdf,
+                         _("Keep the background PDF unchanged in PDF exports\n"
+                           "                                 The annotations are appended to a copy of the PDF file,\n"
+                           "                                 which is faster for large PDF files. Only used if all of\n"
+                           "                                 its pages are exported in their order.\n"),
+                         0},
             GOptionEntry{"export-range", 0, 0, G_OPTION_ARG_STRING, &app_data.exportRange,
                          _("Only export the pages specified by RANGE (e.g. \"2-3,5,7-\")\n"
                            "                                 No effect without -p/--create-pdf or -i/--create-img"),
@@ -686,6 +929,25 @@ auto XournalMain::run(int argc, char** argv) -> int {
                       "                                 No effect without -i/--create-img=foo.png\n"
                       "                                 Ignored if --export-png-dpi or --export-png-width is used"),
                     "N"},
+            GOptionEntry{"export-jobs", 0, 0, G_OPTION_ARG_INT, &app_data.exportJobs,
+                         _("Number of pages (or files with --batch) exported in parallel.\n"
+                           "                                 Default is 1, 0 uses one job per processor\n"
+                           "                                 No effect without -i/--create-img or batch conversion"),
+                         "N"},
+            GOptionEntry{"batch", 0, 0, G_OPTION_ARG_NONE, &app_data.batchMode,
+                         _("Convert many files in one process\n"
+                           "                                 The arguments are read as INPUT OUTPUT pairs,\n"
+                           "                                 the output format is guessed from the extension\n"
+                           "                                 Supported formats: .pdf, .png, .svg"),
+                         0},
+            GOptionEntry{"batch-manifest", 0, 0, G_OPTION_ARG_FILENAME, &app_data.batchManifest,
+                         _("Convert the files listed in MANIFEST, one INPUT<tab>OUTPUT pair per line\n"
+                           "                                 Use - to read the list from the standard input"),
+                         "MANIFEST"},
+            GOptionEntry{"batch-report", 0, 0, G_OPTION_ARG_FILENAME, &app_data.batchReport,
+                         _("Write the JSON status and timing report of a batch conversion to FILE\n"
+                           "                                 Default is the standard output"),
+                         "FILE"},
             GOptionEntry{nullptr}};  // Must be terminated by a nullptr. See gtk doc
     GOptionGroup* exportGroup = g_option_group_new("export", _("Advanced export options"),
                                                    _("Display advanced export options"), nullptr, nullptr);
@@ -694,5 +956,6 @@ auto XournalMain::run(int argc, char** argv) -> int {
 
     auto rv = g_application_run(G_APPLICATION(app), argc, argv);
     g_object_unref(app);
+    Tracing::dump();
     return rv;
 }
@@ -41,6 +41,8 @@ void AutosaveJob::run() {
 
     g_message("%s", FS(_F("Autosaving to {1}") % filepath.string()).c_str());
 
+    // Autosaves happen often in the background, favour speed over file size
+    handler.setCompression(Z_BEST_SPEED);
     handler.saveTo(filepath);
 
     this->error = handler.getErrorMessage();
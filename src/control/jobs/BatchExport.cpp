@@ -0,0 +1,269 @@
+#include "BatchExport.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <utility>
+
+#include "control/xojfile/LoadHandler.h"
+#include "model/Document.h"
+#include "pdf/base/XojPdfExport.h"
+#include "pdf/base/XojPdfExportFactory.h"
+
+#include "ImageExport.h"
+#include "PageRange.h"
+#include "ProgressListener.h"
+#include "StringUtils.h"
+#include "Tracing.h"
+#include "i18n.h"
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+auto millisecondsSince(Clock::time_point start) -> double {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void writeJsonString(std::ostream& out, const std::string& str) {
+    out << '"';
+    for (unsigned char c: str) {
+        switch (c) {
+            case '"':
+                out << "\\\"";
+                break;
+            case '\\':
+                out << "\\\\";
+                break;
+            case '\n':
+                out << "\\n";
+                break;
+            case '\r':
+                out << "\\r";
+                break;
+            case '\t':
+                out << "\\t";
+                break;
+            default:
+                if (c < 0x20) {
+                    out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec
+                        << std::setfill(' ');
+                } else {
+                    out << c;
+                }
+        }
+    }
+    out << '"';
+}
+}  // namespace
+
+BatchExport::BatchExport() = default;
+
+BatchExport::~BatchExport() = default;
+
+auto BatchExport::readManifest(const fs::path& manifest) -> bool {
+    std::ifstream file;
+    std::istream* in = &std::cin;
+    if (manifest != "-") {
+        file.open(manifest);
+        if (!file.is_open()) {
+            this->lastError = FS(_F("Could not open manifest \"{1}\"") % manifest.u8string());
+            return false;
+        }
+        in = &file;
+    }
+
+    std::string line;
+    for (int lineNr = 1; std::getline(*in, line); lineNr++) {
+        line = StringUtils::rtrim(line);
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        size_t tab = line.find('\t');
+        if (tab == std::string::npos || tab == 0 || tab + 1 >= line.size()) {
+            this->lastError =
+                    FS(_F("Invalid line {1} in manifest \"{2}\", expected INPUT<tab>OUTPUT") % lineNr %
+                       manifest.u8string());
+            return false;
+        }
+        addEntry(fs::u8path(line.substr(0, tab)), fs::u8path(line.substr(tab + 1)));
+    }
+
+    return true;
+}
+
+void BatchExport::addEntry(fs::path input, fs::path output) {
+    Entry entry;
+    entry.input = std::move(input);
+    entry.output = std::move(output);
+    this->entries.emplace_back(std::move(entry));
+}
+
+void BatchExport::setExportBackground(ExportBackgroundType exportBackground) {
+    this->exportBackground = exportBackground;
+}
+
+void BatchExport::setExportRange(const char* range) { this->exportRange = range ? range : ""; }
+
+void BatchExport::setProgressiveMode(bool progressiveMode) { this->progressiveMode = progressiveMode; }
+
+void BatchExport::setKeepBackgroundPdf(bool keep) { this->keepBackgroundPdf = keep; }
+
+void BatchExport::setPngSize(int dpi, int width, int height) {
+    this->pngDpi = dpi;
+    this->pngWidth = width;
+    this->pngHeight = height;
+}
+
+void BatchExport::setJobCount(int jobs) {
+    this->jobCount = jobs > 0 ? jobs : static_cast<int>(std::max(1U, std::thread::hardware_concurrency()));
+}
+
+auto BatchExport::getLastError() const -> std::string { return this->lastError; }
+
+auto BatchExport::run() -> bool {
+    auto start = Clock::now();
+
+    // Every worker loads and exports one document at a time, the entries are handed out in manifest order
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        for (size_t i = next++; i < this->entries.size(); i = next++) {
+            convert(this->entries[i]);
+        }
+    };
+
+    size_t workerCount = std::min(static_cast<size_t>(std::max(this->jobCount, 1)), this->entries.size());
+    if (workerCount <= 1) {
+        worker();
+    } else {
+        std::vector<std::thread> workers;
+        workers.reserve(workerCount);
+        for (size_t i = 0; i < workerCount; i++) {
+            workers.emplace_back(worker);
+        }
+        for (std::thread& t: workers) {
+            t.join();
+        }
+    }
+
+    this->totalTime = millisecondsSince(start);
+
+    return std::all_of(this->entries.begin(), this->entries.end(),
+                       [](const Entry& e) { return e.status == "ok"; });
+}
+
+void BatchExport::convert(Entry& entry) {
+    XOJ_TRACE_SCOPE("BatchExport::convert");
+    auto start = Clock::now();
+
+    // The document is owned by the LoadHandler
+    LoadHandler loader;
+    Document* doc = loader.loadDocument(entry.input);
+    entry.loadTime = millisecondsSince(start);
+    if (doc == nullptr) {
+        entry.status = "error";
+        entry.error = loader.getLastError();
+        return;
+    }
+
+    start = Clock::now();
+    std::string ext = StringUtils::toLowerCase(entry.output.extension().u8string());
+    bool success = false;
+    if (ext == ".pdf") {
+        success = exportPdf(entry, doc);
+    } else if (ext == ".png" || ext == ".svg") {
+        success = exportImage(entry, doc);
+    } else {
+        entry.error = FS(_F("Unsupported output format \"{1}\"") % ext);
+    }
+    entry.exportTime = millisecondsSince(start);
+    entry.status = success ? "ok" : "error";
+}
+
+auto BatchExport::exportPdf(Entry& entry, Document* doc) -> bool {
+    std::unique_ptr<XojPdfExport> pdfe(XojPdfExportFactory::createExport(doc, nullptr, this->keepBackgroundPdf));
+    pdfe->setExportBackground(this->exportBackground);
+
+    bool success = false;
+    if (!this->exportRange.empty()) {
+        PageRangeVector range = PageRange::parse(this->exportRange.c_str(), int(doc->getPageCount()));
+        success = pdfe->createPdf(entry.output, range, this->progressiveMode);
+        for (PageRangeEntry* e: range) { delete e; }
+    } else {
+        success = pdfe->createPdf(entry.output, this->progressiveMode);
+    }
+
+    if (!success) {
+        entry.error = pdfe->getLastError();
+    }
+    return success;
+}
+
+auto BatchExport::exportImage(Entry& entry, Document* doc) -> bool {
+    ExportGraphicsFormat format = EXPORT_GRAPHICS_PNG;
+    if (StringUtils::toLowerCase(entry.output.extension().u8string()) == ".svg") {
+        format = EXPORT_GRAPHICS_SVG;
+    }
+
+    PageRangeVector range;
+    if (!this->exportRange.empty()) {
+        range = PageRange::parse(this->exportRange.c_str(), int(doc->getPageCount()));
+    } else {
+        range.push_back(new PageRangeEntry(0, int(doc->getPageCount() - 1)));
+    }
+
+    // Files are already converted in parallel, so each document is exported by a single thread
+    ImageExport imgExport(doc, entry.output, format, this->exportBackground, range);
+    if (format == EXPORT_GRAPHICS_PNG) {
+        if (this->pngDpi > 0) {
+            imgExport.setQualityParameter(EXPORT_QUALITY_DPI, this->pngDpi);
+        } else if (this->pngWidth > 0) {
+            imgExport.setQualityParameter(EXPORT_QUALITY_WIDTH, this->pngWidth);
+        } else if (this->pngHeight > 0) {
+            imgExport.setQualityParameter(EXPORT_QUALITY_HEIGHT, this->pngHeight);
+        }
+    }
+
+    DummyProgressListener progress;
+    imgExport.exportGraphics(&progress);
+
+    for (PageRangeEntry* e: range) { delete e; }
+
+    entry.error = imgExport.getLastErrorMsg();
+    return entry.error.empty();
+}
+
+void BatchExport::writeReport(std::ostream& out) const {
+    size_t failed = std::count_if(this->entries.begin(), this->entries.end(),
+                                  [](const Entry& e) { return e.status != "ok"; });
+
+    out << std::fixed << std::setprecision(3);
+    out << "{\n";
+    out << "  \"jobs\": " << this->jobCount << ",\n";
+    out << "  \"total\": " << this->entries.size() << ",\n";
+    out << "  \"failed\": " << failed << ",\n";
+    out << "  \"total_ms\": " << this->totalTime << ",\n";
+    out << "  \"files\": [";
+    for (size_t i = 0; i < this->entries.size(); i++) {
+        const Entry& e = this->entries[i];
+        out << (i == 0 ? "\n" : ",\n") << "    {\"input\": ";
+        writeJsonString(out, e.input.u8string());
+        out << ", \"output\": ";
+        writeJsonString(out, e.output.u8string());
+        out << ", \"status\": ";
+        writeJsonString(out, e.status);
+        out << ", \"load_ms\": " << e.loadTime << ", \"export_ms\": " << e.exportTime;
+        if (!e.error.empty()) {
+            out << ", \"error\": ";
+            writeJsonString(out, e.error);
+        }
+        out << "}";
+    }
+    out << "\n  ]\n}\n";
+}
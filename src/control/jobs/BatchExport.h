@@ -0,0 +1,122 @@
+/*
+ * Xournal++
+ *
+ * Headless conversion of many documents in one process
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "BaseExportJob.h"
+#include "filesystem.h"
+
+class Document;
+
+/**
+ * @brief Converts a list of input files to PDF or image files, using several worker threads
+ *
+ * The output format of each entry is guessed from the extension of its output file (.pdf, .png or .svg).
+ * All entries share the export options, the result of every entry is collected in a report.
+ */
+class BatchExport {
+public:
+    struct Entry {
+        fs::path input;
+        fs::path output;
+
+        /**
+         * "ok" or "error"
+         */
+        std::string status;
+        std::string error;
+
+        /**
+         * Time spent loading / exporting the document, in milliseconds
+         */
+        double loadTime = 0;
+        double exportTime = 0;
+    };
+
+public:
+    BatchExport();
+    virtual ~BatchExport();
+
+public:
+    /**
+     * @brief Add the entries listed in a manifest file
+     *
+     * Each non-empty line which does not start with '#' contains an input and an output path,
+     * separated by a tab character. "-" reads the manifest from the standard input.
+     *
+     * @return false if the manifest could not be read or contains an invalid line
+     */
+    bool readManifest(const fs::path& manifest);
+
+    /**
+     * Add a single conversion
+     */
+    void addEntry(fs::path input, fs::path output);
+
+    void setExportBackground(ExportBackgroundType exportBackground);
+    void setExportRange(const char* range);
+    void setProgressiveMode(bool progressiveMode);
+
+    /**
+     * Keep the background PDF of PDF exports unchanged, see XojPdfExportFactory::createExport()
+     */
+    void setKeepBackgroundPdf(bool keep);
+    void setPngSize(int dpi, int width, int height);
+
+    /**
+     * @brief Set the number of files converted in parallel
+     * @param jobs The number of worker threads, 0 to use one per processor
+     */
+    void setJobCount(int jobs);
+
+    /**
+     * Convert all entries
+     *
+     * @return true if all entries were converted successfully
+     */
+    bool run();
+
+    /**
+     * Write the per file status and timing as JSON
+     */
+    void writeReport(std::ostream& out) const;
+
+    std::string getLastError() const;
+
+private:
+    void convert(Entry& entry);
+    bool exportPdf(Entry& entry, Document* doc);
+    bool exportImage(Entry& entry, Document* doc);
+
+private:
+    std::vector<Entry> entries;
+
+    ExportBackgroundType exportBackground = EXPORT_BACKGROUND_ALL;
+    std::string exportRange;
+    bool progressiveMode = false;
+    bool keepBackgroundPdf = false;
+    int pngDpi = -1;
+    int pngWidth = -1;
+    int pngHeight = -1;
+
+    int jobCount = 1;
+
+    /**
+     * Wall clock time of the whole run, in milliseconds
+     */
+    double totalTime = 0;
+
+    std::string lastError;
+};
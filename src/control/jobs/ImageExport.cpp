@@ -1,6 +1,10 @@
 #include "ImageExport.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <condition_variable>
+#include <thread>
 #include <utility>
 
 #include <cairo-svg.h>
@@ -36,11 +40,27 @@ void ImageExport::setQualityParameter(ExportQualityCriterion criterion, int valu
     this->qualityParameter = RasterImageQualityParameter(criterion, value);
 }
 
+/**
+ * @brief Set the number of pages which are rendered and encoded in parallel
+ * @param jobs The number of worker threads, 0 to use one per processor
+ */
+void ImageExport::setJobCount(int jobs) {
+    this->jobCount = jobs > 0 ? jobs : static_cast<int>(std::max(1U, std::thread::hardware_concurrency()));
+}
+
 /**
  * @brief Get the last error message
  * @return The last error message to show to the user
  */
-auto ImageExport::getLastErrorMsg() const -> string { return lastError; }
+auto ImageExport::getLastErrorMsg() const -> string {
+    std::lock_guard<std::mutex> lock(this->errorMutex);
+    return lastError;
+}
+
+void ImageExport::setLastError(const std::string& error) {
+    std::lock_guard<std::mutex> lock(this->errorMutex);
+    this->lastError = error;
+}
 
 /**
  * @brief Create Cairo surface for a given page
@@ -54,32 +74,33 @@ auto ImageExport::getLastErrorMsg() const -> string { return lastError; }
  * height (in pixels). In this case, the zoomRatio (and the DPI) is page-dependent as soon as the document has pages of
  * different sizes.
  */
-auto ImageExport::createSurface(double width, double height, int id, double zoomRatio) -> double {
+auto ImageExport::createSurface(double width, double height, int id, double zoomRatio, cairo_surface_t*& surface,
+                                cairo_t*& cr) -> double {
     switch (this->format) {
         case EXPORT_GRAPHICS_PNG:
             switch (this->qualityParameter.getQualityCriterion()) {
                 case EXPORT_QUALITY_WIDTH:
                     zoomRatio = ((double)this->qualityParameter.getValue()) / width;
-                    this->surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, this->qualityParameter.getValue(),
-                                                               (int)std::round(height * zoomRatio));
+                    surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, this->qualityParameter.getValue(),
+                                                         (int)std::round(height * zoomRatio));
                     break;
                 case EXPORT_QUALITY_HEIGHT:
                     zoomRatio = ((double)this->qualityParameter.getValue()) / height;
-                    this->surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, (int)std::round(width * zoomRatio),
-                                                               this->qualityParameter.getValue());
+                    surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, (int)std::round(width * zoomRatio),
+                                                         this->qualityParameter.getValue());
                     break;
                 case EXPORT_QUALITY_DPI:  // Use the zoomRatio given as argument
-                    this->surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, (int)std::round(width * zoomRatio),
-                                                               (int)std::round(height * zoomRatio));
+                    surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, (int)std::round(width * zoomRatio),
+                                                         (int)std::round(height * zoomRatio));
                     break;
             }
-            this->cr = cairo_create(this->surface);
-            cairo_scale(this->cr, zoomRatio, zoomRatio);
+            cr = cairo_create(surface);
+            cairo_scale(cr, zoomRatio, zoomRatio);
             return zoomRatio;
         case EXPORT_GRAPHICS_SVG:
-            this->surface = cairo_svg_surface_create(getFilenameWithNumber(id).u8string().c_str(), width, height);
-            cairo_svg_surface_restrict_to_version(this->surface, CAIRO_SVG_VERSION_1_2);
-            this->cr = cairo_create(this->surface);
+            surface = cairo_svg_surface_create(getFilenameWithNumber(id).u8string().c_str(), width, height);
+            cairo_svg_surface_restrict_to_version(surface, CAIRO_SVG_VERSION_1_2);
+            cr = cairo_create(surface);
             break;
         default:
             g_error("Unsupported graphics format: %i", this->format);
@@ -90,8 +111,8 @@ auto ImageExport::createSurface(double width, double height, int id, double zoom
 /**
  * Free / store the surface
  */
-auto ImageExport::freeSurface(int id) -> bool {
-    cairo_destroy(this->cr);
+auto ImageExport::freeSurface(int id, cairo_surface_t* surface, cairo_t* cr) -> bool {
+    cairo_destroy(cr);
 
     cairo_status_t status = CAIRO_STATUS_SUCCESS;
     if (format == EXPORT_GRAPHICS_PNG) {
@@ -132,33 +153,34 @@ auto ImageExport::getFilenameWithNumber(int no) const -> fs::path {
  * @param format The format of the exported image
  * @param view A DocumentView for drawing the page
  */
-void ImageExport::exportImagePage(int pageId, int id, double zoomRatio, ExportGraphicsFormat format,
+void ImageExport::exportImagePage(const PageRef& page, int id, double zoomRatio, ExportGraphicsFormat format,
                                   DocumentView& view) {
-    doc->lock();
-    PageRef page = doc->getPage(pageId);
-    doc->unlock();
+    cairo_surface_t* surface = nullptr;
+    cairo_t* cr = nullptr;
+    zoomRatio = createSurface(page->getWidth(), page->getHeight(), id, zoomRatio, surface, cr);
 
-    zoomRatio = createSurface(page->getWidth(), page->getHeight(), id, zoomRatio);
-
-    cairo_status_t state = cairo_surface_status(this->surface);
+    cairo_status_t state = cairo_surface_status(surface);
     if (state != CAIRO_STATUS_SUCCESS) {
-        this->lastError = _("Error save image #1");
+        setLastError(_("Error save image #1"));
+        cairo_destroy(cr);
+        cairo_surface_destroy(surface);
         return;
     }
 
     if (page->getBackgroundType().isPdfPage() && (exportBackground >= EXPORT_BACKGROUND_UNRULED)) {
+        std::lock_guard<std::mutex> lock(this->pdfMutex);
         auto pgNo = page->getPdfPageNr();
         XojPdfPageSPtr popplerPage = doc->getPdfPage(pgNo);
 
         PdfView::drawPage(nullptr, popplerPage, cr, zoomRatio, page->getWidth(), page->getHeight());
     }
 
-    view.drawPage(page, this->cr, true, exportBackground == EXPORT_BACKGROUND_NONE,
+    view.drawPage(page, cr, true, exportBackground == EXPORT_BACKGROUND_NONE,
                   exportBackground == EXPORT_BACKGROUND_NONE, exportBackground <= EXPORT_BACKGROUND_UNRULED);
 
-    if (!freeSurface(id)) {
+    if (!freeSurface(id, surface, cr)) {
         // could not create this file...
-        this->lastError = _("Error save image #2");
+        setLastError(_("Error save image #2"));
         return;
     }
 }
@@ -197,21 +219,84 @@ void ImageExport::exportGraphics(ProgressListener* stateListener) {
         zoomRatio = ((double)this->qualityParameter.getValue()) / Util::DPI_NORMALIZATION_FACTOR;
     }
 
-    DocumentView view;
-    int current = 0;
-
+    /*
+     * Every exported page with the number in its file name, in export order. The pages are pinned, so the unload
+     * timer does not free their layers while they are drawn without the document lock. Unloaded layers are read
+     * back by the worker which draws them, Layer::ensureLoaded() is thread safe.
+     */
+    std::vector<std::pair<PageRef, int>> pages;
+    doc->lock();
     for (int i = 0; i < count; i++) {
-        int id = i + 1;
-        if (onePage) {
-            id = -1;
+        if (selectedPages[i]) {
+            PageRef page = doc->getPage(i);
+            page->pinContents();
+            pages.emplace_back(std::move(page), onePage ? -1 : i + 1);
         }
+    }
+    doc->unlock();
 
-        if (selectedPages[i]) {
+    exportPages(pages, zoomRatio, stateListener);
+
+    for (auto& [page, id]: pages) {
+        page->unpinContents();
+    }
+}
+
+void ImageExport::exportPages(const std::vector<std::pair<PageRef, int>>& pages, double zoomRatio,
+                              ProgressListener* stateListener) {
+    size_t workerCount = std::min(static_cast<size_t>(std::max(this->jobCount, 1)), pages.size());
+    if (workerCount <= 1) {
+        DocumentView view;
+        int current = 0;
+        for (const auto& [page, id]: pages) {
             stateListener->setCurrentState(current++);
+            exportImagePage(page, id, zoomRatio, format, view);
+        }
+        return;
+    }
 
-            exportImagePage(i, id, zoomRatio, format, view);
+    /*
+     * Every worker renders and encodes one page at a time, so at most workerCount surfaces exist at once.
+     * Each page is written to its own file, the output does not depend on the order the pages are finished in.
+     */
+    std::atomic<size_t> nextPage{0};
+    std::mutex progressMutex;
+    std::condition_variable progressChanged;
+    size_t finished = 0;
+
+    auto worker = [&]() {
+        DocumentView view;
+        for (size_t i = nextPage++; i < pages.size(); i = nextPage++) {
+            exportImagePage(pages[i].first, pages[i].second, zoomRatio, format, view);
+
+            std::lock_guard<std::mutex> lock(progressMutex);
+            finished++;
+            progressChanged.notify_one();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(workerCount);
+    for (size_t i = 0; i < workerCount; i++) {
+        workers.emplace_back(worker);
+    }
+
+    // Report the progress from the calling thread only, like the sequential export
+    for (size_t reported = 0; reported < pages.size();) {
+        size_t done = 0;
+        {
+            std::unique_lock<std::mutex> lock(progressMutex);
+            progressChanged.wait(lock, [&]() { return finished > reported; });
+            done = finished;
+        }
+        for (; reported < done; reported++) {
+            stateListener->setCurrentState(static_cast<int>(reported));
         }
     }
+
+    for (std::thread& t: workers) {
+        t.join();
+    }
 }
 
 RasterImageQualityParameter::RasterImageQualityParameter() = default;
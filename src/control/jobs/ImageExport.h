@@ -11,11 +11,14 @@
 
 #pragma once
 
+#include <mutex>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <gtk/gtk.h>
 
+#include "model/PageRef.h"
 #include "view/DocumentView.h"
 
 #include "BaseExportJob.h"
@@ -97,6 +100,15 @@ public:
      */
     void setQualityParameter(ExportQualityCriterion criterion, int value);
 
+    /**
+     * @brief Set the number of pages which are exported in parallel
+     * @param jobs The number of worker threads, 0 to use one per processor
+     *
+     * The pages are drawn and encoded in parallel, only PDF backgrounds are rendered one at a time.
+     * Each worker holds one page surface at a time, so this also bounds the memory used by the export.
+     */
+    void setJobCount(int jobs);
+
 private:
     /**
      * @brief Create Cairo surface for a given page
@@ -104,17 +116,25 @@ private:
      * @param height the height of the page being exported
      * @param id the id of the page being exported
      * @param zoomRatio the zoom ratio for PNG exports with fixed DPI
+     * @param surface Returns the created surface
+     * @param cr Returns the cairo context of the surface
      *
      * @return the zoom ratio of the current page if the export type is PNG, 0.0 otherwise
      *          The return value may differ from that of the parameter zoomRatio
      *          if the export has fixed page width or height (in pixels)
      */
-    double createSurface(double width, double height, int id, double zoomRatio);
+    double createSurface(double width, double height, int id, double zoomRatio, cairo_surface_t*& surface,
+                         cairo_t*& cr);
 
     /**
      * Free / store the surface
      */
-    bool freeSurface(int id);
+    bool freeSurface(int id, cairo_surface_t* surface, cairo_t* cr);
+
+    /**
+     * Remember an error message, may be called from the worker threads
+     */
+    void setLastError(const std::string& error);
 
     /**
      * @brief Get a filename with a (page) number appended
@@ -126,14 +146,24 @@ private:
     fs::path getFilenameWithNumber(int no) const;
 
     /**
-     * @brief Export a single PNG/SVG page
-     * @param pageId The index of the page being exported
+     * @brief Export a single PNG/SVG page, without the document lock
+     * @param page The page being exported, pinned against unloading
      * @param id The number of the page being exported
      * @param zoomRatio The zoom ratio for PNG exports with fixed DPI
      * @param format The format of the exported image
      * @param view A DocumentView for drawing the page
      */
-    void exportImagePage(int pageId, int id, double zoomRatio, ExportGraphicsFormat format, DocumentView& view);
+    void exportImagePage(const PageRef& page, int id, double zoomRatio, ExportGraphicsFormat format,
+                         DocumentView& view);
+
+    /**
+     * @brief Export the pages, in parallel if more than one job is set
+     * @param pages The pinned pages with the number in their file name
+     * @param zoomRatio The zoom ratio for PNG exports with fixed DPI
+     * @param stateListener A listener to track the progress
+     */
+    void exportPages(const std::vector<std::pair<PageRef, int>>& pages, double zoomRatio,
+                     ProgressListener* stateListener);
 
 public:
     /**
@@ -167,17 +197,22 @@ public:
     RasterImageQualityParameter qualityParameter = RasterImageQualityParameter();
 
     /**
-     * Export surface
+     * Number of pages exported in parallel, 1 exports sequentially in the calling thread
      */
-    cairo_surface_t* surface = nullptr;
+    int jobCount = 1;
 
     /**
-     * Cairo context
+     * The last error message to show to the user
      */
-    cairo_t* cr = nullptr;
+    std::string lastError;
 
     /**
-     * The last error message to show to the user
+     * Protects lastError
      */
-    std::string lastError;
+    mutable std::mutex errorMutex;
+
+    /**
+     * Serializes the rendering of PDF backgrounds, the Poppler document is not guaranteed to be thread safe
+     */
+    std::mutex pdfMutex;
 };
@@ -1,6 +1,7 @@
 #include "PreviewJob.h"
 
 #include "control/Control.h"
+#include "control/ThumbnailCache.h"
 #include "gui/Shadow.h"
 #include "gui/sidebar/previews/base/SidebarPreviewBase.h"
 #include "gui/sidebar/previews/base/SidebarPreviewBaseEntry.h"
@@ -9,6 +10,8 @@
 #include "view/DocumentView.h"
 #include "view/PdfView.h"
 
+#include "Tracing.h"
+
 PreviewJob::PreviewJob(SidebarPreviewBaseEntry* sidebar): sidebarPreview(sidebar) {}
 
 PreviewJob::~PreviewJob() { this->sidebarPreview = nullptr; }
@@ -20,9 +23,9 @@ auto PreviewJob::getSource() -> void* { return this->sidebarPreview; }
 auto PreviewJob::getType() -> JobType { return JOB_TYPE_PREVIEW; }
 
 void PreviewJob::initGraphics() {
-    GtkAllocation alloc;
-    gtk_widget_get_allocation(this->sidebarPreview->widget, &alloc);
-    crBuffer = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, alloc.width, alloc.height);
+    // Don't use the widget allocation here, the entry may be unrealized while the job is queued
+    crBuffer = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, this->sidebarPreview->getWidgetWidth(),
+                                          this->sidebarPreview->getWidgetHeight());
     zoom = this->sidebarPreview->sidebar->getZoom();
     cr2 = cairo_create(crBuffer);
 }
@@ -39,16 +42,19 @@ void PreviewJob::finishPaint() {
         cairo_surface_destroy(this->sidebarPreview->crBuffer);
     }
     this->sidebarPreview->crBuffer = crBuffer;
+    this->sidebarPreview->previewRendered = true;
 
     // The preview widget can be referenced after this is deleted.
     // Only it should be referenced in the callback.
     GtkWidget* previewWidget = this->sidebarPreview->widget;
-    g_object_ref(previewWidget);
+    if (previewWidget) {
+        g_object_ref(previewWidget);
 
-    Util::execInUiThread([previewWidget]() {
-        gtk_widget_queue_draw(previewWidget);
-        g_object_unref(previewWidget);
-    });
+        Util::execInUiThread([previewWidget]() {
+            gtk_widget_queue_draw(previewWidget);
+            g_object_unref(previewWidget);
+        });
+    }
 
     g_mutex_unlock(&this->sidebarPreview->drawingMutex);
 }
@@ -141,14 +147,46 @@ void PreviewJob::clipToPage() {
     cairo_clip(cr2);
 }
 
+auto PreviewJob::renderPreview(ThumbnailCache* thumbnails, Document* doc, const PageRef& page, double zoom,
+                               int width, int height, bool rendered, const std::function<cairo_surface_t*()>& render)
+        -> cairo_surface_t* {
+    if (thumbnails == nullptr || !thumbnails->isEnabled() || rendered) {
+        return render();
+    }
+
+    std::string key = ThumbnailCache::computeKey(doc, page, zoom, width, height);
+    if (cairo_surface_t* cached = thumbnails->lookup(key, width, height)) {
+        return cached;
+    }
+
+    cairo_surface_t* surface = render();
+    thumbnails->store(key, surface);
+    return surface;
+}
+
 void PreviewJob::run() {
+    XOJ_TRACE_SCOPE("PreviewJob::run");
     if (this->sidebarPreview == nullptr) {
         return;
     }
 
-    initGraphics();
-    drawBorder();
-    clipToPage();
-    drawPage();
+    g_mutex_lock(&this->sidebarPreview->drawingMutex);
+    bool rendered = this->sidebarPreview->previewRendered;
+    g_mutex_unlock(&this->sidebarPreview->drawingMutex);
+
+    Control* control = this->sidebarPreview->sidebar->getControl();
+    ThumbnailCache* thumbnails =
+            this->sidebarPreview->getRenderType() == RENDER_TYPE_PAGE_PREVIEW ? control->getThumbnailCache() : nullptr;
+
+    this->crBuffer = renderPreview(thumbnails, control->getDocument(), this->sidebarPreview->page,
+                                   this->sidebarPreview->sidebar->getZoom(), this->sidebarPreview->getWidgetWidth(),
+                                   this->sidebarPreview->getWidgetHeight(), rendered, [this]() {
+                                       initGraphics();
+                                       drawBorder();
+                                       clipToPage();
+                                       drawPage();
+                                       return this->crBuffer;
+                                   });
+
     finishPaint();
 }
@@ -11,16 +11,20 @@
 
 #pragma once
 
+#include <functional>
 #include <string>
 #include <vector>
 
 #include <gtk/gtk.h>
 
+#include "model/PageRef.h"
+
 #include "Job.h"
 
 
 class SidebarPreviewBaseEntry;
 class Document;
+class ThumbnailCache;
 
 /**
  * @brief A Job which renders a SidebarPreviewPage
@@ -40,6 +44,19 @@ public:
 
     virtual JobType getType();
 
+    /**
+     * Takes a page preview from the thumbnail cache, or renders it and stores it there. The cache is only used for
+     * the first preview of an entry, repaints after an edit would only fill it up.
+     *
+     * @param thumbnails The cache, nullptr to always render
+     * @param rendered true if the entry already shows a preview of an earlier job
+     * @param render Renders the preview and returns it
+     * @return The preview, owned by the caller
+     */
+    static cairo_surface_t* renderPreview(ThumbnailCache* thumbnails, Document* doc, const PageRef& page, double zoom,
+                                          int width, int height, bool rendered,
+                                          const std::function<cairo_surface_t*()>& render);
+
 private:
     void initGraphics();
     void clipToPage();
@@ -11,6 +11,7 @@
 #include "view/PdfView.h"
 
 #include "Rectangle.h"
+#include "Tracing.h"
 #include "Util.h"
 
 RenderJob::RenderJob(XojPageView* view): view(view) {}
@@ -71,6 +72,7 @@ void RenderJob::rerenderRectangle(Rectangle<double> const& rect) {
 }
 
 void RenderJob::run() {
+    XOJ_TRACE_SCOPE("RenderJob::run");
     double zoom = this->view->xournal->getZoom();
 
     g_mutex_lock(&this->view->repaintRectMutex);
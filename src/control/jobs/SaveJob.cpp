@@ -3,6 +3,8 @@
 #include <config.h>
 
 #include "control/Control.h"
+#include "control/xojfile/PageFileReader.h"
+#include "control/xojfile/PageFileWriter.h"
 #include "control/xojfile/SaveHandler.h"
 #include "view/DocumentView.h"
 
@@ -83,6 +85,11 @@ void SaveJob::updatePreview(Control* control) {
 auto SaveJob::save() -> bool {
     updatePreview(control);
     Document* doc = this->control->getDocument();
+
+    if (PageFileReader::isPageFile(doc->getFilepath())) {
+        return savePageFile();
+    }
+
     SaveHandler h;
 
     doc->lock();
@@ -119,3 +126,34 @@ auto SaveJob::save() -> bool {
     }
     return true;
 }
+
+auto SaveJob::savePageFile() -> bool {
+    Document* doc = this->control->getDocument();
+    PageFileWriter writer;
+
+    doc->lock();
+    fs::path filepath = doc->getFilepath();
+
+    if (doc->shouldCreateBackupOnSave() && fs::is_regular_file(filepath)) {
+        // Copied instead of renamed, the unloaded layers are still read from the file
+        std::error_code ec;
+        fs::copy_file(filepath, fs::path{filepath} += "~", fs::copy_options::overwrite_existing, ec);
+        if (ec) {
+            doc->unlock();
+            g_warning("Could not create backup! Failed with %s", ec.message().c_str());
+            return false;
+        }
+        doc->setCreateBackupOnSave(false);
+    }
+
+    bool success = writer.save(doc, filepath, this->control);
+    doc->unlock();
+
+    if (!success) {
+        this->lastError = FS(_F("Save file error: {1}") % writer.getErrorMessage());
+        if (!control->getWindow()) {
+            g_error("%s", this->lastError.c_str());
+        }
+    }
+    return success;
+}
@@ -34,6 +34,12 @@ public:
 protected:
     virtual void afterRun();
 
+private:
+    /**
+     * Saves a document which was opened from a binary page file in the same format
+     */
+    bool savePageFile();
+
 private:
     std::string lastError;
 };
@@ -5,6 +5,8 @@
 
 #include <config-debug.h>
 
+#include "Tracing.h"
+
 #ifdef DEBUG_SHEDULER
 #define SDEBUG g_message
 #else
@@ -242,6 +244,7 @@ auto Scheduler::jobThreadCallback(Scheduler* scheduler) -> gpointer {
         {
             std::lock_guard lock{scheduler->jobRunningMutex};
             SDEBUG("do job: %" PRId64, (uint64_t)job);
+            XOJ_TRACE_SCOPE("Scheduler::execute");
             job->execute();
             job->unref();
         }
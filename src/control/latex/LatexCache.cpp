@@ -0,0 +1,81 @@
+#include "LatexCache.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include <glib.h>
+
+#include "PathUtil.h"
+
+LatexCache::LatexCache(fs::path folder): folder(std::move(folder)) {}
+
+auto LatexCache::computeKey(const std::string& command, const std::string& texContents) -> std::string {
+    GChecksum* checksum = g_checksum_new(G_CHECKSUM_SHA256);
+    g_checksum_update(checksum, reinterpret_cast<const guchar*>(command.data()), command.size());
+    // Separate the parts, so moving text from one to the other changes the key
+    g_checksum_update(checksum, reinterpret_cast<const guchar*>(""), 1);
+    g_checksum_update(checksum, reinterpret_cast<const guchar*>(texContents.data()), texContents.size());
+    std::string key = g_checksum_get_string(checksum);
+    g_checksum_free(checksum);
+    return key;
+}
+
+auto LatexCache::getPath(const std::string& key) const -> fs::path { return this->folder / (key + ".pdf"); }
+
+auto LatexCache::load(const std::string& key) const -> std::optional<std::string> {
+    fs::path path = getPath(key);
+    std::error_code ec;
+    if (!fs::is_regular_file(path, ec)) {
+        return std::nullopt;
+    }
+
+    auto pdf = Util::readString(path, false);
+    if (pdf) {
+        // The modification time orders the entries for prune()
+        fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+    }
+    return pdf;
+}
+
+auto LatexCache::store(const std::string& key, const std::string& pdf) const -> bool {
+    GError* err = nullptr;
+    // Written to a temporary file and renamed, another instance never reads a partial entry
+    if (!g_file_set_contents(getPath(key).u8string().c_str(), pdf.data(), static_cast<gssize>(pdf.size()), &err)) {
+        g_warning("Could not store the LaTeX render in the cache: %s", err->message);
+        g_error_free(err);
+        return false;
+    }
+    return true;
+}
+
+void LatexCache::prune(uintmax_t maxSize) const {
+    struct Entry {
+        fs::file_time_type time;
+        uintmax_t size;
+        fs::path path;
+    };
+    std::vector<Entry> entries;
+
+    std::error_code ec;
+    for (auto const& file: fs::directory_iterator(this->folder, ec)) {
+        if (file.path().extension() != ".pdf") {
+            continue;
+        }
+        uintmax_t size = fs::file_size(file.path(), ec);
+        if (ec) {
+            continue;
+        }
+        entries.push_back({fs::last_write_time(file.path(), ec), size, file.path()});
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.time > b.time; });
+
+    uintmax_t total = 0;
+    for (auto const& entry: entries) {
+        total += entry.size;
+        if (total > maxSize) {
+            fs::remove(entry.path, ec);
+        }
+    }
+}
@@ -0,0 +1,56 @@
+/*
+ * Xournal++
+ *
+ * Cache of rendered LaTeX formulas
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "filesystem.h"
+
+/**
+ * @brief The rendered PDFs of LaTeX formulas, addressed by a hash of everything which affects the output
+ *
+ * The key covers the generator command and the complete .tex file, that is the template, the formula and the
+ * text color. The cache is kept in the user cache folder, so a formula is only compiled once for all documents
+ * and sessions. The least recently used entries are deleted by prune().
+ */
+class LatexCache {
+public:
+    explicit LatexCache(fs::path folder);
+
+public:
+    static std::string computeKey(const std::string& command, const std::string& texContents);
+
+    /**
+     * @return The PDF rendered for the key, if it is cached
+     */
+    std::optional<std::string> load(const std::string& key) const;
+
+    /**
+     * @return false if the PDF could not be written
+     */
+    bool store(const std::string& key, const std::string& pdf) const;
+
+    /**
+     * Deletes the least recently used entries until the cache uses at most maxSize bytes
+     */
+    void prune(uintmax_t maxSize) const;
+
+    static constexpr uintmax_t DEFAULT_MAX_SIZE = 32 * 1024 * 1024;
+
+private:
+    fs::path getPath(const std::string& key) const;
+
+private:
+    fs::path folder;
+};
@@ -147,6 +147,10 @@ void Settings::loadDefault() {
 
     this->pageRerenderThreshold = 5.0;
     this->pdfPageCacheSize = 10;
+    this->followAudioPlayback = true;
+    this->unloadPages = false;
+    this->unloadPagesDistance = 20;
+    this->thumbnailCacheSize = 100;
     this->preloadPagesBefore = 3U;
     this->preloadPagesAfter = 5U;
     this->eagerPageCleanup = true;
@@ -430,6 +434,14 @@ void Settings::parseItem(xmlDocPtr doc, xmlNodePtr cur) {
         this->pageRerenderThreshold = g_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("pdfPageCacheSize")) == 0) {
         this->pdfPageCacheSize = g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10);
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("followAudioPlayback")) == 0) {
+        this->followAudioPlayback = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("unloadPages")) == 0) {
+        this->unloadPages = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("unloadPagesDistance")) == 0) {
+        this->unloadPagesDistance = g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10);
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("thumbnailCacheSize")) == 0) {
+        this->thumbnailCacheSize = g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10);
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("preloadPagesBefore")) == 0) {
         this->preloadPagesBefore = g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10);
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("preloadPagesAfter")) == 0) {
@@ -906,6 +918,14 @@ void Settings::save() {
 
     SAVE_INT_PROP(pdfPageCacheSize);
     ATTACH_COMMENT("The count of rendered PDF pages which will be cached.");
+    SAVE_BOOL_PROP(followAudioPlayback);
+    ATTACH_COMMENT("Scroll to and highlight the strokes written at the current audio playback position.");
+    SAVE_BOOL_PROP(unloadPages);
+    ATTACH_COMMENT("Write the contents of pages far from the view to a temporary file and free their memory.");
+    SAVE_INT_PROP(unloadPagesDistance);
+    ATTACH_COMMENT("Pages farther than this from the current page may be unloaded.");
+    SAVE_INT_PROP(thumbnailCacheSize);
+    ATTACH_COMMENT("Maximum size of the persistent sidebar thumbnail cache in MiB, 0 disables it.");
     SAVE_UINT_PROP(preloadPagesBefore);
     SAVE_UINT_PROP(preloadPagesAfter);
     SAVE_BOOL_PROP(eagerPageCleanup);
@@ -1739,6 +1759,46 @@ void Settings::setPdfPageCacheSize(int size) {
     save();
 }
 
+auto Settings::isFollowAudioPlayback() const -> bool { return this->followAudioPlayback; }
+
+void Settings::setFollowAudioPlayback(bool followAudioPlayback) {
+    if (this->followAudioPlayback == followAudioPlayback) {
+        return;
+    }
+    this->followAudioPlayback = followAudioPlayback;
+    save();
+}
+
+auto Settings::isUnloadPages() const -> bool { return this->unloadPages; }
+
+void Settings::setUnloadPages(bool unloadPages) {
+    if (this->unloadPages == unloadPages) {
+        return;
+    }
+    this->unloadPages = unloadPages;
+    save();
+}
+
+auto Settings::getUnloadPagesDistance() const -> int { return this->unloadPagesDistance; }
+
+void Settings::setUnloadPagesDistance(int unloadPagesDistance) {
+    if (this->unloadPagesDistance == unloadPagesDistance) {
+        return;
+    }
+    this->unloadPagesDistance = unloadPagesDistance;
+    save();
+}
+
+auto Settings::getThumbnailCacheSize() const -> int { return this->thumbnailCacheSize; }
+
+void Settings::setThumbnailCacheSize(int thumbnailCacheSize) {
+    if (this->thumbnailCacheSize == thumbnailCacheSize) {
+        return;
+    }
+    this->thumbnailCacheSize = thumbnailCacheSize;
+    save();
+}
+
 auto Settings::getPreloadPagesBefore() const -> unsigned int { return this->preloadPagesBefore; }
 
 void Settings::setPreloadPagesBefore(unsigned int n) {
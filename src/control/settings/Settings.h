@@ -342,6 +342,30 @@ public:
     int getPdfPageCacheSize() const;
     [[maybe_unused]] void setPdfPageCacheSize(int size);
 
+    /**
+     * Scroll to and highlight the strokes written at the current audio playback position
+     */
+    bool isFollowAudioPlayback() const;
+    void setFollowAudioPlayback(bool followAudioPlayback);
+
+    /**
+     * Free the contents of pages which are far from the view, see XournalView::unloadPages()
+     */
+    bool isUnloadPages() const;
+    void setUnloadPages(bool unloadPages);
+
+    /**
+     * Minimum distance in pages from the current page for unloading
+     */
+    int getUnloadPagesDistance() const;
+    void setUnloadPagesDistance(int unloadPagesDistance);
+
+    /**
+     * Size limit of the on-disk thumbnail cache in MiB
+     */
+    int getThumbnailCacheSize() const;
+    void setThumbnailCacheSize(int thumbnailCacheSize);
+
     unsigned int getPreloadPagesBefore() const;
     void setPreloadPagesBefore(unsigned int n);
 
@@ -841,6 +865,26 @@ private:
      */
     int pdfPageCacheSize{};
 
+    /**
+     * Scroll to the strokes written at the current audio playback position and highlight them
+     */
+    bool followAudioPlayback{};
+
+    /**
+     * Write the contents of pages far from the view to a temporary file and free them
+     */
+    bool unloadPages{};
+
+    /**
+     * Pages farther than this from the current page may be unloaded
+     */
+    int unloadPagesDistance{};
+
+    /**
+     * Maximum size of the persistent sidebar thumbnail cache in MiB, 0 disables it
+     */
+    int thumbnailCacheSize{};
+
     /**
      *  Percentage by which the page's zoom must change
      * for PDF pages to re-render while zooming.
@@ -57,6 +57,7 @@ void XojOpenDlg::addFilterXopp() {
     GtkFileFilter* filterXopp = gtk_file_filter_new();
     gtk_file_filter_set_name(filterXopp, _("Xournal++ files"));
     gtk_file_filter_add_pattern(filterXopp, "*.xopp");
+    gtk_file_filter_add_pattern(filterXopp, "*.xopb");
     gtk_file_chooser_add_filter(GTK_FILE_CHOOSER(dialog), filterXopp);
 }
 
@@ -93,6 +94,7 @@ auto XojOpenDlg::showOpenDialog(bool pdf, bool& attachPdf) -> fs::path {
         gtk_file_filter_set_name(filterSupported, _("Supported files"));
         gtk_file_filter_add_pattern(filterSupported, "*.xoj");
         gtk_file_filter_add_pattern(filterSupported, "*.xopp");
+        gtk_file_filter_add_pattern(filterSupported, "*.xopb");
         gtk_file_filter_add_pattern(filterSupported, "*.xopt");
         gtk_file_filter_add_pattern(filterSupported, "*.pdf");
         gtk_file_filter_add_pattern(filterSupported, "*.PDF");
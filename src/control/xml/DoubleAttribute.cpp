@@ -6,9 +6,4 @@ DoubleAttribute::DoubleAttribute(const char* name, double value): XMLAttribute(n
 
 DoubleAttribute::~DoubleAttribute() = default;
 
-void DoubleAttribute::writeOut(OutputStream* out) {
-    char str[G_ASCII_DTOSTR_BUF_SIZE];
-    // g_ascii_ version uses C locale always.
-    g_ascii_formatd(str, G_ASCII_DTOSTR_BUF_SIZE, Util::PRECISION_FORMAT_STRING, value);
-    out->write(str);
-}
+void DoubleAttribute::writeOut(OutputStream* out) { Util::writeDouble(out, value); }
@@ -35,15 +35,11 @@ void XmlStrokeNode::writeOut(OutputStream* out) {
 
     out->write(" width=\"");
 
-    char widthStr[G_ASCII_DTOSTR_BUF_SIZE];
-    // g_ascii_ version uses C locale always.
-    g_ascii_formatd(widthStr, G_ASCII_DTOSTR_BUF_SIZE, Util::PRECISION_FORMAT_STRING, width);
-    out->write(widthStr);
+    Util::writeDouble(out, width);
 
     for (int i = 0; i < widthsLength; i++) {
-        g_ascii_formatd(widthStr, G_ASCII_DTOSTR_BUF_SIZE, Util::PRECISION_FORMAT_STRING, widths[i]);
         out->write(" ");
-        out->write(widthStr);
+        Util::writeDouble(out, widths[i]);
     }
 
     out->write("\"");
@@ -0,0 +1,248 @@
+#include "DocumentGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+
+#include <cairo-pdf.h>
+
+#include "model/Image.h"
+#include "model/Layer.h"
+#include "model/PageType.h"
+#include "model/Stroke.h"
+#include "model/TexImage.h"
+#include "model/Text.h"
+#include "model/XojPage.h"
+
+namespace {
+constexpr double A4_WIDTH = 595.275591;
+constexpr double A4_HEIGHT = 841.889764;
+constexpr double PI = 3.14159265358979323846;
+
+constexpr Color PEN_COLORS[] = {Color{0x000000U}, Color{0x3333CCU}, Color{0xFF0000U}, Color{0x008000U}};
+constexpr Color HIGHLIGHTER_COLOR = Color{0xFFFF00U};
+
+const char* const WORDS[] = {"Lorem", "ipsum", "dolor", "sit", "amet", "consectetur", "adipiscing", "elit"};
+const char* const FORMULA = "x = \\frac{-b \\pm \\sqrt{b^2 - 4ac}}{2a}";
+
+auto appendToString(void* closure, const unsigned char* data, unsigned int length) -> cairo_status_t {
+    static_cast<std::string*>(closure)->append(reinterpret_cast<const char*>(data), length);
+    return CAIRO_STATUS_SUCCESS;
+}
+}  // namespace
+
+DocumentGenerator::DocumentGenerator(DocumentGeneratorOptions options): options(std::move(options)) {
+    this->gen.seed(this->options.seed);
+}
+
+DocumentGenerator::~DocumentGenerator() = default;
+
+auto DocumentGenerator::getLastError() const -> std::string { return this->lastError; }
+
+/*
+ * The std distributions are implementation defined, only the output of std::mt19937 is the same everywhere. So
+ * the ranges are mapped here, to generate the same document with every standard library.
+ */
+auto DocumentGenerator::uniform(double min, double max) -> double {
+    // 53 random bits, as many as a double has, in [0, 1)
+    uint64_t high = this->gen() >> 5U;
+    uint64_t low = this->gen() >> 6U;
+    double unit = static_cast<double>((high << 26U) | low) / 9007199254740992.0;
+    return min + unit * (max - min);
+}
+
+auto DocumentGenerator::uniformInt(int min, int max) -> int {
+    if (max <= min) {
+        return min;
+    }
+    // The modulo bias is negligible for the small ranges used here
+    auto range = static_cast<uint32_t>(max - min) + 1U;
+    return min + static_cast<int>(this->gen() % range);
+}
+
+auto DocumentGenerator::generate(Document* doc) -> bool {
+    if (!this->options.pdfBackground.empty()) {
+        if (!doc->readPdf(this->options.pdfBackground, true, false)) {
+            this->lastError = doc->getLastErrorMsg();
+            return false;
+        }
+
+        for (size_t i = 0; i < doc->getPageCount(); i++) {
+            PageRef page = doc->getPage(i);
+            page->setBackgroundType(PageType(PageTypeFormat::Pdf));
+            fillPage(page);
+        }
+        return true;
+    }
+
+    for (int i = 0; i < this->options.pages; i++) {
+        auto page = std::make_shared<XojPage>(A4_WIDTH, A4_HEIGHT);
+        page->setBackgroundType(PageType(PageTypeFormat::Lined));
+        fillPage(page);
+        doc->addPage(page);
+    }
+    return true;
+}
+
+void DocumentGenerator::fillPage(const PageRef& page) {
+    for (int i = 0; i < this->options.layersPerPage; i++) {
+        auto* layer = new Layer();
+        fillLayer(layer, page->getWidth(), page->getHeight());
+        page->addLayer(layer);
+    }
+
+    // Images, texts and TeX go to the top layer
+    Layer* top = page->getLayers()->empty() ? nullptr : page->getLayers()->back();
+    if (top == nullptr) {
+        top = new Layer();
+        page->addLayer(top);
+    }
+    for (int i = 0; i < this->options.imagesPerPage; i++) {
+        top->addElement(createImage(page->getWidth(), page->getHeight()));
+    }
+    for (int i = 0; i < this->options.textsPerPage; i++) {
+        top->addElement(createText(page->getWidth(), page->getHeight()));
+    }
+    for (int i = 0; i < this->options.texImagesPerPage; i++) {
+        top->addElement(createTexImage(page->getWidth(), page->getHeight()));
+    }
+
+    page->setSelectedLayerId(static_cast<int>(page->getLayerCount()));
+}
+
+void DocumentGenerator::fillLayer(Layer* layer, double width, double height) {
+    for (int i = 0; i < this->options.strokesPerLayer; i++) {
+        layer->addElement(createStroke(width, height));
+    }
+}
+
+auto DocumentGenerator::createStroke(double width, double height) -> Stroke* {
+    auto* stroke = new Stroke();
+
+    bool highlighter = uniform(0, 1) < this->options.highlighterRatio;
+    stroke->setToolType(highlighter ? STROKE_TOOL_HIGHLIGHTER : STROKE_TOOL_PEN);
+    stroke->setColor(highlighter ? HIGHLIGHTER_COLOR : PEN_COLORS[this->gen() % std::size(PEN_COLORS)]);
+    double strokeWidth = highlighter ? 8.5 : 1.41;
+    stroke->setWidth(strokeWidth);
+
+    int points = uniformInt(std::max(this->options.minPoints, 2), std::max(this->options.maxPoints, 2));
+
+    // A wavy line like handwriting, which turns slowly and stays on the page
+    double x = uniform(0.1, 0.7) * width;
+    double y = uniform(0.05, 0.95) * height;
+    double direction = uniform(-0.3, 0.3);
+    double phase = uniform(0, 2 * PI);
+    for (int i = 0; i < points; i++) {
+        double wave = 4.0 * std::sin(phase + i * 0.4);
+        double px = std::clamp(x + std::cos(direction) * i * 1.2, 0.0, width);
+        double py = std::clamp(y + std::sin(direction) * i * 1.2 + wave, 0.0, height);
+
+        if (this->options.pressure) {
+            stroke->addPoint(Point(px, py, strokeWidth * (0.5 + 0.5 * std::abs(std::sin(phase + i * 0.1)))));
+        } else {
+            stroke->addPoint(Point(px, py));
+        }
+    }
+
+    return stroke;
+}
+
+auto DocumentGenerator::createImage(double width, double height) -> Element* {
+    int size = std::max(this->options.imageSize, 1);
+    cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, size, size);
+    cairo_t* cr = cairo_create(surface);
+
+    // A random gradient, so the images do not compress to nothing
+    cairo_pattern_t* pattern = cairo_pattern_create_linear(0, 0, size, size);
+    cairo_pattern_add_color_stop_rgb(pattern, 0, uniform(0, 1), uniform(0, 1), uniform(0, 1));
+    cairo_pattern_add_color_stop_rgb(pattern, 1, uniform(0, 1), uniform(0, 1), uniform(0, 1));
+    cairo_set_source(cr, pattern);
+    cairo_paint(cr);
+    cairo_pattern_destroy(pattern);
+    for (int i = 0; i < 20; i++) {
+        cairo_set_source_rgba(cr, uniform(0, 1), uniform(0, 1), uniform(0, 1), 0.5);
+        cairo_arc(cr, uniform(0, size), uniform(0, size), uniform(2, size / 4.0), 0, 2 * PI);
+        cairo_fill(cr);
+    }
+    cairo_destroy(cr);
+
+    auto* image = new Image();
+    image->setImage(surface);
+    double side = uniform(0.1, 0.3) * width;
+    image->setX(uniform(0, width - side));
+    image->setY(uniform(0, height - side));
+    image->setWidth(side);
+    image->setHeight(side);
+    return image;
+}
+
+auto DocumentGenerator::createText(double width, double height) -> Element* {
+    std::string str;
+    int words = uniformInt(3, 12);
+    for (int i = 0; i < words; i++) {
+        if (i > 0) {
+            str += i % 6 == 0 ? "\n" : " ";
+        }
+        str += WORDS[this->gen() % std::size(WORDS)];
+    }
+
+    auto* text = new Text();
+    text->setText(str);
+    text->setColor(PEN_COLORS[this->gen() % std::size(PEN_COLORS)]);
+    text->setX(uniform(0, width * 0.7));
+    text->setY(uniform(0, height * 0.95));
+    return text;
+}
+
+auto DocumentGenerator::createTexImage(double width, double height) -> Element* {
+    if (this->texPdf.empty()) {
+        // Stands in for the output of LaTeX: a small one page PDF
+        cairo_surface_t* surface = cairo_pdf_surface_create_for_stream(appendToString, &this->texPdf, 160, 30);
+        cairo_t* cr = cairo_create(surface);
+        cairo_set_source_rgb(cr, 0, 0, 0);
+        cairo_move_to(cr, 4, 20);
+        cairo_set_font_size(cr, 12);
+        cairo_show_text(cr, FORMULA);
+        cairo_destroy(cr);
+        cairo_surface_finish(surface);
+        cairo_surface_destroy(surface);
+    }
+
+    auto* tex = new TexImage();
+    tex->setText(FORMULA);
+    tex->loadData(std::string(this->texPdf));
+    tex->setX(uniform(0, width - 160));
+    tex->setY(uniform(0, height - 30));
+    tex->setWidth(160);
+    tex->setHeight(30);
+    return tex;
+}
+
+auto DocumentGenerator::writeBackgroundPdf(const fs::path& file, int pages) -> bool {
+    cairo_surface_t* surface = cairo_pdf_surface_create(file.u8string().c_str(), A4_WIDTH, A4_HEIGHT);
+    cairo_t* cr = cairo_create(surface);
+
+    for (int i = 0; i < pages; i++) {
+        cairo_set_source_rgb(cr, 0.2, 0.2, 0.2);
+        cairo_set_font_size(cr, 24);
+        cairo_move_to(cr, 60, 80);
+        cairo_show_text(cr, ("Page " + std::to_string(i + 1)).c_str());
+
+        // Some vector content, so the PDF page takes a bit of time to render
+        cairo_set_line_width(cr, 0.5);
+        for (int line = 0; line < 40; line++) {
+            cairo_move_to(cr, 60, 120 + line * 17);
+            cairo_line_to(cr, A4_WIDTH - 60, 120 + line * 17);
+        }
+        cairo_stroke(cr);
+        cairo_show_page(cr);
+    }
+
+    cairo_destroy(cr);
+    cairo_surface_finish(surface);
+    bool success = cairo_surface_status(surface) == CAIRO_STATUS_SUCCESS;
+    cairo_surface_destroy(surface);
+    return success;
+}
@@ -0,0 +1,123 @@
+/*
+ * Xournal++
+ *
+ * Generates synthetic documents for benchmarks and stress tests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <random>
+#include <string>
+
+#include "model/Document.h"
+#include "model/PageRef.h"
+
+#include "filesystem.h"
+
+class Layer;
+class Stroke;
+class Element;
+
+/**
+ * Parameters of a generated document, all counts are per page (or per layer)
+ */
+struct DocumentGeneratorOptions {
+    /**
+     * The same seed and options always produce the same document
+     */
+    unsigned int seed = 1;
+
+    /**
+     * Number of pages, ignored if pdfBackground is set
+     */
+    int pages = 1;
+    int layersPerPage = 1;
+    int strokesPerLayer = 200;
+
+    /**
+     * The number of points of a stroke is uniformly distributed in [minPoints, maxPoints]
+     */
+    int minPoints = 20;
+    int maxPoints = 200;
+
+    /**
+     * Store a pressure (width) value for every point
+     */
+    bool pressure = false;
+
+    /**
+     * Share of the strokes drawn with the highlighter
+     */
+    double highlighterRatio = 0.1;
+
+    int imagesPerPage = 0;
+
+    /**
+     * Width and height of the generated images, in pixels
+     */
+    int imageSize = 256;
+
+    int textsPerPage = 0;
+    int texImagesPerPage = 0;
+
+    /**
+     * If set, the document gets one page per page of this PDF, with the PDF page as background
+     */
+    fs::path pdfBackground;
+};
+
+class DocumentGenerator {
+public:
+    explicit DocumentGenerator(DocumentGeneratorOptions options);
+    virtual ~DocumentGenerator();
+
+public:
+    /**
+     * @brief Add the generated pages to the document
+     * @return false if the PDF background could not be read, see getLastError()
+     */
+    bool generate(Document* doc);
+
+    std::string getLastError() const;
+
+    /**
+     * @brief Write a simple PDF with numbered pages, to be used as background
+     * @return false if the file could not be written
+     */
+    static bool writeBackgroundPdf(const fs::path& file, int pages);
+
+private:
+    void fillPage(const PageRef& page);
+    void fillLayer(Layer* layer, double width, double height);
+
+    Stroke* createStroke(double width, double height);
+    Element* createImage(double width, double height);
+    Element* createText(double width, double height);
+    Element* createTexImage(double width, double height);
+
+    /**
+     * @return A random number in [min, max)
+     */
+    double uniform(double min, double max);
+
+    /**
+     * @return A random number in [min, max]
+     */
+    int uniformInt(int min, int max);
+
+private:
+    DocumentGeneratorOptions options;
+    std::mt19937 gen;
+
+    /**
+     * The TeX images are PDFs rendered once and shared by all TexImage elements
+     */
+    std::string texPdf;
+
+    std::string lastError;
+};
@@ -14,6 +14,7 @@
 
 #include "GzUtil.h"
 #include "LoadHandlerHelper.h"
+#include "Tracing.h"
 #include "i18n.h"
 
 using std::string;
@@ -189,6 +190,7 @@ auto LoadHandler::readContentFile(char* buffer, zip_uint64_t len) -> zip_int64_t
 }
 
 auto LoadHandler::parseXml() -> bool {
+    XOJ_TRACE_SCOPE("LoadHandler::parseXml");
     const GMarkupParser parser = {LoadHandler::parserStartElement, LoadHandler::parserEndElement,
                                   LoadHandler::parserText, nullptr, nullptr};
     this->error = nullptr;
@@ -0,0 +1,113 @@
+#include "MappedPageStore.h"
+
+MappedPageStore::MappedPageStore() = default;
+
+MappedPageStore::~MappedPageStore() {
+    if (this->file) {
+        g_mapped_file_unref(this->file);
+    }
+}
+
+auto MappedPageStore::map(const fs::path& filepath, GError** error) -> bool {
+    GMappedFile* mapped = g_mapped_file_new(filepath.u8string().c_str(), false, error);
+    if (mapped == nullptr) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(this->mapMutex);
+    if (this->file) {
+        g_mapped_file_unref(this->file);
+    }
+    this->file = mapped;
+    this->filepath = filepath;
+    this->copies.clear();
+    return true;
+}
+
+void MappedPageStore::detach() {
+    std::lock_guard<std::mutex> lock(this->mapMutex);
+    if (this->file == nullptr) {
+        return;
+    }
+
+    const char* data = g_mapped_file_get_contents(this->file);
+    size_t length = g_mapped_file_get_length(this->file);
+    for (const auto& [offset, entry]: this->retained) {
+        if (offset <= length && entry.length <= length - offset) {
+            this->copies.emplace(offset, std::string(data + offset, entry.length));
+        }
+    }
+
+    g_mapped_file_unref(this->file);
+    this->file = nullptr;
+    this->filepath.clear();
+}
+
+void MappedPageStore::retain(const Entry& entry) {
+    std::lock_guard<std::mutex> lock(this->mapMutex);
+    Retained& retained = this->retained[entry.offset];
+    retained.length = entry.length;
+    retained.count++;
+}
+
+auto MappedPageStore::write(const std::string&, Entry&) -> bool { return false; }
+
+auto MappedPageStore::findStored(const Entry& entry) const -> const char* {
+    if (this->file) {
+        size_t length = g_mapped_file_get_length(this->file);
+        if (entry.offset > length || entry.length > length - entry.offset) {
+            return nullptr;
+        }
+        return g_mapped_file_get_contents(this->file) + entry.offset;
+    }
+
+    auto it = this->copies.find(entry.offset);
+    return it != this->copies.end() && it->second.size() == entry.length ? it->second.data() : nullptr;
+}
+
+auto MappedPageStore::read(const Entry& entry, std::string& data) -> bool {
+    std::lock_guard<std::mutex> lock(this->mapMutex);
+    const char* stored = findStored(entry);
+    return stored != nullptr && decode(stored, entry, data);
+}
+
+auto MappedPageStore::readStored(const Entry& entry, std::string& stored) -> bool {
+    std::lock_guard<std::mutex> lock(this->mapMutex);
+    const char* data = findStored(entry);
+    if (data == nullptr) {
+        return false;
+    }
+    stored.assign(data, entry.length);
+    return true;
+}
+
+void MappedPageStore::release(const Entry& entry) {
+    std::lock_guard<std::mutex> lock(this->mapMutex);
+    auto it = this->retained.find(entry.offset);
+    if (it == this->retained.end() || --it->second.count > 0) {
+        return;
+    }
+    this->retained.erase(it);
+    this->copies.erase(entry.offset);
+}
+
+auto MappedPageStore::contains(uint64_t offset, uint64_t length) const -> bool {
+    std::lock_guard<std::mutex> lock(this->mapMutex);
+    size_t size = this->file ? g_mapped_file_get_length(this->file) : 0;
+    return offset <= size && length <= size - offset;
+}
+
+auto MappedPageStore::getData() const -> const char* {
+    std::lock_guard<std::mutex> lock(this->mapMutex);
+    return this->file ? g_mapped_file_get_contents(this->file) : nullptr;
+}
+
+auto MappedPageStore::getLength() const -> size_t {
+    std::lock_guard<std::mutex> lock(this->mapMutex);
+    return this->file ? g_mapped_file_get_length(this->file) : 0;
+}
+
+auto MappedPageStore::getFilepath() const -> fs::path {
+    std::lock_guard<std::mutex> lock(this->mapMutex);
+    return this->filepath;
+}
@@ -0,0 +1,106 @@
+/*
+ * Xournal++
+ *
+ * The layer chunks of a memory mapped page file
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include <glib.h>
+
+#include "model/PageStore.h"
+
+#include "filesystem.h"
+
+/**
+ * @brief Reads the layer chunks of a page file from a memory mapping, nothing is written to it
+ *
+ * A mapped file cannot be replaced on Windows. Before a document is saved to the file it was loaded from,
+ * PageFileWriter moves its unloaded layers to a store of the new file and detaches this store. The entries which
+ * are still referenced then, e.g. by undo actions, are kept in memory.
+ */
+class MappedPageStore: public PageStore {
+public:
+    MappedPageStore();
+    ~MappedPageStore() override;
+
+public:
+    /**
+     * Maps the file, a previous mapping is released
+     *
+     * @return false if the file could not be mapped, see error
+     */
+    bool map(const fs::path& filepath, GError** error);
+
+    /**
+     * Copies the retained entries to memory and releases the mapping, so the file can be replaced
+     */
+    void detach();
+
+    /**
+     * Marks an entry as referenced by a layer until it is released, see detach()
+     */
+    void retain(const Entry& entry);
+
+    bool write(const std::string& data, Entry& entry) override;
+    bool read(const Entry& entry, std::string& data) override;
+    void release(const Entry& entry) override;
+
+    /**
+     * Copies the entry as it is stored, without decompressing it
+     */
+    bool readStored(const Entry& entry, std::string& stored);
+
+    /**
+     * @return true if the range is within the mapped file
+     */
+    bool contains(uint64_t offset, uint64_t length) const;
+
+    /**
+     * The contents of the mapped file, valid until the next call of map() or detach()
+     */
+    const char* getData() const;
+    size_t getLength() const;
+
+    /**
+     * @return The mapped file, empty if there is no mapping
+     */
+    fs::path getFilepath() const;
+
+private:
+    /**
+     * @return The stored bytes of the entry, nullptr if they are neither mapped nor copied. Needs the lock.
+     */
+    const char* findStored(const Entry& entry) const;
+
+private:
+    mutable std::mutex mapMutex;
+
+    GMappedFile* file = nullptr;
+    fs::path filepath;
+
+    struct Retained {
+        uint64_t length = 0;
+        int count = 0;
+    };
+
+    /**
+     * The retained entries, by offset
+     */
+    std::map<uint64_t, Retained> retained;
+
+    /**
+     * The retained entries after detach(), by offset
+     */
+    std::map<uint64_t, std::string> copies;
+};
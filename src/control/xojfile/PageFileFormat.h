@@ -0,0 +1,95 @@
+/*
+ * Xournal++
+ *
+ * Layout of the binary page file (.xopb)
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+/**
+ * A page file starts with the PageFileHeader, followed by the chunks and the index:
+ *
+ * - Every layer with elements is one chunk: the elements as serialized by Layer::serializeElements(),
+ *   compressed as in the PageStore, so the file is used as the page store of the opened document.
+ *   Stroke points are packed arrays, images keep their encoded data.
+ * - Attached background images (PNG) and an attached PDF are raw chunks.
+ * - The index is written with ObjectOutputStream and contains the document properties, the background images
+ *   and for every page its size, background and layers, with the position and the audio references (filename,
+ *   timestamp and bounds of the element) of each layer chunk.
+ *
+ * Opening a file only reads the index, the chunks are read and decompressed when a layer is accessed. This is
+ * one small index record per page and layer, independent of the number of elements.
+ *
+ * The header is little endian. The elements and the index use the byte order of the writing machine, which is
+ * stored in the header as G_BYTE_ORDER. Files with another byte order are rejected.
+ */
+namespace PageFileFormat {
+
+constexpr char MAGIC[8] = {'X', 'O', 'P', 'P', 'P', 'A', 'G', 'E'};
+/**
+ * 2: The audio references of a layer contain the bounds of the element
+ */
+constexpr uint32_t VERSION = 2;
+constexpr const char* EXTENSION = ".xopb";
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint64_t indexOffset;
+    uint64_t indexLength;
+};
+
+constexpr size_t HEADER_SIZE = 32;
+
+namespace detail {
+inline void writeLittleEndian(char* data, uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; i++) {
+        data[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+}
+
+inline auto readLittleEndian(const char* data, size_t bytes) -> uint64_t {
+    uint64_t value = 0;
+    for (size_t i = 0; i < bytes; i++) {
+        value |= static_cast<uint64_t>(static_cast<unsigned char>(data[i])) << (8 * i);
+    }
+    return value;
+}
+}  // namespace detail
+
+/**
+ * @param data HEADER_SIZE bytes
+ */
+inline void writeHeader(const Header& header, char* data) {
+    std::copy(std::begin(header.magic), std::end(header.magic), data);
+    detail::writeLittleEndian(data + 8, header.version, 4);
+    detail::writeLittleEndian(data + 12, header.byteOrder, 4);
+    detail::writeLittleEndian(data + 16, header.indexOffset, 8);
+    detail::writeLittleEndian(data + 24, header.indexLength, 8);
+}
+
+/**
+ * @param data HEADER_SIZE bytes
+ */
+inline auto readHeader(const char* data) -> Header {
+    Header header{};
+    std::copy(data, data + 8, header.magic);
+    header.version = static_cast<uint32_t>(detail::readLittleEndian(data + 8, 4));
+    header.byteOrder = static_cast<uint32_t>(detail::readLittleEndian(data + 12, 4));
+    header.indexOffset = detail::readLittleEndian(data + 16, 8);
+    header.indexLength = detail::readLittleEndian(data + 24, 8);
+    return header;
+}
+
+}  // namespace PageFileFormat
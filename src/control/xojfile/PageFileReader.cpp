@@ -0,0 +1,240 @@
+#include "PageFileReader.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include <gio/gio.h>
+
+#include "control/pagetype/PageTypeHandler.h"
+#include "model/BackgroundImage.h"
+#include "model/Layer.h"
+#include "model/PageStore.h"
+#include "model/XojPage.h"
+#include "serializing/InputStreamException.h"
+#include "serializing/ObjectInputStream.h"
+
+#include "MappedPageStore.h"
+#include "PageFileFormat.h"
+#include "StringUtils.h"
+#include "Tracing.h"
+#include "i18n.h"
+
+namespace {
+/**
+ * Reads the number of records which follow in the index. Every record takes at least one byte, so larger
+ * numbers are corrupted and would only allocate memory.
+ */
+auto readCount(ObjectInputStream& in, uint64_t indexLength) -> size_t {
+    int count = in.readInt();
+    if (count < 0 || static_cast<uint64_t>(count) > indexLength) {
+        throw InputStreamException(FS(FORMAT_STR("Invalid record count {1}") % count), __FILE__, __LINE__);
+    }
+    return static_cast<size_t>(count);
+}
+}  // namespace
+
+PageFileReader::PageFileReader(): doc(&handler) {}
+
+PageFileReader::~PageFileReader() = default;
+
+auto PageFileReader::getLastError() -> std::string { return this->lastError; }
+
+auto PageFileReader::getMissingPdfFilename() -> std::string { return this->missingPdf; }
+
+auto PageFileReader::isPageFile(const fs::path& filepath) -> bool {
+    return StringUtils::toLowerCase(filepath.extension().string()) == PageFileFormat::EXTENSION;
+}
+
+auto PageFileReader::loadDocument(const fs::path& filepath) -> Document* {
+    XOJ_TRACE_SCOPE("PageFileReader::loadDocument");
+
+    this->doc.clearDocument();
+    this->lastError.clear();
+    this->missingPdf.clear();
+
+    GError* error = nullptr;
+    auto store = std::make_shared<MappedPageStore>();
+    if (!store->map(filepath, &error)) {
+        this->lastError = FS(_F("Could not open \"{1}\": {2}") % filepath.u8string() % error->message);
+        g_error_free(error);
+        return nullptr;
+    }
+
+    if (!store->contains(0, PageFileFormat::HEADER_SIZE)) {
+        this->lastError = _("The file is not a Xournal++ page file");
+        return nullptr;
+    }
+    PageFileFormat::Header header = PageFileFormat::readHeader(store->getData());
+
+    if (!std::equal(std::begin(PageFileFormat::MAGIC), std::end(PageFileFormat::MAGIC), header.magic)) {
+        this->lastError = _("The file is not a Xournal++ page file");
+        return nullptr;
+    }
+    if (header.byteOrder != G_BYTE_ORDER) {
+        this->lastError = _("The page file was written on a machine with another byte order, convert it to .xopp");
+        return nullptr;
+    }
+    if (header.version > PageFileFormat::VERSION) {
+        this->lastError = _("The page file was written by a newer version of Xournal++");
+        return nullptr;
+    }
+    if (!store->contains(header.indexOffset, header.indexLength)) {
+        this->lastError = _("The page file is truncated");
+        return nullptr;
+    }
+    if (header.indexLength > static_cast<uint64_t>(std::numeric_limits<int>::max())) {
+        this->lastError = _("The index of the page file is too large");
+        return nullptr;
+    }
+
+    ObjectInputStream in;
+    if (!in.read(store->getData() + header.indexOffset, static_cast<int>(header.indexLength))) {
+        this->lastError = _("The index of the page file could not be read");
+        return nullptr;
+    }
+
+    try {
+        in.readObject("PageFile");
+
+        fs::path pdfFilepath = fs::u8path(in.readString());
+        bool attachPdf = in.readInt();
+        size_t pdfOffset = in.readSizeT();
+        size_t pdfLength = in.readSizeT();
+
+        if (!pdfFilepath.empty()) {
+            if (attachPdf && pdfLength > 0 && store->contains(pdfOffset, pdfLength)) {
+                // Poppler reads from the data while the document is open, so it is not freed,
+                // as for the attachments of .xopp files
+                gpointer data = g_malloc(pdfLength);
+                std::memcpy(data, store->getData() + pdfOffset, pdfLength);
+                this->doc.readPdf(pdfFilepath, false, true, data, pdfLength);
+            } else if (fs::is_regular_file(pdfFilepath)) {
+                this->doc.readPdf(pdfFilepath, false, attachPdf);
+            } else {
+                this->missingPdf = pdfFilepath.u8string();
+            }
+
+            if (!this->doc.getLastErrorMsg().empty()) {
+                g_warning("%s", FC(_F("Error reading PDF: {1}") % this->doc.getLastErrorMsg()));
+            }
+        }
+
+        std::vector<BackgroundImage> images(readCount(in, header.indexLength));
+        for (BackgroundImage& img: images) {
+            fs::path imgFilepath = fs::u8path(in.readString());
+            bool attached = in.readInt();
+            size_t offset = in.readSizeT();
+            size_t length = in.readSizeT();
+
+            GError* imgError = nullptr;
+            if (attached && length > 0 && store->contains(offset, length)) {
+                GInputStream* stream =
+                        g_memory_input_stream_new_from_data(store->getData() + offset, length, nullptr);
+                img.loadFile(stream, imgFilepath, &imgError);
+                g_input_stream_close(stream, nullptr, nullptr);
+                g_object_unref(stream);
+            } else {
+                img.loadFile(imgFilepath, &imgError);
+            }
+            img.setAttach(attached);
+
+            if (imgError) {
+                g_warning("%s", FC(_F("Could not read image: {1}. Error message: {2}") % imgFilepath.u8string() %
+                                   imgError->message));
+                g_error_free(imgError);
+            }
+        }
+
+        size_t pageCount = readCount(in, header.indexLength);
+        std::vector<PageRef> pages;
+        pages.reserve(pageCount);
+        for (size_t i = 0; i < pageCount; i++) {
+            in.readObject("Page");
+
+            double width = in.readDouble();
+            double height = in.readDouble();
+            auto page = std::make_shared<XojPage>(width, height);
+
+            PageType type;
+            type.format = PageTypeHandler::getPageTypeFormatForString(in.readString());
+            type.config = in.readString();
+            page->setBackgroundType(type);
+            page->setBackgroundColor(Color(static_cast<uint32_t>(in.readInt())));
+
+            bool hasBackgroundName = in.readInt();
+            std::string backgroundName = in.readString();
+            if (hasBackgroundName) {
+                page->setBackgroundName(backgroundName);
+            }
+
+            size_t pdfPage = in.readSizeT();
+            if (type.isPdfPage()) {
+                page->setBackgroundPdfPageNr(pdfPage);
+            }
+
+            int image = in.readInt();
+            if (image >= 0 && static_cast<size_t>(image) < images.size()) {
+                page->setBackgroundImage(images[static_cast<size_t>(image)]);
+            }
+
+            size_t layerCount = readCount(in, header.indexLength);
+            for (size_t l = 0; l < layerCount; l++) {
+                in.readObject("Layer");
+
+                auto layer = std::make_unique<Layer>();
+                bool hasName = in.readInt();
+                std::string name = in.readString();
+                if (hasName) {
+                    layer->setName(name);
+                }
+                layer->setVisible(in.readInt());
+
+                size_t count = in.readSizeT();
+                PageStore::Entry entry;
+                entry.offset = in.readSizeT();
+                entry.length = in.readSizeT();
+                entry.size = in.readSizeT();
+
+                Layer::AudioReferences audio(readCount(in, header.indexLength));
+                for (Layer::AudioReference& reference: audio) {
+                    reference.filename = in.readString();
+                    reference.timestamp = in.readSizeT();
+                    if (header.version >= 2) {
+                        double x = in.readDouble();
+                        double y = in.readDouble();
+                        double width = in.readDouble();
+                        double height = in.readDouble();
+                        reference.bounds = Rectangle<double>(x, y, width, height);
+                    }
+                }
+                if (count > 0) {
+                    layer->setStoredElements(store, entry, count, std::move(audio));
+                    store->retain(entry);
+                }
+                page->addLayer(layer.release());
+
+                in.endObject();
+            }
+
+            in.endObject();
+            pages.push_back(std::move(page));
+        }
+
+        in.endObject();
+        this->doc.addPages(pages.begin(), pages.end());
+    } catch (const std::exception& e) {
+        // Also std::bad_alloc or std::length_error for absurd sizes
+        this->lastError = FS(_F("The index of the page file is corrupted: {1}") % e.what());
+        this->doc.clearDocument();
+        return nullptr;
+    }
+
+    this->doc.setFilepath(filepath);
+    // Like for .xopp files, the first save keeps the loaded file as backup
+    this->doc.setCreateBackupOnSave(true);
+    return &this->doc;
+}
@@ -0,0 +1,58 @@
+/*
+ * Xournal++
+ *
+ * Loads a binary page file
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <string>
+
+#include "model/Document.h"
+#include "model/DocumentHandler.h"
+
+#include "filesystem.h"
+
+/**
+ * @brief Reads the format described in PageFileFormat.h
+ *
+ * The file is memory mapped and only the index is parsed, the layers of the loaded pages read their elements from
+ * the mapping on the first access. The mapping is released with the last of these layers.
+ */
+class PageFileReader {
+public:
+    PageFileReader();
+    virtual ~PageFileReader();
+
+public:
+    /**
+     * Document should not be freed, it will be freed with the PageFileReader!
+     *
+     * @return nullptr on error, see getLastError()
+     */
+    Document* loadDocument(const fs::path& filepath);
+
+    std::string getLastError();
+
+    /**
+     * @return The PDF background which could not be found, empty if there is none
+     */
+    std::string getMissingPdfFilename();
+
+    /**
+     * @return true if the file looks like a page file, the content is not checked
+     */
+    static bool isPageFile(const fs::path& filepath);
+
+private:
+    DocumentHandler handler;
+    Document doc;
+
+    std::string lastError;
+    std::string missingPdf;
+};
@@ -0,0 +1,267 @@
+#include "PageFileWriter.h"
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <gdk-pixbuf/gdk-pixbuf.h>
+
+#include "control/jobs/ProgressListener.h"
+#include "control/pagetype/PageTypeHandler.h"
+#include "model/BackgroundImage.h"
+#include "model/Document.h"
+#include "model/Layer.h"
+#include "model/XojPage.h"
+#include "serializing/BinObjectEncoding.h"
+#include "serializing/ObjectOutputStream.h"
+
+#include "MappedPageStore.h"
+#include "PageFileFormat.h"
+#include "PathUtil.h"
+#include "Tracing.h"
+#include "i18n.h"
+
+PageFileWriter::PageFileWriter() = default;
+
+PageFileWriter::~PageFileWriter() = default;
+
+auto PageFileWriter::getErrorMessage() -> std::string { return this->errorMessage; }
+
+auto PageFileWriter::writeChunk(const std::string& stored, size_t size, PageStore::Entry& entry) -> bool {
+    this->out.write(stored.data(), static_cast<std::streamsize>(stored.size()));
+    if (!this->out.good()) {
+        return false;
+    }
+
+    entry.offset = this->offset;
+    entry.length = stored.size();
+    entry.size = size;
+    this->offset += stored.size();
+    return true;
+}
+
+auto PageFileWriter::writeRawChunk(const std::string& data, PageStore::Entry& entry) -> bool {
+    return writeChunk(data, data.size(), entry);
+}
+
+auto PageFileWriter::save(Document* doc, const fs::path& filepath, ProgressListener* listener) -> bool {
+    XOJ_TRACE_SCOPE("PageFileWriter::save");
+
+    auto tmpPath = fs::path(filepath) += ".tmp";
+    this->out.open(tmpPath, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!this->out.is_open()) {
+        this->errorMessage = FS(_F("Could not open \"{1}\" for writing") % tmpPath.u8string());
+        return false;
+    }
+
+    // Written again at the end, when the position of the index is known
+    PageFileFormat::Header header{};
+    std::copy(std::begin(PageFileFormat::MAGIC), std::end(PageFileFormat::MAGIC), header.magic);
+    header.version = PageFileFormat::VERSION;
+    header.byteOrder = G_BYTE_ORDER;
+    char headerData[PageFileFormat::HEADER_SIZE];
+    PageFileFormat::writeHeader(header, headerData);
+    this->out.write(headerData, sizeof(headerData));
+    this->offset = sizeof(headerData);
+
+    ObjectOutputStream index(new BinObjectEncoding());
+    bool ok = true;
+
+    index.writeObject("PageFile");
+    index.writeString(doc->getPdfFilepath().u8string());
+    index.writeInt(doc->isAttachPdf());
+
+    PageStore::Entry pdfEntry;
+    if (doc->isAttachPdf() && !doc->getPdfFilepath().empty()) {
+        auto pdfPath = Util::getTmpDirSubfolder("pages") / (filepath.filename().u8string() + ".bg.pdf");
+        GError* error = nullptr;
+        doc->getPdfDocument().save(pdfPath, &error);
+        if (error) {
+            this->errorMessage = FS(_F("Could not write background \"{1}\", {2}") % pdfPath.u8string() %
+                                    error->message);
+            g_error_free(error);
+            ok = false;
+        } else if (auto pdf = Util::readString(pdfPath, false)) {
+            ok = writeRawChunk(*pdf, pdfEntry);
+        } else {
+            this->errorMessage = FS(_F("Could not read background \"{1}\"") % pdfPath.u8string());
+            ok = false;
+        }
+        std::error_code ec;
+        fs::remove(pdfPath, ec);
+    }
+    index.writeSizeT(pdfEntry.offset);
+    index.writeSizeT(pdfEntry.length);
+
+    // Pages sharing a background image share its pixbuf, the image is written once
+    std::map<GdkPixbuf*, int> imageIds;
+    std::vector<BackgroundImage> images;
+    for (size_t i = 0; i < doc->getPageCount(); i++) {
+        BackgroundImage& img = doc->getPage(i)->getBackgroundImage();
+        if (!img.isEmpty() && imageIds.emplace(img.getPixbuf(), static_cast<int>(images.size())).second) {
+            images.push_back(img);
+        }
+    }
+
+    index.writeInt(static_cast<int>(images.size()));
+    for (BackgroundImage& img: images) {
+        PageStore::Entry entry;
+        if (ok && img.isAttached() && img.getPixbuf()) {
+            gchar* buffer = nullptr;
+            gsize size = 0;
+            GError* error = nullptr;
+            if (gdk_pixbuf_save_to_buffer(img.getPixbuf(), &buffer, &size, "png", &error, nullptr)) {
+                ok = writeRawChunk(std::string(buffer, size), entry);
+                g_free(buffer);
+            } else {
+                this->errorMessage = FS(_F("Could not write background \"{1}\", {2}") %
+                                        img.getFilepath().u8string() % error->message);
+                g_error_free(error);
+                ok = false;
+            }
+        }
+        index.writeString(img.getFilepath().u8string());
+        index.writeInt(img.isAttached());
+        index.writeSizeT(entry.offset);
+        index.writeSizeT(entry.length);
+    }
+
+    if (listener) {
+        listener->setMaximumState(static_cast<int>(doc->getPageCount()));
+    }
+
+    std::vector<MovedLayer> movedLayers;
+
+    index.writeInt(static_cast<int>(doc->getPageCount()));
+    for (size_t i = 0; i < doc->getPageCount() && ok; i++) {
+        PageRef p = doc->getPage(i);
+        index.writeObject("Page");
+        index.writeDouble(p->getWidth());
+        index.writeDouble(p->getHeight());
+        index.writeString(PageTypeHandler::getStringForPageTypeFormat(p->getBackgroundType().format));
+        index.writeString(p->getBackgroundType().config);
+        index.writeInt(static_cast<int>(uint32_t(p->getBackgroundColor())));
+        index.writeInt(p->backgroundHasName());
+        index.writeString(p->getBackgroundName());
+        index.writeSizeT(p->getPdfPageNr());
+        BackgroundImage& img = p->getBackgroundImage();
+        index.writeInt(img.isEmpty() ? -1 : imageIds[img.getPixbuf()]);
+
+        index.writeInt(static_cast<int>(p->getLayers()->size()));
+        for (Layer* l: *p->getLayers()) {
+            PageStore::Entry entry;
+            size_t count = 0;
+
+            std::shared_ptr<PageStore> store;
+            PageStore::Entry storedEntry;
+            std::shared_ptr<MappedPageStore> mapped;
+            if (l->getStoredElements(store, storedEntry, count)) {
+                mapped = std::dynamic_pointer_cast<MappedPageStore>(store);
+            }
+
+            if (mapped) {
+                // Still in the page file it was loaded from, copied without reading the elements
+                std::string stored;
+                ok = ok && mapped->readStored(storedEntry, stored) && writeChunk(stored, storedEntry.size, entry);
+                movedLayers.push_back({l, entry, count, mapped});
+            } else {
+                count = l->isAnnotated() ? l->getElements().size() : 0;
+                if (count > 0) {
+                    std::string data = l->serializeElements();
+                    std::string stored;
+                    ok = ok && PageStore::encode(data, stored) && writeChunk(stored, data.size(), entry);
+                }
+            }
+
+            index.writeObject("Layer");
+            index.writeInt(l->hasName());
+            index.writeString(l->getName());
+            index.writeInt(l->isVisible());
+            index.writeSizeT(count);
+            index.writeSizeT(entry.offset);
+            index.writeSizeT(entry.length);
+            index.writeSizeT(entry.size);
+
+            // The audio index does not need to read the elements
+            Layer::AudioReferences audio = count > 0 ? l->getAudioReferences() : Layer::AudioReferences();
+            index.writeInt(static_cast<int>(audio.size()));
+            for (const Layer::AudioReference& reference: audio) {
+                index.writeString(reference.filename);
+                index.writeSizeT(reference.timestamp);
+                index.writeDouble(reference.bounds.x);
+                index.writeDouble(reference.bounds.y);
+                index.writeDouble(reference.bounds.width);
+                index.writeDouble(reference.bounds.height);
+            }
+            index.endObject();
+        }
+        index.endObject();
+
+        if (listener) {
+            listener->setCurrentState(static_cast<int>(i + 1));
+        }
+    }
+    index.endObject();
+
+    GString* str = index.getStr();
+    header.indexOffset = this->offset;
+    header.indexLength = str->len;
+    this->out.write(str->str, static_cast<std::streamsize>(str->len));
+    g_string_free(str, true);
+
+    this->out.seekp(0);
+    PageFileFormat::writeHeader(header, headerData);
+    this->out.write(headerData, sizeof(headerData));
+    this->out.close();
+
+    if (!ok || this->out.fail()) {
+        if (this->errorMessage.empty()) {
+            this->errorMessage = FS(_F("Could not write \"{1}\"") % tmpPath.u8string());
+        }
+        std::error_code ec;
+        fs::remove(tmpPath, ec);
+        return false;
+    }
+
+    // The file of the moved layers may be replaced, it must not be mapped anymore then
+    auto newStore = std::make_shared<MappedPageStore>();
+    moveLayers(movedLayers, newStore, filepath);
+
+    bool renamed = true;
+    try {
+        Util::safeRenameFile(tmpPath, filepath);
+    } catch (const fs::filesystem_error& e) {
+        this->errorMessage = FS(_F("Could not write \"{1}\", {2}") % filepath.u8string() % e.what());
+        renamed = false;
+    }
+
+    // If the file could not be replaced, the moved layers are read from the temporary file, which is kept
+    GError* error = nullptr;
+    if (!movedLayers.empty() && !newStore->map(renamed ? filepath : tmpPath, &error)) {
+        g_warning("Could not map the saved page file: %s", error->message);
+        g_error_free(error);
+    }
+    return renamed;
+}
+
+void PageFileWriter::moveLayers(const std::vector<MovedLayer>& movedLayers,
+                                const std::shared_ptr<MappedPageStore>& newStore, const fs::path& filepath) {
+    std::vector<std::shared_ptr<MappedPageStore>> oldStores;
+    for (const MovedLayer& moved: movedLayers) {
+        moved.layer->setStoredElements(newStore, moved.entry, moved.count, moved.layer->getAudioReferences());
+        newStore->retain(moved.entry);
+        if (std::find(oldStores.begin(), oldStores.end(), moved.store) == oldStores.end()) {
+            oldStores.push_back(moved.store);
+        }
+    }
+
+    // Layers which are not saved, e.g. of deleted pages kept for undo, still read from the old store
+    for (const auto& store: oldStores) {
+        std::error_code ec;
+        if (fs::equivalent(store->getFilepath(), filepath, ec)) {
+            store->detach();
+        }
+    }
+}
@@ -0,0 +1,81 @@
+/*
+ * Xournal++
+ *
+ * Saves a document as binary page file
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "model/PageStore.h"
+
+#include "filesystem.h"
+
+class Document;
+class Layer;
+class MappedPageStore;
+class ProgressListener;
+
+/**
+ * @brief Writes the format described in PageFileFormat.h
+ *
+ * The file is written next to the target and renamed when it is complete. Layers which are still unloaded from a page
+ * file are copied as they are stored, and read from the new file afterwards. The old file is not mapped anymore when
+ * it is replaced, see MappedPageStore.
+ */
+class PageFileWriter {
+public:
+    PageFileWriter();
+    virtual ~PageFileWriter();
+
+public:
+    /**
+     * The document needs to be locked by the caller. Layers which are unloaded to the temporary page store are
+     * loaded while they are written.
+     *
+     * @return false on error, see getErrorMessage()
+     */
+    bool save(Document* doc, const fs::path& filepath, ProgressListener* listener = nullptr);
+
+    std::string getErrorMessage();
+
+private:
+    /**
+     * Appends a chunk to the file, the entry refers to it afterwards
+     */
+    bool writeChunk(const std::string& stored, size_t size, PageStore::Entry& entry);
+
+    bool writeRawChunk(const std::string& data, PageStore::Entry& entry);
+
+    /**
+     * A layer which was copied from a page file without reading its elements
+     */
+    struct MovedLayer {
+        Layer* layer;
+        PageStore::Entry entry;
+        size_t count;
+        std::shared_ptr<MappedPageStore> store;
+    };
+
+    /**
+     * Lets the moved layers read from the written file, and detaches the stores of the old file if it is replaced
+     */
+    static void moveLayers(const std::vector<MovedLayer>& movedLayers,
+                           const std::shared_ptr<MappedPageStore>& newStore, const fs::path& filepath);
+
+private:
+    std::ofstream out;
+    uint64_t offset = 0;
+
+    std::string errorMessage;
+};
@@ -21,6 +21,7 @@
 #include "model/Text.h"
 
 #include "PathUtil.h"
+#include "Tracing.h"
 #include "i18n.h"
 
 SaveHandler::SaveHandler() {
@@ -310,8 +311,13 @@ void SaveHandler::writeBackgroundName(XmlNode* background, PageRef p) {
     }
 }
 
+void SaveHandler::setCompression(int level, int threads) {
+    this->compressionLevel = level;
+    this->compressionThreads = threads;
+}
+
 void SaveHandler::saveTo(const fs::path& filepath, ProgressListener* listener) {
-    GzOutputStream out(filepath);
+    GzOutputStream out(filepath, this->compressionLevel, this->compressionThreads);
 
     if (!out.getLastError().empty()) {
         this->errorMessage = out.getLastError();
@@ -328,6 +334,7 @@ void SaveHandler::saveTo(const fs::path& filepath, ProgressListener* listener) {
 }
 
 void SaveHandler::saveTo(OutputStream* out, const fs::path& filepath, ProgressListener* listener) {
+    XOJ_TRACE_SCOPE("SaveHandler::saveTo");
     // XMLNode should be locale-safe ( store doubles using Locale 'C' format
 
     out->write("<?xml version=\"1.0\" standalone=\"no\"?>\n");
@@ -37,6 +37,13 @@ public:
     void saveTo(OutputStream* out, const fs::path& filepath, ProgressListener* listener = nullptr);
     std::string getErrorMessage();
 
+    /**
+     * @brief Set how saveTo(filepath) compresses the file
+     * @param level The zlib compression level, Z_BEST_SPEED for autosaves, Z_DEFAULT_COMPRESSION for manual saves
+     * @param threads The number of threads compressing the file, 0 to use all processors
+     */
+    void setCompression(int level, int threads = 0);
+
 protected:
     static std::string getColorStr(Color c, unsigned char alpha = 0xff);
 
@@ -56,6 +63,8 @@ protected:
 
 protected:
     XmlNode* root;
+    int compressionLevel = Z_DEFAULT_COMPRESSION;
+    int compressionThreads = 0;
     bool firstPdfPageVisited;
     int attachBgId;
 
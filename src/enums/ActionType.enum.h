@@ -204,6 +204,7 @@ enum ActionType {
     // Menu Help
     ACTION_ABOUT = 800,
     ACTION_HELP,
+    ACTION_MEMORY_REPORT,
 
     // Footer, not really an action, but need an identifier too
     ACTION_FOOTER_PAGESPIN = 900,
@@ -592,6 +592,10 @@ auto ActionType_fromString(const string& value) -> ActionType {
         return ACTION_HELP;
     }
 
+    if (value == "ACTION_MEMORY_REPORT") {
+        return ACTION_MEMORY_REPORT;
+    }
+
     if (value == "ACTION_FOOTER_PAGESPIN") {
         return ACTION_FOOTER_PAGESPIN;
     }
@@ -1190,6 +1194,10 @@ auto ActionType_toString(ActionType value) -> string {
         return "ACTION_HELP";
     }
 
+    if (value == ACTION_MEMORY_REPORT) {
+        return "ACTION_MEMORY_REPORT";
+    }
+
     if (value == ACTION_FOOTER_PAGESPIN) {
         return "ACTION_FOOTER_PAGESPIN";
     }
@@ -810,6 +810,13 @@ void XojPageView::paintPageSync(cairo_t* cr, GdkRectangle* rect) {
         cairo_restore(cr);
     }
 
+    if (this->xournal->getControl()->getAudioController()->hasHighlight()) {
+        cairo_save(cr);
+        cairo_scale(cr, zoom, zoom);
+        paintAudioHighlight(cr);
+        cairo_restore(cr);
+    }
+
     if (this->inputHandler) {
         int dpiScaleFactor = xournal->getDpiScaleFactor();
         cairo_scale(cr, 1.0 / dpiScaleFactor, 1.0 / dpiScaleFactor);
@@ -817,6 +824,19 @@ void XojPageView::paintPageSync(cairo_t* cr, GdkRectangle* rect) {
     }
 }
 
+void XojPageView::paintAudioHighlight(cairo_t* cr) {
+    AudioController* audio = this->xournal->getControl()->getAudioController();
+
+    GdkRGBA color = getSelectionColor();
+    cairo_set_source_rgba(cr, color.red, color.green, color.blue, 0.3);
+
+    // The index keeps the bounds, so neither all elements are visited nor unloaded layers loaded
+    for (const Rectangle<double>& bounds: audio->getHighlightedBounds(this->page)) {
+        cairo_rectangle(cr, bounds.x, bounds.y, bounds.width, bounds.height);
+    }
+    cairo_fill(cr);
+}
+
 auto XojPageView::paintPage(cairo_t* cr, GdkRectangle* rect) -> bool {
     g_mutex_lock(&this->drawingMutex);
 
@@ -839,6 +859,8 @@ auto XojPageView::getBufferPixels() -> int {
     return 0;
 }
 
+auto XojPageView::getMemoryFootprint() const -> size_t { return getSurfaceSize(this->crBuffer); }
+
 auto XojPageView::getSelectionColor() -> GdkRGBA { return Util::rgb_to_GdkRGBA(settings->getSelectionColor()); }
 
 auto XojPageView::getTextEditor() -> TextEditor* { return textEditor; }
@@ -18,6 +18,7 @@
 #include "model/TexImage.h"
 
 #include "Layout.h"
+#include "MemoryAccountable.h"
 #include "Range.h"
 #include "Redrawable.h"
 
@@ -32,7 +33,7 @@ class TextEditor;
 class VerticalToolHandler;
 class XournalView;
 
-class XojPageView: public Redrawable, public PageListener {
+class XojPageView: public Redrawable, public PageListener, public MemoryAccountable {
 public:
     XojPageView(XournalView* xournal, const PageRef& page);
     virtual ~XojPageView();
@@ -88,6 +89,11 @@ public:
     GdkRGBA getSelectionColor() override;
     int getBufferPixels();
 
+    /**
+     * The size of the rendered page buffer
+     */
+    size_t getMemoryFootprint() const override;
+
     /**
      * 0 if currently visible
      * -1 if no image is saved (never visible or cleanup)
@@ -184,6 +190,11 @@ private:
 
     void drawLoadingPage(cairo_t* cr);
 
+    /**
+     * Marks the elements written at the current audio playback position, see AudioController::isHighlighted()
+     */
+    void paintAudioHighlight(cairo_t* cr);
+
     void setX(int x);
     void setY(int y);
 
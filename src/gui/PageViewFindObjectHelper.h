@@ -161,7 +161,7 @@ protected:
                     fn = path->string();
                 }
                 auto* ac = view->getXournal()->getControl()->getAudioController();
-                bool success = ac->startPlayback(fn, (unsigned int)ts);
+                bool success = ac->startPlayback(fn, (unsigned int)ts, s->getAudioFilename());
                 playbackStatus = {success, fn};
                 return success;
             }
@@ -4,6 +4,7 @@
 #include <cmath>
 #include <memory>
 #include <tuple>
+#include <unordered_set>
 
 #include <gdk/gdk.h>
 
@@ -14,6 +15,7 @@
 #include "model/Document.h"
 #include "model/Stroke.h"
 #include "undo/DeleteUndoAction.h"
+#include "undo/UndoRedoHandler.h"
 #include "widgets/XournalWidget.h"
 
 #include "Layout.h"
@@ -94,6 +96,7 @@ void XournalView::staticLayoutPages(GtkWidget* widget, GtkAllocation* allocation
 
 auto XournalView::clearMemoryTimer(XournalView* widget) -> gboolean {
     widget->cleanupBufferCache();
+    widget->unloadPages();
     return true;
 }
 
@@ -111,6 +114,48 @@ auto XournalView::cleanupBufferCache() -> void {
     }
 }
 
+void XournalView::unloadPages() {
+    Settings* settings = this->control->getSettings();
+    if (!settings->isUnloadPages()) {
+        return;
+    }
+
+    Document* doc = this->control->getDocument();
+    if (!doc->tryLock()) {
+        // Busy, e.g. saving, try again with the next timer
+        return;
+    }
+
+    std::unordered_set<XojPage*> referenced;
+    for (const PageRef& p: this->control->getUndoRedoHandler()->getReferencedPages()) {
+        referenced.insert(p.get());
+    }
+    if (EditSelection* selection = getSelection()) {
+        referenced.insert(selection->getSourcePage().get());
+    }
+
+    // Serializing is done in the UI thread, so limit the time spent per timer
+    constexpr gint64 TIME_LIMIT_US = 50000;
+    const gint64 start = g_get_monotonic_time();
+    const auto distance = static_cast<size_t>(std::max(settings->getUnloadPagesDistance(), 1));
+    std::shared_ptr<PageStore> store = doc->getPageStore();
+
+    for (size_t i = 0; i < this->viewPages.size() && g_get_monotonic_time() - start < TIME_LIMIT_US; i++) {
+        XojPageView* view = this->viewPages[i];
+        bool near = i + distance >= this->currentPage && i <= this->currentPage + distance;
+        if (near || view->getLastVisibleTime() == 0 || view->getTextEditor() != nullptr) {
+            continue;
+        }
+
+        PageRef page = view->getPage();
+        if (page->isLoaded() && referenced.count(page.get()) == 0) {
+            page->unloadContents(store);
+        }
+    }
+
+    doc->unlock();
+}
+
 auto XournalView::getCurrentPage() const -> size_t { return currentPage; }
 
 const int scrollKeySize = 30;
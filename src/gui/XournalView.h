@@ -148,6 +148,13 @@ private:
 
     void cleanupBufferCache();
 
+    /**
+     * Moves the contents of pages far from the current page to the page store of the document, if enabled
+     * in the settings. Pages referenced by undo, a selection or a text editor stay loaded.
+     * Unloaded pages are loaded again on their next access, e.g. when they are drawn.
+     */
+    void unloadPages();
+
     static void staticLayoutPages(GtkWidget* widget, GtkAllocation* allocation, void* data);
 
 private:
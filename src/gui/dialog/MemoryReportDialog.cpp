@@ -0,0 +1,32 @@
+#include "MemoryReportDialog.h"
+
+#include <sstream>
+
+#include "control/Control.h"
+
+namespace {
+constexpr int RESPONSE_REFRESH = 1;
+}
+
+MemoryReportDialog::MemoryReportDialog(GladeSearchpath* gladeSearchPath, Control* control):
+        GladeGui(gladeSearchPath, "memoryReport.glade", "memoryReportDialog"), control(control) {}
+
+MemoryReportDialog::~MemoryReportDialog() = default;
+
+void MemoryReportDialog::refresh() {
+    std::ostringstream text;
+    this->control->createMemoryReport().writeText(text);
+
+    GtkTextBuffer* buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(get("txtReport")));
+    gtk_text_buffer_set_text(buffer, text.str().c_str(), -1);
+}
+
+void MemoryReportDialog::show(GtkWindow* parent) {
+    gtk_window_set_transient_for(GTK_WINDOW(this->window), parent);
+
+    do {
+        refresh();
+    } while (gtk_dialog_run(GTK_DIALOG(this->window)) == RESPONSE_REFRESH);
+
+    gtk_widget_hide(this->window);
+}
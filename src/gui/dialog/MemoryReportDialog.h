@@ -0,0 +1,34 @@
+/*
+ * Xournal++
+ *
+ * Shows the memory used by the document, views and caches
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include "gui/GladeGui.h"
+
+class Control;
+
+class MemoryReportDialog: public GladeGui {
+public:
+    MemoryReportDialog(GladeSearchpath* gladeSearchPath, Control* control);
+    ~MemoryReportDialog() override;
+
+public:
+    void show(GtkWindow* parent) override;
+
+private:
+    /**
+     * Collects a new report and shows it
+     */
+    void refresh();
+
+private:
+    Control* control;
+};
@@ -7,6 +7,7 @@
 #include "util/DeviceListHelper.h"
 
 #include "InputEvents.h"
+#include "Tracing.h"
 
 InputContext::InputContext(XournalView* view, ScrollHandling* scrollHandling) {
     this->view = view;
@@ -66,6 +67,7 @@ auto InputContext::eventCallback(GtkWidget* widget, GdkEvent* event, InputContex
 }
 
 auto InputContext::handle(GdkEvent* sourceEvent) -> bool {
+    XOJ_TRACE_SCOPE("InputContext::handle");
     printDebug(sourceEvent);
 
     InputEvent event = InputEvents::translateEvent(sourceEvent, this->getSettings());
@@ -10,6 +10,8 @@ AbstractSidebarPage::~AbstractSidebarPage() {
 
 void AbstractSidebarPage::selectPageNr(size_t page, size_t pdfPage) {}
 
+auto AbstractSidebarPage::getMemoryFootprint() const -> size_t { return 0; }
+
 auto AbstractSidebarPage::getControl() -> Control* { return this->control; }
 
 void AbstractSidebarPage::setTmpDisabled(bool disabled) {
@@ -20,11 +20,13 @@
 #include "model/DocumentChangeType.h"
 #include "model/DocumentListener.h"
 
+#include "MemoryAccountable.h"
+
 
 class Control;
 class SidebarToolbar;
 
-class AbstractSidebarPage: public DocumentListener, public SidebarToolbarActionListener {
+class AbstractSidebarPage: public DocumentListener, public SidebarToolbarActionListener, public MemoryAccountable {
 public:
     AbstractSidebarPage(Control* control, SidebarToolbar* toolbar);
     virtual ~AbstractSidebarPage();
@@ -63,6 +65,11 @@ public:
      */
     virtual void selectPageNr(size_t page, size_t pdfPage);
 
+    /**
+     * The memory used by the buffers of this sidebar page, 0 if it has none
+     */
+    size_t getMemoryFootprint() const override;
+
     /**
      * Returns the Application controller
      */
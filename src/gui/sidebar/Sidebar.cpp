@@ -154,6 +154,14 @@ void Sidebar::saveSize() {
 
 auto Sidebar::getToolbar() -> SidebarToolbar* { return &this->toolbar; }
 
+auto Sidebar::getMemoryFootprint() const -> size_t {
+    size_t bytes = 0;
+    for (AbstractSidebarPage* p: this->pages) {
+        bytes += p->getMemoryFootprint();
+    }
+    return bytes;
+}
+
 auto Sidebar::getControl() -> Control* { return this->control; }
 
 void Sidebar::documentChanged(DocumentChangeType type) {
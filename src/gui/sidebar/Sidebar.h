@@ -19,12 +19,14 @@
 #include "model/DocumentChangeType.h"
 #include "model/DocumentListener.h"
 
+#include "MemoryAccountable.h"
+
 class AbstractSidebarPage;
 class Control;
 class GladeGui;
 class SidebarPageButton;
 
-class Sidebar: public DocumentListener, public SidebarToolbarActionListener {
+class Sidebar: public DocumentListener, public SidebarToolbarActionListener, public MemoryAccountable {
 public:
     Sidebar(GladeGui* gui, Control* control);
     virtual ~Sidebar();
@@ -73,6 +75,11 @@ public:
      */
     SidebarToolbar* getToolbar();
 
+    /**
+     * The memory used by the previews of all sidebar pages
+     */
+    size_t getMemoryFootprint() const override;
+
 public:
     // DocumentListener interface
     virtual void documentChanged(DocumentChangeType type);
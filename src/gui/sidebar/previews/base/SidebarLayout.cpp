@@ -44,7 +44,7 @@ public:
 
     auto getWidth() const -> int { return this->currentWidth; }
 
-    auto placeAt(int y, GtkLayout* layout) -> int {
+    auto placeAt(int y) -> int {
         int height = 0;
         int x = 0;
 
@@ -56,7 +56,7 @@ public:
         for (SidebarPreviewBaseEntry* p: this->list) {
             int currentY = (height - p->getHeight()) / 2;
 
-            gtk_layout_move(layout, p->getWidget(), x, y + currentY);
+            p->setLayoutPosition(x, y + currentY);
 
             x += p->getWidth();
         }
@@ -86,7 +86,7 @@ void SidebarLayout::layout(SidebarPreviewBase* sidebar) {
         if (row.isSpaceFor(p)) {
             row.add(p);
         } else {
-            y += row.placeAt(y, GTK_LAYOUT(sidebar->iconViewPreview));
+            y += row.placeAt(y);
 
             width = std::max(width, row.getWidth());
 
@@ -96,7 +96,7 @@ void SidebarLayout::layout(SidebarPreviewBase* sidebar) {
     }
 
     if (row.getCount() != 0) {
-        y += row.placeAt(y, GTK_LAYOUT(sidebar->iconViewPreview));
+        y += row.placeAt(y);
 
         width = std::max(width, row.getWidth());
 
@@ -104,4 +104,6 @@ void SidebarLayout::layout(SidebarPreviewBase* sidebar) {
     }
 
     gtk_layout_set_size(GTK_LAYOUT(sidebar->iconViewPreview), width, y);
+
+    sidebar->updateVisibleEntries();
 }
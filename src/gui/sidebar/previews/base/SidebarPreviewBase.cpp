@@ -6,6 +6,11 @@
 #include "SidebarLayout.h"
 #include "SidebarPreviewBaseEntry.h"
 
+/**
+ * Maximum number of hidden widgets kept for reuse
+ */
+constexpr size_t MAX_RECYCLED_WIDGETS = 32;
+
 
 SidebarPreviewBase::SidebarPreviewBase(Control* control, GladeGui* gui, SidebarToolbar* toolbar):
         AbstractSidebarPage(control, toolbar) {
@@ -32,10 +37,28 @@ SidebarPreviewBase::SidebarPreviewBase(Control* control, GladeGui* gui, SidebarT
 
     g_signal_connect(this->scrollPreview, "size-allocate", G_CALLBACK(sizeChanged), this);
 
+    GtkAdjustment* vadj = gtk_scrolled_window_get_vadjustment(GTK_SCROLLED_WINDOW(this->scrollPreview));
+    g_signal_connect(vadj, "value-changed", G_CALLBACK(scrollChanged), this);
+    g_signal_connect(vadj, "changed", G_CALLBACK(scrollChanged), this);
+
     gtk_widget_show_all(this->scrollPreview);
 }
 
 SidebarPreviewBase::~SidebarPreviewBase() {
+    GtkAdjustment* vadj = gtk_scrolled_window_get_vadjustment(GTK_SCROLLED_WINDOW(this->scrollPreview));
+    g_signal_handlers_disconnect_by_data(vadj, this);
+
+    for (SidebarPreviewBaseEntry* p: this->previews) {
+        delete p;
+    }
+    this->previews.clear();
+
+    for (GtkWidget* w: this->recycledWidgets) {
+        gtk_widget_destroy(w);
+        g_object_unref(w);
+    }
+    this->recycledWidgets.clear();
+
     gtk_widget_destroy(this->iconViewPreview);
     this->iconViewPreview = nullptr;
 
@@ -46,11 +69,6 @@ SidebarPreviewBase::~SidebarPreviewBase() {
     this->layoutmanager = nullptr;
 
     this->scrollPreview = nullptr;
-
-    for (SidebarPreviewBaseEntry* p: this->previews) {
-        delete p;
-    }
-    this->previews.clear();
 }
 
 void SidebarPreviewBase::enableSidebar() { enabled = true; }
@@ -67,13 +85,79 @@ void SidebarPreviewBase::sizeChanged(GtkWidget* widget, GtkAllocation* allocatio
     if (std::abs(lastWidth - allocation->width) > 20) {
         sidebar->layout();
         lastWidth = allocation->width;
+    } else {
+        sidebar->updateVisibleEntries();
     }
 }
 
+void SidebarPreviewBase::scrollChanged(GtkAdjustment* adjustment, SidebarPreviewBase* sidebar) {
+    sidebar->updateVisibleEntries();
+}
+
+void SidebarPreviewBase::updateVisibleEntries() {
+    GtkAdjustment* vadj = gtk_scrolled_window_get_vadjustment(GTK_SCROLLED_WINDOW(this->scrollPreview));
+    double pageSize = gtk_adjustment_get_page_size(vadj);
+    double value = gtk_adjustment_get_value(vadj);
+
+    // Keep one screen above and below realized, so scrolling does not show empty entries
+    double top = value - pageSize;
+    double bottom = value + 2 * pageSize;
+
+    // Unrealize first, so the freed widgets can be reused for the newly visible entries
+    std::vector<SidebarPreviewBaseEntry*> visible;
+    for (SidebarPreviewBaseEntry* p: this->previews) {
+        int y = p->getLayoutY();
+        if (y + p->getHeight() >= top && y <= bottom) {
+            visible.push_back(p);
+        } else {
+            p->unrealize();
+        }
+    }
+
+    for (SidebarPreviewBaseEntry* p: visible) {
+        p->realize();
+    }
+}
+
+auto SidebarPreviewBase::acquireEntryWidget() -> GtkWidget* {
+    if (!this->recycledWidgets.empty()) {
+        GtkWidget* w = this->recycledWidgets.back();
+        this->recycledWidgets.pop_back();
+        return w;
+    }
+
+    GtkWidget* w = SidebarPreviewBaseEntry::createWidget();
+    gtk_layout_put(GTK_LAYOUT(this->iconViewPreview), w, 0, 0);
+    return w;
+}
+
+void SidebarPreviewBase::releaseEntryWidget(GtkWidget* widget) {
+    if (this->recycledWidgets.size() >= MAX_RECYCLED_WIDGETS) {
+        gtk_widget_destroy(widget);
+        g_object_unref(widget);
+        return;
+    }
+
+    gtk_widget_hide(widget);
+    this->recycledWidgets.push_back(widget);
+}
+
+void SidebarPreviewBase::moveEntryWidget(GtkWidget* widget, int x, int y) {
+    gtk_layout_move(GTK_LAYOUT(this->iconViewPreview), widget, x, y);
+}
+
 auto SidebarPreviewBase::getZoom() const -> double { return this->zoom; }
 
 auto SidebarPreviewBase::getCache() -> PdfCache* { return this->cache; }
 
+auto SidebarPreviewBase::getMemoryFootprint() const -> size_t {
+    size_t bytes = this->cache->getMemoryFootprint();
+    for (SidebarPreviewBaseEntry* p: this->previews) {
+        bytes += p->getMemoryFootprint();
+    }
+    return bytes;
+}
+
 void SidebarPreviewBase::layout() { SidebarLayout::layout(this); }
 
 auto SidebarPreviewBase::hasData() -> bool { return true; }
@@ -105,23 +189,14 @@ auto SidebarPreviewBase::scrollToPreview(SidebarPreviewBase* sidebar) -> bool {
     if (sidebar->selectedEntry != npos && sidebar->selectedEntry < sidebar->previews.size()) {
         SidebarPreviewBaseEntry* p = sidebar->previews[sidebar->selectedEntry];
 
-        // scroll to preview
+        // scroll to preview, the layout position is known even if the entry is not realized
         GtkAdjustment* hadj = gtk_scrolled_window_get_hadjustment(GTK_SCROLLED_WINDOW(sidebar->scrollPreview));
         GtkAdjustment* vadj = gtk_scrolled_window_get_vadjustment(GTK_SCROLLED_WINDOW(sidebar->scrollPreview));
-        GtkWidget* widget = p->getWidget();
-
-        GtkAllocation allocation;
-        gtk_widget_get_allocation(widget, &allocation);
-        int x = allocation.x;
-        int y = allocation.y;
-
-        if (x == -1) {
-            g_idle_add(reinterpret_cast<GSourceFunc>(scrollToPreview), sidebar);
-            return false;
-        }
+        int x = p->getLayoutX();
+        int y = p->getLayoutY();
 
-        gtk_adjustment_clamp_page(vadj, y, y + allocation.height);
-        gtk_adjustment_clamp_page(hadj, x, x + allocation.width);
+        gtk_adjustment_clamp_page(vadj, y, y + p->getHeight());
+        gtk_adjustment_clamp_page(hadj, x, x + p->getWidth());
     }
     return false;
 }
@@ -64,6 +64,32 @@ public:
      */
     PdfCache* getCache();
 
+    /**
+     * The preview buffers of all entries and the PDF cache
+     */
+    size_t getMemoryFootprint() const override;
+
+    /**
+     * Realizes the entries within or near the visible area and unrealizes all others,
+     * so the number of widgets and preview buffers does not depend on the page count
+     */
+    void updateVisibleEntries();
+
+    /**
+     * Takes a widget from the recycle pool, or creates a new one, already placed in the layout
+     */
+    GtkWidget* acquireEntryWidget();
+
+    /**
+     * Hides the widget of an unrealized entry and keeps it for reuse
+     */
+    void releaseEntryWidget(GtkWidget* widget);
+
+    /**
+     * Moves a preview widget within the layout
+     */
+    void moveEntryWidget(GtkWidget* widget, int x, int y);
+
 public:
     // DocumentListener interface (only the part handled by SidebarPreviewBase)
     virtual void documentChanged(DocumentChangeType type);
@@ -81,6 +107,11 @@ protected:
      */
     static void sizeChanged(GtkWidget* widget, GtkAllocation* allocation, SidebarPreviewBase* sidebar);
 
+    /**
+     * The sidebar was scrolled
+     */
+    static void scrollChanged(GtkAdjustment* adjustment, SidebarPreviewBase* sidebar);
+
 private:
     /**
      * The scrollbar with the icons
@@ -102,6 +133,11 @@ private:
      */
     SidebarLayout* layoutmanager = nullptr;
 
+    /**
+     * Widgets of unrealized entries, kept hidden in the layout for reuse
+     */
+    std::vector<GtkWidget*> recycledWidgets;
+
 
     // Members also used by subclasses
 protected:
@@ -8,16 +8,36 @@
 
 SidebarPreviewBaseEntry::SidebarPreviewBaseEntry(SidebarPreviewBase* sidebar, const PageRef& page):
         sidebar(sidebar), page(page) {
-    this->widget = gtk_button_new();  // re: issue 1072
+    g_mutex_init(&this->drawingMutex);
+}
 
-    gtk_widget_show(this->widget);
-    g_object_ref(this->widget);
+SidebarPreviewBaseEntry::~SidebarPreviewBaseEntry() {
+    this->sidebar->getControl()->getScheduler()->removeSidebar(this);
 
-    g_mutex_init(&this->drawingMutex);
+    if (this->widget) {
+        g_signal_handlers_disconnect_by_data(this->widget, this);
+        this->sidebar->releaseEntryWidget(this->widget);
+        this->widget = nullptr;
+    }
+    this->page = nullptr;
 
-    updateSize();
-    gtk_widget_set_events(widget, GDK_EXPOSURE_MASK);
+    if (this->crBuffer) {
+        cairo_surface_destroy(this->crBuffer);
+        this->crBuffer = nullptr;
+    }
+
+    g_mutex_clear(&this->drawingMutex);
+}
+
+auto SidebarPreviewBaseEntry::createWidget() -> GtkWidget* {
+    GtkWidget* w = gtk_button_new();  // re: issue 1072
+    g_object_ref(w);
+    gtk_widget_set_events(w, GDK_EXPOSURE_MASK);
+    gtk_widget_show(w);
+    return w;
+}
 
+void SidebarPreviewBaseEntry::connectSignals() {
     g_signal_connect(this->widget, "draw", G_CALLBACK(drawCallback), this);
 
     g_signal_connect(this->widget, "clicked", G_CALLBACK(+[](GtkWidget* widget, SidebarPreviewBaseEntry* self) {
@@ -27,19 +47,67 @@ SidebarPreviewBaseEntry::SidebarPreviewBaseEntry(SidebarPreviewBase* sidebar, co
                      this);
 }
 
-SidebarPreviewBaseEntry::~SidebarPreviewBaseEntry() {
+void SidebarPreviewBaseEntry::realize() {
+    if (this->widget) {
+        return;
+    }
+
+    GtkWidget* w = this->sidebar->acquireEntryWidget();
+
+    g_mutex_lock(&this->drawingMutex);
+    this->widget = w;
+    g_mutex_unlock(&this->drawingMutex);
+
+    connectSignals();
+    updateSize();
+    this->sidebar->moveEntryWidget(getWidget(), this->layoutX, this->layoutY);
+    gtk_widget_show(this->widget);
+}
+
+void SidebarPreviewBaseEntry::unrealize() {
+    if (this->widget == nullptr) {
+        return;
+    }
+
+    // A running preview job may still reference the widget
     this->sidebar->getControl()->getScheduler()->removeSidebar(this);
-    this->page = nullptr;
 
-    gtk_widget_destroy(this->widget);
+    g_mutex_lock(&this->drawingMutex);
+    GtkWidget* w = this->widget;
     this->widget = nullptr;
-
     if (this->crBuffer) {
         cairo_surface_destroy(this->crBuffer);
         this->crBuffer = nullptr;
     }
+    this->previewRendered = false;
+    g_mutex_unlock(&this->drawingMutex);
+
+    g_signal_handlers_disconnect_by_data(w, this);
+    this->sidebar->releaseEntryWidget(w);
+}
+
+auto SidebarPreviewBaseEntry::isRealized() const -> bool { return this->widget != nullptr; }
+
+auto SidebarPreviewBaseEntry::getMemoryFootprint() const -> size_t {
+    g_mutex_lock(&this->drawingMutex);
+    size_t bytes = getSurfaceSize(this->crBuffer);
+    g_mutex_unlock(&this->drawingMutex);
+    return bytes;
 }
 
+void SidebarPreviewBaseEntry::setLayoutPosition(int x, int y) {
+    this->layoutX = x;
+    this->layoutY = y;
+
+    if (this->widget) {
+        this->sidebar->moveEntryWidget(getWidget(), x, y);
+    }
+}
+
+auto SidebarPreviewBaseEntry::getLayoutX() const -> int { return this->layoutX; }
+
+auto SidebarPreviewBaseEntry::getLayoutY() const -> int { return this->layoutY; }
+
 auto SidebarPreviewBaseEntry::drawCallback(GtkWidget* widget, cairo_t* cr, SidebarPreviewBaseEntry* preview)
         -> gboolean {
     preview->paint(cr);
@@ -52,16 +120,29 @@ void SidebarPreviewBaseEntry::setSelected(bool selected) {
     }
     this->selected = selected;
 
-    gtk_widget_queue_draw(this->widget);
+    if (this->widget) {
+        gtk_widget_queue_draw(this->widget);
+    }
 }
 
-void SidebarPreviewBaseEntry::repaint() { sidebar->getControl()->getScheduler()->addRepaintSidebar(this); }
+void SidebarPreviewBaseEntry::repaint() {
+    if (this->widget == nullptr) {
+        // Not visible, the preview is rendered as soon as the entry is realized and drawn
+        g_mutex_lock(&this->drawingMutex);
+        if (this->crBuffer) {
+            cairo_surface_destroy(this->crBuffer);
+            this->crBuffer = nullptr;
+        }
+        this->previewRendered = false;
+        g_mutex_unlock(&this->drawingMutex);
+        return;
+    }
 
-void SidebarPreviewBaseEntry::drawLoadingPage() {
-    GtkAllocation alloc;
-    gtk_widget_get_allocation(widget, &alloc);
+    sidebar->getControl()->getScheduler()->addRepaintSidebar(this);
+}
 
-    this->crBuffer = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, alloc.width, alloc.height);
+void SidebarPreviewBaseEntry::drawLoadingPage() {
+    this->crBuffer = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, getWidgetWidth(), getWidgetHeight());
 
     double zoom = sidebar->getZoom();
 
@@ -130,7 +211,9 @@ void SidebarPreviewBaseEntry::paint(cairo_t* cr) {
 }
 
 void SidebarPreviewBaseEntry::updateSize() {
-    gtk_widget_set_size_request(this->widget, getWidgetWidth(), getWidgetHeight());
+    if (this->widget) {
+        gtk_widget_set_size_request(this->widget, getWidgetWidth(), getWidgetHeight());
+    }
 }
 
 auto SidebarPreviewBaseEntry::getWidgetWidth() -> int {
@@ -18,6 +18,7 @@
 
 #include "model/PageRef.h"
 
+#include "MemoryAccountable.h"
 #include "Util.h"
 
 
@@ -41,10 +42,10 @@ typedef enum {
 } PreviewRenderType;
 
 
-class SidebarPreviewBaseEntry {
+class SidebarPreviewBaseEntry: public MemoryAccountable {
 public:
     SidebarPreviewBaseEntry(SidebarPreviewBase* sidebar, const PageRef& page);
-    virtual ~SidebarPreviewBaseEntry();
+    ~SidebarPreviewBaseEntry() override;
 
 public:
     virtual GtkWidget* getWidget();
@@ -56,6 +57,42 @@ public:
     virtual void repaint();
     virtual void updateSize();
 
+    /**
+     * Attaches a widget to this entry, either recycled from the sidebar or newly created,
+     * and shows it at the layout position. Entries are only realized while they are in or
+     * near the visible area of the sidebar.
+     */
+    virtual void realize();
+
+    /**
+     * Returns the widget to the sidebar for reuse and drops the rendered preview.
+     * The preview is rendered again once the entry gets realized.
+     */
+    virtual void unrealize();
+
+    /**
+     * @return true if the entry currently has a widget
+     */
+    bool isRealized() const;
+
+    /**
+     * The size of the rendered preview buffer
+     */
+    size_t getMemoryFootprint() const override;
+
+    /**
+     * Sets the position of the entry within the sidebar, moves the widget if realized
+     */
+    void setLayoutPosition(int x, int y);
+
+    int getLayoutX() const;
+    int getLayoutY() const;
+
+    /**
+     * Creates a new preview widget, with a reference held by the caller
+     */
+    static GtkWidget* createWidget();
+
     /**
      * @return What should be rendered
      */
@@ -67,6 +104,11 @@ private:
 protected:
     virtual void mouseButtonPressCallback() = 0;
 
+    /**
+     * Connects the signals of the (possibly recycled) widget to this entry
+     */
+    virtual void connectSignals();
+
     virtual int getWidgetWidth();
     virtual int getWidgetHeight();
 
@@ -93,17 +135,28 @@ protected:
     /**
      * Mutex
      */
-    GMutex drawingMutex{};
+    mutable GMutex drawingMutex{};
+
+    /**
+     * The Widget which is used for drawing, nullptr if the entry is not realized
+     */
+    GtkWidget* widget = nullptr;
 
     /**
-     * The Widget which is used for drawing
+     * Position within the sidebar layout
      */
-    GtkWidget* widget;
+    int layoutX = 0;
+    int layoutY = 0;
 
     /**
      * Buffer because of performance reasons
      */
     cairo_surface_t* crBuffer = nullptr;
 
+    /**
+     * If crBuffer contains a preview from a PreviewJob, not the loading page. Reset when the preview is dropped.
+     */
+    bool previewRendered = false;
+
     friend class PreviewJob;
 };
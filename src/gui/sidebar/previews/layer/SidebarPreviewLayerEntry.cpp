@@ -1,5 +1,6 @@
 #include "SidebarPreviewLayerEntry.h"
 
+#include "control/Control.h"
 #include "gui/Shadow.h"
 #include "gui/sidebar/previews/layer/SidebarPreviewLayers.h"
 
@@ -13,6 +14,11 @@ SidebarPreviewLayerEntry::SidebarPreviewLayerEntry(SidebarPreviewBase* sidebar,
         layer(layer),
         stacked(stacked),
         box(gtk_box_new(GTK_ORIENTATION_VERTICAL, 2)) {
+    // Layer previews are few and carry their own controls, so they are always realized
+    this->widget = createWidget();
+    connectSignals();
+    updateSize();
+
     GtkWidget* toolbar = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 6);
 
     cbVisible = gtk_check_button_new_with_label(layerName.c_str());
@@ -40,10 +46,19 @@ SidebarPreviewLayerEntry::SidebarPreviewLayerEntry(SidebarPreviewBase* sidebar,
 }
 
 SidebarPreviewLayerEntry::~SidebarPreviewLayerEntry() {
+    this->sidebar->getControl()->getScheduler()->removeSidebar(this);
+
     gtk_widget_destroy(this->box);
     this->box = nullptr;
+
+    g_object_unref(this->widget);
+    this->widget = nullptr;
 }
 
+void SidebarPreviewLayerEntry::realize() {}
+
+void SidebarPreviewLayerEntry::unrealize() {}
+
 void SidebarPreviewLayerEntry::checkboxToggled() {
     if (inUpdate) {
         return;
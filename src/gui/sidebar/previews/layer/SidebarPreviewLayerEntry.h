@@ -38,6 +38,13 @@ public:
 
     virtual GtkWidget* getWidget();
 
+    /**
+     * Layer entries are never virtualized
+     * @override
+     */
+    virtual void realize();
+    virtual void unrealize();
+
     /**
      * Set the value of the visible checkbox
      */
@@ -0,0 +1,217 @@
+#include "AudioIndex.h"
+
+#include <algorithm>
+#include <iterator>
+#include <unordered_map>
+
+#include "Document.h"
+#include "Layer.h"
+#include "XojPage.h"
+
+AudioIndex::PageEntry::PageEntry(AudioIndex* index, PageRef page): index(index), page(std::move(page)) {
+    registerListener(this->page);
+}
+
+void AudioIndex::PageEntry::rangeChanged(Range& range) { invalidate(); }
+
+void AudioIndex::PageEntry::elementChanged(Element* elem) { invalidate(); }
+
+void AudioIndex::PageEntry::pageChanged() { invalidate(); }
+
+void AudioIndex::PageEntry::invalidate() {
+    this->dirty = true;
+    this->index->dirty = true;
+}
+
+void AudioIndex::PageEntry::scan() {
+    // Unloaded layers keep their audio references, so they are not loaded for the index
+    this->elements.clear();
+    const std::vector<Layer*>& layers = *this->page->getLayers();
+    for (size_t l = 0; l < layers.size(); l++) {
+        for (Layer::AudioReference& reference: layers[l]->getAudioReferences()) {
+            this->elements[reference.filename].push_back({reference.timestamp, reference.bounds, l});
+        }
+    }
+    for (auto& [filename, references]: this->elements) {
+        std::stable_sort(references.begin(), references.end(),
+                         [](const Reference& a, const Reference& b) { return a.timestamp < b.timestamp; });
+    }
+    this->dirty = false;
+}
+
+AudioIndex::AudioIndex(Document* doc): doc(doc) {}
+
+AudioIndex::~AudioIndex() = default;
+
+void AudioIndex::syncPages() {
+    size_t count = this->doc->getPageCount();
+    bool same = this->pages.size() == count;
+    for (size_t i = 0; same && i < count; i++) {
+        same = this->pages[i]->page == this->doc->getPage(i);
+    }
+    if (same) {
+        return;
+    }
+
+    // Keep the entries of pages which were only moved
+    std::unordered_map<XojPage*, std::unique_ptr<PageEntry>> old;
+    for (auto& entry: this->pages) {
+        XojPage* p = entry->page.get();
+        old.emplace(p, std::move(entry));
+    }
+
+    this->pages.clear();
+    this->pages.reserve(count);
+    this->entries.clear();
+    for (size_t i = 0; i < count; i++) {
+        PageRef page = this->doc->getPage(i);
+        auto it = old.find(page.get());
+        if (it != old.end() && it->second) {
+            this->pages.push_back(std::move(it->second));
+        } else {
+            this->pages.push_back(std::make_unique<PageEntry>(this, page));
+        }
+        this->entries[page.get()] = this->pages.back().get();
+    }
+}
+
+void AudioIndex::update() {
+    if (!this->dirty) {
+        return;
+    }
+
+    // Do not block the GUI while a job holds the document, the last state is used until then
+    if (!this->doc->tryLock()) {
+        return;
+    }
+    syncPages();
+    for (auto& entry: this->pages) {
+        if (entry->dirty) {
+            entry->scan();
+        }
+    }
+    this->doc->unlock();
+
+    this->marks.clear();
+    for (size_t p = 0; p < this->pages.size(); p++) {
+        for (auto const& [filename, references]: this->pages[p]->elements) {
+            std::vector<Mark>& fileMarks = this->marks[filename];
+            for (const PageEntry::Reference& reference: references) {
+                fileMarks.push_back({reference.timestamp, p});
+            }
+        }
+    }
+    for (auto& [filename, fileMarks]: this->marks) {
+        std::stable_sort(fileMarks.begin(), fileMarks.end(),
+                         [](const Mark& a, const Mark& b) { return a.timestamp < b.timestamp; });
+    }
+
+    this->dirty = false;
+}
+
+auto AudioIndex::findPage(const std::string& audioFilename, size_t timestamp) -> size_t {
+    update();
+
+    auto it = this->marks.find(audioFilename);
+    if (it == this->marks.end() || it->second.empty()) {
+        return npos;
+    }
+
+    auto const& fileMarks = it->second;
+    auto mark = std::upper_bound(fileMarks.begin(), fileMarks.end(), timestamp,
+                                 [](size_t ts, const Mark& m) { return ts < m.timestamp; });
+    if (mark == fileMarks.begin()) {
+        return mark->page;
+    }
+    return std::prev(mark)->page;
+}
+
+auto AudioIndex::findPages(const std::string& audioFilename, size_t from, size_t to) -> std::vector<size_t> {
+    update();
+
+    std::vector<size_t> result;
+    auto it = this->marks.find(audioFilename);
+    if (it == this->marks.end()) {
+        return result;
+    }
+
+    auto const& fileMarks = it->second;
+    auto begin = std::lower_bound(fileMarks.begin(), fileMarks.end(), from,
+                                  [](const Mark& m, size_t ts) { return m.timestamp < ts; });
+    auto end = std::upper_bound(begin, fileMarks.end(), to, [](size_t ts, const Mark& m) { return ts < m.timestamp; });
+    for (auto mark = begin; mark != end; ++mark) {
+        result.push_back(mark->page);
+    }
+
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
+
+auto AudioIndex::findElements(const PageRef& page, const std::string& audioFilename, size_t from, size_t to)
+        -> std::vector<Rectangle<double>> {
+    update();
+
+    std::vector<Rectangle<double>> result;
+    auto entry = this->entries.find(page.get());
+    if (entry == this->entries.end()) {
+        return result;
+    }
+    auto it = entry->second->elements.find(audioFilename);
+    if (it == entry->second->elements.end()) {
+        return result;
+    }
+
+    using Reference = PageEntry::Reference;
+    auto const& references = it->second;
+    auto begin = std::lower_bound(references.begin(), references.end(), from,
+                                  [](const Reference& r, size_t ts) { return r.timestamp < ts; });
+    auto end = std::upper_bound(begin, references.end(), to,
+                                [](size_t ts, const Reference& r) { return ts < r.timestamp; });
+
+    const std::vector<Layer*>& layers = *page->getLayers();
+    for (auto reference = begin; reference != end; ++reference) {
+        if (reference->layer < layers.size() && layers[reference->layer]->isVisible()) {
+            result.push_back(reference->bounds);
+        }
+    }
+    return result;
+}
+
+auto AudioIndex::size() -> size_t {
+    update();
+
+    size_t count = 0;
+    for (auto const& [filename, fileMarks]: this->marks) {
+        count += fileMarks.size();
+    }
+    return count;
+}
+
+void AudioIndex::documentChanged(DocumentChangeType type) {
+    if (type == DOCUMENT_CHANGE_PDF_BOOKMARKS) {
+        return;
+    }
+    for (auto& entry: this->pages) {
+        entry->dirty = true;
+    }
+    this->dirty = true;
+}
+
+void AudioIndex::pageChanged(size_t page) {
+    // The entries may not yet follow an insertion or deletion, so look the page up
+    PageRef changed = this->doc->getPage(page);
+    for (auto& entry: this->pages) {
+        if (entry->page == changed) {
+            entry->dirty = true;
+        }
+    }
+    this->dirty = true;
+}
+
+void AudioIndex::pageInserted(size_t page) {
+    // The page list is compared with the document on the next lookup
+    this->dirty = true;
+}
+
+void AudioIndex::pageDeleted(size_t page) { this->dirty = true; }
@@ -0,0 +1,136 @@
+/*
+ * Xournal++
+ *
+ * Index from audio recordings to the pages written while recording
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "DocumentListener.h"
+#include "PageListener.h"
+#include "PageRef.h"
+#include "Rectangle.h"
+
+class Document;
+
+/**
+ * @brief Maps a position in an audio recording to the pages with the elements written at that time
+ *
+ * The index listens to the document and to every page. Changes only mark the affected pages, they are scanned
+ * again on the next lookup. So editing costs nothing while no audio is played, and a lookup after an edit
+ * only scans the changed pages.
+ *
+ * All methods must be called from the GUI thread.
+ */
+class AudioIndex: public DocumentListener {
+public:
+    explicit AudioIndex(Document* doc);
+    ~AudioIndex() override;
+
+    AudioIndex(const AudioIndex&) = delete;
+    AudioIndex& operator=(const AudioIndex&) = delete;
+
+public:
+    /**
+     * @return The page of the last element written at or before the timestamp, or the page of the first element
+     *         if the timestamp is before all elements. npos if no element refers to the recording.
+     */
+    size_t findPage(const std::string& audioFilename, size_t timestamp);
+
+    /**
+     * @return The pages with elements written in [from, to], sorted and without duplicates
+     */
+    std::vector<size_t> findPages(const std::string& audioFilename, size_t from, size_t to);
+
+    /**
+     * @return The bounds of the elements on visible layers of the page which were written in [from, to]. Only the
+     *         matching elements are visited, unloaded layers are not loaded.
+     */
+    std::vector<Rectangle<double>> findElements(const PageRef& page, const std::string& audioFilename, size_t from,
+                                                size_t to);
+
+    /**
+     * @return The number of indexed elements
+     */
+    size_t size();
+
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    // DocumentListener interface
+public:
+    void documentChanged(DocumentChangeType type) override;
+    void pageChanged(size_t page) override;
+    void pageInserted(size_t page) override;
+    void pageDeleted(size_t page) override;
+
+private:
+    /**
+     * The audio elements of one page, marked dirty by the page listener
+     */
+    class PageEntry: public PageListener {
+    public:
+        PageEntry(AudioIndex* index, PageRef page);
+
+        void rangeChanged(Range& range) override;
+        void elementChanged(Element* elem) override;
+        void pageChanged() override;
+
+        void invalidate();
+        void scan();
+
+        AudioIndex* index;
+        PageRef page;
+        bool dirty = true;
+
+        struct Reference {
+            size_t timestamp;
+            Rectangle<double> bounds;
+            size_t layer;
+        };
+
+        /**
+         * The elements by audio filename, sorted by timestamp
+         */
+        std::map<std::string, std::vector<Reference>> elements;
+    };
+
+    struct Mark {
+        size_t timestamp;
+        size_t page;
+    };
+
+    void update();
+    void syncPages();
+
+private:
+    Document* doc;
+
+    std::vector<std::unique_ptr<PageEntry>> pages;
+
+    /**
+     * The entries of pages by page
+     */
+    std::unordered_map<const XojPage*, PageEntry*> entries;
+
+    /**
+     * Audio filename to the marks of all pages, sorted by timestamp
+     */
+    std::map<std::string, std::vector<Mark>> marks;
+
+    /**
+     * Set if any page changed since the marks were built
+     */
+    bool dirty = true;
+};
@@ -1,5 +1,12 @@
 #include "BackgroundImage.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+#include "ImagePyramid.h"
+#include "MimeData.h"
 #include "Stacktrace.h"
 
 /*
@@ -13,25 +20,107 @@
 
 struct BackgroundImage::Content {
     Content(fs::path path, GError** error):
-            path(std::move(path)), pixbuf(gdk_pixbuf_new_from_file(this->path.u8string().c_str(), error)) {}
+            path(std::move(path)), pixbuf(gdk_pixbuf_new_from_file(this->path.u8string().c_str(), error)) {
+        // The file is read again for the export, if it did not change
+        std::error_code sizeError;
+        std::error_code timeError;
+        this->sourceSize = fs::file_size(this->path, sizeError);
+        this->sourceTime = fs::last_write_time(this->path, timeError);
+        if (this->pixbuf && !sizeError && !timeError) {
+            this->sourcePath = this->path;
+        }
+    }
 
     Content(GInputStream* stream, fs::path path, GError** error):
             path(std::move(path)), pixbuf(gdk_pixbuf_new_from_stream(stream, nullptr, error)) {}
 
     ~Content() {
-        g_object_unref(this->pixbuf);
-        this->pixbuf = nullptr;
+        if (this->surface) {
+            cairo_surface_destroy(this->surface);
+            this->surface = nullptr;
+        }
+        if (this->pixbuf) {
+            g_object_unref(this->pixbuf);
+            this->pixbuf = nullptr;
+        }
     };
 
     Content(const Content&) = delete;
-    Content(Content&&) = default;
+    Content(Content&&) = delete;
     auto operator=(const Content&) -> Content& = delete;
-    auto operator=(Content &&) -> Content& = default;
+    auto operator=(Content &&) -> Content& = delete;
+
+    /**
+     * The premultiplied conversion of the pixbuf, which used to be done for each draw
+     */
+    auto getSurface() -> cairo_surface_t* {
+        std::lock_guard<std::mutex> lock(this->surfaceLock);
+        if (!this->surface) {
+            this->surface = gdk_cairo_surface_create_from_pixbuf(this->pixbuf, 1, nullptr);
+        }
+        return this->surface;
+    }
+
+    /**
+     * @return The contents of the file the image was decoded from, nullptr if it was decoded from a stream or the
+     *         file changed since
+     */
+    auto readSource() const -> std::shared_ptr<const std::string> {
+        if (this->sourcePath.empty()) {
+            return nullptr;
+        }
+        std::error_code sizeError;
+        std::error_code timeError;
+        if (fs::file_size(this->sourcePath, sizeError) != this->sourceSize ||
+            fs::last_write_time(this->sourcePath, timeError) != this->sourceTime || sizeError || timeError) {
+            return nullptr;
+        }
+
+        gchar* contents = nullptr;
+        gsize length = 0;
+        if (!g_file_get_contents(this->sourcePath.u8string().c_str(), &contents, &length, nullptr)) {
+            return nullptr;
+        }
+        auto data = std::make_shared<const std::string>(contents, length);
+        g_free(contents);
+        return data->size() == this->sourceSize ? data : nullptr;
+    }
+
+    auto getExportSurface() -> cairo_surface_t* {
+        cairo_surface_t* original = getSurface();
+        std::shared_ptr<const std::string> data = readSource();
+        if (!data) {
+            return cairo_surface_reference(original);
+        }
+
+        std::lock_guard<std::mutex> lock(this->surfaceLock);
+        if (this->exportId.empty()) {
+            this->exportId = Util::getImageId(*data);
+        }
+        return Util::createExportSurface(original, std::move(data), this->exportId);
+    }
 
     fs::path path;
     GdkPixbuf* pixbuf = nullptr;
     int pageId = -1;
     bool attach = false;
+
+    /**
+     * The file the image was decoded from, with its size and modification time then. Empty if it was decoded from
+     * a stream.
+     */
+    fs::path sourcePath;
+    uintmax_t sourceSize = 0;
+    fs::file_time_type sourceTime;
+
+    /**
+     * The hash of the file contents for the export, computed on the first export
+     */
+    std::string exportId;
+
+    cairo_surface_t* surface = nullptr;
+    mutable std::mutex surfaceLock;
+    ImagePyramid pyramid;
 };
 
 BackgroundImage::BackgroundImage() = default;
@@ -85,4 +174,32 @@ void BackgroundImage::setAttach(bool attach) {
 
 auto BackgroundImage::getPixbuf() -> GdkPixbuf* { return this->img ? this->img->pixbuf : nullptr; }
 
+auto BackgroundImage::getSurface(double width, double height) -> cairo_surface_t* {
+    if (!this->img || !this->img->pixbuf) {
+        return nullptr;
+    }
+
+    return this->img->pyramid.getLevel(this->img->getSurface(), width, height);
+}
+
+auto BackgroundImage::getExportSurface() -> cairo_surface_t* {
+    if (!this->img || !this->img->pixbuf) {
+        return nullptr;
+    }
+
+    return this->img->getExportSurface();
+}
+
 auto BackgroundImage::isEmpty() -> bool { return !this->img; }
+
+auto BackgroundImage::getMemoryFootprint() const -> size_t {
+    if (!this->img) {
+        return 0;
+    }
+
+    // Content shared by copies on other pages is divided between them, so the sum over all pages counts it once
+    std::lock_guard<std::mutex> lock(this->img->surfaceLock);
+    size_t size = getPixbufSize(this->img->pixbuf) + getSurfaceSize(this->img->surface) +
+                  this->img->pyramid.getMemoryFootprint();
+    return size / std::max<size_t>(static_cast<size_t>(this->img.use_count()), 1);
+}
@@ -17,13 +17,14 @@
 
 #include <gtk/gtk.h>
 
+#include "MemoryAccountable.h"
 #include "filesystem.h"
 
-struct BackgroundImage {
+struct BackgroundImage: public MemoryAccountable {
     BackgroundImage();
     BackgroundImage(const BackgroundImage& img);
     BackgroundImage(BackgroundImage&& img) noexcept;
-    ~BackgroundImage();
+    ~BackgroundImage() override;
 
     BackgroundImage& operator=(const BackgroundImage& img) = default;
     BackgroundImage& operator=(BackgroundImage&& img) = default;
@@ -48,8 +49,32 @@ struct BackgroundImage {
 
     GdkPixbuf* getPixbuf();
 
+    /**
+     * Returns the smallest level of the mipmap which has at least the given size in device pixels, so the image is
+     * never scaled up by more than the full resolution requires, and never scaled down by more than a factor of 2.
+     *
+     * The levels are created on first use and shared by all copies of this BackgroundImage, that is by all pages
+     * with a cloned background. Thread safe.
+     *
+     * @return A new reference the caller has to release with cairo_surface_destroy(), or nullptr if empty
+     */
+    cairo_surface_t* getSurface(double width, double height);
+
+    /**
+     * The full resolution image for drawing it to a PDF or SVG target. If the image was loaded from a file which did
+     * not change since, the file is read again and attached to the surface, see Util::createExportSurface().
+     *
+     * @return A new surface the caller has to release with cairo_surface_destroy(), or nullptr if empty
+     */
+    cairo_surface_t* getExportSurface();
+
     bool isEmpty();
 
+    /**
+     * The size of the decoded pixbuf and of the cached surfaces, divided by the number of copies sharing them
+     */
+    size_t getMemoryFootprint() const override;
+
 private:
     struct Content;
     std::shared_ptr<Content> img;
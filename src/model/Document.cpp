@@ -159,6 +159,13 @@ void Document::setPreview(cairo_surface_t* preview) {
     }
 }
 
+auto Document::getPageStore() -> std::shared_ptr<PageStore> {
+    if (!this->pageStore) {
+        this->pageStore = std::make_shared<PageStore>();
+    }
+    return this->pageStore;
+}
+
 auto Document::getEvMetadataFilename() -> fs::path {
     if (!this->filepath.empty()) {
         return this->filepath;
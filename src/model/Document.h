@@ -25,6 +25,7 @@
 #include "DocumentHandler.h"
 #include "LinkDestination.h"
 #include "PageRef.h"
+#include "PageStore.h"
 #include "filesystem.h"
 
 class Document {
@@ -85,6 +86,11 @@ public:
     cairo_surface_t* getPreview();
     void setPreview(cairo_surface_t* preview);
 
+    /**
+     * The temporary file for the contents of unloaded pages, created on first use
+     */
+    std::shared_ptr<PageStore> getPageStore();
+
     void lock();
     void unlock();
     bool tryLock();
@@ -151,6 +157,11 @@ private:
      */
     cairo_surface_t* preview = nullptr;
 
+    /**
+     * Unloaded layers keep a reference, so the store lives as long as their pages
+     */
+    std::shared_ptr<PageStore> pageStore;
+
     /**
      * The lock of the document
      */
@@ -11,6 +11,8 @@ Element::~Element() = default;
 
 auto Element::getType() const -> ElementType { return this->type; }
 
+auto Element::getMemoryFootprint() const -> size_t { return sizeof(Element); }
+
 void Element::setX(double x) {
     this->x = x;
     this->sizeCalculated = false;
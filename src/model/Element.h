@@ -19,6 +19,7 @@
 #include "serializing/Serializable.h"
 
 #include "Color.h"
+#include "MemoryAccountable.h"
 #include "Rectangle.h"
 
 
@@ -31,7 +32,7 @@ public:
     virtual ~ShapeContainer() = default;
 };
 
-class Element: public Serializable {
+class Element: public Serializable, public MemoryAccountable {
 protected:
     Element(ElementType type);
 
@@ -73,6 +74,11 @@ public:
      */
     virtual Element* clone() = 0;
 
+    /**
+     * @overwrite
+     */
+    size_t getMemoryFootprint() const override;
+
 private:
 protected:
     virtual void calcSize() const = 0;
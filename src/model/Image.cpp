@@ -1,13 +1,16 @@
 #include "Image.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "serializing/ObjectInputStream.h"
 #include "serializing/ObjectOutputStream.h"
 
+#include "ImagePyramid.h"
+#include "MimeData.h"
 #include "pixbuf-utils.h"
 
-Image::Image(): Element(ELEMENT_IMAGE) {}
+Image::Image(): Element(ELEMENT_IMAGE), pyramid(std::make_shared<ImagePyramid>()) {}
 
 Image::~Image() {
     if (this->image) {
@@ -25,8 +28,10 @@ auto Image::clone() -> Element* {
     img->width = this->width;
     img->height = this->height;
     img->data = this->data;
+    img->exportId = this->exportId;
 
     img->image = cairo_surface_reference(this->image);
+    img->pyramid = this->pyramid;
     img->snappedBounds = this->snappedBounds;
     img->sizeCalculated = this->sizeCalculated;
     img->read = this->read;
@@ -34,6 +39,12 @@ auto Image::clone() -> Element* {
     return img;
 }
 
+auto Image::getMemoryFootprint() const -> size_t {
+    // Data shared with clones is divided between them, so the sum over all images counts it once
+    size_t dataSize = this->data->capacity() / std::max<size_t>(this->data.getUseCount(), 1);
+    return sizeof(Image) + dataSize + getSurfaceSize(this->image) + this->pyramid->getMemoryFootprint();
+}
+
 void Image::setWidth(double width) {
     this->width = width;
     this->calcSize();
@@ -46,22 +57,30 @@ void Image::setHeight(double height) {
 
 auto Image::cairoReadFunction(const Image* image, unsigned char* data, unsigned int length) -> cairo_status_t {
     for (unsigned int i = 0; i < length; i++, image->read++) {
-        if (image->read >= image->data.length()) {
+        if (image->read >= image->data->length()) {
             return CAIRO_STATUS_READ_ERROR;
         }
 
-        data[i] = image->data[image->read];
+        data[i] = (*image->data)[image->read];
     }
 
     return CAIRO_STATUS_SUCCESS;
 }
 
+auto Image::cairoWriteFunction(std::string* data, const unsigned char* buffer, unsigned int length)
+        -> cairo_status_t {
+    data->append(reinterpret_cast<const char*>(buffer), length);
+    return CAIRO_STATUS_SUCCESS;
+}
+
 void Image::setImage(std::string data) {
     if (this->image) {
         cairo_surface_destroy(this->image);
         this->image = nullptr;
     }
-    this->data = std::move(data);
+    this->pyramid = std::make_shared<ImagePyramid>();
+    this->data = CopyOnWrite<std::string>(std::move(data));
+    this->exportId.clear();
 }
 
 void Image::setImage(GdkPixbuf* img) { setImage(f_pixbuf_to_cairo_surface(img)); }
@@ -71,12 +90,15 @@ void Image::setImage(cairo_surface_t* image) {
         cairo_surface_destroy(this->image);
         this->image = nullptr;
     }
+    this->pyramid = std::make_shared<ImagePyramid>();
+    this->data = CopyOnWrite<std::string>();
+    this->exportId.clear();
 
     this->image = image;
 }
 
 auto Image::getImage() const -> cairo_surface_t* {
-    if (this->image == nullptr && this->data.length()) {
+    if (this->image == nullptr && this->data->length()) {
         this->read = 0;
         this->image = cairo_image_surface_create_from_png_stream(
                 reinterpret_cast<cairo_read_func_t>(&cairoReadFunction), const_cast<Image*>(this));
@@ -85,6 +107,29 @@ auto Image::getImage() const -> cairo_surface_t* {
     return this->image;
 }
 
+auto Image::getScaledImage(double width, double height) const -> cairo_surface_t* {
+    cairo_surface_t* img = getImage();
+    if (img == nullptr || cairo_surface_status(img) != CAIRO_STATUS_SUCCESS) {
+        return nullptr;
+    }
+    return this->pyramid->getLevel(img, width, height);
+}
+
+auto Image::getExportImage() const -> cairo_surface_t* {
+    cairo_surface_t* img = getImage();
+    if (img == nullptr || cairo_surface_status(img) != CAIRO_STATUS_SUCCESS) {
+        return nullptr;
+    }
+    if (this->exportId.empty() && !this->data->empty()) {
+        this->exportId = Util::getImageId(*this->data);
+    }
+    return Util::createExportSurface(img, this->data.share(), this->exportId);
+}
+
+auto Image::getEncodedData() const -> const std::string& { return *this->data; }
+
+auto Image::shareEncodedData() const -> std::shared_ptr<const std::string> { return this->data.share(); }
+
 void Image::scale(double x0, double y0, double fx, double fy, double rotation,
                   bool) {  // line width scaling option is not used
     this->x -= x0;
@@ -109,7 +154,13 @@ void Image::serialize(ObjectOutputStream& out) {
     out.writeDouble(this->width);
     out.writeDouble(this->height);
 
-    out.writeImage(this->image);
+    if (this->data->empty() && this->image) {
+        cairo_surface_write_to_png_stream(this->image, reinterpret_cast<cairo_write_func_t>(&cairoWriteFunction),
+                                          &this->data.write());
+    }
+
+    // Written as it is, so the image is not decoded before it is drawn
+    out.writeData(this->data->data(), static_cast<int>(this->data->size()), 1);
 
     out.endObject();
 }
@@ -122,12 +173,12 @@ void Image::readSerialized(ObjectInputStream& in) {
     this->width = in.readDouble();
     this->height = in.readDouble();
 
-    if (this->image) {
-        cairo_surface_destroy(this->image);
-        this->image = nullptr;
-    }
-
-    this->image = in.readImage();
+    char* encoded{};
+    int length{};
+    in.readData(reinterpret_cast<void**>(&encoded), &length);
+    setImage(length > 0 ? std::string(encoded, static_cast<size_t>(length)) : std::string());
+    // Allocated as char array by readData()
+    delete[] encoded;
 
     in.endObject();
     this->calcSize();
@@ -11,11 +11,14 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
 
+#include "CopyOnWrite.h"
 #include "Element.h"
 
+class ImagePyramid;
 
 class Image: public Element {
 public:
@@ -31,6 +34,31 @@ public:
     void setImage(GdkPixbuf* img);
     cairo_surface_t* getImage() const;
 
+    /**
+     * The image downsampled for drawing it with the given size in device pixels
+     *
+     * @return A new reference the caller has to release with cairo_surface_destroy(), nullptr if there is no image
+     */
+    cairo_surface_t* getScaledImage(double width, double height) const;
+
+    /**
+     * The original image for drawing it to a PDF or SVG target, with the PNG data attached, see
+     * Util::createExportSurface()
+     *
+     * @return A new surface the caller has to release with cairo_surface_destroy(), nullptr if there is no image
+     */
+    cairo_surface_t* getExportImage() const;
+
+    /**
+     * @return The PNG encoded image, empty if the image was set from a surface or pixbuf
+     */
+    const std::string& getEncodedData() const;
+
+    /**
+     * @return The PNG encoded image, which is not modified while it is kept, see CopyOnWrite::share()
+     */
+    std::shared_ptr<const std::string> shareEncodedData() const;
+
     virtual void scale(double x0, double y0, double fx, double fy, double rotation, bool restoreLineWidth);
     virtual void rotate(double x0, double y0, double th);
 
@@ -39,6 +67,11 @@ public:
      */
     virtual Element* clone();
 
+    /**
+     * The PNG data and the decoded surface, if it was already decoded, and its downsampled levels
+     */
+    size_t getMemoryFootprint() const override;
+
 public:
     // Serialize interface
     void serialize(ObjectOutputStream& out);
@@ -48,11 +81,25 @@ private:
     void calcSize() const override;
 
     static cairo_status_t cairoReadFunction(const Image* image, unsigned char* data, unsigned int length);
+    static cairo_status_t cairoWriteFunction(std::string* data, const unsigned char* buffer, unsigned int length);
 
 private:
     mutable cairo_surface_t* image = nullptr;
 
-    std::string data;
+    /**
+     * Downsampled levels of image, shared with the clones
+     */
+    std::shared_ptr<ImagePyramid> pyramid;
+
+    /**
+     * PNG data, shared with the clones
+     */
+    CopyOnWrite<std::string> data;
+
+    /**
+     * The hash of data for the export, computed on the first export
+     */
+    mutable std::string exportId;
 
     mutable std::string::size_type read = false;
 };
@@ -1,17 +1,222 @@
 #include "Layer.h"
 
+#include <algorithm>
+#include <iterator>
+#include <unordered_set>
+
+#include "serializing/BinObjectEncoding.h"
+#include "serializing/ObjectInputStream.h"
+#include "serializing/ObjectOutputStream.h"
+
+#include "AudioElement.h"
+#include "Image.h"
 #include "Stacktrace.h"
+#include "Stroke.h"
+#include "TexImage.h"
+#include "Text.h"
+#include "Util.h"
+#include "XojMsgBox.h"
+#include "i18n.h"
+
+namespace {
+auto collectAudioReferences(const std::vector<Element*>& elements) -> Layer::AudioReferences {
+    Layer::AudioReferences references;
+    for (Element* e: elements) {
+        auto* audio = dynamic_cast<AudioElement*>(e);
+        if (audio == nullptr) {
+            continue;
+        }
+        std::string filename = audio->getAudioFilename();
+        if (!filename.empty()) {
+            references.push_back({std::move(filename), audio->getTimestamp(), e->boundingRect()});
+        }
+    }
+    return references;
+}
+}  // namespace
 
 Layer::Layer() = default;
 
 Layer::~Layer() {
+    if (this->store) {
+        this->store->release(this->storeEntry);
+    }
+
+    for (Element* e: this->elements) {
+        delete e;
+    }
+    this->elements.clear();
+}
+
+auto Layer::unload(const std::shared_ptr<PageStore>& store) -> bool {
+    std::lock_guard<std::mutex> lock(this->storeMutex);
+    if (this->store || this->elements.empty()) {
+        return false;
+    }
+
+    if (!store->write(serializeElements(), this->storeEntry)) {
+        return false;
+    }
+
+    this->unloadedCount = this->elements.size();
+    this->unloadedAudio = collectAudioReferences(this->elements);
     for (Element* e: this->elements) {
         delete e;
     }
     this->elements.clear();
+    this->elements.shrink_to_fit();
+    this->store = store;
+    this->unloaded = true;
+    return true;
+}
+
+auto Layer::isLoaded() const -> bool { return !this->unloaded; }
+
+auto Layer::hasLoadError() const -> bool { return this->loadFailed; }
+
+auto Layer::serializeElements() const -> std::string {
+    ensureLoaded();
+
+    ObjectOutputStream out(new BinObjectEncoding());
+    out.writeInt(static_cast<int>(this->elements.size()));
+    for (Element* e: this->elements) {
+        e->serialize(out);
+    }
+
+    GString* str = out.getStr();
+    std::string data(str->str, str->len);
+    g_string_free(str, true);
+    return data;
+}
+
+void Layer::setStoredElements(const std::shared_ptr<PageStore>& store, const PageStore::Entry& entry, size_t count,
+                              AudioReferences audio) {
+    std::lock_guard<std::mutex> lock(this->storeMutex);
+    if (this->store) {
+        this->store->release(this->storeEntry);
+    }
+    for (Element* e: this->elements) {
+        delete e;
+    }
+    this->elements.clear();
+
+    this->store = store;
+    this->storeEntry = entry;
+    this->unloadedCount = count;
+    this->unloadedAudio = std::move(audio);
+    this->loadFailed = false;
+    this->unloaded = true;
+}
+
+auto Layer::getStoredElements(std::shared_ptr<PageStore>& store, PageStore::Entry& entry, size_t& count) const
+        -> bool {
+    std::lock_guard<std::mutex> lock(this->storeMutex);
+    if (!this->unloaded || !this->store) {
+        return false;
+    }
+    store = this->store;
+    entry = this->storeEntry;
+    count = this->unloadedCount;
+    return true;
+}
+
+void Layer::ensureLoaded() const {
+    if (!this->unloaded) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(this->storeMutex);
+    if (!this->store || this->loadFailed) {
+        return;
+    }
+
+    std::vector<Element*> loaded;
+    if (!readStoredElements(loaded)) {
+        // Keep the entry and do not allow changes, so the stored elements are not replaced by an empty layer
+        this->loadFailed = true;
+        Util::execInUiThread([]() {
+            XojMsgBox::showErrorToUser(nullptr, _("The contents of a layer could not be loaded back from the "
+                                                  "temporary page store. The layer is shown empty and cannot "
+                                                  "be edited."));
+        });
+        return;
+    }
+
+    this->elements = std::move(loaded);
+    this->store->release(this->storeEntry);
+    this->store.reset();
+    this->unloadedAudio.clear();
+    this->unloaded = false;
+}
+
+auto Layer::getAudioReferences() const -> AudioReferences {
+    if (this->unloaded) {
+        std::lock_guard<std::mutex> lock(this->storeMutex);
+        if (this->store) {
+            return this->unloadedAudio;
+        }
+    }
+    return collectAudioReferences(this->elements);
+}
+
+auto Layer::readStoredElements(std::vector<Element*>& loaded) const -> bool {
+    std::string data;
+    ObjectInputStream in;
+    if (!this->store->read(this->storeEntry, data) || !in.read(data.data(), static_cast<int>(data.size()))) {
+        g_critical("Could not read the elements of an unloaded layer back from the page store");
+        return false;
+    }
+
+    std::vector<std::unique_ptr<Element>> elements;
+    try {
+        int count = in.readInt();
+        // Every element takes more than one byte, a larger count is corrupted
+        if (count < 0 || static_cast<size_t>(count) > data.size()) {
+            throw InputStreamException(FS(FORMAT_STR("Invalid element count {1}") % count), __FILE__, __LINE__);
+        }
+        elements.reserve(static_cast<size_t>(count));
+        for (int i = 0; i < count; i++) {
+            std::string name = in.getNextObjectName();
+            std::unique_ptr<Element> element;
+            if (name == "Stroke") {
+                element = std::make_unique<Stroke>();
+            } else if (name == "Image") {
+                element = std::make_unique<Image>();
+            } else if (name == "TexImage") {
+                element = std::make_unique<TexImage>();
+            } else if (name == "Text") {
+                element = std::make_unique<Text>();
+            } else {
+                throw InputStreamException(FS(FORMAT_STR("Get unknown object {1}") % name), __FILE__, __LINE__);
+            }
+
+            element->readSerialized(in);
+            elements.push_back(std::move(element));
+        }
+    } catch (const std::exception& e) {
+        // Also std::bad_alloc for sizes in a corrupted page file
+        g_critical("Unloaded layer is corrupted: %s", e.what());
+        return false;
+    }
+
+    loaded.reserve(elements.size());
+    for (auto& e: elements) {
+        loaded.push_back(e.release());
+    }
+    return true;
+}
+
+auto Layer::checkWritable(const char* method) const -> bool {
+    if (this->loadFailed) {
+        g_warning("Layer::%s: The layer could not be loaded and is read only!", method);
+        return false;
+    }
+    return true;
 }
 
 auto Layer::clone() const -> Layer* {
+    ensureLoaded();
+
     auto* layer = new Layer();
 
     if (hasName()) {
@@ -26,6 +231,11 @@ auto Layer::clone() const -> Layer* {
 }
 
 void Layer::addElement(Element* e) {
+    ensureLoaded();
+    if (!checkWritable("addElement")) {
+        return;
+    }
+
     if (e == nullptr) {
         g_warning("addElement(nullptr)!");
         Stacktrace::printStracktrace();
@@ -43,6 +253,11 @@ void Layer::addElement(Element* e) {
 }
 
 void Layer::insertElement(Element* e, ElementIndex pos) {
+    ensureLoaded();
+    if (!checkWritable("insertElement")) {
+        return;
+    }
+
     if (e == nullptr) {
         g_warning("insertElement(nullptr)!");
         Stacktrace::printStracktrace();
@@ -72,6 +287,8 @@ void Layer::insertElement(Element* e, ElementIndex pos) {
 }
 
 auto Layer::indexOf(Element* e) const -> ElementIndex {
+    ensureLoaded();
+
     for (unsigned int i = 0; i < this->elements.size(); i++) {
         if (this->elements[i] == e) {
             return i;
@@ -82,6 +299,8 @@ auto Layer::indexOf(Element* e) const -> ElementIndex {
 }
 
 auto Layer::removeElement(Element* e, bool free) -> ElementIndex {
+    ensureLoaded();
+
     for (unsigned int i = 0; i < this->elements.size(); i++) {
         if (e == this->elements[i]) {
             this->elements.erase(this->elements.begin() + i);
@@ -98,7 +317,31 @@ auto Layer::removeElement(Element* e, bool free) -> ElementIndex {
     return InvalidElementIndex;
 }
 
-auto Layer::isAnnotated() const -> bool { return !this->elements.empty(); }
+void Layer::addElements(const std::vector<Element*>& newElements) {
+    ensureLoaded();
+    if (!checkWritable("addElements")) {
+        return;
+    }
+    this->elements.insert(this->elements.end(), newElements.begin(), newElements.end());
+}
+
+auto Layer::removeElements(const std::vector<Element*>& removed) -> size_t {
+    ensureLoaded();
+
+    std::unordered_set<Element*> lookup(removed.begin(), removed.end());
+    auto end = std::remove_if(this->elements.begin(), this->elements.end(),
+                              [&lookup](Element* e) { return lookup.count(e) > 0; });
+    auto count = static_cast<size_t>(std::distance(end, this->elements.end()));
+    this->elements.erase(end, this->elements.end());
+    return count;
+}
+
+auto Layer::isAnnotated() const -> bool {
+    if (this->unloaded) {
+        return this->unloadedCount > 0;
+    }
+    return !this->elements.empty();
+}
 
 /**
  * @return true if the layer is visible
@@ -110,7 +353,10 @@ auto Layer::isVisible() const -> bool { return visible; }
  */
 void Layer::setVisible(bool visible) { this->visible = visible; }
 
-auto Layer::getElements() const -> const std::vector<Element*>& { return this->elements; }
+auto Layer::getElements() const -> const std::vector<Element*>& {
+    ensureLoaded();
+    return this->elements;
+}
 
 auto Layer::hasName() const -> bool { return name.has_value(); }
 
@@ -11,10 +11,16 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "Element.h"
+#include "PageStore.h"
+#include "Rectangle.h"
 
 template <class T>
 using optional = std::optional<T>;
@@ -35,6 +41,13 @@ public:
      */
     void addElement(Element* e);
 
+    /**
+     * Appends new Element%s to this Layer
+     *
+     * @note Unlike addElement(), does not check whether the elements are already contained in the Layer
+     */
+    void addElements(const std::vector<Element*>& newElements);
+
     /**
      * Inserts an Element in the specified position of the Layer%s internal list
      *
@@ -52,6 +65,13 @@ public:
      */
     ElementIndex removeElement(Element* e, bool free);
 
+    /**
+     * Removes the Element%s from the Layer in a single pass, without deleting them
+     *
+     * @return The number of removed elements
+     */
+    size_t removeElements(const std::vector<Element*>& removed);
+
     /**
      * Returns an iterator over the Element%s contained in this Layer
      */
@@ -93,8 +113,112 @@ public:
      */
     void setName(const std::string& newName);
 
+    /**
+     * Serializes the elements to the store and frees them. They are read back transparently
+     * by the next method which accesses the elements, so no pointer to an element of this layer
+     * may be kept by the caller.
+     *
+     * The document needs to be locked, so no other thread uses the elements while they are freed.
+     *
+     * @return false if the layer is empty, already unloaded or could not be written
+     */
+    bool unload(const std::shared_ptr<PageStore>& store);
+
+    /**
+     * @return false if the elements are currently in the page store
+     */
+    bool isLoaded() const;
+
+    /**
+     * @return true if the elements could not be read back from the page store. The layer is empty and
+     *         read only then, the elements stay in the store.
+     */
+    bool hasLoadError() const;
+
+    /**
+     * An element which refers to a recording, with its bounds for highlighting it during playback
+     */
+    struct AudioReference {
+        std::string filename;
+        size_t timestamp = 0;
+        Rectangle<double> bounds;
+    };
+    using AudioReferences = std::vector<AudioReference>;
+
+    /**
+     * @return The audio references of the elements. They are kept while the layer is unloaded,
+     *         so they are available without loading the elements again.
+     */
+    AudioReferences getAudioReferences() const;
+
+    /**
+     * @return The element count followed by the serialized elements, as stored by unload()
+     */
+    std::string serializeElements() const;
+
+    /**
+     * Replaces the elements by count elements which are already in a store, e.g. in a memory mapped page file.
+     * They are read on the first access, like the elements of an unloaded layer.
+     *
+     * @param audio The audio references of the stored elements
+     */
+    void setStoredElements(const std::shared_ptr<PageStore>& store, const PageStore::Entry& entry, size_t count,
+                           AudioReferences audio);
+
+    /**
+     * @param store Returns the store of the elements while the layer is unloaded
+     * @param entry Returns the entry of the elements in the store
+     * @param count Returns the number of stored elements
+     * @return false if the elements are loaded. Also true if they could not be read back, see hasLoadError().
+     */
+    bool getStoredElements(std::shared_ptr<PageStore>& store, PageStore::Entry& entry, size_t& count) const;
+
+private:
+    /**
+     * Reads the elements back from the page store, if the layer was unloaded. Several threads may call this
+     * at once, e.g. the UI and a render job.
+     */
+    void ensureLoaded() const;
+
+    /**
+     * @return false if the entry could not be read or is corrupted, loaded is empty then
+     */
+    bool readStoredElements(std::vector<Element*>& loaded) const;
+
+    /**
+     * @return false if the layer could not be loaded, so it must not be changed
+     */
+    bool checkWritable(const char* method) const;
+
 private:
-    std::vector<Element*> elements;
+    mutable std::vector<Element*> elements;
+
+    /**
+     * Serializes loading and unloading of the elements
+     */
+    mutable std::mutex storeMutex;
+
+    /**
+     * Set while the elements are unloaded, so loaded layers are accessed without locking
+     */
+    mutable std::atomic<bool> unloaded{false};
+    mutable std::atomic<bool> loadFailed{false};
+
+    /**
+     * Set while the elements are unloaded
+     */
+    mutable std::shared_ptr<PageStore> store;
+    PageStore::Entry storeEntry;
+
+    /**
+     * The number of unloaded elements, so isAnnotated() does not need to load them
+     */
+    size_t unloadedCount = 0;
+
+    /**
+     * The audio references of the unloaded elements
+     */
+    AudioReferences unloadedAudio;
 
     bool visible = true;
 
@@ -0,0 +1,162 @@
+#include "PageStore.h"
+
+#include <atomic>
+#include <limits>
+#include <vector>
+
+#include <glib.h>
+#include <zlib.h>
+
+#include "PathUtil.h"
+
+/**
+ * Deflate compresses at most about 1032:1
+ */
+constexpr uint64_t MAX_DEFLATE_RATIO = 1032;
+
+PageStore::PageStore() = default;
+
+PageStore::~PageStore() {
+    if (this->file.is_open()) {
+        this->file.close();
+        std::error_code ec;
+        fs::remove(this->path, ec);
+    }
+}
+
+auto PageStore::open() -> bool {
+    if (this->file.is_open()) {
+        return true;
+    }
+
+    static std::atomic<int> counter{0};
+    this->path = Util::getTmpDirSubfolder("pages") / ("store-" + std::to_string(++counter) + ".bin");
+    this->file.open(this->path, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!this->file.is_open()) {
+        g_warning("Could not create the page store \"%s\"", this->path.u8string().c_str());
+        return false;
+    }
+    return true;
+}
+
+auto PageStore::allocate(uint64_t length) -> uint64_t {
+    // Best fit, the rest of the free block stays available
+    auto it = this->freeSpace.lower_bound(length);
+    if (it == this->freeSpace.end()) {
+        uint64_t offset = this->fileEnd;
+        this->fileEnd += length;
+        return offset;
+    }
+
+    uint64_t offset = it->second;
+    uint64_t rest = it->first - length;
+    this->freeSpace.erase(it);
+    if (rest > 0) {
+        this->freeSpace.emplace(rest, offset + length);
+    }
+    return offset;
+}
+
+auto PageStore::encode(const std::string& data, std::string& stored) -> bool {
+    // The elements are mostly coordinates, the fastest level already halves them
+    uLongf length = compressBound(data.size());
+    stored.resize(length);
+    if (compress2(reinterpret_cast<Bytef*>(stored.data()), &length, reinterpret_cast<const Bytef*>(data.data()),
+                  data.size(), Z_BEST_SPEED) != Z_OK) {
+        return false;
+    }
+
+    if (length >= data.size()) {
+        stored = data;
+    } else {
+        stored.resize(length);
+    }
+    return true;
+}
+
+auto PageStore::decode(const char* stored, const Entry& entry, std::string& data) -> bool {
+    // The entry may come from a file, do not allocate more than an ObjectInputStream can read or deflate can produce
+    if (entry.size > static_cast<uint64_t>(std::numeric_limits<int>::max())) {
+        return false;
+    }
+    if (entry.length == entry.size) {
+        data.assign(stored, entry.size);
+        return true;
+    }
+    if (entry.size / MAX_DEFLATE_RATIO > entry.length) {
+        return false;
+    }
+
+    data.resize(entry.size);
+    uLongf size = entry.size;
+    return uncompress(reinterpret_cast<Bytef*>(data.data()), &size, reinterpret_cast<const Bytef*>(stored),
+                      entry.length) == Z_OK &&
+           size == entry.size;
+}
+
+auto PageStore::write(const std::string& data, Entry& entry) -> bool {
+    std::string stored;
+    if (!encode(data, stored)) {
+        return false;
+    }
+    uint64_t length = stored.size();
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (!open()) {
+        return false;
+    }
+
+    uint64_t offset = allocate(length);
+    this->file.clear();
+    this->file.seekp(static_cast<std::streamoff>(offset));
+    this->file.write(stored.data(), static_cast<std::streamsize>(length));
+    this->file.flush();
+    if (!this->file.good()) {
+        this->freeSpace.emplace(length, offset);
+        return false;
+    }
+
+    entry.offset = offset;
+    entry.length = length;
+    entry.size = data.size();
+    this->storedSize += length;
+    return true;
+}
+
+auto PageStore::read(const Entry& entry, std::string& data) -> bool {
+    std::vector<char> stored(entry.length);
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (!this->file.is_open()) {
+            return false;
+        }
+        this->file.clear();
+        this->file.seekg(static_cast<std::streamoff>(entry.offset));
+        this->file.read(stored.data(), static_cast<std::streamsize>(entry.length));
+        if (!this->file.good()) {
+            return false;
+        }
+    }
+
+    return decode(stored.data(), entry, data);
+}
+
+void PageStore::release(const Entry& entry) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->storedSize -= entry.length;
+
+    if (this->storedSize == 0) {
+        // Nothing left, start over at the beginning of the file
+        this->freeSpace.clear();
+        this->fileEnd = 0;
+        std::error_code ec;
+        fs::resize_file(this->path, 0, ec);
+        return;
+    }
+    this->freeSpace.emplace(entry.length, entry.offset);
+}
+
+auto PageStore::getStoredSize() -> uint64_t {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->storedSize;
+}
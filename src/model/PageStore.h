@@ -0,0 +1,100 @@
+/*
+ * Xournal++
+ *
+ * Temporary storage for the contents of unloaded pages
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "filesystem.h"
+
+/**
+ * @brief A temporary file with the serialized, compressed elements of unloaded layers
+ *
+ * The file is created on the first write and deleted with the store. Released space is reused by later writes.
+ * All methods are thread safe. Subclasses may read the entries from another source, see PageFileReader.
+ */
+class PageStore {
+public:
+    struct Entry {
+        uint64_t offset = 0;
+
+        /**
+         * Compressed size in the file, equal to size if the data is stored uncompressed
+         */
+        uint64_t length = 0;
+
+        /**
+         * Size of the data before compression
+         */
+        uint64_t size = 0;
+    };
+
+public:
+    PageStore();
+    virtual ~PageStore();
+
+    PageStore(const PageStore&) = delete;
+    PageStore& operator=(const PageStore&) = delete;
+
+public:
+    /**
+     * @return false if the data could not be written, e.g. because the disk is full
+     */
+    virtual bool write(const std::string& data, Entry& entry);
+
+    /**
+     * @return false if the entry could not be read back
+     */
+    virtual bool read(const Entry& entry, std::string& data);
+
+    /**
+     * Marks the space of an entry as free, the entry must not be read afterwards
+     */
+    virtual void release(const Entry& entry);
+
+    /**
+     * @return The number of bytes used by entries which were not yet released
+     */
+    uint64_t getStoredSize();
+
+    /**
+     * Compresses the data as stored in an entry. Data which does not get smaller, e.g. encoded images,
+     * is stored as it is.
+     */
+    static bool encode(const std::string& data, std::string& stored);
+
+    /**
+     * @param stored The entry.length bytes of the entry
+     */
+    static bool decode(const char* stored, const Entry& entry, std::string& data);
+
+private:
+    bool open();
+    uint64_t allocate(uint64_t length);
+
+private:
+    std::mutex mutex;
+
+    fs::path path;
+    std::fstream file;
+
+    uint64_t fileEnd = 0;
+    uint64_t storedSize = 0;
+
+    /**
+     * Released space, length to offset
+     */
+    std::multimap<uint64_t, uint64_t> freeSpace;
+};
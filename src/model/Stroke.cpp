@@ -1,5 +1,6 @@
 #include "Stroke.h"
 
+#include <algorithm>
 #include <cmath>
 #include <numeric>
 
@@ -69,6 +70,12 @@ auto Stroke::cloneStroke() const -> Stroke* {
 
 auto Stroke::clone() -> Element* { return this->cloneStroke(); }
 
+auto Stroke::getMemoryFootprint() const -> size_t {
+    // Points shared with clones are divided between them, so the sum over all strokes counts them once
+    size_t pointSize = this->points->capacity() * sizeof(Point);
+    return sizeof(Stroke) + pointSize / std::max<size_t>(this->points.getUseCount(), 1);
+}
+
 void Stroke::serialize(ObjectOutputStream& out) {
     out.writeObject("Stroke");
 
@@ -80,7 +87,7 @@ void Stroke::serialize(ObjectOutputStream& out) {
 
     out.writeInt(fill);
 
-    out.writeData(this->points.data(), this->points.size(), sizeof(Point));
+    out.writeData(this->points->data(), this->points->size(), sizeof(Point));
 
     this->lineStyle.serialize(out);
 
@@ -101,8 +108,9 @@ void Stroke::readSerialized(ObjectInputStream& in) {
     Point* p{};
     int count{};
     in.readData(reinterpret_cast<void**>(&p), &count);
-    this->points = std::vector<Point>{p, p + count};
-    g_free(p);
+    this->points = CopyOnWrite<std::vector<Point>>(std::vector<Point>{p, p + count});
+    // Allocated as char array by readData()
+    delete[] reinterpret_cast<char*>(p);
     this->lineStyle.readSerialized(in);
 
     in.endObject();
@@ -133,7 +141,7 @@ auto Stroke::getWidth() const -> double { return this->width; }
 auto Stroke::rescaleWithMirror() -> bool { return true; }
 
 auto Stroke::isInSelection(ShapeContainer* container) -> bool {
-    for (auto&& p: this->points) {
+    for (auto&& p: *this->points) {
         double px = p.x;
         double py = p.y;
 
@@ -146,8 +154,8 @@ auto Stroke::isInSelection(ShapeContainer* container) -> bool {
 }
 
 void Stroke::setFirstPoint(double x, double y) {
-    if (!this->points.empty()) {
-        Point& p = this->points.front();
+    if (!this->points->empty()) {
+        Point& p = this->points.write().front();
         p.x = x;
         p.y = y;
         this->sizeCalculated = false;
@@ -157,43 +165,48 @@ void Stroke::setFirstPoint(double x, double y) {
 void Stroke::setLastPoint(double x, double y) { setLastPoint({x, y}); }
 
 void Stroke::setLastPoint(const Point& p) {
-    if (!this->points.empty()) {
-        this->points.back() = p;
+    if (!this->points->empty()) {
+        this->points.write().back() = p;
         this->sizeCalculated = false;
     }
 }
 
 void Stroke::addPoint(const Point& p) {
-    this->points.emplace_back(p);
+    this->points.write().emplace_back(p);
     updateBounds(Element::x, Element::y, Element::width, Element::height, Element::snappedBounds, p,
                  hasPressure() ? p.z / 2.0 : this->width / 2.0);
 }
 
-auto Stroke::getPointCount() const -> int { return this->points.size(); }
+auto Stroke::getPointCount() const -> int { return this->points->size(); }
 
-auto Stroke::getPointVector() const -> std::vector<Point> const& { return points; }
+auto Stroke::getPointVector() const -> std::vector<Point> const& { return *points; }
 
 void Stroke::deletePointsFrom(int index) {
-    points.resize(std::min(size_t(index), points.size()));
+    points.write().resize(std::min(size_t(index), points->size()));
     this->sizeCalculated = false;
 }
 
 void Stroke::deletePoint(int index) {
-    this->points.erase(std::next(begin(this->points), index));
+    auto& writablePoints = this->points.write();
+    writablePoints.erase(std::next(begin(writablePoints), index));
     this->sizeCalculated = false;
 }
 
 auto Stroke::getPoint(int index) const -> Point {
-    if (index < 0 || index >= this->points.size()) {
+    if (index < 0 || index >= this->points->size()) {
         g_warning("Stroke::getPoint(%i) out of bounds!", index);
         return Point(0, 0, Point::NO_PRESSURE);
     }
-    return points.at(index);
+    return points->at(index);
 }
 
-auto Stroke::getPoints() const -> const Point* { return this->points.data(); }
+auto Stroke::getPoints() const -> const Point* { return this->points->data(); }
 
-void Stroke::freeUnusedPointItems() { this->points = {begin(this->points), end(this->points)}; }
+auto Stroke::sharePoints() const -> std::shared_ptr<const std::vector<Point>> { return this->points.share(); }
+
+void Stroke::freeUnusedPointItems() {
+    this->points = CopyOnWrite<std::vector<Point>>(std::vector<Point>{begin(*this->points), end(*this->points)});
+}
 
 void Stroke::setToolType(StrokeTool type) { this->toolType = type; }
 
@@ -204,7 +217,7 @@ void Stroke::setLineStyle(const LineStyle& style) { this->lineStyle = style; }
 auto Stroke::getLineStyle() const -> const LineStyle& { return this->lineStyle; }
 
 void Stroke::move(double dx, double dy) {
-    for (auto&& point: points) {
+    for (auto&& point: points.write()) {
         point.x += dx;
         point.y += dy;
     }
@@ -220,7 +233,7 @@ void Stroke::rotate(double x0, double y0, double th) {
     cairo_matrix_rotate(&rotMatrix, th);
     cairo_matrix_translate(&rotMatrix, -x0, -y0);
 
-    for (auto&& p: points) {
+    for (auto&& p: points.write()) {
         cairo_matrix_transform_point(&rotMatrix, &p.x, &p.y);
     }
     this->sizeCalculated = false;
@@ -237,7 +250,7 @@ void Stroke::scale(double x0, double y0, double fx, double fy, double rotation,
     cairo_matrix_rotate(&scaleMatrix, -rotation);
     cairo_matrix_translate(&scaleMatrix, -x0, -y0);
 
-    for (auto&& p: points) {
+    for (auto&& p: points.write()) {
         cairo_matrix_transform_point(&scaleMatrix, &p.x, &p.y);
 
         if (p.z != Point::NO_PRESSURE) {
@@ -250,56 +263,57 @@ void Stroke::scale(double x0, double y0, double fx, double fy, double rotation,
 }
 
 auto Stroke::hasPressure() const -> bool {
-    if (!this->points.empty()) {
-        return this->points[0].z != Point::NO_PRESSURE;
+    if (!this->points->empty()) {
+        return (*this->points)[0].z != Point::NO_PRESSURE;
     }
     return false;
 }
 
 auto Stroke::getAvgPressure() const -> double {
-    return std::accumulate(begin(this->points), end(this->points), 0.0,
+    return std::accumulate(begin(*this->points), end(*this->points), 0.0,
                            [](double l, Point const& p) { return l + p.z; }) /
-           this->points.size();
+           this->points->size();
 }
 
 void Stroke::scalePressure(double factor) {
     if (!hasPressure()) {
         return;
     }
-    for (auto&& p: this->points) {
+    for (auto&& p: this->points.write()) {
         p.z *= factor;
     }
 }
 
 void Stroke::clearPressure() {
-    for (auto&& p: points) {
+    for (auto&& p: points.write()) {
         p.z = Point::NO_PRESSURE;
     }
 }
 
 void Stroke::setLastPressure(double pressure) {
-    if (!this->points.empty()) {
-        this->points.back().z = pressure;
+    if (!this->points->empty()) {
+        this->points.write().back().z = pressure;
     }
 }
 
 void Stroke::setSecondToLastPressure(double pressure) {
     auto const pointCount = this->getPointCount();
     if (pointCount >= 2) {
-        this->points[pointCount - 2].z = pressure;
+        this->points.write()[pointCount - 2].z = pressure;
     }
 }
 
 void Stroke::setPressure(const std::vector<double>& pressure) {
     // The last pressure is not used - as there is no line drawn from this point
-    if (this->points.size() - 1 != pressure.size()) {
+    if (this->points->size() - 1 != pressure.size()) {
         g_warning("invalid pressure point count: %s, expected %s", std::to_string(pressure.size()).data(),
-                  std::to_string(this->points.size() - 1).data());
+                  std::to_string(this->points->size() - 1).data());
     }
 
-    auto max_size = std::min(pressure.size(), this->points.size() - 1);
+    auto max_size = std::min(pressure.size(), this->points->size() - 1);
+    auto& writablePoints = this->points.write();
     for (size_t i = 0U; i != max_size; ++i) {
-        this->points[i].z = pressure[i];
+        writablePoints[i].z = pressure[i];
     }
 }
 
@@ -314,7 +328,7 @@ auto Stroke::intersects(double x, double y, double halfEraserSize) -> bool {
  * checks if the stroke is intersected by the eraser rectangle
  */
 auto Stroke::intersects(double x, double y, double halfEraserSize, double* gap) -> bool {
-    if (this->points.empty()) {
+    if (this->points->empty()) {
         return false;
     }
 
@@ -323,9 +337,9 @@ auto Stroke::intersects(double x, double y, double halfEraserSize, double* gap)
     double y1 = y - halfEraserSize;
     double y2 = y + halfEraserSize;
 
-    double lastX = points[0].x;
-    double lastY = points[0].y;
-    for (auto&& point: points) {
+    double lastX = (*points)[0].x;
+    double lastY = (*points)[0].y;
+    for (auto&& point: *points) {
         double px = point.x;
         double py = point.y;
 
@@ -383,7 +397,7 @@ auto Stroke::intersects(double x, double y, double halfEraserSize, double* gap)
  * Also used for Selected Bounding box.
  */
 void Stroke::calcSize() const {
-    if (this->points.empty()) {
+    if (this->points->empty()) {
         Element::x = 0;
         Element::y = 0;
 
@@ -403,7 +417,7 @@ void Stroke::calcSize() const {
     auto halfThick = 0.0;
 
     //#pragma omp parralel
-    for (auto&& p: points) {
+    for (auto&& p: *points) {
         halfThick = std::max(halfThick, p.z);
         minSnapX = std::min(minSnapX, p.x);
         minSnapY = std::min(minSnapY, p.y);
@@ -411,7 +425,7 @@ void Stroke::calcSize() const {
         maxSnapY = std::max(maxSnapY, p.y);
     }
 
-    halfThick = points[0].z != Point::NO_PRESSURE ? halfThick / 2.0 : this->width / 2.0;
+    halfThick = (*points)[0].z != Point::NO_PRESSURE ? halfThick / 2.0 : this->width / 2.0;
 
     auto minX = minSnapX - halfThick;
     auto minY = minSnapY - halfThick;
@@ -432,7 +446,7 @@ void Stroke::setErasable(ErasableStroke* eraseable) { this->eraseable = eraseabl
 void Stroke::debugPrint() {
     g_message("%s", FC(FORMAT_STR("Stroke {1} / hasPressure() = {2}") % (uint64_t)this % this->hasPressure()));
 
-    for (auto&& p: points) {
+    for (auto&& p: *points) {
         g_message("%lf / %lf", p.x, p.y);
     }
 
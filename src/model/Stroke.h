@@ -11,7 +11,11 @@
 
 #pragma once
 
+#include <memory>
+#include <vector>
+
 #include "AudioElement.h"
+#include "CopyOnWrite.h"
 #include "Element.h"
 #include "LineStyle.h"
 #include "Point.h"
@@ -34,6 +38,8 @@ public:
     Stroke* cloneStroke() const;
     Element* clone() override;
 
+    size_t getMemoryFootprint() const override;
+
     /**
      * Clone style attributes, but not the data (position, width etc.)
      */
@@ -70,6 +76,12 @@ public:
     Point getPoint(int index) const;
     const Point* getPoints() const;
 
+    /**
+     * @return The points, which are not modified while they are kept, see CopyOnWrite::share(). nullptr if there
+     *         are no points.
+     */
+    std::shared_ptr<const std::vector<Point>> sharePoints() const;
+
     void deletePoint(int index);
     void deletePointsFrom(int index);
 
@@ -118,8 +130,8 @@ private:
 
     StrokeTool toolType = STROKE_TOOL_PEN;
 
-    // The array with the points
-    std::vector<Point> points{};
+    // The array with the points, shared with the clones until one of them changes
+    CopyOnWrite<std::vector<Point>> points;
 
     /**
      * Dashed line
@@ -1,5 +1,7 @@
 #include "TexImage.h"
 
+#include <algorithm>
+#include <atomic>
 #include <utility>
 
 #include "serializing/ObjectInputStream.h"
@@ -7,6 +9,11 @@
 
 #include "pixbuf-utils.h"
 
+/**
+ * Source of the data ids, unique for the process
+ */
+static std::atomic<uint64_t> nextDataId{1};
+
 TexImage::TexImage(): Element(ELEMENT_TEXIMAGE) { this->sizeCalculated = true; }
 
 TexImage::~TexImage() { freeImageAndPdf(); }
@@ -34,15 +41,21 @@ auto TexImage::clone() -> Element* {
     img->snappedBounds = this->snappedBounds;
     img->sizeCalculated = this->sizeCalculated;
 
-    img->pdf = this->pdf;
-    g_object_ref(this->pdf);
-
-    img->loadData(std::string(this->binaryData), nullptr);
-
+    // The data is never modified, so the clone shares it. The Poppler document is not shared, as the original
+    // and the clone may be drawn by different threads.
+    img->binaryData = this->binaryData;
+    img->dataId = this->dataId;
+    img->parseData(nullptr);
 
     return img;
 }
 
+auto TexImage::getMemoryFootprint() const -> size_t {
+    // Data shared with clones is divided between them, so the sum over all TeX images counts it once
+    size_t dataSize = this->binaryData->capacity() / std::max<size_t>(this->binaryData.getUseCount(), 1);
+    return sizeof(TexImage) + dataSize + this->text.capacity() + getSurfaceSize(this->image);
+}
+
 void TexImage::setWidth(double width) {
     this->width = width;
     this->calcSize();
@@ -55,10 +68,10 @@ void TexImage::setHeight(double height) {
 
 auto TexImage::cairoReadFunction(TexImage* image, unsigned char* data, unsigned int length) -> cairo_status_t {
     for (unsigned int i = 0; i < length; i++, image->read++) {
-        if (image->read >= image->binaryData.length()) {
+        if (image->read >= image->binaryData->length()) {
             return CAIRO_STATUS_READ_ERROR;
         }
-        data[i] = image->binaryData[image->read];
+        data[i] = (*image->binaryData)[image->read];
     }
 
     return CAIRO_STATUS_SUCCESS;
@@ -67,23 +80,33 @@ auto TexImage::cairoReadFunction(TexImage* image, unsigned char* data, unsigned
 /**
  * Gets the binary data, a .PNG image or a .PDF
  */
-auto TexImage::getBinaryData() const -> std::string const& { return this->binaryData; }
+auto TexImage::getBinaryData() const -> std::string const& { return *this->binaryData; }
+
+auto TexImage::shareBinaryData() const -> std::shared_ptr<const std::string> { return this->binaryData.share(); }
 
 void TexImage::setText(std::string text) { this->text = std::move(text); }
 
 auto TexImage::getText() const -> std::string { return this->text; }
 
 auto TexImage::loadData(std::string&& bytes, GError** err) -> bool {
+    // The Poppler document reads the old data until it is freed
+    this->freeImageAndPdf();
+    this->binaryData = CopyOnWrite<std::string>(std::move(bytes));
+    this->dataId = nextDataId++;
+    return parseData(err);
+}
+
+auto TexImage::parseData(GError** err) -> bool {
     this->freeImageAndPdf();
-    this->binaryData = bytes;
-    if (this->binaryData.length() < 4) {
+    if (this->binaryData->length() < 4) {
         return false;
     }
 
-    const std::string type = binaryData.substr(1, 3);
+    const std::string type = binaryData->substr(1, 3);
     if (type == "PDF") {
-        // Note: binaryData must not be modified while pdf is live.
-        this->pdf = poppler_document_new_from_data(this->binaryData.data(), this->binaryData.size(), nullptr, err);
+        // Note: binaryData must not be modified while pdf is live. It is only replaced, never written to.
+        this->pdf = poppler_document_new_from_data(const_cast<char*>(this->binaryData->data()),
+                                                   static_cast<int>(this->binaryData->size()), nullptr, err);
         if (!pdf || poppler_document_get_n_pages(this->pdf) < 1) {
             return false;
         }
@@ -93,6 +116,7 @@ auto TexImage::loadData(std::string&& bytes, GError** err) -> bool {
             g_object_unref(page);
         }
     } else if (type == "PNG") {
+        this->read = 0;
         this->image = cairo_image_surface_create_from_png_stream(
                 reinterpret_cast<cairo_read_func_t>(&cairoReadFunction), this);
     } else {
@@ -106,6 +130,8 @@ auto TexImage::getImage() const -> cairo_surface_t* { return this->image; }
 
 auto TexImage::getPdf() const -> PopplerDocument* { return this->pdf; }
 
+auto TexImage::getDataId() const -> uint64_t { return this->dataId; }
+
 void TexImage::scale(double x0, double y0, double fx, double fy, double rotation,
                      bool) {  // line width scaling option is not used
 
@@ -130,7 +156,7 @@ void TexImage::serialize(ObjectOutputStream& out) {
     out.writeDouble(this->height);
     out.writeString(this->text);
 
-    out.writeData(this->binaryData.c_str(), this->binaryData.length(), 1);
+    out.writeData(this->binaryData->c_str(), this->binaryData->length(), 1);
 
     out.endObject();
 }
@@ -151,6 +177,7 @@ void TexImage::readSerialized(ObjectInputStream& in) {
     in.readData(reinterpret_cast<void**>(&data), &len);
 
     this->loadData(std::string(data, len), nullptr);
+    delete[] data;
 
     in.endObject();
     this->calcSize();
@@ -11,12 +11,14 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include <poppler.h>
 
+#include "CopyOnWrite.h"
 #include "Element.h"
 
 
@@ -38,6 +40,11 @@ public:
      */
     const std::string& getBinaryData() const;
 
+    /**
+     * @return The binary data, which is not modified while it is kept, see CopyOnWrite::share()
+     */
+    std::shared_ptr<const std::string> shareBinaryData() const;
+
     /**
      * @return The image, if render source is PNG. Note: this is deprecated.
      */
@@ -50,6 +57,11 @@ public:
      */
     PopplerDocument* getPdf() const;
 
+    /**
+     * @return Identifies the loaded data, it changes with each call of loadData(). Used as key for rendered images.
+     */
+    uint64_t getDataId() const;
+
     virtual void scale(double x0, double y0, double fx, double fy, double rotation, bool restoreLineWidth);
     virtual void rotate(double x0, double y0, double th);
 
@@ -59,6 +71,12 @@ public:
 
     virtual Element* clone();
 
+    /**
+     * The PDF (or PNG) data and the surface of a PNG. The Poppler document reads from binaryData,
+     * its own allocations are not known.
+     */
+    size_t getMemoryFootprint() const override;
+
     /**
      * @return true if the binary data (PNG or PDF) was loaded successfully.
      */
@@ -74,6 +92,11 @@ private:
 
     static cairo_status_t cairoReadFunction(TexImage* image, unsigned char* data, unsigned int length);
 
+    /**
+     * Create the PDF document or the image from binaryData
+     */
+    bool parseData(GError** err);
+
     /**
      * Free image and PDF
      */
@@ -91,15 +114,17 @@ private:
     cairo_surface_t* image = nullptr;
 
     /**
-     * PNG Image / PDF Document
+     * PNG Image / PDF Document, shared with the clones
      */
-    std::string binaryData;
+    CopyOnWrite<std::string> binaryData;
 
     /**
      * Read position for PNG binaryData (deprecated).
      */
     std::string::size_type read = 0;
 
+    uint64_t dataId = 0;
+
     /**
      * Tex String
      */
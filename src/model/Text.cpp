@@ -32,6 +32,8 @@ auto Text::clone() -> Element* {
     return text;
 }
 
+auto Text::getMemoryFootprint() const -> size_t { return sizeof(Text) + this->text.capacity(); }
+
 auto Text::getFont() -> XojFont& { return font; }
 
 void Text::setFont(const XojFont& font) { this->font = font; }
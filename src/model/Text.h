@@ -11,12 +11,16 @@
 
 #pragma once
 
+#include <memory>
+
 #include <gtk/gtk.h>
 
 #include "AudioElement.h"
 #include "Element.h"
 #include "Font.h"
 
+struct TextLayoutCache;
+
 class Text: public AudioElement {
 public:
     Text();
@@ -47,6 +51,8 @@ public:
      */
     Element* clone() override;
 
+    size_t getMemoryFootprint() const override;
+
     bool intersects(double x, double y, double halfEraserSize) override;
     bool intersects(double x, double y, double halfEraserSize, double* gap) override;
 
@@ -65,4 +71,11 @@ private:
     std::string text;
 
     bool inEditing = false;
+
+    /**
+     * The shaped text, only accessed by TextView while it holds its layout lock or the lock of the cache
+     */
+    mutable std::shared_ptr<TextLayoutCache> layoutCache;
+
+    friend class TextView;
 };
@@ -61,6 +61,39 @@ void XojPage::setSelectedLayerId(int id) { this->currentLayer = id; }
 
 auto XojPage::getLayers() -> std::vector<Layer*>* { return &this->layer; }
 
+auto XojPage::getMemoryFootprint() const -> size_t {
+    size_t bytes = sizeof(XojPage) + this->backgroundImage.getMemoryFootprint();
+    for (Layer* l: this->layer) {
+        if (!l->isLoaded()) {
+            continue;
+        }
+        for (Element* e: l->getElements()) {
+            bytes += e->getMemoryFootprint();
+        }
+    }
+    return bytes;
+}
+
+auto XojPage::unloadContents(const std::shared_ptr<PageStore>& store) -> bool {
+    if (this->pinCount > 0) {
+        return false;
+    }
+
+    bool unloaded = false;
+    for (Layer* l: this->layer) {
+        unloaded = l->unload(store) || unloaded;
+    }
+    return unloaded;
+}
+
+void XojPage::pinContents() { this->pinCount++; }
+
+void XojPage::unpinContents() { this->pinCount--; }
+
+auto XojPage::isLoaded() const -> bool {
+    return std::all_of(this->layer.begin(), this->layer.end(), [](Layer* l) { return l->isLoaded(); });
+}
+
 auto XojPage::getLayerCount() -> size_t { return this->layer.size(); }
 
 /**
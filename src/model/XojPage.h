@@ -11,11 +11,13 @@
 
 #pragma once
 
+#include <atomic>
 #include <string>
 #include <vector>
 
 #include "BackgroundImage.h"
 #include "Layer.h"
+#include "MemoryAccountable.h"
 #include "PageHandler.h"
 #include "PageType.h"
 #include "Util.h"
@@ -23,7 +25,7 @@
 template <class T>
 using optional = std::optional<T>;
 
-class XojPage: public PageHandler {
+class XojPage: public PageHandler, public MemoryAccountable {
 public:
     XojPage(double width, double height);
     ~XojPage() override;
@@ -81,6 +83,31 @@ public:
      */
     XojPage* clone();
 
+    /**
+     * The elements of all loaded layers and the background image
+     */
+    size_t getMemoryFootprint() const override;
+
+    /**
+     * Moves the elements of all layers to the page store, see Layer::unload().
+     * The document has to be locked and no element of this page may be referenced anywhere else.
+     *
+     * @return true if any layer was unloaded, false also if the page is pinned
+     */
+    bool unloadContents(const std::shared_ptr<PageStore>& store);
+
+    /**
+     * Keeps the layers from being unloaded until unpinContents() was called as often, so the page can be drawn
+     * without the document lock, e.g. by the export. Call it with the document locked.
+     */
+    void pinContents();
+    void unpinContents();
+
+    /**
+     * @return false if any layer is unloaded
+     */
+    bool isLoaded() const;
+
 private:
     /**
      * The Background image if any
@@ -113,6 +140,11 @@ private:
      */
     size_t pdfBackgroundPage = npos;
 
+    /**
+     * The number of pinContents() calls without unpinContents()
+     */
+    std::atomic<int> pinCount{0};
+
     /**
      * The background color if the background type is plain
      */
@@ -131,6 +163,12 @@ private:
     // Allow LoadHandler to add layers directly
     friend class LoadHandler;
 
+    // Allow DocumentGenerator to add layers to generated pages
+    friend class DocumentGenerator;
+
+    // Allow PageFileReader to add layers directly
+    friend class PageFileReader;
+
     // Allow LayerController to modify layers of a page
     // Notifications were be sent
     friend class LayerController;
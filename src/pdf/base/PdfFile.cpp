@@ -0,0 +1,812 @@
+#include "PdfFile.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#include <glib.h>
+#include <zlib.h>
+
+namespace {
+constexpr int MAX_DEPTH = 64;
+constexpr size_t MAX_OBJECTS = 8 * 1024 * 1024;
+
+/**
+ * Generation numbers have five digits
+ */
+constexpr long long MAX_GENERATION = 65535;
+
+auto isWhite(char c) -> bool { return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\f' || c == '\0'; }
+
+auto isDelimiter(char c) -> bool { return std::strchr("()<>[]{}/%", c) != nullptr; }
+
+auto isInteger(const std::string& token) -> bool {
+    if (token.empty()) {
+        return false;
+    }
+    size_t start = (token[0] == '+' || token[0] == '-') ? 1 : 0;
+    return start < token.size() &&
+           std::all_of(token.begin() + start, token.end(), [](char c) { return g_ascii_isdigit(c); });
+}
+
+auto toNumber(const std::string& token) -> long long {
+    if (!isInteger(token)) {
+        throw PdfFormatException("Expected an integer, got \"" + token + "\"");
+    }
+    errno = 0;
+    long long value = std::strtoll(token.c_str(), nullptr, 10);
+    if (errno == ERANGE) {
+        throw PdfFormatException("Number \"" + token + "\" is out of range");
+    }
+    return value;
+}
+
+/**
+ * @return The integer token, which has to be within [min, max]
+ */
+auto toNumber(const std::string& token, long long min, long long max) -> long long {
+    long long value = toNumber(token);
+    if (value < min || value > max) {
+        throw PdfFormatException("Number \"" + token + "\" is out of range");
+    }
+    return value;
+}
+
+/**
+ * Reads tokens and direct objects from a buffer
+ */
+class Lexer {
+public:
+    Lexer(const char* data, size_t length, size_t pos): data(data), length(length), pos(pos) {}
+
+    void skipSpace() {
+        while (pos < length) {
+            if (data[pos] == '%') {
+                while (pos < length && data[pos] != '\n' && data[pos] != '\r') {
+                    pos++;
+                }
+            } else if (isWhite(data[pos])) {
+                pos++;
+            } else {
+                return;
+            }
+        }
+    }
+
+    /**
+     * @return The next keyword or number, empty at a delimiter
+     */
+    auto readToken() -> std::string {
+        skipSpace();
+        size_t start = pos;
+        while (pos < length && !isWhite(data[pos]) && !isDelimiter(data[pos])) {
+            pos++;
+        }
+        return std::string(data + start, pos - start);
+    }
+
+    auto readObject(int level = 0) -> PdfObject {
+        if (level > MAX_DEPTH) {
+            throw PdfFormatException("Objects are nested too deep");
+        }
+        skipSpace();
+        if (pos >= length) {
+            throw PdfFormatException("Unexpected end of data");
+        }
+
+        PdfObject obj;
+        char c = data[pos];
+        if (c == '/') {
+            pos++;
+            size_t start = pos;
+            while (pos < length && !isWhite(data[pos]) && !isDelimiter(data[pos])) {
+                pos++;
+            }
+            obj.type = PdfObject::NAME;
+            obj.value.assign(data + start, pos - start);
+        } else if (c == '(') {
+            size_t start = pos++;
+            for (int nesting = 1; nesting > 0; pos++) {
+                if (pos >= length) {
+                    throw PdfFormatException("Unterminated string");
+                }
+                if (data[pos] == '\\') {
+                    pos++;
+                } else if (data[pos] == '(') {
+                    nesting++;
+                } else if (data[pos] == ')') {
+                    nesting--;
+                }
+            }
+            obj.type = PdfObject::STRING;
+            obj.value.assign(data + start, pos - start);
+        } else if (c == '<' && pos + 1 < length && data[pos + 1] == '<') {
+            pos += 2;
+            obj.type = PdfObject::DICTIONARY;
+            for (;;) {
+                skipSpace();
+                if (pos + 1 < length && data[pos] == '>' && data[pos + 1] == '>') {
+                    pos += 2;
+                    break;
+                }
+                PdfObject key = readObject(level + 1);
+                if (key.type != PdfObject::NAME) {
+                    throw PdfFormatException("Dictionary key is not a name");
+                }
+                obj.entries.emplace_back(std::move(key.value), readObject(level + 1));
+            }
+        } else if (c == '<') {
+            const void* end = std::memchr(data + pos, '>', length - pos);
+            if (end == nullptr) {
+                throw PdfFormatException("Unterminated hex string");
+            }
+            size_t start = pos;
+            pos = static_cast<size_t>(static_cast<const char*>(end) - data) + 1;
+            obj.type = PdfObject::STRING;
+            obj.value.assign(data + start, pos - start);
+        } else if (c == '[') {
+            pos++;
+            obj.type = PdfObject::ARRAY;
+            for (;;) {
+                skipSpace();
+                if (pos < length && data[pos] == ']') {
+                    pos++;
+                    break;
+                }
+                obj.items.push_back(readObject(level + 1));
+            }
+        } else {
+            std::string token = readToken();
+            if (token.empty()) {
+                throw PdfFormatException(std::string("Unexpected character '") + c + "'");
+            }
+            if (token == "null") {
+                return obj;
+            }
+            if (token == "true" || token == "false") {
+                obj.type = PdfObject::BOOLEAN;
+            } else if (isInteger(token)) {
+                // Could be the start of a reference "num gen R"
+                size_t start = pos;
+                std::string gen = readToken();
+                if (isInteger(gen) && readToken() == "R") {
+                    return PdfObject::makeReference(static_cast<int>(toNumber(token, 0, INT_MAX)),
+                                                    static_cast<int>(toNumber(gen, 0, MAX_GENERATION)));
+                }
+                pos = start;
+                obj.type = PdfObject::NUMBER;
+            } else if (std::strchr("+-.0123456789", token[0]) != nullptr) {
+                obj.type = PdfObject::NUMBER;
+            } else {
+                throw PdfFormatException("Unexpected keyword \"" + token + "\"");
+            }
+            obj.value = std::move(token);
+        }
+        return obj;
+    }
+
+    auto startsWith(const char* keyword) const -> bool {
+        size_t len = std::strlen(keyword);
+        return pos + len <= length && std::memcmp(data + pos, keyword, len) == 0;
+    }
+
+    const char* data;
+    size_t length;
+    size_t pos;
+};
+
+auto inflateData(const std::string& in) -> std::string {
+    z_stream zs{};
+    if (inflateInit(&zs) != Z_OK) {
+        throw PdfFormatException("Could not initialize zlib");
+    }
+    zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in.data()));
+    zs.avail_in = static_cast<uInt>(in.size());
+
+    std::string out;
+    char buffer[64 * 1024];
+    int ret = Z_OK;
+    while (ret != Z_STREAM_END) {
+        zs.next_out = reinterpret_cast<Bytef*>(buffer);
+        zs.avail_out = sizeof(buffer);
+        ret = inflate(&zs, Z_NO_FLUSH);
+        if (ret != Z_OK && ret != Z_STREAM_END && ret != Z_BUF_ERROR) {
+            inflateEnd(&zs);
+            throw PdfFormatException("Corrupt Flate stream");
+        }
+        if (out.size() + (sizeof(buffer) - zs.avail_out) > PdfFile::MAX_DECODED_SIZE) {
+            inflateEnd(&zs);
+            throw PdfFormatException("Flate stream is too large");
+        }
+        out.append(buffer, sizeof(buffer) - zs.avail_out);
+        if (ret == Z_BUF_ERROR) {
+            // Truncated data, use what could be decoded, as other readers do
+            break;
+        }
+    }
+    inflateEnd(&zs);
+    return out;
+}
+
+/**
+ * Reverts the PNG predictors, which are used by most cross reference streams
+ */
+auto unpredict(const std::string& in, const PdfObject* params) -> std::string {
+    auto param = [params](const char* key, int def, int max) {
+        const PdfObject* p = params ? params->get(key) : nullptr;
+        return p ? static_cast<int>(p->getInteger(0, max)) : def;
+    };
+    int predictor = param("Predictor", 1, 15);
+    if (predictor == 1) {
+        return in;
+    }
+    if (predictor < 10) {
+        throw PdfFormatException("TIFF predictors are not supported");
+    }
+
+    // The output is never larger than the input
+    int bits = param("Colors", 1, 32) * param("BitsPerComponent", 8, 16);
+    int columns = param("Columns", 1, static_cast<int>(std::min<size_t>(in.size(), INT_MAX)));
+    if (bits <= 0 || columns <= 0) {
+        throw PdfFormatException("Invalid predictor parameters");
+    }
+    size_t bpp = std::max(1, bits / 8);
+    size_t rowLength = (static_cast<size_t>(columns) * static_cast<size_t>(bits) + 7) / 8;
+
+    std::string out;
+    std::string prev(rowLength, '\0');
+    std::string row(rowLength, '\0');
+    for (size_t pos = 0; pos + rowLength + 1 <= in.size(); pos += rowLength + 1) {
+        auto type = static_cast<uint8_t>(in[pos]);
+        for (size_t i = 0; i < rowLength; i++) {
+            int raw = static_cast<uint8_t>(in[pos + 1 + i]);
+            int left = i >= bpp ? static_cast<uint8_t>(row[i - bpp]) : 0;
+            int up = static_cast<uint8_t>(prev[i]);
+            int upLeft = i >= bpp ? static_cast<uint8_t>(prev[i - bpp]) : 0;
+            int value = raw;
+            switch (type) {
+                case 0:
+                    break;
+                case 1:
+                    value += left;
+                    break;
+                case 2:
+                    value += up;
+                    break;
+                case 3:
+                    value += (left + up) / 2;
+                    break;
+                case 4: {
+                    int p = left + up - upLeft;
+                    int pa = std::abs(p - left);
+                    int pb = std::abs(p - up);
+                    int pc = std::abs(p - upLeft);
+                    value += (pa <= pb && pa <= pc) ? left : (pb <= pc ? up : upLeft);
+                    break;
+                }
+                default:
+                    throw PdfFormatException("Invalid PNG predictor");
+            }
+            row[i] = static_cast<char>(value);
+        }
+        out += row;
+        std::swap(row, prev);
+    }
+    return out;
+}
+}  // namespace
+
+auto PdfObject::makeNumber(double value) -> PdfObject {
+    char buffer[G_ASCII_DTOSTR_BUF_SIZE];
+    g_ascii_formatd(buffer, sizeof(buffer), "%.4f", value);
+    std::string text = buffer;
+    text.erase(text.find_last_not_of('0') + 1);
+    if (text.back() == '.') {
+        text.pop_back();
+    }
+    if (text == "-0") {
+        text = "0";
+    }
+
+    PdfObject obj;
+    obj.type = NUMBER;
+    obj.value = std::move(text);
+    return obj;
+}
+
+auto PdfObject::makeName(std::string name) -> PdfObject {
+    PdfObject obj;
+    obj.type = NAME;
+    obj.value = std::move(name);
+    return obj;
+}
+
+auto PdfObject::makeReference(int num, int gen) -> PdfObject {
+    PdfObject obj;
+    obj.type = REFERENCE;
+    obj.num = num;
+    obj.gen = gen;
+    return obj;
+}
+
+auto PdfObject::makeArray() -> PdfObject {
+    PdfObject obj;
+    obj.type = ARRAY;
+    return obj;
+}
+
+auto PdfObject::makeDictionary() -> PdfObject {
+    PdfObject obj;
+    obj.type = DICTIONARY;
+    return obj;
+}
+
+auto PdfObject::makeStream(std::string data) -> PdfObject {
+    PdfObject obj;
+    obj.type = STREAM;
+    obj.data = std::move(data);
+    return obj;
+}
+
+auto PdfObject::isName(const char* name) const -> bool { return this->type == NAME && this->value == name; }
+
+auto PdfObject::getNumber() const -> double {
+    if (this->type != NUMBER) {
+        throw PdfFormatException("Expected a number");
+    }
+    return g_ascii_strtod(this->value.c_str(), nullptr);
+}
+
+auto PdfObject::getInteger(long long min, long long max) const -> long long {
+    double value = getNumber();
+    // Also false for NaN
+    if (!(value >= static_cast<double>(min) && value <= static_cast<double>(max))) {
+        throw PdfFormatException("Number " + this->value + " is out of range");
+    }
+    return std::llround(value);
+}
+
+auto PdfObject::get(const std::string& key) const -> const PdfObject* {
+    for (const auto& entry: this->entries) {
+        if (entry.first == key) {
+            return &entry.second;
+        }
+    }
+    return nullptr;
+}
+
+void PdfObject::set(const std::string& key, PdfObject obj) {
+    for (auto& entry: this->entries) {
+        if (entry.first == key) {
+            entry.second = std::move(obj);
+            return;
+        }
+    }
+    this->entries.emplace_back(key, std::move(obj));
+}
+
+void PdfObject::remove(const std::string& key) {
+    this->entries.erase(std::remove_if(this->entries.begin(), this->entries.end(),
+                                       [&key](const auto& entry) { return entry.first == key; }),
+                        this->entries.end());
+}
+
+void PdfObject::write(std::string& out) const {
+    switch (this->type) {
+        case NONE:
+            out += "null";
+            break;
+        case BOOLEAN:
+        case NUMBER:
+        case STRING:
+            out += this->value;
+            break;
+        case NAME:
+            out += "/" + this->value;
+            break;
+        case ARRAY:
+            out += "[";
+            for (size_t i = 0; i < this->items.size(); i++) {
+                if (i > 0) {
+                    out += " ";
+                }
+                this->items[i].write(out);
+            }
+            out += "]";
+            break;
+        case REFERENCE:
+            out += std::to_string(this->num) + " " + std::to_string(this->gen) + " R";
+            break;
+        case DICTIONARY:
+        case STREAM:
+            out += "<<";
+            for (const auto& entry: this->entries) {
+                if (this->type == STREAM && entry.first == "Length") {
+                    continue;
+                }
+                out += "/" + entry.first + " ";
+                entry.second.write(out);
+                out += "\n";
+            }
+            if (this->type == STREAM) {
+                out += "/Length " + std::to_string(this->data.size()) + ">>\nstream\n";
+                out += this->data;
+                out += "\nendstream";
+            } else {
+                out += ">>";
+            }
+            break;
+    }
+}
+
+PdfFile::PdfFile(const char* data, size_t length): data(data), length(length) {
+    if (length < 8 || std::memcmp(data, "%PDF-", 5) != 0) {
+        throw PdfFormatException("Not a PDF file");
+    }
+
+    // The offset of the cross reference is written at the end of the file
+    size_t tail = std::min<size_t>(length, 1024);
+    std::string end(data + length - tail, tail);
+    size_t found = end.rfind("startxref");
+    if (found == std::string::npos) {
+        throw PdfFormatException("startxref not found");
+    }
+    Lexer lexer(data, length, length - tail + found + 9);
+    this->xrefOffset = static_cast<size_t>(toNumber(lexer.readToken(), 1, LLONG_MAX));
+    if (this->xrefOffset >= length) {
+        throw PdfFormatException("Invalid startxref");
+    }
+
+    std::set<size_t> visited;
+    readXref(this->xrefOffset, visited);
+}
+
+void PdfFile::setEntry(size_t num, int type, size_t offset, int gen) {
+    if (num >= MAX_OBJECTS) {
+        throw PdfFormatException("Too many objects");
+    }
+    // Objects in an object stream are found by the number of the stream
+    if ((type == 1 && offset >= this->length) || (type == 2 && offset >= MAX_OBJECTS)) {
+        throw PdfFormatException("Invalid cross reference entry for object " + std::to_string(num));
+    }
+    if (num >= this->xref.size()) {
+        this->xref.resize(num + 1);
+    }
+    // The newest revision is read first and wins
+    if (this->xref[num].type == -1) {
+        this->xref[num] = {type, offset, gen};
+    }
+}
+
+void PdfFile::readXref(size_t offset, std::set<size_t>& visited) {
+    if (offset >= this->length || !visited.insert(offset).second) {
+        throw PdfFormatException("Invalid cross reference offset");
+    }
+
+    Lexer lexer(this->data, this->length, offset);
+    lexer.skipSpace();
+    PdfObject sectionTrailer;
+    if (lexer.startsWith("xref")) {
+        lexer.pos += 4;
+        for (std::string token = lexer.readToken(); token != "trailer"; token = lexer.readToken()) {
+            auto first = static_cast<size_t>(toNumber(token, 0, MAX_OBJECTS));
+            auto count = static_cast<size_t>(toNumber(lexer.readToken(), 0, MAX_OBJECTS));
+            for (size_t i = 0; i < count; i++) {
+                auto entryOffset = static_cast<size_t>(toNumber(lexer.readToken(), 0, LLONG_MAX));
+                int gen = static_cast<int>(toNumber(lexer.readToken(), 0, MAX_GENERATION));
+                std::string kind = lexer.readToken();
+                if (kind != "n" && kind != "f") {
+                    throw PdfFormatException("Invalid cross reference entry");
+                }
+                // Free entries hold the next free object number, not an offset
+                setEntry(first + i, kind == "n" ? 1 : 0, kind == "n" ? entryOffset : 0, gen);
+            }
+        }
+        sectionTrailer = lexer.readObject();
+        if (sectionTrailer.type != PdfObject::DICTIONARY) {
+            throw PdfFormatException("Invalid trailer");
+        }
+        if (this->trailer.type == PdfObject::NONE) {
+            this->trailer = sectionTrailer;
+        }
+
+        // Hybrid files list the objects of object streams in an additional cross reference stream
+        if (const PdfObject* stream = sectionTrailer.get("XRefStm")) {
+            readXrefStream(parseObjectAt(toOffset(*stream), -1));
+        }
+    } else {
+        PdfObject stream = parseObjectAt(offset, -1);
+        if (stream.type != PdfObject::STREAM || !stream.get("Type") || !stream.get("Type")->isName("XRef")) {
+            throw PdfFormatException("Invalid cross reference stream");
+        }
+        if (this->trailer.type == PdfObject::NONE) {
+            this->trailer.type = PdfObject::DICTIONARY;
+            this->trailer.entries = stream.entries;
+            this->xrefStream = true;
+        }
+        readXrefStream(stream);
+        sectionTrailer.entries = std::move(stream.entries);
+    }
+
+    if (const PdfObject* prev = sectionTrailer.get("Prev")) {
+        readXref(toOffset(*prev), visited);
+    }
+}
+
+void PdfFile::readXrefStream(const PdfObject& stream) {
+    const PdfObject* w = stream.get("W");
+    if (!w || w->type != PdfObject::ARRAY || w->items.size() != 3) {
+        throw PdfFormatException("Invalid /W of cross reference stream");
+    }
+    size_t widths[3];
+    for (int i = 0; i < 3; i++) {
+        widths[i] = static_cast<size_t>(w->items[i].getInteger(0, 8));
+    }
+    size_t entryLength = widths[0] + widths[1] + widths[2];
+    if (entryLength == 0) {
+        throw PdfFormatException("Invalid /W of cross reference stream");
+    }
+
+    std::vector<size_t> index;
+    if (const PdfObject* idx = stream.get("Index")) {
+        for (const PdfObject& item: idx->items) {
+            index.push_back(static_cast<size_t>(item.getInteger(0, MAX_OBJECTS)));
+        }
+    } else {
+        const PdfObject* size = stream.get("Size");
+        if (!size) {
+            throw PdfFormatException("Cross reference stream without /Size");
+        }
+        index = {0, static_cast<size_t>(size->getInteger(0, MAX_OBJECTS))};
+    }
+
+    std::string entries = decodeStream(stream);
+    size_t pos = 0;
+    auto readField = [&](size_t width, size_t def) {
+        if (width == 0) {
+            return def;
+        }
+        size_t value = 0;
+        for (size_t i = 0; i < width; i++) {
+            value = (value << 8U) | static_cast<uint8_t>(entries[pos++]);
+        }
+        return value;
+    };
+    for (size_t i = 0; i + 1 < index.size(); i += 2) {
+        for (size_t n = 0; n < index[i + 1]; n++) {
+            if (pos + entryLength > entries.size()) {
+                throw PdfFormatException("Cross reference stream is too short");
+            }
+            size_t type = readField(widths[0], 1);
+            size_t field2 = readField(widths[1], 0);
+            size_t field3 = readField(widths[2], 0);
+            if (type == 0) {
+                setEntry(index[i] + n, 0, 0, 0);
+            } else if (type <= 2) {
+                // The generation, or the index in the object stream
+                if (field3 > (type == 1 ? static_cast<size_t>(MAX_GENERATION) : MAX_OBJECTS)) {
+                    throw PdfFormatException("Invalid cross reference stream entry");
+                }
+                setEntry(index[i] + n, static_cast<int>(type), field2, static_cast<int>(field3));
+            }
+        }
+    }
+}
+
+auto PdfFile::toOffset(const PdfObject& obj) const -> size_t {
+    return static_cast<size_t>(obj.getInteger(0, static_cast<long long>(this->length) - 1));
+}
+
+auto PdfFile::parseObjectAt(size_t offset, int num) -> PdfObject {
+    Lexer lexer(this->data, this->length, offset);
+    std::string objNum = lexer.readToken();
+    lexer.readToken();
+    if (lexer.readToken() != "obj" || (num >= 0 && toNumber(objNum) != num)) {
+        throw PdfFormatException("Object " + std::to_string(num) + " not found at its offset");
+    }
+
+    PdfObject obj = lexer.readObject();
+    lexer.skipSpace();
+    if (obj.type != PdfObject::DICTIONARY || !lexer.startsWith("stream")) {
+        return obj;
+    }
+
+    lexer.pos += 6;
+    if (lexer.pos < this->length && this->data[lexer.pos] == '\r') {
+        lexer.pos++;
+    }
+    if (lexer.pos < this->length && this->data[lexer.pos] == '\n') {
+        lexer.pos++;
+    }
+    size_t start = lexer.pos;
+
+    // Use /Length if it is right, else search the end of the stream
+    size_t end = std::string::npos;
+    if (const PdfObject* lengthObj = obj.get("Length")) {
+        PdfObject streamLength = resolve(*lengthObj);
+        if (streamLength.type == PdfObject::NUMBER && streamLength.getNumber() >= 0 &&
+            streamLength.getNumber() <= static_cast<double>(this->length - start)) {
+            Lexer check(this->data, this->length, start + static_cast<size_t>(streamLength.getNumber()));
+            check.skipSpace();
+            if (check.startsWith("endstream")) {
+                end = start + static_cast<size_t>(streamLength.getNumber());
+            }
+        }
+    }
+    if (end == std::string::npos) {
+        const char* found = g_strstr_len(this->data + start, static_cast<gssize>(this->length - start), "endstream");
+        if (found == nullptr) {
+            throw PdfFormatException("Unterminated stream");
+        }
+        end = static_cast<size_t>(found - this->data);
+        if (end > start && this->data[end - 1] == '\n') {
+            end--;
+        }
+        if (end > start && this->data[end - 1] == '\r') {
+            end--;
+        }
+    }
+
+    obj.type = PdfObject::STREAM;
+    obj.data.assign(this->data + start, end - start);
+    return obj;
+}
+
+auto PdfFile::parseFromObjectStream(int streamNum, int num) -> PdfObject {
+    auto it = this->objectStreams.find(streamNum);
+    if (it == this->objectStreams.end()) {
+        PdfObject stream = getObject(streamNum);
+        const PdfObject* count = stream.get("N");
+        const PdfObject* first = stream.get("First");
+        if (stream.type != PdfObject::STREAM || !count || !first) {
+            throw PdfFormatException("Invalid object stream");
+        }
+        std::string content = decodeStream(stream);
+        auto contentSize = static_cast<long long>(content.size());
+        ObjectStream decoded{std::move(content), count->getInteger(0, contentSize), first->getInteger(0, contentSize)};
+        it = this->objectStreams.emplace(streamNum, std::move(decoded)).first;
+    }
+
+    // The stream starts with N pairs of object number and offset, relative to /First
+    const ObjectStream& objStream = it->second;
+    const std::string& content = objStream.data;
+    Lexer lexer(content.data(), content.size(), 0);
+    for (long long i = 0; i < objStream.count; i++) {
+        long long objNum = toNumber(lexer.readToken());
+        long long offset = toNumber(lexer.readToken(), 0, static_cast<long long>(content.size()) - objStream.first);
+        if (objNum == num) {
+            Lexer objLexer(content.data(), content.size(), static_cast<size_t>(objStream.first + offset));
+            return objLexer.readObject();
+        }
+    }
+    throw PdfFormatException("Object " + std::to_string(num) + " not found in its object stream");
+}
+
+auto PdfFile::getObject(int num) -> PdfObject {
+    if (num < 0 || static_cast<size_t>(num) >= this->xref.size() || this->xref[num].type <= 0) {
+        return PdfObject();
+    }
+    if (this->depth >= MAX_DEPTH) {
+        throw PdfFormatException("References are nested too deep");
+    }
+
+    struct DepthGuard {
+        int& depth;
+        ~DepthGuard() { depth--; }
+    } guard{++this->depth};
+
+    const XrefEntry& entry = this->xref[num];
+    if (entry.type == 1) {
+        return parseObjectAt(entry.offset, num);
+    }
+    return parseFromObjectStream(static_cast<int>(entry.offset), num);
+}
+
+auto PdfFile::resolve(const PdfObject& obj) -> PdfObject {
+    if (obj.type != PdfObject::REFERENCE) {
+        return obj;
+    }
+    return getObject(obj.num);
+}
+
+auto PdfFile::decodeStream(const PdfObject& stream) -> std::string {
+    PdfObject filters = resolve(stream.get("Filter") ? *stream.get("Filter") : PdfObject());
+    PdfObject params = resolve(stream.get("DecodeParms") ? *stream.get("DecodeParms") : PdfObject());
+    if (filters.type == PdfObject::NAME) {
+        PdfObject filter = std::move(filters);
+        filters = PdfObject::makeArray();
+        filters.items.push_back(std::move(filter));
+        PdfObject param = std::move(params);
+        params = PdfObject::makeArray();
+        params.items.push_back(std::move(param));
+    }
+
+    std::string decoded = stream.data;
+    for (size_t i = 0; i < filters.items.size(); i++) {
+        if (!filters.items[i].isName("FlateDecode") && !filters.items[i].isName("Fl")) {
+            throw PdfFormatException("Filter /" + filters.items[i].value + " is not supported");
+        }
+        PdfObject param = i < params.items.size() ? resolve(params.items[i]) : PdfObject();
+        decoded = unpredict(inflateData(decoded), param.type == PdfObject::DICTIONARY ? &param : nullptr);
+    }
+    return decoded;
+}
+
+void PdfFile::collectPages(const PdfObject& node, PdfObject inherited, std::vector<PdfPage>& pages,
+                           std::set<int>& visited) {
+    if (node.type != PdfObject::REFERENCE || !visited.insert(node.num).second) {
+        throw PdfFormatException("Invalid page tree");
+    }
+
+    PdfObject dict = getObject(node.num);
+    if (dict.type != PdfObject::DICTIONARY) {
+        throw PdfFormatException("Invalid page tree node");
+    }
+
+    const char* inheritable[] = {"Resources", "MediaBox", "CropBox", "Rotate"};
+    const PdfObject* kids = dict.get("Kids");
+    if (kids == nullptr) {
+        for (const char* key: inheritable) {
+            if (!dict.get(key) && inherited.get(key)) {
+                dict.set(key, *inherited.get(key));
+            }
+        }
+        pages.push_back({node.num, node.gen, std::move(dict)});
+        return;
+    }
+
+    for (const char* key: inheritable) {
+        if (dict.get(key)) {
+            inherited.set(key, *dict.get(key));
+        }
+    }
+    PdfObject kidArray = resolve(*kids);
+    for (const PdfObject& kid: kidArray.items) {
+        collectPages(kid, inherited, pages, visited);
+    }
+}
+
+auto PdfFile::getPages() -> std::vector<PdfPage> {
+    const PdfObject* root = this->trailer.get("Root");
+    if (!root) {
+        throw PdfFormatException("The trailer has no /Root");
+    }
+    PdfObject catalog = resolve(*root);
+    const PdfObject* pagesRoot = catalog.get("Pages");
+    if (!pagesRoot) {
+        throw PdfFormatException("The catalog has no /Pages");
+    }
+
+    std::vector<PdfPage> pages;
+    std::set<int> visited;
+    collectPages(*pagesRoot, PdfObject::makeDictionary(), pages, visited);
+    return pages;
+}
+
+auto PdfFile::getTrailer() const -> const PdfObject& { return this->trailer; }
+
+auto PdfFile::getSize() const -> int {
+    const PdfObject* size = this->trailer.get("Size");
+    int trailerSize =
+            size && size->type == PdfObject::NUMBER ? static_cast<int>(size->getInteger(0, MAX_OBJECTS)) : 0;
+    return std::max(trailerSize, static_cast<int>(this->xref.size()));
+}
+
+auto PdfFile::getXrefOffset() const -> size_t { return this->xrefOffset; }
+
+auto PdfFile::usesXrefStream() const -> bool { return this->xrefStream; }
+
+auto PdfFile::isEncrypted() const -> bool { return this->trailer.get("Encrypt") != nullptr; }
+
+auto PdfFile::getLength() const -> size_t { return this->length; }
+
+auto PdfFile::getVersion() const -> std::string {
+    size_t end = 5;
+    while (end < this->length && end < 16 && !isWhite(this->data[end])) {
+        end++;
+    }
+    return std::string(this->data + 5, end - 5);
+}
@@ -0,0 +1,217 @@
+/*
+ * Xournal++
+ *
+ * Minimal reader for the object structure of PDF files
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief The file is damaged or uses a feature which is not supported
+ */
+class PdfFormatException: public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+/**
+ * @brief A PDF object, as far as it is needed to copy objects from one file into another
+ *
+ * Booleans, numbers and strings keep their source text, so they are written back unchanged.
+ */
+struct PdfObject {
+    enum Type { NONE, BOOLEAN, NUMBER, STRING, NAME, ARRAY, DICTIONARY, REFERENCE, STREAM };
+
+    static PdfObject makeNumber(double value);
+    static PdfObject makeName(std::string name);
+    static PdfObject makeReference(int num, int gen = 0);
+    static PdfObject makeArray();
+    static PdfObject makeDictionary();
+    static PdfObject makeStream(std::string data);
+
+    bool isName(const char* name) const;
+    double getNumber() const;
+
+    /**
+     * @return The number rounded to an integer, which has to be within [min, max]
+     */
+    long long getInteger(long long min, long long max) const;
+
+    /**
+     * @return The dictionary entry, or nullptr
+     */
+    const PdfObject* get(const std::string& key) const;
+    void set(const std::string& key, PdfObject obj);
+    void remove(const std::string& key);
+
+    /**
+     * Appends the PDF syntax of the object. The /Length of streams is set to their data.
+     */
+    void write(std::string& out) const;
+
+    Type type = NONE;
+
+    /**
+     * The source text of booleans, numbers and strings, and names without the slash
+     */
+    std::string value;
+
+    std::vector<PdfObject> items;
+
+    /**
+     * The entries of dictionaries and of stream dictionaries, the keys without the slash
+     */
+    std::vector<std::pair<std::string, PdfObject>> entries;
+
+    int num = 0;
+    int gen = 0;
+
+    /**
+     * The encoded data of streams
+     */
+    std::string data;
+};
+
+/**
+ * @brief A page of the page tree, with the inherited attributes copied into its dictionary
+ */
+struct PdfPage {
+    int num = 0;
+    int gen = 0;
+    PdfObject dict;
+};
+
+/**
+ * @brief Reads objects of a PDF file through its cross reference
+ *
+ * Classic cross reference tables, cross reference streams and object streams are supported, filters only as far
+ * as needed for them, which is Flate with PNG predictors. Objects are parsed on access. Encryption is not
+ * supported, see isEncrypted(). All methods throw PdfFormatException if the file cannot be read. Numbers are
+ * range checked before they are used as offsets, object numbers or sizes, and decoded streams are limited to
+ * MAX_DECODED_SIZE, so a damaged or hostile file cannot make the reader allocate arbitrary amounts of memory.
+ */
+class PdfFile {
+public:
+    /**
+     * Maximum size of a decoded stream
+     */
+    static constexpr size_t MAX_DECODED_SIZE = 128 * 1024 * 1024;
+
+    /**
+     * @param data The file contents, which have to stay valid while this object is used
+     */
+    PdfFile(const char* data, size_t length);
+
+public:
+    /**
+     * @return The object, or a null object if it is not in the file
+     */
+    PdfObject getObject(int num);
+
+    /**
+     * @return The object a reference points to, any other object unchanged
+     */
+    PdfObject resolve(const PdfObject& obj);
+
+    /**
+     * @return The decoded data of the stream
+     */
+    std::string decodeStream(const PdfObject& stream);
+
+    /**
+     * @return The pages in document order
+     */
+    std::vector<PdfPage> getPages();
+
+    /**
+     * The trailer of the newest revision, for a cross reference stream its dictionary
+     */
+    const PdfObject& getTrailer() const;
+
+    /**
+     * @return The first object number not used by the file
+     */
+    int getSize() const;
+
+    /**
+     * @return The offset of the newest cross reference section
+     */
+    size_t getXrefOffset() const;
+
+    /**
+     * @return true if the newest cross reference section is a stream
+     */
+    bool usesXrefStream() const;
+
+    bool isEncrypted() const;
+
+    /**
+     * @return The length of the file, where an incremental update starts
+     */
+    size_t getLength() const;
+
+    /**
+     * @return The version of the file header, e.g. "1.4"
+     */
+    std::string getVersion() const;
+
+private:
+    struct XrefEntry {
+        /**
+         * -1 for not set, 0 for free, 1 for an offset in the file, 2 for an object in an object stream
+         */
+        int type = -1;
+        size_t offset = 0;
+        int gen = 0;
+    };
+
+    void readXref(size_t offset, std::set<size_t>& visited);
+    void readXrefStream(const PdfObject& stream);
+    void setEntry(size_t num, int type, size_t offset, int gen);
+
+    /**
+     * @return The number as offset in the file
+     */
+    size_t toOffset(const PdfObject& obj) const;
+
+    PdfObject parseObjectAt(size_t offset, int num);
+    PdfObject parseFromObjectStream(int streamNum, int num);
+    void collectPages(const PdfObject& node, PdfObject inherited, std::vector<PdfPage>& pages, std::set<int>& visited);
+
+private:
+    const char* data;
+    size_t length;
+
+    std::vector<XrefEntry> xref;
+    PdfObject trailer;
+    size_t xrefOffset = 0;
+    bool xrefStream = false;
+
+    struct ObjectStream {
+        std::string data;
+        long long count;
+        long long first;
+    };
+
+    /**
+     * The decoded object streams, by object number
+     */
+    std::map<int, ObjectStream> objectStreams;
+
+    /**
+     * Guards against reference loops, e.g. a /Length pointing to its own stream
+     */
+    int depth = 0;
+};
@@ -0,0 +1,373 @@
+#include "PdfOverlayMerger.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <set>
+
+namespace {
+auto makeNumberArray(const double* values, size_t count) -> PdfObject {
+    PdfObject array = PdfObject::makeArray();
+    for (size_t i = 0; i < count; i++) {
+        array.items.push_back(PdfObject::makeNumber(values[i]));
+    }
+    return array;
+}
+}  // namespace
+
+PdfOverlayMerger::PdfOverlayMerger(PdfFile& source, PdfFile& overlay): source(source), overlay(overlay) {}
+
+auto PdfOverlayMerger::merge(const std::vector<size_t>& sourcePages) -> std::string {
+    if (this->source.isEncrypted()) {
+        throw PdfFormatException("Encrypted files are not supported");
+    }
+    std::vector<PdfPage> srcPages = this->source.getPages();
+    std::vector<PdfPage> ovlPages = this->overlay.getPages();
+    if (ovlPages.size() != sourcePages.size()) {
+        throw PdfFormatException("The overlay does not have the expected number of pages");
+    }
+
+    // The source may not end with a newline
+    this->out = "\n";
+    this->nextNum = this->source.getSize();
+    int pagesNum = this->nextNum++;
+
+    PdfObject kids = PdfObject::makeArray();
+    std::set<size_t> used;
+    bool sameOrder = sourcePages.size() == srcPages.size();
+    for (size_t i = 0; i < sourcePages.size(); i++) {
+        size_t nr = sourcePages[i];
+        sameOrder = sameOrder && nr == i;
+
+        PdfObject page;
+        int num = 0;
+        int gen = 0;
+        if (nr == npos) {
+            num = this->nextNum++;
+            page = copyOverlayPage(ovlPages[i], num);
+        } else {
+            if (nr >= srcPages.size()) {
+                throw PdfFormatException("Page " + std::to_string(nr + 1) + " is not in the source file");
+            }
+            page = drawOnSourcePage(srcPages[nr], ovlPages[i]);
+            if (used.insert(nr).second) {
+                // Replaces the original page, so links to it stay valid
+                num = srcPages[nr].num;
+                gen = srcPages[nr].gen;
+            } else {
+                num = this->nextNum++;
+                page.remove("Annots");
+                page.remove("StructParents");
+                page.remove("B");
+            }
+        }
+        page.set("Parent", PdfObject::makeReference(pagesNum));
+        writeObject(num, gen, page);
+        kids.items.push_back(PdfObject::makeReference(num, gen));
+    }
+
+    PdfObject pages = PdfObject::makeDictionary();
+    pages.set("Type", PdfObject::makeName("Pages"));
+    pages.set("Count", PdfObject::makeNumber(static_cast<double>(kids.items.size())));
+    pages.set("Kids", std::move(kids));
+    writeObject(pagesNum, 0, pages);
+
+    const PdfObject* root = this->source.getTrailer().get("Root");
+    PdfObject catalog = this->source.getObject(root->num);
+    if (catalog.type != PdfObject::DICTIONARY) {
+        throw PdfFormatException("Invalid catalog");
+    }
+    catalog.set("Pages", PdfObject::makeReference(pagesNum));
+    if (!sameOrder) {
+        // The labels are assigned by page index
+        catalog.remove("PageLabels");
+    }
+    const PdfObject* version = catalog.get("Version");
+    std::string sourceVersion = version && version->type == PdfObject::NAME ?
+                                        std::max(version->value, this->source.getVersion()) :
+                                        this->source.getVersion();
+    if (this->overlay.getVersion() > sourceVersion) {
+        catalog.set("Version", PdfObject::makeName(this->overlay.getVersion()));
+    }
+    writeObject(root->num, root->gen, catalog);
+
+    writeXref();
+    return std::move(this->out);
+}
+
+auto PdfOverlayMerger::drawOnSourcePage(const PdfPage& sourcePage, const PdfPage& overlayPage) -> PdfObject {
+    PdfObject page = sourcePage.dict;
+
+    int formNum = this->nextNum++;
+    writeObject(formNum, 0, createForm(overlayPage, sourcePage));
+
+    PdfObject resources = this->source.resolve(page.get("Resources") ? *page.get("Resources") : PdfObject());
+    if (resources.type == PdfObject::NONE) {
+        resources = PdfObject::makeDictionary();
+    }
+    PdfObject xobjects = this->source.resolve(resources.get("XObject") ? *resources.get("XObject") : PdfObject());
+    if (xobjects.type == PdfObject::NONE) {
+        xobjects = PdfObject::makeDictionary();
+    }
+    if (resources.type != PdfObject::DICTIONARY || xobjects.type != PdfObject::DICTIONARY) {
+        throw PdfFormatException("Invalid page resources");
+    }
+    std::string name = "XopOverlay";
+    for (int n = 1; xobjects.get(name); n++) {
+        name = "XopOverlay" + std::to_string(n);
+    }
+    xobjects.set(name, PdfObject::makeReference(formNum));
+    resources.set("XObject", std::move(xobjects));
+    page.set("Resources", std::move(resources));
+
+    // The original content is wrapped into q / Q, as it may leave the graphics state changed
+    PdfObject contents = PdfObject::makeArray();
+    contents.items.push_back(PdfObject::makeReference(getContentStream("q\n")));
+    if (const PdfObject* original = page.get("Contents")) {
+        PdfObject resolved = this->source.resolve(*original);
+        if (resolved.type == PdfObject::ARRAY) {
+            contents.items.insert(contents.items.end(), resolved.items.begin(), resolved.items.end());
+        } else if (original->type == PdfObject::REFERENCE) {
+            contents.items.push_back(*original);
+        }
+    }
+    contents.items.push_back(PdfObject::makeReference(getContentStream("\nQ q /" + name + " Do Q\n")));
+    page.set("Contents", std::move(contents));
+    return page;
+}
+
+auto PdfOverlayMerger::copyOverlayPage(const PdfPage& overlayPage, int num) -> PdfObject {
+    // References back to the page, e.g. of annotations, point to the copy
+    this->imported[overlayPage.num] = num;
+
+    PdfObject page = PdfObject::makeDictionary();
+    for (const auto& entry: overlayPage.dict.entries) {
+        if (entry.first != "Parent") {
+            page.set(entry.first, importObject(entry.second));
+        }
+    }
+    return page;
+}
+
+auto PdfOverlayMerger::createForm(const PdfPage& overlayPage, const PdfPage& sourcePage) -> PdfObject {
+    std::vector<PdfObject> streams;
+    if (const PdfObject* contents = overlayPage.dict.get("Contents")) {
+        PdfObject resolved = this->overlay.resolve(*contents);
+        if (resolved.type == PdfObject::ARRAY) {
+            for (const PdfObject& item: resolved.items) {
+                streams.push_back(this->overlay.resolve(item));
+            }
+        } else {
+            streams.push_back(std::move(resolved));
+        }
+    }
+
+    PdfObject form;
+    if (streams.size() == 1 && streams[0].type == PdfObject::STREAM) {
+        // The common case, the stream is copied without decoding it
+        form = PdfObject::makeStream(std::move(streams[0].data));
+        for (const char* key: {"Filter", "DecodeParms"}) {
+            if (const PdfObject* value = streams[0].get(key)) {
+                form.set(key, importObject(*value));
+            }
+        }
+    } else {
+        std::string data;
+        for (const PdfObject& stream: streams) {
+            if (stream.type != PdfObject::STREAM) {
+                throw PdfFormatException("Invalid page contents");
+            }
+            data += this->overlay.decodeStream(stream) + "\n";
+        }
+        form = PdfObject::makeStream(std::move(data));
+    }
+
+    std::array<double, 4> box = getBox(this->overlay, overlayPage.dict, "MediaBox");
+    std::array<double, 6> matrix = getFormMatrix(overlayPage, sourcePage);
+    form.set("Type", PdfObject::makeName("XObject"));
+    form.set("Subtype", PdfObject::makeName("Form"));
+    form.set("BBox", makeNumberArray(box.data(), box.size()));
+    form.set("Matrix", makeNumberArray(matrix.data(), matrix.size()));
+    if (const PdfObject* resources = overlayPage.dict.get("Resources")) {
+        form.set("Resources", importObject(*resources));
+    }
+    return form;
+}
+
+auto PdfOverlayMerger::getFormMatrix(const PdfPage& overlayPage, const PdfPage& sourcePage) -> std::array<double, 6> {
+    std::array<double, 4> crop = sourcePage.dict.get("CropBox") ? getBox(this->source, sourcePage.dict, "CropBox") :
+                                                                  getBox(this->source, sourcePage.dict, "MediaBox");
+    std::array<double, 4> overlayBox = getBox(this->overlay, overlayPage.dict, "MediaBox");
+
+    int rotate = 0;
+    if (const PdfObject* r = sourcePage.dict.get("Rotate")) {
+        rotate = (static_cast<int>(this->source.resolve(*r).getInteger(-3600, 3600)) % 360 + 360) % 360;
+    }
+    double x0 = crop[0];
+    double y0 = crop[1];
+    double x1 = crop[2];
+    double y1 = crop[3];
+
+    // Maps the upright visible page to the source page, see the /Rotate entry in the PDF reference
+    std::array<double, 6> m{};
+    switch (rotate) {
+        case 0:
+            m = {1, 0, 0, 1, x0, y0};
+            break;
+        case 90:
+            m = {0, 1, -1, 0, x1, y0};
+            break;
+        case 180:
+            m = {-1, 0, 0, -1, x1, y1};
+            break;
+        case 270:
+            m = {0, -1, 1, 0, x0, y1};
+            break;
+        default:
+            throw PdfFormatException("Invalid /Rotate");
+    }
+
+    // Both pages are aligned at the top left corner, as the overlay is drawn over the rendered page
+    double visibleHeight = (rotate == 90 || rotate == 270) ? x1 - x0 : y1 - y0;
+    double dx = -overlayBox[0];
+    double dy = visibleHeight - overlayBox[3];
+    m[4] += m[0] * dx + m[2] * dy;
+    m[5] += m[1] * dx + m[3] * dy;
+    return m;
+}
+
+auto PdfOverlayMerger::getBox(PdfFile& file, const PdfObject& page, const char* key) -> std::array<double, 4> {
+    const PdfObject* value = page.get(key);
+    PdfObject box = value ? file.resolve(*value) : PdfObject();
+    if (box.type != PdfObject::ARRAY || box.items.size() != 4) {
+        throw PdfFormatException(std::string("Invalid /") + key);
+    }
+    double v[4];
+    for (size_t i = 0; i < 4; i++) {
+        v[i] = file.resolve(box.items[i]).getNumber();
+    }
+    return {std::min(v[0], v[2]), std::min(v[1], v[3]), std::max(v[0], v[2]), std::max(v[1], v[3])};
+}
+
+auto PdfOverlayMerger::importObject(const PdfObject& obj) -> PdfObject {
+    if (obj.type == PdfObject::REFERENCE) {
+        return PdfObject::makeReference(importReference(obj.num));
+    }
+
+    PdfObject copy = obj;
+    for (PdfObject& item: copy.items) {
+        item = importObject(item);
+    }
+    for (auto& entry: copy.entries) {
+        entry.second = importObject(entry.second);
+    }
+    return copy;
+}
+
+auto PdfOverlayMerger::importReference(int num) -> int {
+    auto it = this->imported.find(num);
+    if (it != this->imported.end()) {
+        return it->second;
+    }
+    int newNum = this->nextNum++;
+    this->imported[num] = newNum;
+
+    PdfObject obj = this->overlay.getObject(num);
+    if (obj.type == PdfObject::STREAM) {
+        // Written directly by PdfObject::write
+        obj.remove("Length");
+    }
+    writeObject(newNum, 0, importObject(obj));
+    return newNum;
+}
+
+auto PdfOverlayMerger::getContentStream(const std::string& content) -> int {
+    auto it = this->contentStreams.find(content);
+    if (it != this->contentStreams.end()) {
+        return it->second;
+    }
+    int num = this->nextNum++;
+    writeObject(num, 0, PdfObject::makeStream(content));
+    this->contentStreams[content] = num;
+    return num;
+}
+
+void PdfOverlayMerger::writeObject(int num, int gen, const PdfObject& obj) {
+    this->offsets[num] = {this->source.getLength() + this->out.size(), gen};
+    this->out += std::to_string(num) + " " + std::to_string(gen) + " obj\n";
+    obj.write(this->out);
+    this->out += "\nendobj\n";
+}
+
+void PdfOverlayMerger::writeXref() {
+    PdfObject trailer = PdfObject::makeDictionary();
+    for (const char* key: {"Root", "Info", "ID"}) {
+        if (const PdfObject* value = this->source.getTrailer().get(key)) {
+            trailer.set(key, *value);
+        }
+    }
+    trailer.set("Prev", PdfObject::makeNumber(static_cast<double>(this->source.getXrefOffset())));
+
+    size_t xrefOffset = this->source.getLength() + this->out.size();
+
+    // Runs of consecutive object numbers
+    std::vector<std::pair<int, int>> sections;
+    auto addSections = [&]() {
+        sections.clear();
+        for (const auto& entry: this->offsets) {
+            if (!sections.empty() && sections.back().first + sections.back().second == entry.first) {
+                sections.back().second++;
+            } else {
+                sections.emplace_back(entry.first, 1);
+            }
+        }
+    };
+
+    if (this->source.usesXrefStream()) {
+        // Written the way of the source, as not all readers follow a table to an older stream
+        int xrefNum = this->nextNum++;
+        this->offsets[xrefNum] = {xrefOffset, 0};
+        addSections();
+
+        std::string data;
+        for (const auto& entry: this->offsets) {
+            data += '\1';
+            for (int shift = 56; shift >= 0; shift -= 8) {
+                data += static_cast<char>((entry.second.first >> static_cast<unsigned>(shift)) & 0xFFU);
+            }
+            data += static_cast<char>((entry.second.second >> 8) & 0xFF);
+            data += static_cast<char>(entry.second.second & 0xFF);
+        }
+
+        PdfObject stream = PdfObject::makeStream(std::move(data));
+        stream.entries = std::move(trailer.entries);
+        stream.set("Type", PdfObject::makeName("XRef"));
+        stream.set("Size", PdfObject::makeNumber(this->nextNum));
+        const double widths[] = {1, 8, 2};
+        stream.set("W", makeNumberArray(widths, 3));
+        PdfObject index = PdfObject::makeArray();
+        for (const auto& section: sections) {
+            index.items.push_back(PdfObject::makeNumber(section.first));
+            index.items.push_back(PdfObject::makeNumber(section.second));
+        }
+        stream.set("Index", std::move(index));
+        writeObject(xrefNum, 0, stream);
+    } else {
+        addSections();
+        this->out += "xref\n";
+        auto entry = this->offsets.begin();
+        for (const auto& section: sections) {
+            this->out += std::to_string(section.first) + " " + std::to_string(section.second) + "\n";
+            for (int i = 0; i < section.second; i++, entry++) {
+                char line[32];
+                std::snprintf(line, sizeof(line), "%010zu %05d n \n", entry->second.first, entry->second.second);
+                this->out += line;
+            }
+        }
+        trailer.set("Size", PdfObject::makeNumber(this->nextNum));
+        this->out += "trailer\n";
+        trailer.write(this->out);
+        this->out += "\n";
+    }
+
+    this->out += "startxref\n" + std::to_string(xrefOffset) + "\n%%EOF\n";
+}
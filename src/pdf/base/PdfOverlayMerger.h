@@ -0,0 +1,94 @@
+/*
+ * Xournal++
+ *
+ * Draws the pages of one PDF on the pages of another
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <array>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "PdfFile.h"
+
+/**
+ * @brief Writes the pages of an overlay PDF on top of the pages of a source PDF, as incremental update of the source
+ *
+ * The update is appended to the unchanged source file. It contains the objects of the overlay, one Form XObject
+ * per overlay page, and new versions of the used source pages, which draw the form after their original content.
+ * The original page content is neither parsed nor copied, so the size of the update only depends on the overlay.
+ *
+ * A new page tree replaces the old one, so pages can be left out, reordered or used more than once. A page used
+ * again is written as new object without its annotations, which belong to one page only. Links and the outline of
+ * the source keep pointing to the first use of a page.
+ */
+class PdfOverlayMerger {
+public:
+    PdfOverlayMerger(PdfFile& source, PdfFile& overlay);
+
+public:
+    /**
+     * @param sourcePages For each page of the overlay the index of the source page it is drawn on, or npos for
+     *                    pages which are copied from the overlay as they are
+     * @return The update, which is to be appended to the source file
+     */
+    std::string merge(const std::vector<size_t>& sourcePages);
+
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+private:
+    PdfObject drawOnSourcePage(const PdfPage& sourcePage, const PdfPage& overlayPage);
+    PdfObject copyOverlayPage(const PdfPage& overlayPage, int num);
+
+    /**
+     * The overlay page as Form XObject, placed on the visible area of the source page
+     */
+    PdfObject createForm(const PdfPage& overlayPage, const PdfPage& sourcePage);
+
+    /**
+     * @return The contents of the source page, rotated and cropped, in default user space
+     */
+    std::array<double, 6> getFormMatrix(const PdfPage& overlayPage, const PdfPage& sourcePage);
+    std::array<double, 4> getBox(PdfFile& file, const PdfObject& page, const char* key);
+
+    /**
+     * Copies the object with all objects it references from the overlay
+     */
+    PdfObject importObject(const PdfObject& obj);
+    int importReference(int num);
+
+    /**
+     * @return The object number of a shared content stream
+     */
+    int getContentStream(const std::string& content);
+
+    void writeObject(int num, int gen, const PdfObject& obj);
+    void writeXref();
+
+private:
+    PdfFile& source;
+    PdfFile& overlay;
+
+    std::string out;
+    int nextNum = 0;
+
+    /**
+     * Offset and generation of the written objects, by object number
+     */
+    std::map<int, std::pair<size_t, int>> offsets;
+
+    /**
+     * The object numbers of the objects copied from the overlay, by their number in the overlay
+     */
+    std::map<int, int> imported;
+
+    std::map<std::string, int> contentStreams;
+};
@@ -29,15 +29,22 @@ void XojCairoPdfExport::setExportBackground(ExportBackgroundType exportBackgroun
     this->exportBackground = exportBackground;
 }
 
+void XojCairoPdfExport::setOverlayMode(bool overlayMode) { this->overlayMode = overlayMode; }
+
+auto XojCairoPdfExport::getExportedPages() const -> const std::vector<size_t>& { return this->exportedPages; }
+
 auto XojCairoPdfExport::startPdf(const fs::path& file) -> bool {
     this->surface = cairo_pdf_surface_create(file.u8string().c_str(), 0, 0);
     this->cr = cairo_create(surface);
+    this->exportedPages.clear();
 
 #if CAIRO_VERSION >= CAIRO_VERSION_ENCODE(1, 16, 0)
     cairo_pdf_surface_set_metadata(surface, CAIRO_PDF_METADATA_TITLE, doc->getFilepath().filename().u8string().c_str());
     cairo_pdf_surface_set_metadata(surface, CAIRO_PDF_METADATA_CREATOR, PROJECT_STRING);
-    GtkTreeModel* tocModel = doc->getContentsModel();
-    this->populatePdfOutline(tocModel);
+    if (!this->overlayMode) {
+        GtkTreeModel* tocModel = doc->getContentsModel();
+        this->populatePdfOutline(tocModel);
+    }
 #endif
 
     return true;
@@ -104,11 +111,12 @@ void XojCairoPdfExport::exportPage(size_t page) {
     PageRef p = doc->getPage(page);
 
     cairo_pdf_surface_set_size(this->surface, p->getWidth(), p->getHeight());
+    this->exportedPages.push_back(page);
 
     DocumentView view;
 
     cairo_save(this->cr);
-    if (p->getBackgroundType().isPdfPage() && (exportBackground >= EXPORT_BACKGROUND_UNRULED)) {
+    if (p->getBackgroundType().isPdfPage() && (exportBackground >= EXPORT_BACKGROUND_UNRULED) && !overlayMode) {
         int pgNo = p->getPdfPageNr();
         XojPdfPageSPtr popplerPage = doc->getPdfPage(pgNo);
 
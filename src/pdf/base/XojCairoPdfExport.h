@@ -11,6 +11,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "control/jobs/BaseExportJob.h"
 #include "control/jobs/ProgressListener.h"
 #include "model/Document.h"
@@ -33,6 +35,16 @@ public:
      */
     virtual void setExportBackground(ExportBackgroundType exportBackground);
 
+    /**
+     * Leave out the PDF background pages and the outline, to draw the result on the original PDF pages
+     */
+    void setOverlayMode(bool overlayMode);
+
+    /**
+     * @return The document page of each page of the last export
+     */
+    const std::vector<size_t>& getExportedPages() const;
+
 private:
     bool startPdf(const fs::path& file);
 #if CAIRO_VERSION >= CAIRO_VERSION_ENCODE(1, 16, 0)
@@ -62,5 +74,8 @@ private:
 
     ExportBackgroundType exportBackground = EXPORT_BACKGROUND_ALL;
 
+    bool overlayMode = false;
+    std::vector<size_t> exportedPages;
+
     std::string lastError;
 };
@@ -0,0 +1,150 @@
+#include "XojPassThroughPdfExport.h"
+
+#include <atomic>
+#include <fstream>
+#include <memory>
+
+#include "PathUtil.h"
+#include "PdfFile.h"
+#include "PdfOverlayMerger.h"
+#include "i18n.h"
+
+namespace {
+using MappedFile = std::unique_ptr<GMappedFile, decltype(&g_mapped_file_unref)>;
+
+auto mapFile(const fs::path& path) -> MappedFile {
+    GError* error = nullptr;
+    GMappedFile* file = g_mapped_file_new(path.u8string().c_str(), false, &error);
+    if (file == nullptr) {
+        std::string message = error->message;
+        g_error_free(error);
+        throw PdfFormatException(message);
+    }
+    return MappedFile(file, &g_mapped_file_unref);
+}
+}  // namespace
+
+XojPassThroughPdfExport::XojPassThroughPdfExport(Document* doc, ProgressListener* progressListener):
+        doc(doc), cairoExport(doc, progressListener) {}
+
+XojPassThroughPdfExport::~XojPassThroughPdfExport() = default;
+
+/**
+ * Export without background
+ */
+void XojPassThroughPdfExport::setExportBackground(ExportBackgroundType exportBackground) {
+    this->exportBackground = exportBackground;
+    this->cairoExport.setExportBackground(exportBackground);
+}
+
+auto XojPassThroughPdfExport::canPassThrough(const fs::path& file, const std::vector<size_t>& pages) -> bool {
+    if (this->exportBackground < EXPORT_BACKGROUND_UNRULED || doc->getPdfPageCount() == 0) {
+        return false;
+    }
+
+    // The background PDF is read while the file is written
+    std::error_code ec;
+    fs::path pdfFile = doc->getPdfFilepath();
+    if (!fs::is_regular_file(pdfFile, ec) || fs::equivalent(pdfFile, file, ec)) {
+        return false;
+    }
+
+    // The whole background PDF is copied, so no page of it may be left out, and its outline has to stay valid
+    size_t next = 0;
+    for (size_t i: pages) {
+        PageRef p = doc->getPage(i);
+        if (p->getBackgroundType().isPdfPage()) {
+            if (p->getPdfPageNr() != next) {
+                return false;
+            }
+            next++;
+        }
+    }
+    return next == doc->getPdfPageCount();
+}
+
+auto XojPassThroughPdfExport::exportPdf(const fs::path& file, const std::vector<size_t>& pages,
+                                        const std::function<bool(const fs::path&)>& render) -> bool {
+    this->lastError = "";
+    if (!canPassThrough(file, pages)) {
+        this->cairoExport.setOverlayMode(false);
+        return render(file);
+    }
+
+    static std::atomic<int> overlayCount{0};
+    fs::path overlayFile = Util::getTmpDirSubfolder("export") / ("overlay-" + std::to_string(overlayCount++) + ".pdf");
+
+    this->cairoExport.setOverlayMode(true);
+    bool success = render(overlayFile);
+    if (success) {
+        try {
+            success = writeMerged(file, overlayFile);
+        } catch (const std::exception& e) {
+            // Also std::bad_alloc, or std::length_error for sizes in a damaged file
+            g_warning("Could not copy the pages of the background PDF, they are drawn again: %s", e.what());
+            this->cairoExport.setOverlayMode(false);
+            success = render(file);
+        }
+    }
+
+    std::error_code ec;
+    fs::remove(overlayFile, ec);
+    return success;
+}
+
+auto XojPassThroughPdfExport::writeMerged(const fs::path& file, const fs::path& overlayFile) -> bool {
+    MappedFile sourceData = mapFile(doc->getPdfFilepath());
+    MappedFile overlayData = mapFile(overlayFile);
+    PdfFile source(g_mapped_file_get_contents(sourceData.get()), g_mapped_file_get_length(sourceData.get()));
+    PdfFile overlay(g_mapped_file_get_contents(overlayData.get()), g_mapped_file_get_length(overlayData.get()));
+
+    if (source.getPages().size() != doc->getPdfPageCount()) {
+        throw PdfFormatException("The background PDF was changed after it was loaded");
+    }
+
+    std::vector<size_t> sourcePages;
+    for (size_t i: this->cairoExport.getExportedPages()) {
+        PageRef p = doc->getPage(i);
+        sourcePages.push_back(p->getBackgroundType().isPdfPage() ? p->getPdfPageNr() : PdfOverlayMerger::npos);
+    }
+
+    PdfOverlayMerger merger(source, overlay);
+    std::string update = merger.merge(sourcePages);
+
+    std::ofstream out(file, std::ios::binary | std::ios::trunc);
+    out.write(g_mapped_file_get_contents(sourceData.get()),
+              static_cast<std::streamsize>(g_mapped_file_get_length(sourceData.get())));
+    out.write(update.data(), static_cast<std::streamsize>(update.size()));
+    out.close();
+    if (!out) {
+        this->lastError = FS(_F("Could not write file \"{1}\"") % file.u8string());
+        return false;
+    }
+    return true;
+}
+
+auto XojPassThroughPdfExport::createPdf(fs::path const& file, PageRangeVector& range, bool progressiveMode) -> bool {
+    std::vector<size_t> pages;
+    for (PageRangeEntry* e: range) {
+        for (int i = e->getFirst(); i <= e->getLast(); i++) {
+            if (i >= 0 && i < static_cast<int>(doc->getPageCount())) {
+                pages.push_back(static_cast<size_t>(i));
+            }
+        }
+    }
+    return exportPdf(file, pages,
+                     [&](const fs::path& f) { return this->cairoExport.createPdf(f, range, progressiveMode); });
+}
+
+auto XojPassThroughPdfExport::createPdf(fs::path const& file, bool progressiveMode) -> bool {
+    std::vector<size_t> pages;
+    for (size_t i = 0; i < doc->getPageCount(); i++) {
+        pages.push_back(i);
+    }
+    return exportPdf(file, pages,
+                     [&](const fs::path& f) { return this->cairoExport.createPdf(f, progressiveMode); });
+}
+
+auto XojPassThroughPdfExport::getLastError() -> std::string {
+    return this->lastError.empty() ? this->cairoExport.getLastError() : this->lastError;
+}
@@ -0,0 +1,80 @@
+/*
+ * Xournal++
+ *
+ * PDF export which copies the pages of the background PDF
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "control/jobs/BaseExportJob.h"
+#include "control/jobs/ProgressListener.h"
+#include "model/Document.h"
+
+#include "XojCairoPdfExport.h"
+#include "XojPdfExport.h"
+#include "filesystem.h"
+
+/**
+ * @brief Exports documents with a background PDF without drawing the PDF pages again
+ *
+ * Only the annotations are drawn, by XojCairoPdfExport in overlay mode. The overlay is then appended to a copy of
+ * the background PDF as incremental update, see PdfOverlayMerger, so the export time depends on the annotations
+ * only.
+ *
+ * The copy keeps everything of the background PDF, e.g. its outline and the pages which were deleted from the
+ * document. It is therefore only used if every page of the background PDF is exported once and in its order, pages
+ * without PDF background may be inserted. Otherwise, or if the background PDF cannot be copied, e.g. as it is
+ * encrypted or damaged, the whole document is drawn by XojCairoPdfExport.
+ */
+class XojPassThroughPdfExport: public XojPdfExport {
+public:
+    XojPassThroughPdfExport(Document* doc, ProgressListener* progressListener);
+    virtual ~XojPassThroughPdfExport();
+
+public:
+    virtual bool createPdf(fs::path const& file, bool progressiveMode);
+    virtual bool createPdf(fs::path const& file, PageRangeVector& range, bool progressiveMode);
+    virtual std::string getLastError();
+
+    /**
+     * Export without background
+     */
+    virtual void setExportBackground(ExportBackgroundType exportBackground);
+
+private:
+    /**
+     * @param render Exports the pages with cairoExport into the given file
+     */
+    bool exportPdf(const fs::path& file, const std::vector<size_t>& pages,
+                   const std::function<bool(const fs::path&)>& render);
+
+    /**
+     * @return true if the background PDF is exported and all of its pages are exported once, in their order
+     */
+    bool canPassThrough(const fs::path& file, const std::vector<size_t>& pages);
+
+    /**
+     * Writes the background PDF with the overlay drawn on its pages
+     *
+     * @throws std::exception if the background PDF cannot be copied, e.g. PdfFormatException
+     */
+    bool writeMerged(const fs::path& file, const fs::path& overlayFile);
+
+private:
+    Document* doc = nullptr;
+
+    XojCairoPdfExport cairoExport;
+
+    ExportBackgroundType exportBackground = EXPORT_BACKGROUND_ALL;
+
+    std::string lastError;
+};
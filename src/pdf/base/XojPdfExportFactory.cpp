@@ -3,11 +3,16 @@
 #include <config-features.h>
 
 #include "XojCairoPdfExport.h"
+#include "XojPassThroughPdfExport.h"
 
 XojPdfExportFactory::XojPdfExportFactory() = default;
 
 XojPdfExportFactory::~XojPdfExportFactory() = default;
 
-auto XojPdfExportFactory::createExport(Document* doc, ProgressListener* listener) -> XojPdfExport* {
+auto XojPdfExportFactory::createExport(Document* doc, ProgressListener* listener, bool keepBackgroundPdf)
+        -> XojPdfExport* {
+    if (keepBackgroundPdf) {
+        return new XojPassThroughPdfExport(doc, listener);
+    }
     return new XojCairoPdfExport(doc, listener);
 }
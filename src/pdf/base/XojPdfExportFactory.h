@@ -26,7 +26,11 @@ private:
     virtual ~XojPdfExportFactory();
 
 public:
-    static XojPdfExport* createExport(Document* doc, ProgressListener* listener);
+    /**
+     * @param keepBackgroundPdf Append the annotations to an unchanged copy of the background PDF, see
+     *                          XojPassThroughPdfExport, instead of drawing its pages again
+     */
+    static XojPdfExport* createExport(Document* doc, ProgressListener* listener, bool keepBackgroundPdf = false);
 
 private:
 };
@@ -11,6 +11,9 @@
 
 #include <cstring>
 #include <map>
+#include <memory>
+#include <utility>
+#include <vector>
 
 #include <gtk/gtk.h>
 
@@ -22,9 +25,13 @@
 #include "gui/XournalView.h"
 #include "gui/widgets/XournalWidget.h"
 #include "model/Font.h"
+#include "model/Layer.h"
+#include "model/Stroke.h"
 #include "model/StrokeStyle.h"
 #include "model/Text.h"
+#include "undo/InsertUndoAction.h"
 
+#include "Range.h"
 #include "StringUtils.h"
 #include "XojMsgBox.h"
 
@@ -1132,6 +1139,314 @@ static int applib_scaleTextElements(lua_State* L) {
 }
 
 
+/**
+ * Checks the optional page number and layer ID (both starting at 1) at the stack positions index and index + 1.
+ * Raises a Lua error if there is no such page or layer, so no C++ object may be alive in the caller yet.
+ *
+ * @return The index of the page in the document and of the layer on the page, the current page and its current
+ *         layer by default
+ */
+static std::pair<size_t, size_t> checkPageAndLayer(lua_State* L, int index) {
+    Plugin* plugin = Plugin::getPluginFromLua(L);
+    Control* control = plugin->getControl();
+    Document* doc = control->getDocument();
+
+    size_t pageNr = control->getCurrentPageNo();
+    if (!lua_isnoneornil(L, index)) {
+        lua_Integer nr = luaL_checkinteger(L, index);
+        if (nr < 1 || static_cast<size_t>(nr) > doc->getPageCount()) {
+            luaL_error(L, "No page with page number %d", static_cast<int>(nr));
+        }
+        pageNr = static_cast<size_t>(nr - 1);
+    }
+
+    size_t layerCount = 0;
+    size_t layerIndex = 0;
+    if (XojPage* page = doc->getPage(pageNr).get()) {
+        layerCount = page->getLayerCount();
+        layerIndex = page->getSelectedLayerId() > 0 ? page->getSelectedLayerId() - 1 : 0;
+    }
+    if (layerCount == 0) {
+        luaL_error(L, "No layer on page %d", static_cast<int>(pageNr + 1));
+    }
+
+    if (!lua_isnoneornil(L, index + 1)) {
+        lua_Integer layerId = luaL_checkinteger(L, index + 1);
+        if (layerId < 1 || static_cast<size_t>(layerId) > layerCount) {
+            luaL_error(L, "No layer with layer ID %d", static_cast<int>(layerId));
+        }
+        layerIndex = static_cast<size_t>(layerId - 1);
+    }
+
+    return {pageNr, layerIndex};
+}
+
+/**
+ * Reads the array field of the table at the stack position index
+ *
+ * @return false if the field is neither an array nor nil, values is empty if it is nil
+ */
+static bool readNumberArray(lua_State* L, int index, const char* field, std::vector<double>& values) {
+    values.clear();
+    int type = lua_getfield(L, index, field);
+    if (type != LUA_TTABLE) {
+        lua_pop(L, 1);
+        return type == LUA_TNIL;
+    }
+
+    values.resize(lua_rawlen(L, -1));
+    for (size_t i = 0; i < values.size(); i++) {
+        lua_rawgeti(L, -1, static_cast<lua_Integer>(i + 1));
+        values[i] = lua_tonumber(L, -1);
+        lua_pop(L, 1);
+    }
+    lua_pop(L, 1);
+    return true;
+}
+
+/**
+ * Creates a stroke from the table at the stack position index, see applib_getStrokes() for the fields
+ *
+ * @return nullptr if the table does not describe a stroke
+ */
+static Stroke* readStroke(lua_State* L, int index, double defaultWidth, Color defaultColor) {
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> pressure;
+    if (!lua_istable(L, index) || !readNumberArray(L, index, "x", x) || !readNumberArray(L, index, "y", y) ||
+        !readNumberArray(L, index, "pressure", pressure)) {
+        return nullptr;
+    }
+    if (x.size() < 2 || x.size() != y.size() || (!pressure.empty() && pressure.size() != x.size())) {
+        return nullptr;
+    }
+
+    auto* stroke = new Stroke();
+
+    lua_getfield(L, index, "width");
+    stroke->setWidth(lua_isnumber(L, -1) ? lua_tonumber(L, -1) : defaultWidth);
+    lua_pop(L, 1);
+
+    lua_getfield(L, index, "color");
+    stroke->setColor(lua_isinteger(L, -1) ? Color(static_cast<uint32_t>(lua_tointeger(L, -1))) : defaultColor);
+    lua_pop(L, 1);
+
+    lua_getfield(L, index, "fill");
+    stroke->setFill(lua_isinteger(L, -1) ? static_cast<int>(lua_tointeger(L, -1)) : -1);
+    lua_pop(L, 1);
+
+    lua_getfield(L, index, "tool");
+    const char* tool = lua_isstring(L, -1) ? lua_tostring(L, -1) : "pen";
+    if (strcmp(tool, "highlighter") == 0) {
+        stroke->setToolType(STROKE_TOOL_HIGHLIGHTER);
+    } else if (strcmp(tool, "eraser") == 0) {
+        stroke->setToolType(STROKE_TOOL_ERASER);
+    }
+    lua_pop(L, 1);
+
+    for (size_t i = 0; i < x.size(); i++) {
+        stroke->addPoint(Point(x[i], y[i], pressure.empty() ? Point::NO_PRESSURE : pressure[i]));
+    }
+    return stroke;
+}
+
+/**
+ * Returns the strokes of a layer with their coordinates as flat arrays. The optional parameters are the
+ * page number and the layer ID, both starting at 1. By default the current layer of the current page is used.
+ *
+ * Returns a table with a table for each stroke:
+ * {
+ *   {
+ *     "x" = {number, ...},
+ *     "y" = {number, ...},
+ *     "pressure" = {number, ...} (only if the stroke has pressure, the width of the stroke at each point),
+ *     "width" = number,
+ *     "color" = integer (RGB hex code),
+ *     "fill" = integer (-1 if the stroke is not filled, otherwise the opacity 0 - 255),
+ *     "tool" = string ("pen", "highlighter" or "eraser")
+ *   },
+ *   ...
+ * }
+ *
+ * Example:
+ *   local strokes = app.getStrokes(1, 1)
+ *   for _, stroke in ipairs(strokes) do
+ *     print(#stroke.x .. " points, color " .. stroke.color)
+ *   end
+ */
+static int applib_getStrokes(lua_State* L) {
+    Plugin* plugin = Plugin::getPluginFromLua(L);
+    Control* control = plugin->getControl();
+    Document* doc = control->getDocument();
+    auto [pageNr, layerIndex] = checkPageAndLayer(L, 1);
+
+    struct StrokeData {
+        std::vector<Point> points;
+        double width;
+        Color color;
+        int fill;
+        StrokeTool tool;
+    };
+    std::vector<StrokeData> strokes;
+
+    // Copy the strokes in one go, so the document is not locked while the Lua tables are built
+    doc->lock();
+    Layer* layer = (*doc->getPage(pageNr)->getLayers())[layerIndex];
+    for (Element* e: layer->getElements()) {
+        if (e->getType() == ELEMENT_STROKE) {
+            auto* s = static_cast<Stroke*>(e);
+            strokes.push_back({s->getPointVector(), s->getWidth(), s->getColor(), s->getFill(), s->getToolType()});
+        }
+    }
+    doc->unlock();
+
+    lua_createtable(L, static_cast<int>(strokes.size()), 0);
+    for (size_t i = 0; i < strokes.size(); i++) {
+        const StrokeData& s = strokes[i];
+        auto pointCount = static_cast<int>(s.points.size());
+        lua_createtable(L, 0, 7);  // beginning of table for stroke i
+
+        lua_pushliteral(L, "x");
+        lua_createtable(L, pointCount, 0);
+        for (int p = 0; p < pointCount; p++) {
+            lua_pushnumber(L, s.points[p].x);
+            lua_rawseti(L, -2, p + 1);
+        }
+        lua_settable(L, -3);
+
+        lua_pushliteral(L, "y");
+        lua_createtable(L, pointCount, 0);
+        for (int p = 0; p < pointCount; p++) {
+            lua_pushnumber(L, s.points[p].y);
+            lua_rawseti(L, -2, p + 1);
+        }
+        lua_settable(L, -3);
+
+        if (pointCount > 0 && s.points[0].z != Point::NO_PRESSURE) {
+            lua_pushliteral(L, "pressure");
+            lua_createtable(L, pointCount, 0);
+            for (int p = 0; p < pointCount; p++) {
+                lua_pushnumber(L, s.points[p].z);
+                lua_rawseti(L, -2, p + 1);
+            }
+            lua_settable(L, -3);
+        }
+
+        lua_pushliteral(L, "width");
+        lua_pushnumber(L, s.width);
+        lua_settable(L, -3);
+
+        lua_pushliteral(L, "color");
+        lua_pushinteger(L, s.color);
+        lua_settable(L, -3);
+
+        lua_pushliteral(L, "fill");
+        lua_pushinteger(L, s.fill);
+        lua_settable(L, -3);
+
+        lua_pushliteral(L, "tool");
+        switch (s.tool) {
+            case STROKE_TOOL_HIGHLIGHTER:
+                lua_pushliteral(L, "highlighter");
+                break;
+            case STROKE_TOOL_ERASER:
+                lua_pushliteral(L, "eraser");
+                break;
+            default:
+                lua_pushliteral(L, "pen");
+                break;
+        }
+        lua_settable(L, -3);
+
+        lua_rawseti(L, -2, static_cast<lua_Integer>(i + 1));  // end of table for stroke i
+    }
+
+    return 1;
+}
+
+/**
+ * Inserts the strokes of the table at stack position 1 and pushes their count
+ *
+ * @return 0 on success, otherwise the number of the invalid stroke. Nothing was inserted then.
+ */
+static size_t insertStrokes(lua_State* L, size_t pageNr, size_t layerIndex) {
+    Plugin* plugin = Plugin::getPluginFromLua(L);
+    Control* control = plugin->getControl();
+    Document* doc = control->getDocument();
+    ToolHandler* toolHandler = control->getToolHandler();
+
+    double width = toolHandler->getToolThickness(TOOL_PEN)[toolHandler->getPenSize()];
+    Color color = toolHandler->getTool(TOOL_PEN).getColor();
+
+    size_t count = lua_rawlen(L, 1);
+    std::vector<Element*> strokes;
+    strokes.reserve(count);
+    for (size_t i = 1; i <= count; i++) {
+        lua_rawgeti(L, 1, static_cast<lua_Integer>(i));
+        Stroke* stroke = readStroke(L, lua_gettop(L), width, color);
+        lua_pop(L, 1);
+
+        if (stroke == nullptr) {
+            for (Element* e: strokes) {
+                delete e;
+            }
+            return i;
+        }
+        strokes.push_back(stroke);
+    }
+
+    if (!strokes.empty()) {
+        Range range(strokes.front()->getX(), strokes.front()->getY());
+        for (Element* e: strokes) {
+            range.addPoint(e->getX(), e->getY());
+            range.addPoint(e->getX() + e->getElementWidth(), e->getY() + e->getElementHeight());
+        }
+
+        // A single transaction, the document is locked only once for all strokes
+        doc->lock();
+        PageRef page = doc->getPage(pageNr);
+        Layer* layer = (*page->getLayers())[layerIndex];
+        layer->addElements(strokes);
+        doc->unlock();
+
+        control->getUndoRedoHandler()->addUndoAction(
+                std::make_unique<InsertsUndoAction>(page, layer, std::move(strokes)));
+        page->fireRangeChanged(range);
+    }
+
+    lua_pushinteger(L, static_cast<lua_Integer>(count));
+    return 0;
+}
+
+/**
+ * Inserts many strokes at once. They are a single undo action and the page is rerendered once.
+ * The optional parameters are the page number and the layer ID, both starting at 1. By default the strokes are
+ * inserted in the current layer of the current page.
+ *
+ * Each stroke is a table with the fields returned by app.getStrokes(). "x" and "y" are required and need at
+ * least two points, the other fields are optional. The width and color of the pen tool are used by default.
+ *
+ * Returns the number of inserted strokes. If a stroke is invalid, none is inserted.
+ *
+ * Example:
+ *   local strokes = {}
+ *   for i = 1, 1000 do
+ *     strokes[i] = {x = {10, 100}, y = {i * 0.5, i * 0.5}, width = 0.3, color = 0xff0000}
+ *   end
+ *   app.addStrokes(strokes, 1)
+ */
+static int applib_addStrokes(lua_State* L) {
+    luaL_checktype(L, 1, LUA_TTABLE);
+    auto [pageNr, layerIndex] = checkPageAndLayer(L, 2);
+
+    // Raise the error after insertStrokes() cleaned up, the error jumps over the C++ destructors
+    if (size_t invalid = insertStrokes(L, pageNr, layerIndex); invalid > 0) {
+        luaL_error(L, "Invalid stroke %d", static_cast<int>(invalid));
+    }
+
+    return 1;
+}
+
 /**
  * Gets the display DPI.
  * Example: app.getDisplayDpi()
@@ -1146,6 +1461,63 @@ static int applib_getDisplayDpi(lua_State* L) {
 }
 
 
+/**
+ * Gets the memory used by the document, the page views, the caches and the undo stack, in bytes.
+ * The categories are strokes, texts, images, teximages, backgrounds, pagebuffers (per page and in total)
+ * and pdfcache, previews, undo (in total only).
+ *
+ * Example:
+ *   local report = app.getMemoryReport()
+ *   if report.total > 512 * 1024 * 1024 then
+ *     print("Strokes: " .. report.categories.strokes .. ", page 1: " .. report.pages[1].total)
+ *   end
+ */
+static int applib_getMemoryReport(lua_State* L) {
+    Plugin* plugin = Plugin::getPluginFromLua(L);
+    Control* control = plugin->getControl();
+    MemoryReport report = control->createMemoryReport();
+
+    lua_newtable(L);
+
+    lua_pushliteral(L, "total");
+    lua_pushinteger(L, report.getTotal());
+    lua_settable(L, -3);
+
+    lua_pushliteral(L, "categories");
+    lua_newtable(L);  // beginning of categories table
+    for (size_t c = 0; c < MemoryReport::CATEGORY_COUNT; c++) {
+        auto category = static_cast<MemoryCategory>(c);
+        lua_pushstring(L, MemoryReport::getCategoryName(category));
+        lua_pushinteger(L, report.getTotal(category));
+        lua_settable(L, -3);
+    }
+    lua_settable(L, -3);  // end of categories table
+
+    lua_pushliteral(L, "pages");
+    lua_newtable(L);  // beginning of pages table
+    for (size_t p = 0; p < report.getPageCount(); p++) {
+        lua_pushinteger(L, p + 1);
+        lua_newtable(L);  // beginning of table for page p
+
+        lua_pushliteral(L, "total");
+        lua_pushinteger(L, report.getPageTotal(p));
+        lua_settable(L, -3);
+
+        for (size_t c = 0; c < MemoryReport::CATEGORY_COUNT; c++) {
+            auto category = static_cast<MemoryCategory>(c);
+            lua_pushstring(L, MemoryReport::getCategoryName(category));
+            lua_pushinteger(L, report.getPageUsage(p, category));
+            lua_settable(L, -3);
+        }
+
+        lua_settable(L, -3);  // end of table for page p
+    }
+    lua_settable(L, -3);  // end of pages table
+
+    return 1;
+}
+
+
 /*
  * The full Lua Plugin API.
  * See above for example usage of each function.
@@ -1173,6 +1545,9 @@ static const luaL_Reg applib[] = {{"msgbox", applib_msgbox},
                                   {"setBackgroundName", applib_setBackgroundName},
                                   {"scaleTextElements", applib_scaleTextElements},
                                   {"getDisplayDpi", applib_getDisplayDpi},
+                                  {"getMemoryReport", applib_getMemoryReport},
+                                  {"getStrokes", applib_getStrokes},
+                                  {"addStrokes", applib_addStrokes},
                                   // Placeholder
                                   //	{"MSG_BT_OK", nullptr},
 
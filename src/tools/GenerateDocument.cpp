@@ -0,0 +1,111 @@
+/*
+ * Xournal++
+ *
+ * Command line tool which writes synthetic documents for benchmarks and stress tests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <array>
+#include <iostream>
+
+#include <glib.h>
+
+#include "control/xojfile/DocumentGenerator.h"
+#include "control/xojfile/SaveHandler.h"
+#include "model/DocumentHandler.h"
+
+#include "filesystem.h"
+
+auto main(int argc, char* argv[]) -> int {
+    DocumentGeneratorOptions options;
+    int seed = static_cast<int>(options.seed);
+    gboolean pressure = false;
+    int backgroundPages = 0;
+    gchar* pdfBackground = nullptr;
+    int level = -1;
+
+    std::array entries = {
+            GOptionEntry{"seed", 's', 0, G_OPTION_ARG_INT, &seed, "Seed of the random generator (default 1)", "N"},
+            GOptionEntry{"pages", 'p', 0, G_OPTION_ARG_INT, &options.pages, "Number of pages (default 1)", "N"},
+            GOptionEntry{"layers", 'l', 0, G_OPTION_ARG_INT, &options.layersPerPage, "Layers per page (default 1)",
+                         "N"},
+            GOptionEntry{"strokes", 0, 0, G_OPTION_ARG_INT, &options.strokesPerLayer,
+                         "Strokes per layer (default 200)", "N"},
+            GOptionEntry{"min-points", 0, 0, G_OPTION_ARG_INT, &options.minPoints,
+                         "Minimum number of points of a stroke (default 20)", "N"},
+            GOptionEntry{"max-points", 0, 0, G_OPTION_ARG_INT, &options.maxPoints,
+                         "Maximum number of points of a stroke (default 200)", "N"},
+            GOptionEntry{"pressure", 0, 0, G_OPTION_ARG_NONE, &pressure, "Store pressure values for all points",
+                         nullptr},
+            GOptionEntry{"highlighter", 0, 0, G_OPTION_ARG_DOUBLE, &options.highlighterRatio,
+                         "Share of highlighter strokes, between 0 and 1 (default 0.1)", "RATIO"},
+            GOptionEntry{"images", 0, 0, G_OPTION_ARG_INT, &options.imagesPerPage, "Images per page (default 0)",
+                         "N"},
+            GOptionEntry{"image-size", 0, 0, G_OPTION_ARG_INT, &options.imageSize,
+                         "Width and height of the images in pixels (default 256)", "N"},
+            GOptionEntry{"texts", 0, 0, G_OPTION_ARG_INT, &options.textsPerPage, "Text elements per page (default 0)",
+                         "N"},
+            GOptionEntry{"tex", 0, 0, G_OPTION_ARG_INT, &options.texImagesPerPage, "TeX images per page (default 0)",
+                         "N"},
+            GOptionEntry{"pdf", 0, 0, G_OPTION_ARG_FILENAME, &pdfBackground,
+                         "Use the pages of PDFFILE as background, --pages is ignored", "PDFFILE"},
+            GOptionEntry{"generate-pdf", 0, 0, G_OPTION_ARG_INT, &backgroundPages,
+                         "Write a PDF with N pages next to the output and use it as background", "N"},
+            GOptionEntry{"compression", 0, 0, G_OPTION_ARG_INT, &level, "zlib compression level (default 6)", "0-9"},
+            GOptionEntry{nullptr}};
+
+    GOptionContext* context = g_option_context_new("OUTPUT.xopp - generate a synthetic Xournal++ document");
+    g_option_context_add_main_entries(context, entries.data(), nullptr);
+    GError* error = nullptr;
+    bool parsed = g_option_context_parse(context, &argc, &argv, &error);
+    g_option_context_free(context);
+    if (!parsed) {
+        std::cerr << error->message << std::endl;
+        g_error_free(error);
+        return 1;
+    }
+    if (argc != 2) {
+        std::cerr << "Expected exactly one output file, see --help" << std::endl;
+        return 1;
+    }
+
+    fs::path output = fs::u8path(argv[1]);
+    options.seed = static_cast<unsigned int>(seed);
+    options.pressure = pressure;
+
+    if (pdfBackground) {
+        options.pdfBackground = fs::u8path(pdfBackground);
+        g_free(pdfBackground);
+    } else if (backgroundPages > 0) {
+        options.pdfBackground = output;
+        options.pdfBackground.replace_extension(".background.pdf");
+        if (!DocumentGenerator::writeBackgroundPdf(options.pdfBackground, backgroundPages)) {
+            std::cerr << "Could not write " << options.pdfBackground.u8string() << std::endl;
+            return 2;
+        }
+        options.pdfBackground = fs::absolute(options.pdfBackground);
+    }
+
+    DocumentHandler handler;
+    Document doc(&handler);
+    DocumentGenerator generator(options);
+    if (!generator.generate(&doc)) {
+        std::cerr << generator.getLastError() << std::endl;
+        return 2;
+    }
+
+    SaveHandler h;
+    h.setCompression(level);
+    h.prepareSave(&doc);
+    h.saveTo(output);
+    if (!h.getErrorMessage().empty()) {
+        std::cerr << h.getErrorMessage() << std::endl;
+        return 3;
+    }
+
+    return 0;
+}
@@ -29,6 +29,18 @@ void DeleteUndoAction::addElement(Layer* layer, Element* e, int pos) {
                                           reinterpret_cast<GCompareFunc>(PageLayerPosEntry<Element>::cmp));
 }
 
+auto DeleteUndoAction::getMemoryFootprint() const -> size_t {
+    size_t bytes = UndoAction::getMemoryFootprint();
+    for (GList* l = this->elements; l != nullptr; l = l->next) {
+        auto e = static_cast<PageLayerPosEntry<Element>*>(l->data);
+        bytes += sizeof(PageLayerPosEntry<Element>);
+        if (!undone) {
+            bytes += e->element->getMemoryFootprint();
+        }
+    }
+    return bytes;
+}
+
 auto DeleteUndoAction::undo(Control*) -> bool {
     if (this->elements == nullptr) {
         g_warning("Could not undo DeleteUndoAction, there is nothing to undo");
@@ -34,6 +34,8 @@ public:
 
     std::string getText() override;
 
+    size_t getMemoryFootprint() const override;
+
 private:
     GList* elements = nullptr;
     bool eraser = true;
@@ -32,6 +32,25 @@ EraseUndoAction::~EraseUndoAction() {
     this->edited = nullptr;
 }
 
+auto EraseUndoAction::getMemoryFootprint() const -> size_t {
+    size_t bytes = UndoAction::getMemoryFootprint();
+    for (GList* l = this->original; l != nullptr; l = l->next) {
+        auto* e = static_cast<PageLayerPosEntry<Stroke>*>(l->data);
+        bytes += sizeof(PageLayerPosEntry<Stroke>);
+        if (!undone) {
+            bytes += e->element->getMemoryFootprint();
+        }
+    }
+    for (GList* l = this->edited; l != nullptr; l = l->next) {
+        auto* e = static_cast<PageLayerPosEntry<Stroke>*>(l->data);
+        bytes += sizeof(PageLayerPosEntry<Stroke>);
+        if (undone) {
+            bytes += e->element->getMemoryFootprint();
+        }
+    }
+    return bytes;
+}
+
 void EraseUndoAction::addOriginal(Layer* layer, Stroke* element, int pos) {
     this->original = g_list_insert_sorted(this->original, new PageLayerPosEntry<Stroke>(layer, element, pos),
                                           reinterpret_cast<GCompareFunc>(PageLayerPosEntry<Stroke>::cmp));
@@ -38,6 +38,8 @@ public:
 
     virtual std::string getText();
 
+    size_t getMemoryFootprint() const override;
+
 private:
     GList* edited = nullptr;
     GList* original = nullptr;
@@ -50,6 +50,14 @@ auto GroupUndoAction::undo(Control* control) -> bool {
     return result;
 }
 
+auto GroupUndoAction::getMemoryFootprint() const -> size_t {
+    size_t bytes = UndoAction::getMemoryFootprint();
+    for (UndoAction* a: actions) {
+        bytes += a->getMemoryFootprint();
+    }
+    return bytes;
+}
+
 auto GroupUndoAction::getText() -> std::string {
     if (actions.empty()) {
         return "!! NOTHING !!";
@@ -35,6 +35,8 @@ public:
 
     virtual std::string getText();
 
+    size_t getMemoryFootprint() const override;
+
 private:
     std::vector<UndoAction*> actions;
 };
@@ -17,6 +17,7 @@ InsertDeletePageUndoAction::InsertDeletePageUndoAction(const PageRef& page, int
 InsertDeletePageUndoAction::~InsertDeletePageUndoAction() { this->page = nullptr; }
 
 auto InsertDeletePageUndoAction::undo(Control* control) -> bool {
+    this->undone = true;
     if (this->inserted) {
         return deletePage(control);
     }
@@ -26,6 +27,7 @@ auto InsertDeletePageUndoAction::undo(Control* control) -> bool {
 }
 
 auto InsertDeletePageUndoAction::redo(Control* control) -> bool {
+    this->undone = false;
     if (this->inserted) {
         return insertPage(control);
     }
@@ -34,6 +36,15 @@ auto InsertDeletePageUndoAction::redo(Control* control) -> bool {
     return deletePage(control);
 }
 
+auto InsertDeletePageUndoAction::getMemoryFootprint() const -> size_t {
+    size_t bytes = UndoAction::getMemoryFootprint();
+    // An undone insert and a not undone delete leave the page outside of the document
+    if (this->inserted == this->undone && this->page) {
+        bytes += this->page->getMemoryFootprint();
+    }
+    return bytes;
+}
+
 auto InsertDeletePageUndoAction::insertPage(Control* control) -> bool {
     Document* doc = control->getDocument();
 
@@ -28,6 +28,11 @@ public:
 
     virtual std::string getText();
 
+    /**
+     * Includes the page, while it is not part of the document
+     */
+    size_t getMemoryFootprint() const override;
+
 private:
     bool insertPage(Control* control);
     bool deletePage(Control* control);
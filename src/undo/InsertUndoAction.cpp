@@ -7,6 +7,7 @@
 #include "model/Layer.h"
 #include "model/PageRef.h"
 
+#include "Range.h"
 #include "i18n.h"
 
 InsertUndoAction::InsertUndoAction(const PageRef& page, Layer* layer, Element* element):
@@ -39,6 +40,14 @@ auto InsertUndoAction::getText() -> std::string {
     }
 }
 
+auto InsertUndoAction::getMemoryFootprint() const -> size_t {
+    size_t bytes = UndoAction::getMemoryFootprint();
+    if (this->undone) {
+        bytes += this->element->getMemoryFootprint();
+    }
+    return bytes;
+}
+
 auto InsertUndoAction::undo(Control* control) -> bool {
     this->layer->removeElement(this->element, false);
 
@@ -78,22 +87,44 @@ InsertsUndoAction::~InsertsUndoAction() {
 
 auto InsertsUndoAction::getText() -> std::string { return _("Insert elements"); }
 
-auto InsertsUndoAction::undo(Control* control) -> bool {
-    for (Element* elem: this->elements) {
-        this->layer->removeElement(elem, false);
-        this->page->fireElementChanged(elem);
+auto InsertsUndoAction::getMemoryFootprint() const -> size_t {
+    size_t bytes = UndoAction::getMemoryFootprint() + this->elements.capacity() * sizeof(Element*);
+    if (this->undone) {
+        for (Element* e: this->elements) {
+            bytes += e->getMemoryFootprint();
+        }
+    }
+    return bytes;
+}
+
+void InsertsUndoAction::fireRangeChanged() {
+    if (this->elements.empty()) {
+        return;
     }
 
+    // One rerender for all elements, there may be many thousands of them
+    Element* first = this->elements.front();
+    Range range(first->getX(), first->getY());
+    for (Element* e: this->elements) {
+        range.addPoint(e->getX(), e->getY());
+        range.addPoint(e->getX() + e->getElementWidth(), e->getY() + e->getElementHeight());
+    }
+
+    this->page->fireRangeChanged(range);
+}
+
+auto InsertsUndoAction::undo(Control* control) -> bool {
+    this->layer->removeElements(this->elements);
+    fireRangeChanged();
+
     this->undone = true;
 
     return true;
 }
 
 auto InsertsUndoAction::redo(Control* control) -> bool {
-    for (Element* elem: this->elements) {
-        this->layer->addElement(elem);
-        this->page->fireElementChanged(elem);
-    }
+    this->layer->addElements(this->elements);
+    fireRangeChanged();
 
     this->undone = false;
 
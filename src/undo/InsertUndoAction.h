@@ -28,6 +28,8 @@ public:
 
     virtual std::string getText();
 
+    size_t getMemoryFootprint() const override;
+
 private:
     Layer* layer;
     Element* element;
@@ -44,6 +46,11 @@ public:
 
     virtual std::string getText();
 
+    size_t getMemoryFootprint() const override;
+
+private:
+    void fireRangeChanged();
+
 private:
     Layer* layer;
     std::vector<Element*> elements;
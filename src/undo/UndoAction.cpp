@@ -11,3 +11,5 @@ auto UndoAction::getPages() -> std::vector<PageRef> {
 }
 
 auto UndoAction::getClassName() const -> std::string const& { return this->className; }
+
+auto UndoAction::getMemoryFootprint() const -> size_t { return sizeof(UndoAction) + this->className.capacity(); }
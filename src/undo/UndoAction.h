@@ -13,15 +13,16 @@
 
 #include "model/PageRef.h"
 
+#include "MemoryAccountable.h"
 #include "config.h"
 
 class Control;
 class XojPage;
 
-class UndoAction {
+class UndoAction: public MemoryAccountable {
 public:
     UndoAction(std::string className);  // NOLINT
-    virtual ~UndoAction() = default;
+    ~UndoAction() override = default;
 
 public:
     virtual bool undo(Control* control) = 0;
@@ -36,6 +37,12 @@ public:
 
     auto getClassName() const -> std::string const&;
 
+    /**
+     * The memory held by this action, including elements which are only referenced by the undo stack
+     * (e.g. deleted elements). Elements which are still part of the document are not counted.
+     */
+    size_t getMemoryFootprint() const override;
+
 protected:
     // This is only for debugging / Testing purpose
     std::string className;
@@ -257,3 +257,29 @@ void UndoRedoHandler::documentAutosaved() {
 void UndoRedoHandler::documentSaved() {
     this->savedUndo = this->undoList.empty() ? nullptr : this->undoList.back().get();
 }
+
+auto UndoRedoHandler::getReferencedPages() -> std::vector<PageRef> {
+    std::vector<PageRef> pages;
+    for (auto const& action: this->undoList) {
+        for (PageRef& p: action->getPages()) {
+            pages.push_back(std::move(p));
+        }
+    }
+    for (auto const& action: this->redoList) {
+        for (PageRef& p: action->getPages()) {
+            pages.push_back(std::move(p));
+        }
+    }
+    return pages;
+}
+
+auto UndoRedoHandler::getMemoryFootprint() const -> size_t {
+    size_t bytes = 0;
+    for (auto const& action: this->undoList) {
+        bytes += action->getMemoryFootprint();
+    }
+    for (auto const& action: this->redoList) {
+        bytes += action->getMemoryFootprint();
+    }
+    return bytes;
+}
@@ -58,6 +58,16 @@ public:
     void documentAutosaved();
     void documentSaved();
 
+    /**
+     * The memory held by all undo and redo actions
+     */
+    size_t getMemoryFootprint() const;
+
+    /**
+     * @return The pages affected by any undo or redo action, may contain duplicates
+     */
+    std::vector<PageRef> getReferencedPages();
+
 private:
     void clearRedo();
     void printContents();
@@ -0,0 +1,80 @@
+/*
+ * Xournal++
+ *
+ * A value which is shared by copies until it is modified
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+/**
+ * @brief Holds a value which copies of the holder share, until one of them modifies it
+ *
+ * Used for the payload of elements (points, image and PDF data), so cloned elements, duplicated pages and copied
+ * layers do not copy it. An empty holder does not allocate.
+ *
+ * The value is copied in write() if it is shared. Like the elements themselves, a holder must not be modified
+ * while another thread reads it. Different holders of the same value can be used from different threads.
+ */
+template <class T>
+class CopyOnWrite {
+public:
+    CopyOnWrite() = default;
+    explicit CopyOnWrite(T value): value(std::make_shared<std::shared_ptr<T>>(std::make_shared<T>(std::move(value)))) {}
+
+public:
+    const T& operator*() const { return this->value ? **this->value : empty(); }
+    const T* operator->() const { return &**this; }
+
+    /**
+     * @return The value for modification, copied first if it is shared with another holder or kept by share()
+     */
+    T& write() {
+        if (!this->value) {
+            this->value = std::make_shared<std::shared_ptr<T>>(std::make_shared<T>());
+        } else if (this->value.use_count() > 1) {
+            this->value = std::make_shared<std::shared_ptr<T>>(std::make_shared<T>(**this->value));
+        } else if (this->value->use_count() > 1) {
+            // Only kept by share(), this is the only holder
+            *this->value = std::make_shared<T>(**this->value);
+        }
+        return **this->value;
+    }
+
+    /**
+     * @return The value, which stays valid independent of this holder, nullptr if empty. While it is kept, write()
+     *         copies the value first.
+     */
+    std::shared_ptr<const T> share() const { return this->value ? *this->value : nullptr; }
+
+    /**
+     * @return The number of holders which share the value, 0 if empty. References from share() are not counted,
+     *         so the size of the value can be divided between the holders.
+     */
+    size_t getUseCount() const { return static_cast<size_t>(this->value.use_count()); }
+
+    /**
+     * @return Whether both hold the same instance of the value
+     */
+    bool sharesWith(const CopyOnWrite& other) const { return this->value && this->value == other.value; }
+
+private:
+    static const T& empty() {
+        static const T emptyValue{};
+        return emptyValue;
+    }
+
+private:
+    /**
+     * Copies of the holder share the outer pointer, share() only hands out the inner one
+     */
+    std::shared_ptr<std::shared_ptr<T>> value;
+};
@@ -33,6 +33,8 @@ void emergencySave() {
 
     SaveHandler handler;
     handler.prepareSave(document);
+    // Do not start new threads while crashing
+    handler.setCompression(Z_DEFAULT_COMPRESSION, 1);
     handler.saveTo(filepath);
 
     if (!handler.getErrorMessage().empty()) {
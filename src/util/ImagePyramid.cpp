@@ -0,0 +1,61 @@
+#include "ImagePyramid.h"
+
+#include <algorithm>
+
+#include "MemoryAccountable.h"
+
+ImagePyramid::~ImagePyramid() { clear(); }
+
+auto ImagePyramid::getLevel(cairo_surface_t* original, double width, double height) -> cairo_surface_t* {
+    int originalWidth = cairo_image_surface_get_width(original);
+    int originalHeight = cairo_image_surface_get_height(original);
+
+    // The last level which is still at least as large as the target
+    width = std::max(width, 1.0);
+    height = std::max(height, 1.0);
+    size_t level = 0;
+    while ((originalWidth >> (level + 1)) >= width && (originalHeight >> (level + 1)) >= height) {
+        level++;
+    }
+    if (level == 0) {
+        return cairo_surface_reference(original);
+    }
+
+    std::lock_guard<std::mutex> lock(this->levelLock);
+    while (this->levels.size() < level) {
+        cairo_surface_t* previous = this->levels.empty() ? original : this->levels.back();
+        int previousWidth = cairo_image_surface_get_width(previous);
+        int previousHeight = cairo_image_surface_get_height(previous);
+        int levelWidth = std::max(1, previousWidth / 2);
+        int levelHeight = std::max(1, previousHeight / 2);
+
+        cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, levelWidth, levelHeight);
+        cairo_t* cr = cairo_create(surface);
+        cairo_scale(cr, static_cast<double>(levelWidth) / previousWidth,
+                    static_cast<double>(levelHeight) / previousHeight);
+        cairo_set_source_surface(cr, previous, 0, 0);
+        cairo_pattern_set_filter(cairo_get_source(cr), CAIRO_FILTER_GOOD);
+        cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+        cairo_paint(cr);
+        cairo_destroy(cr);
+        this->levels.push_back(surface);
+    }
+    return cairo_surface_reference(this->levels[level - 1]);
+}
+
+void ImagePyramid::clear() {
+    std::lock_guard<std::mutex> lock(this->levelLock);
+    for (cairo_surface_t* level: this->levels) {
+        cairo_surface_destroy(level);
+    }
+    this->levels.clear();
+}
+
+auto ImagePyramid::getMemoryFootprint() const -> size_t {
+    std::lock_guard<std::mutex> lock(this->levelLock);
+    size_t size = 0;
+    for (cairo_surface_t* level: this->levels) {
+        size += MemoryAccountable::getSurfaceSize(level);
+    }
+    return size;
+}
@@ -0,0 +1,64 @@
+/*
+ * Xournal++
+ *
+ * Downsampled levels of an image surface
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <mutex>
+#include <vector>
+
+#include <gtk/gtk.h>
+
+/**
+ * @brief A mipmap of an image surface, used to draw large images at a small scale
+ *
+ * Level n has half the size of level n - 1, level 0 is the original surface. The original is owned by the caller
+ * and passed to each call, only the downsampled levels are kept here. They are created on first use, by the
+ * thread which draws, so page renders build them in the render thread and not in the GUI thread.
+ *
+ * All methods are thread safe.
+ */
+class ImagePyramid {
+public:
+    ImagePyramid() = default;
+    ~ImagePyramid();
+
+    ImagePyramid(const ImagePyramid&) = delete;
+    ImagePyramid& operator=(const ImagePyramid&) = delete;
+
+public:
+    /**
+     * Returns the smallest level which has at least the given size in pixels. So an image is never drawn from a
+     * level which has to be scaled up, unless the original has to, and never scaled down by more than a factor of
+     * 2, which cairo does with good quality.
+     *
+     * @param original The level 0 image surface, the same for all calls until clear()
+     * @return A new reference the caller has to release with cairo_surface_destroy()
+     */
+    cairo_surface_t* getLevel(cairo_surface_t* original, double width, double height);
+
+    /**
+     * Drops the levels, needed if the original changes
+     */
+    void clear();
+
+    /**
+     * @return The size of the pixel data of the downsampled levels
+     */
+    size_t getMemoryFootprint() const;
+
+private:
+    /**
+     * Downsampled levels, levels[0] is level 1
+     */
+    std::vector<cairo_surface_t*> levels;
+
+    mutable std::mutex levelLock;
+};
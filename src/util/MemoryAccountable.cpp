@@ -0,0 +1,16 @@
+#include "MemoryAccountable.h"
+
+auto MemoryAccountable::getSurfaceSize(cairo_surface_t* surface) -> size_t {
+    if (surface == nullptr || cairo_surface_get_type(surface) != CAIRO_SURFACE_TYPE_IMAGE) {
+        return 0;
+    }
+    return static_cast<size_t>(cairo_image_surface_get_stride(surface)) *
+           static_cast<size_t>(cairo_image_surface_get_height(surface));
+}
+
+auto MemoryAccountable::getPixbufSize(GdkPixbuf* pixbuf) -> size_t {
+    if (pixbuf == nullptr) {
+        return 0;
+    }
+    return gdk_pixbuf_get_byte_length(pixbuf);
+}
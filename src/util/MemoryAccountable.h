@@ -0,0 +1,38 @@
+/*
+ * Xournal++
+ *
+ * Interface for objects which can report their memory usage
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include <gtk/gtk.h>
+
+class MemoryAccountable {
+public:
+    virtual ~MemoryAccountable() = default;
+
+    /**
+     * @return The number of bytes held by this object, including its buffers and surfaces.
+     *         The value is an estimate, allocator overhead is not counted.
+     */
+    virtual size_t getMemoryFootprint() const = 0;
+
+public:
+    /**
+     * @return The size of the pixel data of an image surface, 0 for nullptr and other surface types
+     */
+    static size_t getSurfaceSize(cairo_surface_t* surface);
+
+    /**
+     * @return The size of the pixel data of a pixbuf, 0 for nullptr
+     */
+    static size_t getPixbufSize(GdkPixbuf* pixbuf);
+};
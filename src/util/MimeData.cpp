@@ -0,0 +1,72 @@
+#include "MimeData.h"
+
+#include <glib.h>
+
+namespace {
+void releaseData(void* data) { delete static_cast<std::shared_ptr<const std::string>*>(data); }
+
+void setMimeData(cairo_surface_t* surface, const char* mimeType, const char* data, size_t length,
+                 cairo_destroy_func_t destroy, void* closure) {
+    cairo_status_t status = cairo_surface_set_mime_data(surface, mimeType, reinterpret_cast<const unsigned char*>(data),
+                                                        length, destroy, closure);
+    if (status != CAIRO_STATUS_SUCCESS) {
+        destroy(closure);
+    }
+}
+}  // namespace
+
+auto Util::getImageMimeType(const std::string& data) -> const char* {
+    if (data.compare(0, 3, "\xFF\xD8\xFF") == 0) {
+        return CAIRO_MIME_TYPE_JPEG;
+    }
+    if (data.compare(0, 8, "\x89PNG\r\n\x1A\n") == 0) {
+        return CAIRO_MIME_TYPE_PNG;
+    }
+    return nullptr;
+}
+
+auto Util::getImageId(const std::string& data) -> std::string {
+    gchar* id =
+            g_compute_checksum_for_data(G_CHECKSUM_SHA256, reinterpret_cast<const guchar*>(data.data()), data.size());
+    std::string result = id;
+    g_free(id);
+    return result;
+}
+
+auto Util::createExportSurface(cairo_surface_t* image, std::shared_ptr<const std::string> data, const std::string& id)
+        -> cairo_surface_t* {
+    if (!data || data->empty() || cairo_surface_status(image) != CAIRO_STATUS_SUCCESS ||
+        cairo_surface_get_type(image) != CAIRO_SURFACE_TYPE_IMAGE) {
+        return cairo_surface_reference(image);
+    }
+
+    cairo_surface_flush(image);
+    cairo_surface_t* surface = cairo_image_surface_create_for_data(
+            cairo_image_surface_get_data(image), cairo_image_surface_get_format(image),
+            cairo_image_surface_get_width(image), cairo_image_surface_get_height(image),
+            cairo_image_surface_get_stride(image));
+
+    // The new surface does not own the pixels, image is kept until it is destroyed
+    static cairo_user_data_key_t imageKey;
+    if (cairo_surface_set_user_data(surface, &imageKey, cairo_surface_reference(image),
+                                    reinterpret_cast<cairo_destroy_func_t>(&cairo_surface_destroy)) !=
+        CAIRO_STATUS_SUCCESS) {
+        cairo_surface_destroy(image);
+        cairo_surface_destroy(surface);
+        return cairo_surface_reference(image);
+    }
+
+    double scaleX = 1;
+    double scaleY = 1;
+    cairo_surface_get_device_scale(image, &scaleX, &scaleY);
+    cairo_surface_set_device_scale(surface, scaleX, scaleY);
+
+    gchar* uniqueId = g_strdup(id.c_str());
+    setMimeData(surface, CAIRO_MIME_TYPE_UNIQUE_ID, uniqueId, id.size(), g_free, uniqueId);
+
+    if (const char* mimeType = getImageMimeType(*data)) {
+        auto* holder = new std::shared_ptr<const std::string>(std::move(data));
+        setMimeData(surface, mimeType, (*holder)->data(), (*holder)->size(), releaseData, holder);
+    }
+    return surface;
+}
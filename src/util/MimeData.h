@@ -0,0 +1,49 @@
+/*
+ * Xournal++
+ *
+ * Encoded image data attached to cairo surfaces
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include <cairo.h>
+
+namespace Util {
+
+/**
+ * @return CAIRO_MIME_TYPE_PNG or CAIRO_MIME_TYPE_JPEG, by the signature of the data, nullptr for other formats
+ */
+const char* getImageMimeType(const std::string& data);
+
+/**
+ * @return The id of the encoded image for CAIRO_MIME_TYPE_UNIQUE_ID, a SHA256 hash of the data
+ */
+std::string getImageId(const std::string& data);
+
+/**
+ * @brief Creates a surface for drawing the image to a PDF or SVG target, with the encoded image attached, see
+ * cairo_surface_set_mime_data()
+ *
+ * The PDF export embeds JPEG data as it is, the SVG export PNG and JPEG data, instead of encoding the pixels again.
+ * CAIRO_MIME_TYPE_UNIQUE_ID is set to id, so both embed an image only once per file, also if it was decoded more
+ * than once, e.g. for copies pasted from the clipboard.
+ *
+ * The returned surface uses the pixels of image, which must not be changed while it exists. The data is only
+ * attached to it, so it is freed once the export does not need it anymore.
+ *
+ * @param data The encoded image, kept by the surface until it is destroyed
+ * @param id The id of data, see getImageId()
+ * @return A new surface, or a new reference to image if it is not an image surface or data is nullptr
+ */
+cairo_surface_t* createExportSurface(cairo_surface_t* image, std::shared_ptr<const std::string> data,
+                                     const std::string& id);
+
+}  // namespace Util
@@ -1,6 +1,9 @@
 #include "OutputStream.h"
 
+#include <algorithm>
 #include <cstdlib>
+#include <cstring>
+#include <thread>
 
 #include <glib.h>
 
@@ -15,14 +18,66 @@ void OutputStream::write(const std::string& str) { write(str.c_str(), str.length
 
 void OutputStream::write(const char* str) { write(str, strlen(str)); }
 
+////////////////////////////////////////////////////////
+/// BufferedOutputStream ///////////////////////////////
+////////////////////////////////////////////////////////
+
+BufferedOutputStream::BufferedOutputStream(size_t bufferSize): buffer(bufferSize) {}
+
+BufferedOutputStream::~BufferedOutputStream() = default;
+
+void BufferedOutputStream::write(const char* data, int len) {
+    if (len <= 0) {
+        return;
+    }
+    auto length = static_cast<size_t>(len);
+
+    // Always pass on completely filled buffers, so the blocks do not depend on how the data was written
+    while (length > 0) {
+        size_t count = std::min(length, this->buffer.size() - this->used);
+        std::memcpy(this->buffer.data() + this->used, data, count);
+        this->used += count;
+        data += count;
+        length -= count;
+
+        if (this->used == this->buffer.size()) {
+            flush();
+        }
+    }
+}
+
+void BufferedOutputStream::flush() {
+    if (this->used > 0) {
+        writeBuffer(this->buffer.data(), this->used);
+        this->used = 0;
+    }
+}
+
 ////////////////////////////////////////////////////////
 /// GzOutputStream /////////////////////////////////////
 ////////////////////////////////////////////////////////
 
-GzOutputStream::GzOutputStream(fs::path file): file(std::move(file)) {
-    this->fp = GzUtil::openPath(this->file, "w");
+GzOutputStream::GzOutputStream(fs::path file, int level, int threads):
+        BufferedOutputStream(BLOCK_SIZE), level(level), file(std::move(file)) {
+    this->threads = threads > 0 ? static_cast<size_t>(threads) : std::max(1U, std::thread::hardware_concurrency());
+
+    // Transparent mode, the gzip stream is assembled here and zlib only writes it to the file
+    this->fp = GzUtil::openPath(this->file, "wbT");
     if (this->fp == nullptr) {
         this->error = FS(_F("Error opening file: \"{1}\"") % this->file.u8string());
+        return;
+    }
+    this->crc = crc32(0, nullptr, 0);
+
+    // gzip header: magic, deflate, no flags, no mtime, no extra flags, OS unknown
+    const char header[] = {'\x1f', '\x8b', 8, 0, 0, 0, 0, 0, 0, '\xff'};
+    writeData(header, sizeof(header));
+
+    if (this->threads > 1) {
+        this->workers.reserve(this->threads);
+        for (size_t i = 0; i < this->threads; i++) {
+            this->workers.emplace_back(&GzOutputStream::runWorker, this);
+        }
     }
 }
 
@@ -30,16 +85,169 @@ GzOutputStream::~GzOutputStream() {
     if (this->fp) {
         close();
     }
-    this->fp = nullptr;
+    stopWorkers();
 }
 
 auto GzOutputStream::getLastError() -> std::string& { return this->error; }
 
-void GzOutputStream::write(const char* data, int len) { gzwrite(this->fp, data, len); }
+void GzOutputStream::runWorker() {
+    while (true) {
+        std::packaged_task<CompressedBlock()> task;
+        {
+            std::unique_lock<std::mutex> lock(this->queueMutex);
+            this->queueChanged.wait(lock, [this]() { return this->stopping || !this->queue.empty(); });
+            if (this->queue.empty()) {
+                return;
+            }
+            task = std::move(this->queue.front());
+            this->queue.pop_front();
+        }
+        task();
+    }
+}
+
+void GzOutputStream::stopWorkers() {
+    {
+        std::lock_guard<std::mutex> lock(this->queueMutex);
+        this->stopping = true;
+    }
+    this->queueChanged.notify_all();
+    for (std::thread& t: this->workers) {
+        t.join();
+    }
+    this->workers.clear();
+}
+
+auto GzOutputStream::compressBlock(std::string input, std::string dictionary, int level, bool last)
+        -> CompressedBlock {
+    CompressedBlock block;
+    block.length = input.size();
+    block.crc = crc32(crc32(0, nullptr, 0), reinterpret_cast<const Bytef*>(input.data()), input.size());
+
+    z_stream strm{};
+    // Raw deflate, the gzip header and trailer are written by the stream itself
+    if (deflateInit2(&strm, level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return block;
+    }
+    if (!dictionary.empty() && deflateSetDictionary(&strm, reinterpret_cast<const Bytef*>(dictionary.data()),
+                                                    dictionary.size()) != Z_OK) {
+        deflateEnd(&strm);
+        return block;
+    }
+
+    // The sync flush marker is not part of deflateBound()
+    block.data.resize(deflateBound(&strm, input.size()) + 16);
+    strm.next_in = reinterpret_cast<Bytef*>(input.data());
+    strm.avail_in = input.size();
+    strm.next_out = reinterpret_cast<Bytef*>(block.data.data());
+    strm.avail_out = block.data.size();
+
+    // Non-final blocks end on a byte boundary (Z_SYNC_FLUSH), so they can simply be concatenated
+    int ret = deflate(&strm, last ? Z_FINISH : Z_SYNC_FLUSH);
+    block.ok = (last ? ret == Z_STREAM_END : ret == Z_OK) && strm.avail_in == 0;
+    block.data.resize(strm.total_out);
+    deflateEnd(&strm);
+
+    return block;
+}
+
+void GzOutputStream::addBlock(std::string input, bool last) {
+    std::string dict = this->dictionary;
+
+    if (input.size() >= 32 * 1024) {
+        this->dictionary = input.substr(input.size() - 32 * 1024);
+    } else {
+        this->dictionary += input;
+        if (this->dictionary.size() > 32 * 1024) {
+            this->dictionary.erase(0, this->dictionary.size() - 32 * 1024);
+        }
+    }
+
+    std::packaged_task<CompressedBlock()> task(
+            [input = std::move(input), dict = std::move(dict), level = this->level, last]() mutable {
+                return compressBlock(std::move(input), std::move(dict), level, last);
+            });
+    this->pending.push_back(task.get_future());
+
+    if (this->workers.empty()) {
+        // A single thread compresses on the calling thread
+        task();
+    } else {
+        {
+            std::lock_guard<std::mutex> lock(this->queueMutex);
+            this->queue.push_back(std::move(task));
+        }
+        this->queueChanged.notify_one();
+    }
+
+    // Bound the memory: never keep more than two blocks per thread in flight
+    writeCompressedBlocks(2 * this->threads);
+}
+
+void GzOutputStream::writeCompressedBlocks(size_t maxPending) {
+    while (this->pending.size() > maxPending) {
+        CompressedBlock block = this->pending.front().get();
+        this->pending.pop_front();
+
+        if (!this->error.empty()) {
+            continue;
+        }
+        if (!block.ok) {
+            this->error = FS(_F("Error compressing file: \"{1}\"") % this->file.u8string());
+            continue;
+        }
+
+        this->crc = crc32_combine(this->crc, block.crc, static_cast<z_off_t>(block.length));
+        this->length += block.length;
+        writeData(block.data.data(), block.data.size());
+    }
+}
+
+auto GzOutputStream::writeData(const char* data, size_t len) -> bool {
+    if (!this->error.empty()) {
+        return false;
+    }
+    if (len > 0 && gzwrite(this->fp, data, static_cast<unsigned>(len)) != static_cast<int>(len)) {
+        this->error = FS(_F("Error writing file: \"{1}\"") % this->file.u8string());
+        return false;
+    }
+    return true;
+}
+
+void GzOutputStream::writeBuffer(const char* data, size_t len) {
+    // Nothing more is compressed after an error
+    if (!this->fp || !this->error.empty()) {
+        return;
+    }
+
+    for (size_t offset = 0; offset < len; offset += BLOCK_SIZE) {
+        addBlock(std::string(data + offset, std::min(BLOCK_SIZE, len - offset)), false);
+    }
+}
 
 void GzOutputStream::close() {
-    if (this->fp) {
-        gzclose(this->fp);
-        this->fp = nullptr;
+    if (!this->fp) {
+        return;
     }
+
+    flush();
+    if (this->error.empty()) {
+        // An empty final block terminates the deflate stream
+        addBlock("", true);
+    }
+    writeCompressedBlocks(0);
+    stopWorkers();
+
+    // gzip trailer: CRC-32 and the uncompressed size modulo 2^32, little endian
+    char trailer[8];
+    for (int i = 0; i < 4; i++) {
+        trailer[i] = static_cast<char>((this->crc >> (8 * i)) & 0xFF);
+        trailer[i + 4] = static_cast<char>((this->length >> (8 * i)) & 0xFF);
+    }
+    writeData(trailer, sizeof(trailer));
+
+    if (gzclose(this->fp) != Z_OK && this->error.empty()) {
+        this->error = FS(_F("Error writing file: \"{1}\"") % this->file.u8string());
+    }
+    this->fp = nullptr;
 }
@@ -11,7 +11,13 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include <zlib.h>
@@ -31,23 +37,121 @@ public:
     virtual void close() = 0;
 };
 
-class GzOutputStream: public OutputStream {
+/**
+ * @brief Collects small writes in a buffer and passes them on in large blocks
+ *
+ * Subclasses implement writeBuffer(), and have to call flush() before they close the underlying target.
+ */
+class BufferedOutputStream: public OutputStream {
 public:
-    GzOutputStream(fs::path file);
-    virtual ~GzOutputStream();
+    explicit BufferedOutputStream(size_t bufferSize = DEFAULT_BUFFER_SIZE);
+    virtual ~BufferedOutputStream();
 
 public:
+    using OutputStream::write;
     virtual void write(const char* data, int len);
 
+    /**
+     * Pass all buffered data on to writeBuffer()
+     */
+    void flush();
+
+protected:
+    virtual void writeBuffer(const char* data, size_t len) = 0;
+
+public:
+    static constexpr size_t DEFAULT_BUFFER_SIZE = 64 * 1024;
+
+private:
+    std::vector<char> buffer;
+    size_t used = 0;
+};
+
+/**
+ * @brief Writes a gzip file, compressing blocks of the data on several threads
+ *
+ * Like pigz, the data is split into blocks which are deflated independently (each one primed with the last 32 KiB
+ * of the previous block) and concatenated into a single gzip member, so the file can be read by any gzip reader.
+ * The blocks are compressed by a fixed number of worker threads owned by the stream.
+ */
+class GzOutputStream: public BufferedOutputStream {
+public:
+    /**
+     * @param level The zlib compression level, e.g. Z_BEST_SPEED for autosaves
+     * @param threads The number of blocks compressed at the same time, 0 to use one thread per processor
+     *                and 1 to compress on the calling thread only
+     */
+    GzOutputStream(fs::path file, int level = Z_DEFAULT_COMPRESSION, int threads = 0);
+    virtual ~GzOutputStream();
+
+public:
     virtual void close();
 
+    /**
+     * @return The first error, set as soon as a block could not be compressed or written
+     */
     std::string& getLastError();
 
+protected:
+    virtual void writeBuffer(const char* data, size_t len);
+
+private:
+    struct CompressedBlock {
+        std::string data;
+        uLong crc = 0;
+        size_t length = 0;
+        bool ok = false;
+    };
+
+    static CompressedBlock compressBlock(std::string input, std::string dictionary, int level, bool last);
+
+    void addBlock(std::string input, bool last);
+
+    /**
+     * Write the compressed blocks in order, until at most maxPending blocks are still being compressed
+     */
+    void writeCompressedBlocks(size_t maxPending);
+
+    /**
+     * Write to the file, and remember the first error
+     */
+    bool writeData(const char* data, size_t len);
+
+    void runWorker();
+    void stopWorkers();
+
+public:
+    static constexpr size_t BLOCK_SIZE = 128 * 1024;
+
 private:
     gzFile fp = nullptr;
 
+    int level;
+    size_t threads;
+
+    /**
+     * The blocks waiting for a worker
+     */
+    std::deque<std::packaged_task<CompressedBlock()>> queue;
+    std::mutex queueMutex;
+    std::condition_variable queueChanged;
+    bool stopping = false;
+    std::vector<std::thread> workers;
+
+    /**
+     * The results of all blocks not yet written, in file order
+     */
+    std::deque<std::future<CompressedBlock>> pending;
+
+    /**
+     * The last 32 KiB of uncompressed data, used as dictionary for the next block
+     */
+    std::string dictionary;
+
+    uLong crc = 0;
+    uint64_t length = 0;
+
     std::string error;
 
-    std::string target;
     fs::path file;
 };
@@ -0,0 +1,179 @@
+#include "Tracing.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+std::atomic<bool> Tracing::enabled{false};
+
+namespace {
+/**
+ * The fields are atomic, as dump() may read a slot while its thread overwrites it
+ */
+struct TraceEvent {
+    std::atomic<const char*> name{nullptr};
+    std::atomic<int64_t> start{0};
+    std::atomic<int64_t> duration{0};
+};
+
+/**
+ * Written only by its own thread, read by dump()
+ */
+struct ThreadBuffer {
+    explicit ThreadBuffer(int tid): tid(tid), events(Tracing::RING_SIZE) {}
+
+    int tid;
+    std::vector<TraceEvent> events;
+
+    /**
+     * Total number of recorded events, the next one is stored at count % RING_SIZE
+     */
+    std::atomic<size_t> count{0};
+
+    /**
+     * Number of events whose slot was started to be written, count or count + 1
+     */
+    std::atomic<size_t> started{0};
+};
+
+struct TraceState {
+    std::mutex mutex;
+    fs::path output;
+
+    /**
+     * Never freed, threads may still record while the trace is dumped on exit
+     */
+    std::vector<ThreadBuffer*> buffers;
+};
+
+auto state() -> TraceState& {
+    static auto* s = new TraceState;
+    return *s;
+}
+
+auto threadBuffer() -> ThreadBuffer* {
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (buffer == nullptr) {
+        auto& s = state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        buffer = new ThreadBuffer(static_cast<int>(s.buffers.size()) + 1);
+        s.buffers.push_back(buffer);
+    }
+    return buffer;
+}
+
+struct Event {
+    const char* name;
+    int64_t start;
+    int64_t duration;
+};
+
+/**
+ * Copies the events of a buffer while its thread may still record
+ */
+void snapshot(const ThreadBuffer& buffer, std::vector<Event>& events) {
+    events.clear();
+    size_t count = buffer.count.load(std::memory_order_acquire);
+    size_t begin = count > Tracing::RING_SIZE ? count - Tracing::RING_SIZE : 0;
+    for (size_t i = begin; i < count; i++) {
+        const TraceEvent& e = buffer.events[i % Tracing::RING_SIZE];
+        events.push_back({e.name.load(std::memory_order_relaxed), e.start.load(std::memory_order_relaxed),
+                          e.duration.load(std::memory_order_relaxed)});
+    }
+
+    // Events whose slot was written meanwhile are mixed up, drop them
+    std::atomic_thread_fence(std::memory_order_acquire);
+    size_t started = buffer.started.load(std::memory_order_relaxed);
+    if (started > Tracing::RING_SIZE && started - Tracing::RING_SIZE > begin) {
+        size_t overwritten = std::min(started - Tracing::RING_SIZE, count) - begin;
+        events.erase(events.begin(), events.begin() + static_cast<std::ptrdiff_t>(overwritten));
+    }
+}
+
+void writeJsonString(std::ostream& out, const char* str) {
+    out << '"';
+    for (const char* c = str; *c; c++) {
+        if (*c == '"' || *c == '\\') {
+            out << '\\';
+        }
+        out << *c;
+    }
+    out << '"';
+}
+}  // namespace
+
+void Tracing::enable(fs::path output) {
+    auto& s = state();
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.output = std::move(output);
+    }
+    enabled = true;
+}
+
+void Tracing::enableFromEnvironment() {
+    const char* output = std::getenv("XOURNALPP_TRACE");
+    if (output && *output) {
+        enable(fs::u8path(output));
+    }
+}
+
+auto Tracing::now() -> int64_t {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+}
+
+void Tracing::record(const char* name, int64_t start, int64_t end) {
+    ThreadBuffer* buffer = threadBuffer();
+    size_t index = buffer->count.load(std::memory_order_relaxed);
+
+    // Like a seqlock: dump() drops the slots which were overwritten while it copied them
+    buffer->started.store(index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    TraceEvent& e = buffer->events[index % RING_SIZE];
+    e.name.store(name, std::memory_order_relaxed);
+    e.start.store(start, std::memory_order_relaxed);
+    e.duration.store(end - start, std::memory_order_relaxed);
+    buffer->count.store(index + 1, std::memory_order_release);
+}
+
+auto Tracing::dump() -> bool {
+    if (!isEnabled()) {
+        return false;
+    }
+
+    auto& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+
+    std::ofstream out(s.output, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        return false;
+    }
+
+    // Chrome trace event format, "X" are complete events with a duration, all times in microseconds
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    std::vector<Event> events;
+    for (ThreadBuffer* buffer: s.buffers) {
+        snapshot(*buffer, events);
+        for (const Event& e: events) {
+            out << (first ? "\n" : ",\n") << "{\"name\":";
+            writeJsonString(out, e.name);
+            out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->tid
+                << ",\"ts\":" << static_cast<double>(e.start) / 1000.0
+                << ",\"dur\":" << static_cast<double>(e.duration) / 1000.0 << "}";
+            first = false;
+        }
+    }
+    out << "\n]}\n";
+
+    return out.good();
+}
@@ -0,0 +1,100 @@
+/*
+ * Xournal++
+ *
+ * Low overhead tracing of scoped spans, exported as Chrome trace JSON
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "filesystem.h"
+
+/**
+ * @brief Records spans (name, thread, start and duration) into per-thread ring buffers
+ *
+ * Tracing is compiled in but disabled by default, a disabled span costs a single atomic load.
+ * It is enabled with the environment variable XOURNALPP_TRACE=FILE or with the command line option --trace=FILE.
+ * The trace is written to FILE on exit (and on SIGUSR1 on Unix) and can be opened in chrome://tracing or Perfetto.
+ */
+class Tracing {
+private:
+    Tracing() = delete;
+
+public:
+    /**
+     * Enable tracing, the trace is written to output by dump()
+     */
+    static void enable(fs::path output);
+
+    /**
+     * Enable tracing if the environment variable XOURNALPP_TRACE is set
+     */
+    static void enableFromEnvironment();
+
+    static inline bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * Write all recorded spans to the output file
+     *
+     * @return false if tracing is not enabled or the file could not be written
+     */
+    static bool dump();
+
+    /**
+     * Record a finished span
+     * @param name A string literal, it is not copied
+     * @param start The start time in nanoseconds, see now()
+     * @param end The end time in nanoseconds
+     */
+    static void record(const char* name, int64_t start, int64_t end);
+
+    /**
+     * @return A monotonic timestamp in nanoseconds
+     */
+    static int64_t now();
+
+    /**
+     * Number of spans kept per thread, older spans are overwritten
+     */
+    static constexpr size_t RING_SIZE = 1 << 16;
+
+private:
+    static std::atomic<bool> enabled;
+};
+
+/**
+ * Records the time between its construction and destruction as a span
+ */
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name): name(name), start(Tracing::isEnabled() ? Tracing::now() : -1) {}
+
+    ~TraceSpan() {
+        if (this->start >= 0) {
+            Tracing::record(this->name, this->start, Tracing::now());
+        }
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    const char* name;
+    int64_t start;
+};
+
+#define XOJ_TRACE_CONCAT_(a, b) a##b
+#define XOJ_TRACE_CONCAT(a, b) XOJ_TRACE_CONCAT_(a, b)
+
+/**
+ * Trace the current scope, name has to be a string literal
+ */
+#define XOJ_TRACE_SCOPE(name) TraceSpan XOJ_TRACE_CONCAT(xojTraceSpan, __LINE__)(name)
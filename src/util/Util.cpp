@@ -2,7 +2,9 @@
 
 #include <array>
 #include <cassert>
+#include <charconv>
 #include <cstdlib>
+#include <cstring>
 
 #include <unistd.h>
 
@@ -62,13 +64,31 @@ auto Util::paintBackgroundWhite(GtkWidget* widget, cairo_t* cr, void*) -> gboole
     return false;
 }
 
+auto Util::formatDouble(char* buffer, size_t size, double value) -> size_t {
+#ifdef __cpp_lib_to_chars
+    // std::to_chars is exact and never uses the locale, so it produces the same digits as printf("%.8f")
+    auto [end, ec] = std::to_chars(buffer, buffer + size, value, std::chars_format::fixed, Util::PRECISION_DIGITS);
+    if (ec == std::errc()) {
+        return static_cast<size_t>(end - buffer);
+    }
+#endif
+    // Standard library without floating point to_chars, or a value too large for the buffer
+    g_ascii_formatd(buffer, static_cast<gint>(size), Util::PRECISION_FORMAT_STRING, value);
+    return strlen(buffer);
+}
+
+void Util::writeDouble(OutputStream* out, double value) {
+    std::array<char, G_ASCII_DTOSTR_BUF_SIZE> str{};
+    out->write(str.data(), static_cast<int>(formatDouble(str.data(), str.size(), value)));
+}
+
 void Util::writeCoordinateString(OutputStream* out, double xVal, double yVal) {
-    std::array<char, G_ASCII_DTOSTR_BUF_SIZE> coordString{};
-    g_ascii_formatd(coordString.data(), G_ASCII_DTOSTR_BUF_SIZE, Util::PRECISION_FORMAT_STRING, xVal);
-    out->write(coordString.data());
-    out->write(" ");
-    g_ascii_formatd(coordString.data(), G_ASCII_DTOSTR_BUF_SIZE, Util::PRECISION_FORMAT_STRING, yVal);
-    out->write(coordString.data());
+    // Format both values into one buffer, to only write once per point
+    std::array<char, 2 * G_ASCII_DTOSTR_BUF_SIZE + 1> coordString{};
+    size_t len = formatDouble(coordString.data(), G_ASCII_DTOSTR_BUF_SIZE, xVal);
+    coordString[len++] = ' ';
+    len += formatDouble(coordString.data() + len, G_ASCII_DTOSTR_BUF_SIZE, yVal);
+    out->write(coordString.data(), static_cast<int>(len));
 }
 
 void Util::systemWithMessage(const char* command) {
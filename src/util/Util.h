@@ -45,7 +45,24 @@ gboolean paintBackgroundWhite(GtkWidget* widget, cairo_t* cr, void* unused);
  */
 extern void writeCoordinateString(OutputStream* out, double xVal, double yVal);
 
+/**
+ * @brief Format a double like g_ascii_formatd with PRECISION_FORMAT_STRING, without the overhead of printf
+ *
+ * The output is locale independent and identical to the one of g_ascii_formatd.
+ *
+ * @param buffer The buffer to write to, it is not null-terminated
+ * @param size The size of the buffer, at least G_ASCII_DTOSTR_BUF_SIZE
+ * @return The number of characters written
+ */
+extern size_t formatDouble(char* buffer, size_t size, double value);
+
+/**
+ * Write a double formatted with formatDouble to the given OutputStream
+ */
+extern void writeDouble(OutputStream* out, double value);
+
 constexpr const gchar* PRECISION_FORMAT_STRING = "%.8f";
+constexpr const int PRECISION_DIGITS = 8;
 
 constexpr const auto DPI_NORMALIZATION_FACTOR = 72.0;
 
@@ -59,6 +59,10 @@ void AudioPlayer::seek(int seconds) {
     this->vorbisProducer->seek(seconds);
 }
 
+auto AudioPlayer::getTimestamp() -> size_t { return this->vorbisProducer->getTimestamp(); }
+
+auto AudioPlayer::hasEnded() -> bool { return this->audioQueue->hasStreamEnded() && this->audioQueue->empty(); }
+
 auto AudioPlayer::getOutputDevices() -> std::vector<DeviceInfo> { return this->portAudioConsumer->getOutputDevices(); }
 
 auto AudioPlayer::getSettings() -> Settings& { return this->settings; }
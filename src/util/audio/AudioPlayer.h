@@ -34,6 +34,16 @@ public:
     void pause();
     void seek(int seconds);
 
+    /**
+     * @return The playback position in milliseconds from the start of the file
+     */
+    size_t getTimestamp();
+
+    /**
+     * @return true if all audio of the file was played
+     */
+    bool hasEnded();
+
     std::vector<DeviceInfo> getOutputDevices();
 
     Settings& getSettings();
@@ -12,137 +12,195 @@
 #pragma once
 
 #include <algorithm>
-#include <cassert>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
-#include <deque>
+#include <cstddef>
+#include <iterator>
 #include <limits>
 #include <mutex>
+#include <utility>
 #include <vector>
 
+/**
+ * @brief Lock-free single producer, single consumer ring buffer
+ *
+ * One side of the queue is the PortAudio callback, which must not block: push() and pop() are wait-free and the
+ * memory is allocated up front. If the buffer is full, push() drops the samples and counts them instead of waiting.
+ *
+ * The other side (the Vorbis file reader or writer thread) blocks in waitForProducer() / waitForConsumer().
+ * The real-time side never notifies these waits, they poll the fill level with a short timeout. They are woken
+ * directly by signalEndOfStream().
+ *
+ * reset() and setAudioAttributes() must only be called while no stream is running.
+ */
 template <typename T>
 class AudioQueue {
 public:
-    void reset() {
-        std::lock_guard<std::mutex> lock(internalLock);
-        this->popNotified = false;
-        this->pushNotified = false;
-        this->streamEnd = false;
-        internalQueue.clear();
-
-        this->sampleRate = -1;
-        this->channels = 0;
-    }
+    /**
+     * 2^20 samples, more than 5 seconds of stereo audio at 96 kHz
+     */
+    static constexpr size_t DEFAULT_CAPACITY = size_t{1} << 20U;
 
-    bool empty() {
-        std::lock_guard<std::mutex> lock(internalLock);
-        return internalQueue.empty();
+    /**
+     * @param capacity The number of samples, rounded up to a power of two
+     */
+    explicit AudioQueue(size_t capacity = DEFAULT_CAPACITY) {
+        size_t size = 1;
+        while (size < capacity) {
+            size <<= 1U;
+        }
+        this->buffer.resize(size);
+        this->mask = size - 1;
     }
 
-    size_t size() {
-        std::lock_guard<std::mutex> lock(internalLock);
-        return internalQueue.size();
+    void reset() {
+        std::lock_guard<std::mutex> lock(this->waitLock);
+        this->head.store(0, std::memory_order_relaxed);
+        this->tail.store(0, std::memory_order_relaxed);
+        this->dropped.store(0, std::memory_order_relaxed);
+        this->streamEnd.store(false, std::memory_order_release);
+
+        this->sampleRate.store(-1, std::memory_order_relaxed);
+        this->channels.store(0, std::memory_order_relaxed);
     }
 
-    template <typename Iter>
-    void emplace(Iter begI, Iter endI) {
-        std::lock_guard<std::mutex> lock(internalLock);
-        std::move(begI, endI, std::front_inserter(internalQueue));
+    bool empty() const { return size() == 0; }
 
-        this->pushNotified = true;
-        this->pushLockCondition.notify_one();
+    size_t size() const {
+        // Load the tail first, so the difference never underflows
+        size_t t = this->tail.load(std::memory_order_acquire);
+        return this->head.load(std::memory_order_acquire) - t;
     }
 
-    template <typename InsertIter>
-    InsertIter pop(InsertIter insertIter, size_t nSamples) {
-        std::lock_guard<std::mutex> lock(internalLock);
+    size_t capacity() const { return this->buffer.size(); }
 
-        if (this->channels == 0) {
-            this->popNotified = true;
-            this->popLockCondition.notify_one();
-            return insertIter;
+    /**
+     * Producer side, wait-free
+     *
+     * @return false if there is not enough space, the samples are dropped as a whole so the channels stay aligned
+     */
+    template <typename Iter>
+    bool push(Iter begI, Iter endI) {
+        auto count = static_cast<size_t>(std::distance(begI, endI));
+        size_t h = this->head.load(std::memory_order_relaxed);
+        size_t t = this->tail.load(std::memory_order_acquire);
+
+        if (capacity() - (h - t) < count) {
+            this->dropped.fetch_add(count, std::memory_order_relaxed);
+            return false;
         }
 
+        // Copy in up to two parts, the second one wraps around to the beginning of the buffer
+        size_t start = h & this->mask;
+        size_t first = std::min(count, capacity() - start);
+        auto midI = std::next(begI, static_cast<std::ptrdiff_t>(first));
+        std::copy(begI, midI, std::next(this->buffer.begin(), static_cast<std::ptrdiff_t>(start)));
+        std::copy(midI, endI, this->buffer.begin());
+
+        this->head.store(h + count, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Consumer side, wait-free. Only whole frames (a sample for every channel) are returned.
+     *
+     * @return The number of samples written to out, at most nSamples
+     */
+    size_t pop(T* out, size_t nSamples) {
+        auto channelCount = static_cast<size_t>(this->channels.load(std::memory_order_relaxed));
+        if (channelCount == 0) {
+            return 0;
+        }
 
-        auto queueSize = internalQueue.size();
-        auto returnBufferLength = std::min<size_t>(nSamples, queueSize - queueSize % this->channels);
-        auto begI = rbegin(internalQueue);
-        auto endI = std::next(begI, returnBufferLength);
+        size_t t = this->tail.load(std::memory_order_relaxed);
+        size_t available = this->head.load(std::memory_order_acquire) - t;
+        size_t count = std::min(nSamples, available);
+        count -= count % channelCount;
 
-        auto ret = std::move(begI, endI, insertIter);
-        internalQueue.erase(endI.base(), begI.base());
+        size_t start = t & this->mask;
+        size_t first = std::min(count, capacity() - start);
+        auto begI = std::next(this->buffer.begin(), static_cast<std::ptrdiff_t>(start));
+        std::copy(begI, std::next(begI, static_cast<std::ptrdiff_t>(first)), out);
+        std::copy(this->buffer.begin(), std::next(this->buffer.begin(), static_cast<std::ptrdiff_t>(count - first)),
+                  out + first);
 
-        this->popNotified = true;
-        this->popLockCondition.notify_one();
-        return ret;
+        this->tail.store(t + count, std::memory_order_release);
+        return count;
     }
 
-    void signalEndOfStream() {
-        std::lock_guard<std::mutex> lock(internalLock);
-        this->streamEnd = true;
-        this->pushNotified = true;
-        this->popNotified = true;
-        this->pushLockCondition.notify_one();
-        this->popLockCondition.notify_one();
+    /**
+     * Blocks the (non real-time) consumer until at least minSamples are available or the stream ended
+     *
+     * @return false if the wait timed out, call again to keep waiting
+     */
+    bool waitForProducer(size_t minSamples) {
+        std::unique_lock<std::mutex> lock(this->waitLock);
+        return this->waitCondition.wait_for(lock, POLL_INTERVAL,
+                                            [&] { return size() >= minSamples || hasStreamEnded(); });
     }
 
-    void waitForProducer(std::unique_lock<std::mutex>& lock) {
-        // static_assert(lock.mutex() == &this->queueLock);
-        assert(lock.mutex() == &this->queueLock);
-        while (!this->pushNotified && !hasStreamEnded()) {
-            this->pushLockCondition.wait(lock);
-        }
-        this->pushNotified = false;
+    /**
+     * Blocks the (non real-time) producer until at most maxSamples are queued or the stream ended
+     *
+     * @return false if the wait timed out, call again to keep waiting
+     */
+    bool waitForConsumer(size_t maxSamples) {
+        std::unique_lock<std::mutex> lock(this->waitLock);
+        return this->waitCondition.wait_for(lock, POLL_INTERVAL,
+                                            [&] { return size() <= maxSamples || hasStreamEnded(); });
     }
 
-    void waitForConsumer(std::unique_lock<std::mutex>& lock) {
-        // static_assert(lock.mutex() == &this->queueLock);
-        assert(lock.mutex() == &this->queueLock);
-        while (!this->popNotified && !hasStreamEnded()) {
-            this->popLockCondition.wait(lock);
+    void signalEndOfStream() {
+        {
+            std::lock_guard<std::mutex> lock(this->waitLock);
+            this->streamEnd.store(true, std::memory_order_release);
         }
-        this->popNotified = false;
+        this->waitCondition.notify_all();
     }
 
-    bool hasStreamEnded() {
-        std::lock_guard<std::mutex> lock(internalLock);
-        return this->streamEnd;
-    }
+    bool hasStreamEnded() const { return this->streamEnd.load(std::memory_order_acquire); }
 
-    [[nodiscard]] std::unique_lock<std::mutex> acquire_lock() {
-        std::unique_lock retLock{this->queueLock, std::defer_lock};
-        std::lock(retLock, this->internalLock);
-        std::lock_guard{this->internalLock, std::adopt_lock};
-        return retLock;
-    }
+    /**
+     * @return The number of samples push() dropped because the buffer was full, since the last reset()
+     */
+    size_t getDroppedSamples() const { return this->dropped.load(std::memory_order_relaxed); }
 
     void setAudioAttributes(double lSampleRate, unsigned int lChannels) {
-        std::lock_guard<std::mutex> lock(internalLock);
-        this->sampleRate = lSampleRate;
-        this->channels = lChannels;
+        this->sampleRate.store(lSampleRate, std::memory_order_relaxed);
+        this->channels.store(lChannels, std::memory_order_relaxed);
     }
 
     /**
      * @return std::pair<double, int>,
      * std::pair<double, int>::first is the sample rate and std::pair<double, int>::second the channel count.
      */
-    [[nodiscard]] std::pair<double, int> getAudioAttributes() {
-        std::lock_guard<std::mutex> lock(internalLock);
-        return {this->sampleRate, static_cast<int>(this->channels)};
+    [[nodiscard]] std::pair<double, int> getAudioAttributes() const {
+        return {this->sampleRate.load(std::memory_order_relaxed),
+                static_cast<int>(this->channels.load(std::memory_order_relaxed))};
     }
 
 private:
-    std::mutex queueLock;
-    std::mutex internalLock;
+    /**
+     * A few PortAudio buffers at common sample rates
+     */
+    static constexpr std::chrono::milliseconds POLL_INTERVAL{5};
+
+    std::vector<T> buffer;
+    size_t mask = 0;
 
-    std::deque<T> internalQueue;
+    /**
+     * Positions of the producer and the consumer, they only grow and are masked to index the buffer
+     */
+    alignas(64) std::atomic<size_t> head{0};
+    alignas(64) std::atomic<size_t> tail{0};
 
-    std::condition_variable pushLockCondition;
-    std::condition_variable popLockCondition;
+    std::atomic<size_t> dropped{0};
 
-    double sampleRate{std::numeric_limits<double>::quiet_NaN()};
-    unsigned int channels{0};
+    std::atomic<double> sampleRate{std::numeric_limits<double>::quiet_NaN()};
+    std::atomic<unsigned int> channels{0};
+    std::atomic<bool> streamEnd{false};
 
-    bool streamEnd{false};
-    bool pushNotified{false};
-    bool popNotified{false};
+    std::mutex waitLock;
+    std::condition_variable waitCondition;
 };
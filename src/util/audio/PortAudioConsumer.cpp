@@ -94,7 +94,7 @@ auto PortAudioConsumer::playCallback(const void* /*inputBuffer*/, void* outputBu
 
     if (outputBuffer != nullptr) {
         auto begI = static_cast<float*>(outputBuffer);
-        auto midI = this->audioQueue.pop(begI, framesPerBuffer * this->outputChannels);
+        auto midI = std::next(begI, this->audioQueue.pop(begI, framesPerBuffer * this->outputChannels));
         auto endI = std::next(begI, framesPerBuffer * this->outputChannels);
         // Fill buffer to requested length if necessary
 
@@ -85,7 +85,8 @@ auto PortAudioProducer::recordCallback(const void* inputBuffer, void* /*outputBu
     if (inputBuffer != nullptr) {
         size_t providedFrames = framesPerBuffer * this->inputChannels;
         auto begI = static_cast<float const*>(inputBuffer);
-        this->audioQueue.emplace(begI, std::next(begI, providedFrames));
+        // Samples which do not fit are counted by the queue, waiting here would cause dropouts
+        this->audioQueue.push(begI, std::next(begI, providedFrames));
     }
     return paContinue;
 }
@@ -102,6 +103,11 @@ void PortAudioProducer::stopRecording() {
         }
     }
 
+    if (size_t dropped = this->audioQueue.getDroppedSamples(); dropped > 0) {
+        g_warning("PortAudioProducer: %zu samples were dropped, the audio file could not be written fast enough",
+                  dropped);
+    }
+
     // Notify the consumer at the other side that there will be no more data
     this->audioQueue.signalEndOfStream();
 
@@ -3,6 +3,8 @@
 #include <algorithm>
 #include <cmath>
 
+constexpr auto FRAMES_PER_WRITE{4096};
+
 auto VorbisConsumer::start(const std::string& filename) -> bool {
     auto [sampleRate, channels] = this->audioQueue.getAudioAttributes();
 
@@ -26,23 +28,30 @@ auto VorbisConsumer::start(const std::string& filename) -> bool {
     }
 
     this->consumerThread = std::thread([this, sfFile = std::move(sfFile), channels = channels] {
-        auto lock{audioQueue.acquire_lock()};
-        auto buffer_size{static_cast<size_t>(std::max(0, 64 * channels))};
-        std::vector<float> buffer;
-        buffer.reserve(buffer_size);  // efficiency
+        // Larger blocks than the PortAudio buffers, so the encoder is called less often
+        auto bufferSize{static_cast<size_t>(std::max(0, FRAMES_PER_WRITE * channels))};
+        std::vector<float> buffer(bufferSize);
         double audioGain = this->settings.getAudioGain();
 
-        while (!(this->stopConsumer || (audioQueue.hasStreamEnded() && audioQueue.empty()))) {
-            audioQueue.waitForProducer(lock);
-            while (audioQueue.size() > buffer_size || (audioQueue.hasStreamEnded() && !audioQueue.empty())) {
-                buffer.resize(0);
-                this->audioQueue.pop(std::back_inserter(buffer), buffer_size);
-                // apply gain
-                if (audioGain != 1.0) {
-                    std::for_each(begin(buffer), end(buffer), [audioGain](auto& val) { val *= audioGain; });
+        while (!this->stopConsumer) {
+            this->audioQueue.waitForProducer(bufferSize);
+
+            // Check before popping, samples pushed before the end of the stream are popped afterwards
+            bool streamEnded = this->audioQueue.hasStreamEnded();
+            size_t count = this->audioQueue.pop(buffer.data(), bufferSize);
+            if (count == 0) {
+                if (streamEnded) {
+                    break;
                 }
-                sf_writef_float(sfFile.get(), buffer.data(), std::min<size_t>(buffer.size() / channels, 64));
+                continue;
+            }
+
+            // apply gain
+            if (audioGain != 1.0) {
+                std::for_each(begin(buffer), std::next(begin(buffer), count),
+                              [audioGain](auto& val) { val *= audioGain; });
             }
+            sf_writef_float(sfFile.get(), buffer.data(), static_cast<sf_count_t>(count / channels));
         }
     });
     return true;
@@ -1,5 +1,7 @@
 #include "VorbisProducer.h"
 
+#include <algorithm>
+
 #include <glib.h>
 
 constexpr auto sample_buffer_size = size_t{16384U};
@@ -17,8 +19,10 @@ auto VorbisProducer::start(const std::string& filename, unsigned int timestamp)
 
     sf_count_t seekPosition = sfInfo.samplerate / 1000 * timestamp;
 
+    this->position = 0;
     if (seekPosition < sfInfo.frames) {
         sf_seek(sfFile.get(), seekPosition, SEEK_SET);
+        this->position = seekPosition;
     } else {
         g_warning("VorbisProducer: Seeking outside of audio file extent");
     }
@@ -29,24 +33,31 @@ auto VorbisProducer::start(const std::string& filename, unsigned int timestamp)
         size_t numFrames{1};
         size_t const bufferSize{size_t(1024U) * sfInfo.channels};
         std::vector<float> sampleBuffer(bufferSize);
-        auto lock = audioQueue.acquire_lock();
 
         while (!this->stopProducer && numFrames > 0 && !this->audioQueue.hasStreamEnded()) {
             sampleBuffer.resize(bufferSize);
             numFrames = sf_readf_float(sfFile.get(), sampleBuffer.data(), 1024);
+            this->position += static_cast<sf_count_t>(numFrames);
             sampleBuffer.resize(numFrames * sfInfo.channels);
 
-            while (this->audioQueue.size() >= sample_buffer_size && !this->audioQueue.hasStreamEnded() &&
-                   !this->stopProducer) {
-                audioQueue.waitForConsumer(lock);
+            // Keep the queue short, so seeking takes effect quickly
+            while (!this->audioQueue.waitForConsumer(sample_buffer_size - sampleBuffer.size())) {
+                if (this->stopProducer) {
+                    break;
+                }
             }
 
             if (auto tmpSeekSeconds = this->seekSeconds.load(); tmpSeekSeconds != 0) {
-                sf_seek(sfFile.get(), tmpSeekSeconds * sfInfo.samplerate, SEEK_CUR);
+                sf_count_t pos = sf_seek(sfFile.get(), tmpSeekSeconds * sfInfo.samplerate, SEEK_CUR);
                 this->seekSeconds -= tmpSeekSeconds;
+                if (pos >= 0) {
+                    // The buffer was decoded before the seek, continue with the audio at the new position
+                    this->position = pos;
+                    continue;
+                }
             }
 
-            this->audioQueue.emplace(begin(sampleBuffer), end(sampleBuffer));
+            this->audioQueue.push(begin(sampleBuffer), end(sampleBuffer));
         }
         this->audioQueue.signalEndOfStream();
     });
@@ -69,3 +80,14 @@ void VorbisProducer::stop() {
 
 
 void VorbisProducer::seek(int seconds) { this->seekSeconds = seconds; }
+
+auto VorbisProducer::getTimestamp() const -> size_t {
+    auto [sampleRate, channels] = this->audioQueue.getAudioAttributes();
+    if (channels <= 0 || !(sampleRate > 0)) {
+        return 0;
+    }
+
+    auto queued = static_cast<sf_count_t>(this->audioQueue.size() / static_cast<size_t>(channels));
+    sf_count_t frame = std::max<sf_count_t>(this->position - queued, 0);
+    return static_cast<size_t>(static_cast<double>(frame) * 1000 / sampleRate);
+}
@@ -28,10 +28,20 @@ struct VorbisProducer final {
     void stop();
     void seek(int seconds);
 
+    /**
+     * @return The position in milliseconds of the audio the consumer plays next
+     */
+    size_t getTimestamp() const;
+
 private:
     AudioQueue<float>& audioQueue;
     std::thread producerThread{};
 
     std::atomic<bool> stopProducer{false};
     std::atomic<int> seekSeconds{0};
+
+    /**
+     * Frames read from the file, the audio queue holds the last part of it
+     */
+    std::atomic<sf_count_t> position{0};
 };
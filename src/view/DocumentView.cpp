@@ -1,5 +1,8 @@
 #include "DocumentView.h"
 
+#include <algorithm>
+#include <cmath>
+
 #include "background/MainBackgroundPainter.h"
 #include "control/tools/EditSelection.h"
 #include "control/tools/Selection.h"
@@ -7,6 +10,7 @@
 #include "model/eraser/ErasableStroke.h"
 
 #include "StrokeView.h"
+#include "TexRasterCache.h"
 #include "TextView.h"
 
 
@@ -71,11 +75,43 @@ void DocumentView::drawText(cairo_t* cr, Text* t) const {
     cairo_set_matrix(cr, &defaultMatrix);
 }
 
+/**
+ * The size of a rectangle of the user space on the target of cr, in device pixels
+ */
+static void getDeviceSize(cairo_t* cr, double& width, double& height) {
+    cairo_user_to_device_distance(cr, &width, &height);
+    double deviceScaleX = 1;
+    double deviceScaleY = 1;
+    cairo_surface_get_device_scale(cairo_get_target(cr), &deviceScaleX, &deviceScaleY);
+    width = std::abs(width) * deviceScaleX;
+    height = std::abs(height) * deviceScaleY;
+}
+
+/**
+ * Image surfaces get images from their mipmap, selected by the size on the target in device pixels. Other targets,
+ * that is export and print, get the original image with its encoded data.
+ */
+static auto isExportTarget(cairo_t* cr) -> bool {
+    return cairo_surface_get_type(cairo_get_target(cr)) != CAIRO_SURFACE_TYPE_IMAGE;
+}
+
 void DocumentView::drawImage(cairo_t* cr, Image* i) const {
+    cairo_surface_t* img = nullptr;
+    if (isExportTarget(cr)) {
+        img = i->getExportImage();
+    } else {
+        double targetWidth = i->getElementWidth();
+        double targetHeight = i->getElementHeight();
+        getDeviceSize(cr, targetWidth, targetHeight);
+        img = i->getScaledImage(targetWidth, targetHeight);
+    }
+    if (img == nullptr) {
+        return;
+    }
+
     cairo_matrix_t defaultMatrix = {0};
     cairo_get_matrix(cr, &defaultMatrix);
 
-    cairo_surface_t* img = i->getImage();
     int width = cairo_image_surface_get_width(img);
     int height = cairo_image_surface_get_height(img);
 
@@ -95,6 +131,7 @@ void DocumentView::drawImage(cairo_t* cr, Image* i) const {
     }
 
     cairo_set_matrix(cr, &defaultMatrix);
+    cairo_surface_destroy(img);
 }
 
 void DocumentView::drawTexImage(cairo_t* cr, TexImage* texImage) const {
@@ -110,6 +147,28 @@ void DocumentView::drawTexImage(cairo_t* cr, TexImage* texImage) const {
             return;
         }
 
+        // Screen and previews use the cached raster, export and printing render the vectors
+        if (cairo_surface_get_type(cairo_get_target(cr)) == CAIRO_SURFACE_TYPE_IMAGE) {
+            double targetWidth = texImage->getElementWidth();
+            double targetHeight = texImage->getElementHeight();
+            getDeviceSize(cr, targetWidth, targetHeight);
+            cairo_surface_t* raster = TexRasterCache::getInstance().get(texImage, targetWidth, targetHeight);
+            if (raster != nullptr) {
+                cairo_translate(cr, texImage->getX(), texImage->getY());
+                cairo_scale(cr, texImage->getElementWidth() / cairo_image_surface_get_width(raster),
+                            texImage->getElementHeight() / cairo_image_surface_get_height(raster));
+                cairo_set_source_surface(cr, raster, 0, 0);
+                if (this->markAudioStroke) {
+                    cairo_paint_with_alpha(cr, AudioElement::OPACITY_NO_AUDIO);
+                } else {
+                    cairo_paint(cr);
+                }
+                cairo_surface_destroy(raster);
+                cairo_set_matrix(cr, &defaultMatrix);
+                return;
+            }
+        }
+
         PopplerPage* page = poppler_document_get_page(pdf, 0);
 
         double pageWidth = 0;
@@ -186,6 +245,8 @@ void DocumentView::drawLayer(cairo_t* cr, Layer* l) {
     int drawn = 0;
     int notDrawn = 0;
 #endif  // DEBUG_SHOW_REPAINT_BOUNDS
+    // Consecutive strokes which are drawn through a mask, see canShareMask()
+    std::vector<Stroke*> maskedStrokes;
     for (Element* e: l->getElements()) {
 #ifdef DEBUG_SHOW_ELEMENT_BOUNDS
         cairo_set_source_rgb(cr, 0, 1, 0);
@@ -195,50 +256,130 @@ void DocumentView::drawLayer(cairo_t* cr, Layer* l) {
 #endif  // DEBUG_SHOW_REPAINT_BOUNDS
         // cairo_new_path(cr);
 
-        if (this->lX != -1) {
-            if (e->intersectsArea(this->lX, this->lY, this->width, this->height)) {
-                drawElement(cr, e);
+        if (this->lX != -1 && !e->intersectsArea(this->lX, this->lY, this->width, this->height)) {
 #ifdef DEBUG_SHOW_REPAINT_BOUNDS
-                drawn++;
+            notDrawn++;
 #endif  // DEBUG_SHOW_REPAINT_BOUNDS
-            }
+            continue;
+        }
 #ifdef DEBUG_SHOW_REPAINT_BOUNDS
-            else {
-                notDrawn++;
-            }
+        drawn++;
 #endif  // DEBUG_SHOW_REPAINT_BOUNDS
 
-        } else {
-#ifdef DEBUG_SHOW_REPAINT_BOUNDS
-            drawn++;
-#endif  // DEBUG_SHOW_REPAINT_BOUNDS
-            drawElement(cr, e);
+        if (e->getType() == ELEMENT_STROKE) {
+            auto* s = dynamic_cast<Stroke*>(e);
+            if (s->getPointCount() >= 2 && StrokeView(cr, s).usesMask(this->markAudioStroke)) {
+                if (!canShareMask(cr, maskedStrokes, s)) {
+                    drawMaskedStrokes(cr, maskedStrokes);
+                }
+                maskedStrokes.push_back(s);
+                continue;
+            }
         }
+
+        drawMaskedStrokes(cr, maskedStrokes);
+        drawElement(cr, e);
     }
+    drawMaskedStrokes(cr, maskedStrokes);
 
 #ifdef DEBUG_SHOW_REPAINT_BOUNDS
     g_message("DBG:DocumentView: draw %i / not draw %i", drawn, notDrawn);
 #endif  // DEBUG_SHOW_REPAINT_BOUNDS
 }
 
+auto DocumentView::canShareMask(cairo_t* cr, const std::vector<Stroke*>& strokes, Stroke* s) const -> bool {
+    if (strokes.empty()) {
+        return true;
+    }
+    if (strokes.size() >= MAX_SHARED_MASK_STROKES) {
+        return false;
+    }
+
+    // The mask is blitted once, with the color, alpha and operator of the first stroke
+    Stroke* first = strokes.front();
+    if (first->getColor() != s->getColor() ||
+        (first->getToolType() == STROKE_TOOL_HIGHLIGHTER) != (s->getToolType() == STROKE_TOOL_HIGHLIGHTER) ||
+        StrokeView(nullptr, first).getMaskAlpha(this->markAudioStroke) !=
+                StrokeView(nullptr, s).getMaskAlpha(this->markAudioStroke)) {
+        return false;
+    }
+
+    // Overlapping strokes would not be darker where they overlap if painted onto one mask. The margin of one
+    // device pixel keeps the antialiased borders of the strokes apart, also when zoomed out. It is the extent of a
+    // device pixel in user space.
+    double xx = 1;
+    double xy = 0;
+    double yx = 0;
+    double yy = 1;
+    cairo_device_to_user_distance(cr, &xx, &xy);
+    cairo_device_to_user_distance(cr, &yx, &yy);
+    double marginX = std::abs(xx) + std::abs(yx);
+    double marginY = std::abs(xy) + std::abs(yy);
+    Rectangle<double> box = s->boundingRect();
+    box = Rectangle<double>(box.x - marginX, box.y - marginY, box.width + 2 * marginX, box.height + 2 * marginY);
+    return std::none_of(strokes.begin(), strokes.end(),
+                        [&box](Stroke* other) { return other->boundingRect().intersects(box).has_value(); });
+}
+
+void DocumentView::drawMaskedStrokes(cairo_t* cr, std::vector<Stroke*>& strokes) const {
+    if (strokes.size() == 1) {
+        drawStroke(cr, strokes.front());
+    } else if (strokes.size() > 1) {
+        Rectangle<double> box = strokes.front()->boundingRect();
+        for (Stroke* s: strokes) {
+            box.unite(s->boundingRect());
+        }
+
+        // The strokes may be far apart, the mask only covers the part which is drawn
+        double x1 = 0;
+        double y1 = 0;
+        double x2 = 0;
+        double y2 = 0;
+        cairo_clip_extents(cr, &x1, &y1, &x2, &y2);
+        if (auto visible = box.intersects(Rectangle<double>(x1, y1, x2 - x1, y2 - y1))) {
+            cairo_surface_t* surfMask = StrokeView::createMask(cr, *visible);
+            cairo_t* crMask = cairo_create(surfMask);
+            for (Stroke* s: strokes) {
+                StrokeView(cr, s).paintMask(crMask, this->dontRenderEditingStroke);
+            }
+            cairo_destroy(crMask);
+
+            cairo_save(cr);
+            StrokeView(cr, strokes.front()).blitMask(surfMask, this->markAudioStroke);
+            cairo_restore(cr);
+            cairo_surface_destroy(surfMask);
+        }
+    }
+    strokes.clear();
+}
+
 void DocumentView::paintBackgroundImage() {
-    GdkPixbuf* pixbuff = page->getBackgroundImage().getPixbuf();
-    if (pixbuff) {
+    cairo_surface_t* surface = nullptr;
+    if (isExportTarget(cr)) {
+        surface = page->getBackgroundImage().getExportSurface();
+    } else {
+        double targetWidth = page->getWidth();
+        double targetHeight = page->getHeight();
+        getDeviceSize(cr, targetWidth, targetHeight);
+        surface = page->getBackgroundImage().getSurface(targetWidth, targetHeight);
+    }
+    if (surface) {
         cairo_matrix_t matrix = {0};
         cairo_get_matrix(cr, &matrix);
 
-        int width = gdk_pixbuf_get_width(pixbuff);
-        int height = gdk_pixbuf_get_height(pixbuff);
+        int width = cairo_image_surface_get_width(surface);
+        int height = cairo_image_surface_get_height(surface);
 
         double sx = page->getWidth() / width;
         double sy = page->getHeight() / height;
 
         cairo_scale(cr, sx, sy);
 
-        gdk_cairo_set_source_pixbuf(cr, pixbuff, 0, 0);
+        cairo_set_source_surface(cr, surface, 0, 0);
         cairo_paint(cr);
 
         cairo_set_matrix(cr, &matrix);
+        cairo_surface_destroy(surface);
     }
 }
 
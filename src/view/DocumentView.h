@@ -103,6 +103,17 @@ private:
 
     void drawElement(cairo_t* cr, Element* e) const;
 
+    /**
+     * @return Whether the stroke can be painted onto the mask of the given strokes, without changing how the strokes
+     * look. That is if it has the same color and alpha, and does not overlap any of them on the target of cr.
+     */
+    bool canShareMask(cairo_t* cr, const std::vector<Stroke*>& strokes, Stroke* s) const;
+
+    /**
+     * Draw the strokes through one shared mask, instead of one mask per stroke, and clear the list
+     */
+    void drawMaskedStrokes(cairo_t* cr, std::vector<Stroke*>& strokes) const;
+
     void paintBackgroundImage();
 
 private:
@@ -119,4 +130,9 @@ private:
     double lHeight = -1;
 
     MainBackgroundPainter* backgroundPainter;
+
+    /**
+     * Maximum number of strokes sharing one mask, the overlap test is quadratic
+     */
+    static constexpr size_t MAX_SHARED_MASK_STROKES = 64;
 };
@@ -1,5 +1,6 @@
 #include "StrokeView.h"
 
+#include <algorithm>
 #include <cmath>
 
 #include "model/Stroke.h"
@@ -62,60 +63,104 @@ void StrokeView::drawWithPressure() const {
     }
 }
 
-void StrokeView::paint(bool dontRenderEditingStroke, bool markAudioStroke, bool noColor) const {
-
-    cairo_save(cr);
+auto StrokeView::usesMask(bool markAudioStroke, bool noColor) const -> bool {
+    const bool filledHighlighter = s->getToolType() == STROKE_TOOL_HIGHLIGHTER && s->getFill() != -1;
+    const bool drawTranslucent = markAudioStroke && s->getAudioFilename().empty();
+    return (!noColor && filledHighlighter) || drawTranslucent;
+}
 
+auto StrokeView::getMaskAlpha(bool markAudioStroke) const -> uint8_t {
     const bool highlighter = s->getToolType() == STROKE_TOOL_HIGHLIGHTER;
     const bool filledHighlighter = highlighter && s->getFill() != -1;
-    const bool drawTranslucent = markAudioStroke && s->getAudioFilename().empty();
-    const bool useMask = (!noColor && filledHighlighter) || drawTranslucent;
-
-    // The mask will be colorblind
-    noColor = noColor || useMask;
-
-    cairo_surface_t* surfMask = nullptr;
 
-    if (useMask) {
-        /**
-         * To avoid visual glitches when different translucent cairo_stroke are painted,
-         * they are painted without colors to a mask which will in turn be blitted (see below)
-         */
+    /**
+     * Opacity for the mask's content: the base value depends on the tool:
+     * Pen                     : 255
+     * Highlighter (no filling): HIGHLIGHTER_ALPHA
+     * Highlighter (filled)    : s->getFill()
+     */
+    double groupAlpha = highlighter ? static_cast<double>(filledHighlighter ? s->getFill() : HIGHLIGHTER_ALPHA) : 255.0;
 
-        /**
-         * We need to rescale the mask according to the scaling ratio of the target cairo context.
-         * We find out this scaling by looking at the transformation matrix
-         */
-        cairo_matrix_t matrix;
-        cairo_get_matrix(cr, &matrix);
-        // We assume the matrix is an homothety (i.e. only a uniform scaling)
-        assert(matrix.xx == matrix.yy && matrix.xy == 0 && matrix.yx == 0);
+    // If the stroke has no audio attached, we draw it (even more) translucent
+    if (markAudioStroke && s->getAudioFilename().empty()) {
+        groupAlpha *= AudioElement::OPACITY_NO_AUDIO;
+        groupAlpha = std::max(MINIMAL_ALPHA, groupAlpha);
+    }
+    return static_cast<uint8_t>(groupAlpha);
+}
 
-        const double ratio = matrix.xx;
+auto StrokeView::createMask(cairo_t* cr, const Rectangle<double>& box) -> cairo_surface_t* {
+    /**
+     * We need to rescale the mask according to the scaling ratio of the target cairo context.
+     * We find out this scaling by looking at the transformation matrix
+     */
+    cairo_matrix_t matrix;
+    cairo_get_matrix(cr, &matrix);
+    // We assume the matrix is an homothety (i.e. only a uniform scaling)
+    assert(matrix.xx == matrix.yy && matrix.xy == 0 && matrix.yx == 0);
 
-        /**
-         * Create a surface tailored to the stroke's bounding box
-         */
-        Rectangle<double> box = s->boundingRect();
+    const double ratio = matrix.xx;
 
-        const int width = static_cast<int>(std::ceil(box.width * ratio));
-        const int height = static_cast<int>(std::ceil(box.height * ratio));
+    const int width = static_cast<int>(std::ceil(box.width * ratio));
+    const int height = static_cast<int>(std::ceil(box.height * ratio));
 
-        surfMask = cairo_image_surface_create(CAIRO_FORMAT_A8, width, height);
+    cairo_surface_t* surfMask = cairo_image_surface_create(CAIRO_FORMAT_A8, width, height);
 
-        // Apply offset and scaling
-        cairo_surface_set_device_offset(surfMask, -box.x * ratio, -box.y * ratio);
-        cairo_surface_set_device_scale(surfMask, ratio, ratio);
+    // Apply offset and scaling
+    cairo_surface_set_device_offset(surfMask, -box.x * ratio, -box.y * ratio);
+    cairo_surface_set_device_scale(surfMask, ratio, ratio);
 
-        // Get a context to draw on our mask
-        crEffective = cairo_create(surfMask);
+    return surfMask;
+}
 
+void StrokeView::paintMask(cairo_t* crMask, bool dontRenderEditingStroke) const {
 #ifdef DEBUG_SHOW_MASK
-        cairo_set_source_rgba(crEffective, 1, 1, 1, 0.3);
-        cairo_paint(crEffective);
+    cairo_set_source_rgba(crMask, 1, 1, 1, 0.3);
+    cairo_paint(crMask);
 #endif
+
+    crEffective = crMask;
+    drawLines(dontRenderEditingStroke, true, true);
+    crEffective = cr;
+}
+
+void StrokeView::blitMask(cairo_surface_t* surfMask, bool markAudioStroke) const {
+    const bool highlighter = s->getToolType() == STROKE_TOOL_HIGHLIGHTER;
+    cairo_set_operator(cr, highlighter ? CAIRO_OPERATOR_MULTIPLY : CAIRO_OPERATOR_OVER);
+
+    DocumentView::applyColor(cr, s, getMaskAlpha(markAudioStroke));
+
+    cairo_mask_surface(cr, surfMask, 0, 0);
+}
+
+void StrokeView::paint(bool dontRenderEditingStroke, bool markAudioStroke, bool noColor) const {
+    if (usesMask(markAudioStroke, noColor)) {
+        /**
+         * To avoid visual glitches when different translucent cairo_stroke are painted,
+         * they are painted without colors to a mask which will in turn be blitted
+         */
+        cairo_surface_t* surfMask = createMask(cr, s->boundingRect());
+        cairo_t* crMask = cairo_create(surfMask);
+        paintMask(crMask, dontRenderEditingStroke);
+        cairo_destroy(crMask);
+
+        cairo_save(cr);
+        blitMask(surfMask, markAudioStroke);
+        cairo_restore(cr);
+
+        cairo_surface_destroy(surfMask);
+        return;
     }
 
+    cairo_save(cr);
+    drawLines(dontRenderEditingStroke, noColor, false);
+    cairo_restore(cr);
+}
+
+void StrokeView::drawLines(bool dontRenderEditingStroke, bool noColor, bool useMask) const {
+    const bool highlighter = s->getToolType() == STROKE_TOOL_HIGHLIGHTER;
+    const bool filledHighlighter = highlighter && s->getFill() != -1;
+
     cairo_set_line_join(crEffective, CAIRO_LINE_JOIN_ROUND);
     cairo_set_line_cap(crEffective, CAIRO_LINE_CAP_ROUND);
 
@@ -170,38 +215,4 @@ void StrokeView::paint(bool dontRenderEditingStroke, bool markAudioStroke, bool
     } else {
         drawNoPressure();
     }
-
-    if (useMask) {
-        /**
-         * Blit the mask onto the target cairo context.
-         */
-
-        /**
-         * Opacity for the mask's content: the base value depends on the tool:
-         * Pen                     : 255
-         * Highlighter (no filling): HIGHLIGHTER_ALPHA
-         * Highlighter (filled)    : s->getFill()
-         */
-        double groupAlpha =
-                highlighter ? static_cast<double>(filledHighlighter ? s->getFill() : HIGHLIGHTER_ALPHA) : 255.0;
-
-        // If the stroke has no audio attached, we draw it (even more) translucent
-        if (drawTranslucent) {
-            groupAlpha *= AudioElement::OPACITY_NO_AUDIO;
-            groupAlpha = std::max(MINIMAL_ALPHA, groupAlpha);
-        }
-
-        cairo_set_operator(cr, highlighter ? CAIRO_OPERATOR_MULTIPLY : CAIRO_OPERATOR_OVER);
-
-        DocumentView::applyColor(cr, s, (uint8_t)(groupAlpha));
-
-        cairo_mask_surface(cr, surfMask, 0, 0);
-
-        cairo_destroy(crEffective);
-        crEffective = cr;
-        cairo_surface_destroy(surfMask);
-        surfMask = nullptr;
-    }
-
-    cairo_restore(cr);
 }
@@ -15,6 +15,8 @@
 
 #include <gtk/gtk.h>
 
+#include "Rectangle.h"
+
 class Stroke;
 
 class StrokeView {
@@ -32,7 +34,38 @@ public:
      */
     void paint(bool dontRenderEditingStroke, bool markAudioStroke, bool noColor = false) const;
 
+    /**
+     * @return Whether paint() draws the stroke without color onto a mask, which is then blitted in the color of the
+     * stroke. Used for translucent strokes, so the parts where the stroke overlaps itself are not darker.
+     */
+    bool usesMask(bool markAudioStroke, bool noColor = false) const;
+
+    /**
+     * @return The alpha value the mask of the stroke is blitted with
+     */
+    uint8_t getMaskAlpha(bool markAudioStroke) const;
+
+    /**
+     * @brief Create an empty A8 mask for the given area of the user space of cr, in the resolution of cr
+     */
+    static cairo_surface_t* createMask(cairo_t* cr, const Rectangle<double>& box);
+
+    /**
+     * @brief Paint the stroke without color onto a mask created by createMask()
+     */
+    void paintMask(cairo_t* crMask, bool dontRenderEditingStroke) const;
+
+    /**
+     * @brief Blit the mask onto the target context in the color of the stroke
+     */
+    void blitMask(cairo_surface_t* surfMask, bool markAudioStroke) const;
+
 private:
+    /**
+     * Paint the filling and the lines of the stroke onto crEffective
+     */
+    void drawLines(bool dontRenderEditingStroke, bool noColor, bool useMask) const;
+
     inline void pathToCairo() const;
     static void drawErasableStroke(cairo_t* cr, Stroke* s);
 
@@ -0,0 +1,117 @@
+#include "TexRasterCache.h"
+
+#include <cmath>
+#include <iterator>
+
+#include <poppler.h>
+
+#include "model/TexImage.h"
+
+/**
+ * A raster is used for sizes down to 1 / RESCALE_THRESHOLD of its own size, so it is not rendered again for
+ * each step while zooming out. It is never scaled up.
+ */
+constexpr double RESCALE_THRESHOLD = 1.25;
+
+TexRasterCache::TexRasterCache() = default;
+
+TexRasterCache::~TexRasterCache() { clear(); }
+
+auto TexRasterCache::getInstance() -> TexRasterCache& {
+    static TexRasterCache instance;
+    return instance;
+}
+
+auto TexRasterCache::get(const TexImage* texImage, double width, double height) -> cairo_surface_t* {
+    PopplerDocument* pdf = texImage->getPdf();
+    int pixelWidth = static_cast<int>(std::ceil(width));
+    int pixelHeight = static_cast<int>(std::ceil(height));
+    if (pdf == nullptr || pixelWidth <= 0 || pixelHeight <= 0) {
+        return nullptr;
+    }
+    // Formulas zoomed in far are drawn as vectors, so they do not push all others out of the cache
+    if (static_cast<size_t>(pixelWidth) * static_cast<size_t>(pixelHeight) * 4 > MAX_SIZE / 8) {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(this->rasterMutex);
+
+    uint64_t dataId = texImage->getDataId();
+    auto range = this->index.equal_range(dataId);
+    size_t count = 0;
+    for (auto it = range.first; it != range.second; ++it, count++) {
+        auto entry = it->second;
+        int cachedWidth = cairo_image_surface_get_width(entry->surface);
+        int cachedHeight = cairo_image_surface_get_height(entry->surface);
+        if (cachedWidth >= pixelWidth && cachedHeight >= pixelHeight && cachedWidth <= pixelWidth * RESCALE_THRESHOLD &&
+            cachedHeight <= pixelHeight * RESCALE_THRESHOLD) {
+            this->rasters.splice(this->rasters.begin(), this->rasters, entry);
+            return cairo_surface_reference(entry->surface);
+        }
+    }
+
+    if (count >= MAX_RASTERS_PER_IMAGE) {
+        // Replace the least recently used scale of this image
+        for (auto entry = std::prev(this->rasters.end());; --entry) {
+            if (entry->dataId == dataId) {
+                remove(entry);
+                break;
+            }
+        }
+    }
+
+    if (poppler_document_get_n_pages(pdf) < 1) {
+        return nullptr;
+    }
+    PopplerPage* page = poppler_document_get_page(pdf, 0);
+    double pageWidth = 0;
+    double pageHeight = 0;
+    poppler_page_get_size(page, &pageWidth, &pageHeight);
+
+    cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, pixelWidth, pixelHeight);
+    cairo_t* cr = cairo_create(surface);
+    cairo_scale(cr, pixelWidth / pageWidth, pixelHeight / pageHeight);
+    poppler_page_render(page, cr);
+    cairo_destroy(cr);
+    cairo_surface_flush(surface);
+    g_object_unref(page);
+
+    size_t surfaceSize = static_cast<size_t>(cairo_image_surface_get_stride(surface)) * pixelHeight;
+    this->rasters.push_front({dataId, surface, surfaceSize});
+    this->index.emplace(dataId, this->rasters.begin());
+    this->size += surfaceSize;
+
+    while (this->size > MAX_SIZE && this->rasters.size() > 1) {
+        remove(std::prev(this->rasters.end()));
+    }
+
+    return cairo_surface_reference(surface);
+}
+
+void TexRasterCache::remove(std::list<Entry>::iterator entry) {
+    auto range = this->index.equal_range(entry->dataId);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second == entry) {
+            this->index.erase(it);
+            break;
+        }
+    }
+    this->size -= entry->size;
+    cairo_surface_destroy(entry->surface);
+    this->rasters.erase(entry);
+}
+
+auto TexRasterCache::getSize() -> size_t {
+    std::lock_guard<std::mutex> lock(this->rasterMutex);
+    return this->size;
+}
+
+void TexRasterCache::clear() {
+    std::lock_guard<std::mutex> lock(this->rasterMutex);
+    for (Entry& e: this->rasters) {
+        cairo_surface_destroy(e.surface);
+    }
+    this->rasters.clear();
+    this->index.clear();
+    this->size = 0;
+}
@@ -0,0 +1,89 @@
+/*
+ * Xournal++
+ *
+ * Cache for the rasterized TeX images
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+#include <cairo.h>
+
+class TexImage;
+
+/**
+ * The PDF of each TeX image rendered at the scales it is shown with, shared by all threads.
+ * Each image keeps a raster for each of the last few scales, e.g. for the page view and the sidebar previews,
+ * a new one is rendered if no raster is within a few percent of the size. The total size is bounded, the least
+ * recently used rasters are dropped first.
+ *
+ * Only used for image surfaces, PDF export and printing render the PDF as vectors.
+ */
+class TexRasterCache {
+private:
+    TexRasterCache();
+    virtual ~TexRasterCache();
+
+public:
+    static TexRasterCache& getInstance();
+
+    /**
+     * @param width The width of the image on the target in device pixels
+     * @param height The height of the image on the target in device pixels
+     * @return A new reference to the raster, nullptr if the image has no PDF or the raster would be too large
+     *         for the cache
+     */
+    cairo_surface_t* get(const TexImage* texImage, double width, double height);
+
+    /**
+     * @return The size of the pixel data of all cached rasters
+     */
+    size_t getSize();
+
+    void clear();
+
+    /**
+     * Maximum size of the pixel data of all rasters
+     */
+    static constexpr size_t MAX_SIZE = 64 * 1024 * 1024;
+
+    /**
+     * Maximum number of rasters of the same image at different scales
+     */
+    static constexpr size_t MAX_RASTERS_PER_IMAGE = 4;
+
+private:
+    struct Entry {
+        uint64_t dataId;
+        cairo_surface_t* surface;
+        size_t size;
+    };
+
+    /**
+     * Frees a raster and removes it from the list and the index
+     */
+    void remove(std::list<Entry>::iterator entry);
+
+    std::mutex rasterMutex;
+
+    /**
+     * Most recently used rasters first
+     */
+    std::list<Entry> rasters;
+
+    /**
+     * The rasters of each image by its data ID
+     */
+    std::unordered_multimap<uint64_t, std::list<Entry>::iterator> index;
+
+    size_t size = 0;
+};
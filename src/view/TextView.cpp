@@ -1,5 +1,9 @@
 #include "TextView.h"
 
+#include <atomic>
+#include <memory>
+#include <mutex>
+
 #include "control/settings/Settings.h"
 #include "model/Text.h"
 #include "pdf/base/XojPdfPage.h"
@@ -13,10 +17,104 @@ TextView::TextView() = default;
 
 TextView::~TextView() = default;
 
-static int textDpi = 72;
+static std::atomic<int> textDpi{72};
+
+/**
+ * Guards the context of the cached layouts and the caches of the texts, texts are drawn by the render jobs
+ * and the preview jobs while the GUI thread calculates sizes and searches. It is only held to look up and
+ * shape a layout, the layouts are drawn with the mutex of their cache.
+ */
+static std::mutex layoutLock;
+
+/**
+ * Sets the font options of the surface to the context, with metrics and glyph positions neither hinted nor
+ * rounded. Texts are drawn at every zoom level, hinted metrics would only be right at a scale of 1. Glyphs are
+ * still rendered with the hinting of the surface.
+ *
+ * All layouts of texts use these options, so the text editor measures the same size as the cached layouts.
+ */
+static void setLayoutFontOptions(PangoContext* ctx, cairo_surface_t* surface) {
+    cairo_font_options_t* options = cairo_font_options_create();
+    cairo_surface_get_font_options(surface, options);
+    cairo_font_options_set_hint_metrics(options, CAIRO_HINT_METRICS_OFF);
+    pango_cairo_context_set_font_options(ctx, options);
+    cairo_font_options_destroy(options);
+
+#if PANGO_VERSION_CHECK(1, 44, 0)
+    pango_context_set_round_glyph_positions(ctx, false);
+#endif
+}
+
+/**
+ * The context of all cached layouts, with the font options of an image surface. Layouts for other
+ * surfaces (PDF export, printing) are not cached.
+ */
+static auto getLayoutContext(int dpi) -> PangoContext* {
+    static PangoContext* context = [] {
+        // A font map of its own, the default one belongs to the thread which created it
+        PangoFontMap* fontMap = pango_cairo_font_map_new();
+        PangoContext* ctx = pango_font_map_create_context(fontMap);
+        g_object_unref(fontMap);
+
+        cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 1, 1);
+        setLayoutFontOptions(ctx, surface);
+        cairo_surface_destroy(surface);
+        return ctx;
+    }();
+
+    if (pango_cairo_context_get_resolution(context) != dpi) {
+        pango_cairo_context_set_resolution(context, dpi);
+    }
+    return context;
+}
+
+static auto isImageTarget(cairo_t* cr) -> bool {
+    return cairo_surface_get_type(cairo_get_target(cr)) == CAIRO_SURFACE_TYPE_IMAGE;
+}
+
+TextLayoutCache::~TextLayoutCache() {
+    if (this->layout) {
+        std::lock_guard<std::mutex> lock(layoutLock);
+        g_object_unref(this->layout);
+    }
+}
 
 void TextView::setDpi(int dpi) { textDpi = dpi; }
 
+auto TextView::getCachedLayout(const Text* t) -> std::shared_ptr<TextLayoutCache> {
+    std::lock_guard<std::mutex> lock(layoutLock);
+    int dpi = textDpi;
+    PangoContext* context = getLayoutContext(dpi);
+
+    if (!t->layoutCache) {
+        t->layoutCache = std::make_shared<TextLayoutCache>();
+    }
+    std::shared_ptr<TextLayoutCache> cache = t->layoutCache;
+
+    std::lock_guard<std::mutex> cacheLock(cache->mutex);
+    if (cache->layout && cache->dpi == dpi && cache->fontSize == t->getFontSize() && cache->text == t->text &&
+        cache->fontName == t->getFontName()) {
+        return cache;
+    }
+
+    if (cache->layout) {
+        pango_layout_context_changed(cache->layout);
+    } else {
+        cache->layout = pango_layout_new(context);
+    }
+    updatePangoFont(cache->layout, t);
+    pango_layout_set_text(cache->layout, t->text.c_str(), static_cast<int>(t->text.length()));
+
+    // Shape now, the font map of the context must not be used without the layout lock
+    pango_layout_get_size(cache->layout, nullptr, nullptr);
+
+    cache->text = t->text;
+    cache->fontName = t->getFontName();
+    cache->fontSize = t->getFontSize();
+    cache->dpi = dpi;
+    return cache;
+}
+
 auto TextView::initPango(cairo_t* cr, const Text* t) -> PangoLayout* {
     PangoLayout* layout = pango_cairo_create_layout(cr);
 
@@ -24,6 +122,7 @@ auto TextView::initPango(cairo_t* cr, const Text* t) -> PangoLayout* {
     // the next xournal release (with new fileformat...)
     // pango_layout_set_wrap
 
+    setLayoutFontOptions(pango_layout_get_context(layout), cairo_get_target(cr));
     pango_cairo_context_set_resolution(pango_layout_get_context(layout), textDpi);
     pango_cairo_update_layout(cr, layout);
 
@@ -49,25 +148,27 @@ void TextView::drawText(cairo_t* cr, const Text* t) {
 
     cairo_translate(cr, t->getX(), t->getY());
 
-    PangoLayout* layout = initPango(cr, t);
-    string str = t->getText();
-    pango_layout_set_text(layout, str.c_str(), str.length());
+    if (isImageTarget(cr)) {
+        std::shared_ptr<TextLayoutCache> cache = getCachedLayout(t);
+        std::lock_guard<std::mutex> lock(cache->mutex);
+        pango_cairo_show_layout(cr, cache->layout);
+    } else {
+        PangoLayout* layout = initPango(cr, t);
+        string str = t->getText();
+        pango_layout_set_text(layout, str.c_str(), str.length());
 
-    pango_cairo_show_layout(cr, layout);
+        pango_cairo_show_layout(cr, layout);
 
-    g_object_unref(layout);
+        g_object_unref(layout);
+    }
 
     cairo_restore(cr);
 }
 
 auto TextView::findText(const Text* t, string& search) -> std::vector<XojPdfRectangle> {
-    cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 1, 1);
-    cairo_t* cr = cairo_create(surface);
-
-    PangoLayout* layout = initPango(cr, t);
-    string str = t->getText();
-    pango_layout_set_text(layout, str.c_str(), str.length());
-
+    std::shared_ptr<TextLayoutCache> cache = getCachedLayout(t);
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    PangoLayout* layout = cache->layout;
 
     string text = t->getText();
 
@@ -75,9 +176,11 @@ auto TextView::findText(const Text* t, string& search) -> std::vector<XojPdfRect
 
     std::vector<XojPdfRectangle> list;
 
+    string lowerText = StringUtils::toLowerCase(text);
+
     int pos = -1;
     do {
-        pos = StringUtils::toLowerCase(text).find(srch, pos + 1);
+        pos = lowerText.find(srch, pos + 1);
         if (pos != -1) {
             XojPdfRectangle mark;
             PangoRectangle rect = {0};
@@ -93,27 +196,16 @@ auto TextView::findText(const Text* t, string& search) -> std::vector<XojPdfRect
         }
     } while (pos != -1);
 
-    g_object_unref(layout);
-    cairo_surface_destroy(surface);
-    cairo_destroy(cr);
-
     return list;
 }
 
 void TextView::calcSize(const Text* t, double& width, double& height) {
-    cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 1, 1);
-    cairo_t* cr = cairo_create(surface);
+    std::shared_ptr<TextLayoutCache> cache = getCachedLayout(t);
+    std::lock_guard<std::mutex> lock(cache->mutex);
 
-    PangoLayout* layout = initPango(cr, t);
-    string str = t->getText();
-    pango_layout_set_text(layout, str.c_str(), str.length());
     int w = 0;
     int h = 0;
-    pango_layout_get_size(layout, &w, &h);
+    pango_layout_get_size(cache->layout, &w, &h);
     width = (static_cast<double>(w)) / PANGO_SCALE;
     height = (static_cast<double>(h)) / PANGO_SCALE;
-    g_object_unref(layout);
-
-    cairo_surface_destroy(surface);
-    cairo_destroy(cr);
 }
@@ -11,12 +11,44 @@
 
 #pragma once
 
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
 #include <gtk/gtk.h>
 
 #include "pdf/base/XojPdfPage.h"
 
 class Text;
 
+/**
+ * @brief The shaped layout of a Text, kept with the Text so it is only shaped again if it changed
+ */
+struct TextLayoutCache {
+    TextLayoutCache() = default;
+    ~TextLayoutCache();
+
+    TextLayoutCache(const TextLayoutCache&) = delete;
+    TextLayoutCache& operator=(const TextLayoutCache&) = delete;
+
+    PangoLayout* layout = nullptr;
+
+    /**
+     * A layout cannot be used by several threads at once, this guards the layout of this Text only, so
+     * different texts are drawn in parallel
+     */
+    std::mutex mutex;
+
+    /**
+     * What the layout was shaped from
+     */
+    std::string text;
+    std::string fontName;
+    double fontSize = 0;
+    int dpi = 0;
+};
+
 class TextView {
 private:
     TextView();
@@ -41,7 +73,8 @@ public:
     static std::vector<XojPdfRectangle> findText(const Text* t, std::string& search);
 
     /**
-     * Initialize a Pango layout
+     * Initialize a Pango layout, with the same font options as the cached layouts. The text editor uses it, so
+     * its layout has the size calculated by calcSize().
      */
     static PangoLayout* initPango(cairo_t* cr, const Text* t);
 
@@ -49,4 +82,11 @@ public:
      * Sets the font name from Text model
      */
     static void updatePangoFont(PangoLayout* layout, const Text* t);
+
+private:
+    /**
+     * Returns the cache of the Text, with the layout shaped again if the text, the font or the DPI changed.
+     * The mutex of the cache must be held while its layout is used.
+     */
+    static std::shared_ptr<TextLayoutCache> getCachedLayout(const Text* t);
 };
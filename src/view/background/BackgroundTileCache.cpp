@@ -0,0 +1,76 @@
+#include "BackgroundTileCache.h"
+
+/**
+ * Maximum count of cached tiles, tiles are small, but there is one per zoom level
+ */
+constexpr size_t MAX_CACHED_TILES = 64;
+
+auto BackgroundTileKey::operator==(const BackgroundTileKey& other) const -> bool {
+    return name == other.name && tileWidth == other.tileWidth && tileHeight == other.tileHeight &&
+           lineWidth == other.lineWidth && color == other.color && scaleX == other.scaleX && scaleY == other.scaleY &&
+           phaseX == other.phaseX && phaseY == other.phaseY && repeatX == other.repeatX &&
+           repeatY == other.repeatY && pixelWidth == other.pixelWidth && pixelHeight == other.pixelHeight;
+}
+
+BackgroundTileCache::BackgroundTileCache() = default;
+
+BackgroundTileCache::~BackgroundTileCache() { clear(); }
+
+auto BackgroundTileCache::getInstance() -> BackgroundTileCache& {
+    static BackgroundTileCache instance;
+    return instance;
+}
+
+auto BackgroundTileCache::get(const BackgroundTileKey& key, const std::function<void(cairo_t*)>& drawTile)
+        -> cairo_surface_t* {
+    std::lock_guard<std::mutex> lock(this->tileMutex);
+
+    for (auto it = this->tiles.begin(); it != this->tiles.end(); ++it) {
+        if (it->key == key) {
+            this->tiles.splice(this->tiles.begin(), this->tiles, it);
+            return cairo_surface_reference(it->surface);
+        }
+    }
+
+    cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, key.pixelWidth, key.pixelHeight);
+    cairo_t* cr = cairo_create(surface);
+    cairo_translate(cr, key.phaseX, key.phaseY);
+    cairo_scale(cr, key.scaleX, key.scaleY);
+
+    // Lines which run through the tile end at its border, where the neighbouring tile continues them. The coverage
+    // of both parts in the border pixel adds up to the coverage of the whole line.
+    cairo_set_operator(cr, CAIRO_OPERATOR_ADD);
+    int rangeX = key.repeatX ? 1 : 0;
+    int rangeY = key.repeatY ? 1 : 0;
+    for (int i = -rangeX; i <= rangeX; i++) {
+        for (int j = -rangeY; j <= rangeY; j++) {
+            cairo_save(cr);
+            cairo_translate(cr, i * key.tileWidth, j * key.tileHeight);
+            drawTile(cr);
+            cairo_restore(cr);
+        }
+    }
+    cairo_destroy(cr);
+    cairo_surface_flush(surface);
+
+    this->tiles.push_front({key, surface});
+    if (this->tiles.size() > MAX_CACHED_TILES) {
+        cairo_surface_destroy(this->tiles.back().surface);
+        this->tiles.pop_back();
+    }
+
+    return cairo_surface_reference(surface);
+}
+
+auto BackgroundTileCache::getTileCount() -> size_t {
+    std::lock_guard<std::mutex> lock(this->tileMutex);
+    return this->tiles.size();
+}
+
+void BackgroundTileCache::clear() {
+    std::lock_guard<std::mutex> lock(this->tileMutex);
+    for (Entry& e: this->tiles) {
+        cairo_surface_destroy(e.surface);
+    }
+    this->tiles.clear();
+}
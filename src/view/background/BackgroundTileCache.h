@@ -0,0 +1,96 @@
+/*
+ * Xournal++
+ *
+ * Cache for the repeating tiles of patterned backgrounds
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string>
+
+#include <cairo.h>
+
+#include "util/Color.h"
+
+/**
+ * Identifies a tile: the painter specific geometry (name and size) and everything that changes its pixels
+ */
+struct BackgroundTileKey {
+    std::string name;
+    double tileWidth;
+    double tileHeight;
+    double lineWidth;
+    Color color;
+
+    /**
+     * Device pixels per page unit
+     */
+    double scaleX;
+    double scaleY;
+
+    /**
+     * Position of the tile origin in the first pixel, so the tile pixels are aligned with the device pixels
+     */
+    double phaseX;
+    double phaseY;
+
+    /**
+     * Whether the tile repeats in this direction. The contents of the neighbouring tiles which reach into a
+     * repeated tile are drawn as well.
+     */
+    bool repeatX;
+    bool repeatY;
+
+    int pixelWidth;
+    int pixelHeight;
+
+    bool operator==(const BackgroundTileKey& other) const;
+};
+
+/**
+ * Rendered background tiles, shared by all background painters and threads.
+ * The number of tiles is bounded, the least recently used tile is dropped first.
+ */
+class BackgroundTileCache {
+private:
+    BackgroundTileCache();
+    virtual ~BackgroundTileCache();
+
+public:
+    static BackgroundTileCache& getInstance();
+
+    /**
+     * @return A new reference to the tile surface, rendered with drawTile if it is not cached yet.
+     *         drawTile gets a context scaled from tile (page) coordinates to tile pixels.
+     */
+    cairo_surface_t* get(const BackgroundTileKey& key, const std::function<void(cairo_t*)>& drawTile);
+
+    void clear();
+
+    /**
+     * @return The number of cached tiles
+     */
+    size_t getTileCount();
+
+private:
+    struct Entry {
+        BackgroundTileKey key;
+        cairo_surface_t* surface;
+    };
+
+    std::mutex tileMutex;
+
+    /**
+     * Most recently used tiles first
+     */
+    std::list<Entry> tiles;
+};
@@ -1,7 +1,81 @@
 #include "BaseBackgroundPainter.h"
 
+#include <cmath>
+
+#include "BackgroundTileCache.h"
 #include "Util.h"
 
+/**
+ * Larger tiles are not worth caching, the lines are painted directly
+ */
+constexpr int MAX_TILE_PIXELS = 4096;
+
+/**
+ * Maximum difference of the tile period from a whole number of pixels, so the tiles of a page do not drift apart
+ * from the directly painted lines by a visible fraction of a pixel
+ */
+constexpr double MAX_PERIOD_ERROR = 1e-6;
+
+/**
+ * Resolution of the tile position within a pixel, cairo rounds coordinates to 1/256 of a pixel as well
+ */
+constexpr double PHASE_STEPS = 256;
+
+namespace {
+/**
+ * The tiles along one axis, in device pixels
+ */
+struct TileAxis {
+    double scale;
+    int pixels;
+
+    /**
+     * The device pixel where the first tile pixel is drawn, and the position of the tile origin within that pixel
+     */
+    double start;
+    double phase;
+    bool repeat;
+};
+
+/**
+ * @param scale Device pixels per page unit
+ * @param offset Device position of the page origin
+ * @param origin Page position of a tile origin
+ * @param fillStart Page position of the filled range
+ * @param fillSize Size of the filled range
+ * @return false if the tiles cannot be aligned with the device pixels, which is the case for repeated tiles whose
+ *         size is not a whole number of pixels
+ */
+auto placeTiles(double scale, double offset, double tileSize, double origin, double fillStart, double fillSize,
+                TileAxis& axis) -> bool {
+    axis.scale = scale;
+    double period = tileSize * scale;
+
+    // The tile which contains the start of the filled range
+    origin += std::floor((fillStart - origin) / tileSize) * tileSize;
+    axis.repeat = fillStart + fillSize > origin + tileSize * (1 + MAX_PERIOD_ERROR);
+    if (axis.repeat) {
+        if (std::abs(period - std::round(period)) > MAX_PERIOD_ERROR) {
+            return false;
+        }
+        axis.pixels = static_cast<int>(std::round(period));
+    }
+
+    double position = origin * scale + offset;
+    axis.start = std::floor(position);
+    axis.phase = std::round((position - axis.start) * PHASE_STEPS) / PHASE_STEPS;
+    if (axis.phase >= 1) {
+        axis.start += 1;
+        axis.phase = 0;
+    }
+    if (!axis.repeat) {
+        // One more pixel, which stays empty, for the border pixels of the filled range
+        axis.pixels = static_cast<int>(std::ceil(axis.phase + period)) + 1;
+    }
+    return axis.pixels > 0 && axis.pixels <= MAX_TILE_PIXELS;
+}
+}  // namespace
+
 BaseBackgroundPainter::BaseBackgroundPainter() { resetConfig(); }
 
 BaseBackgroundPainter::~BaseBackgroundPainter() = default;
@@ -81,3 +155,69 @@ void BaseBackgroundPainter::paintBackgroundColor() {
     cairo_rectangle(cr, 0, 0, width, height);
     cairo_fill(cr);
 }
+
+auto BaseBackgroundPainter::fillWithTile(const std::string& name, Color color, double tileWidth, double tileHeight,
+                                         double originX, double originY, double x, double y, double w, double h,
+                                         const std::function<void(cairo_t*)>& drawTile) -> bool {
+    cairo_surface_t* target = cairo_get_group_target(cr);
+    switch (cairo_surface_get_type(target)) {
+        case CAIRO_SURFACE_TYPE_PDF:
+        case CAIRO_SURFACE_TYPE_PS:
+        case CAIRO_SURFACE_TYPE_SVG:
+        case CAIRO_SURFACE_TYPE_RECORDING:
+        case CAIRO_SURFACE_TYPE_SCRIPT:
+            // Keep the vector paths for export and printing
+            return false;
+        default:
+            break;
+    }
+
+    cairo_matrix_t matrix;
+    cairo_get_matrix(cr, &matrix);
+    if (matrix.xy != 0 || matrix.yx != 0 || matrix.xx <= 0 || matrix.yy <= 0) {
+        return false;
+    }
+
+    double deviceScaleX = 1;
+    double deviceScaleY = 1;
+    cairo_surface_get_device_scale(target, &deviceScaleX, &deviceScaleY);
+    double deviceOffsetX = 0;
+    double deviceOffsetY = 0;
+    cairo_surface_get_device_offset(target, &deviceOffsetX, &deviceOffsetY);
+
+    // The tile pixels are copied to the device pixels without resampling, so the result equals the direct painting
+    double offsetX = matrix.x0 * deviceScaleX + deviceOffsetX;
+    double offsetY = matrix.y0 * deviceScaleY + deviceOffsetY;
+    TileAxis axisX{};
+    TileAxis axisY{};
+    if (!placeTiles(matrix.xx * deviceScaleX, offsetX, tileWidth, originX, x, w, axisX) ||
+        !placeTiles(matrix.yy * deviceScaleY, offsetY, tileHeight, originY, y, h, axisY)) {
+        return false;
+    }
+
+    BackgroundTileKey key{name,         tileWidth,    tileHeight,   lineWidth * lineWidthFactor,
+                          color,        axisX.scale,  axisY.scale,  axisX.phase,
+                          axisY.phase,  axisX.repeat, axisY.repeat, axisX.pixels,
+                          axisY.pixels};
+    cairo_surface_t* tile = BackgroundTileCache::getInstance().get(key, drawTile);
+
+    cairo_pattern_t* pattern = cairo_pattern_create_for_surface(tile);
+    cairo_pattern_set_extend(pattern, CAIRO_EXTEND_REPEAT);
+    cairo_pattern_set_filter(pattern, CAIRO_FILTER_NEAREST);
+
+    // Maps the page to the tile pixels, shifted by whole device pixels
+    cairo_matrix_t patternMatrix;
+    cairo_matrix_init(&patternMatrix, axisX.scale, 0, 0, axisY.scale, offsetX - axisX.start, offsetY - axisY.start);
+    cairo_pattern_set_matrix(pattern, &patternMatrix);
+
+    cairo_save(cr);
+    cairo_set_source(cr, pattern);
+    cairo_rectangle(cr, x, y, w, h);
+    cairo_fill(cr);
+    cairo_restore(cr);
+
+    cairo_pattern_destroy(pattern);
+    cairo_surface_destroy(tile);
+
+    return true;
+}
@@ -11,6 +11,9 @@
 
 #pragma once
 
+#include <functional>
+#include <string>
+
 #include <gtk/gtk.h>
 
 #include "model/PageRef.h"
@@ -64,6 +67,28 @@ protected:
      */
     Color getForegroundColor2() const;
 
+    /**
+     * Fills the rectangle (x, y, w, h) with a repeating tile, instead of painting every line or dot of the page.
+     * The tile is rendered once per name, size, line width, color and device scale and shared by all pages.
+     *
+     * The tile pixels are aligned with the device pixels, so the result equals painting the lines directly. The
+     * borders of the rectangle need to be between the contents of the tiles, or where the lines end.
+     *
+     * @param name Identifies the painter specific contents of the tile
+     * @param tileWidth Width of the tile in page coordinates
+     * @param tileHeight Height of the tile in page coordinates
+     * @param originX Page position of the left border of a tile
+     * @param originY Page position of the top border of a tile
+     * @param drawTile Draws the tile contents, in page coordinates relative to the tile origin
+     *
+     * @return false if nothing was painted, because the target is a vector surface (PDF export, printing), the
+     *         transformation does not allow tiling or the tile size is not a whole number of device pixels. The
+     *         caller paints the lines directly in this case.
+     */
+    bool fillWithTile(const std::string& name, Color color, double tileWidth, double tileHeight, double originX,
+                      double originY, double x, double y, double w, double h,
+                      const std::function<void(cairo_t*)>& drawTile);
+
 private:
 protected:
     BackgroundConfig* config = nullptr;
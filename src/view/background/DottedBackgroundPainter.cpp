@@ -1,5 +1,7 @@
 #include "DottedBackgroundPainter.h"
 
+#include <cmath>
+
 #include "Util.h"
 
 DottedBackgroundPainter::DottedBackgroundPainter() = default;
@@ -19,6 +21,31 @@ void DottedBackgroundPainter::paint() {
 }
 
 void DottedBackgroundPainter::paintBackgroundDotted() {
+    double lw = lineWidth * lineWidthFactor;
+    auto pos = [dr1 = drawRaster1](int i) { return dr1 + i * dr1; };
+
+    if (lw < drawRaster1 && pos(0) < width && pos(0) < height) {
+        // One dot in the middle of a raster cell
+        auto drawDot = [this, lw, dr1 = drawRaster1](cairo_t* tileCr) {
+            Util::cairo_set_source_rgbi(tileCr, this->foregroundColor1);
+            cairo_set_line_width(tileCr, lw);
+            cairo_set_line_cap(tileCr, CAIRO_LINE_CAP_ROUND);
+            cairo_move_to(tileCr, dr1 / 2, dr1 / 2);
+            cairo_line_to(tileCr, dr1 / 2, dr1 / 2);
+            cairo_stroke(tileCr);
+        };
+
+        double lastX = pos(static_cast<int>(std::ceil(width / drawRaster1)) - 2);
+        double lastY = pos(static_cast<int>(std::ceil(height / drawRaster1)) - 2);
+
+        double start = pos(0) - drawRaster1 / 2;
+        if (fillWithTile("dotted", this->foregroundColor1, drawRaster1, drawRaster1, drawRaster1 / 2,
+                         drawRaster1 / 2, start, start, lastX - pos(0) + drawRaster1, lastY - pos(0) + drawRaster1,
+                         drawDot)) {
+            return;
+        }
+    }
+
     Util::cairo_set_source_rgbi(cr, this->foregroundColor1);
 
     cairo_set_line_width(cr, lineWidth * lineWidthFactor);
@@ -44,6 +44,10 @@ void GraphBackgroundPainter::paintBackgroundGraph() {
 
     auto pos = [dr1 = drawRaster1](int i) { return dr1 + i * dr1; };
 
+    if (paintBackgroundGraphTiled(marginTopBottom, marginLeftRight, snappingOffset)) {
+        return;
+    }
+
     for (int x = 0; pos(x) < width; ++x) {
         if (pos(x) < margin1 || pos(x) > (width - margin1)) {
             continue;
@@ -63,3 +67,59 @@ void GraphBackgroundPainter::paintBackgroundGraph() {
 
     cairo_stroke(cr);
 }
+
+auto GraphBackgroundPainter::paintBackgroundGraphTiled(double marginTopBottom, double marginLeftRight,
+                                                       double snappingOffset) -> bool {
+    double lw = lineWidth * lineWidthFactor;
+    if (lw >= drawRaster1) {
+        return false;
+    }
+
+    auto pos = [dr1 = drawRaster1](int i) { return dr1 + i * dr1; };
+
+    // Range of the lines, same conditions as the loops in paintBackgroundGraph
+    int firstCol = 0;
+    while (pos(firstCol) < width && pos(firstCol) < margin1) { firstCol++; }
+    int lastCol = firstCol - 1;
+    while (pos(lastCol + 1) < width && pos(lastCol + 1) <= width - margin1) { lastCol++; }
+
+    int firstRow = 0;
+    while (pos(firstRow) < height && pos(firstRow) < margin1) { firstRow++; }
+    int lastRow = firstRow - 1;
+    while (pos(lastRow + 1) < height && pos(lastRow + 1) <= height - marginTopBottom) { lastRow++; }
+
+    double dr1 = drawRaster1;
+    Color color = this->foregroundColor1;
+
+    // Vertical lines cover the whole tile height, so the tiles connect seamlessly
+    auto drawVertical = [lw, dr1, color](cairo_t* tileCr) {
+        Util::cairo_set_source_rgbi(tileCr, color);
+        cairo_set_line_width(tileCr, lw);
+        cairo_move_to(tileCr, dr1 / 2, 0);
+        cairo_line_to(tileCr, dr1 / 2, dr1);
+        cairo_stroke(tileCr);
+    };
+    auto drawHorizontal = [lw, dr1, color](cairo_t* tileCr) {
+        Util::cairo_set_source_rgbi(tileCr, color);
+        cairo_set_line_width(tileCr, lw);
+        cairo_move_to(tileCr, 0, dr1 / 2);
+        cairo_line_to(tileCr, dr1, dr1 / 2);
+        cairo_stroke(tileCr);
+    };
+
+    bool painted = true;
+    if (lastCol >= firstCol) {
+        double y0 = marginTopBottom - snappingOffset;
+        double y1 = height - marginTopBottom - snappingOffset;
+        painted = fillWithTile("graph-vertical", color, dr1, dr1, dr1 / 2, 0, pos(firstCol) - dr1 / 2, y0,
+                               pos(lastCol) - pos(firstCol) + dr1, y1 - y0, drawVertical);
+    }
+    if (painted && lastRow >= firstRow) {
+        painted = fillWithTile("graph-horizontal", color, dr1, dr1, 0, dr1 / 2, marginLeftRight,
+                               pos(firstRow) - dr1 / 2, width - 2 * marginLeftRight,
+                               pos(lastRow) - pos(firstRow) + dr1, drawHorizontal);
+    }
+
+    // The target is the same for both calls, either both or none are painted
+    return painted;
+}
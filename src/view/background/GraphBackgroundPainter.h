@@ -30,4 +30,11 @@ public:
      * Reset all used configuration values
      */
     virtual void resetConfig();
+
+private:
+    /**
+     * Paints the grid with cached tiles
+     * @return false if the grid needs to be painted directly
+     */
+    bool paintBackgroundGraphTiled(double marginTopBottom, double marginLeftRight, double snappingOffset);
 };
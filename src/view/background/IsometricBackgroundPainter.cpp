@@ -130,6 +130,30 @@ void IsometricBackgroundPainter::paint() {
         };
         paintBackgroundGraph(cols, rows, xstep, ystep, drawLine);
     } else {
+        // The dot grid repeats every two columns and two rows. Shifted by half a step, both dots of a tile are
+        // inside of it. The last row is only filled in odd columns (see paintBackgroundDotted), an even row count
+        // therefore ends with the last full row.
+        const auto lw = lineWidth * lineWidthFactor;
+        if (cols > 0 && rows > 0 && lw < ystep) {
+            auto drawTile = [&](cairo_t* tileCr) {
+                Util::cairo_set_source_rgbi(tileCr, this->foregroundColor1);
+                cairo_set_line_width(tileCr, lw);
+                cairo_set_line_cap(tileCr, CAIRO_LINE_CAP_ROUND);
+                cairo_move_to(tileCr, xstep / 2, 3 * ystep / 2);
+                cairo_line_to(tileCr, xstep / 2, 3 * ystep / 2);
+                cairo_move_to(tileCr, 3 * xstep / 2, ystep / 2);
+                cairo_line_to(tileCr, 3 * xstep / 2, ystep / 2);
+                cairo_stroke(tileCr);
+            };
+
+            const auto lastY = (rows - rows % 2) * ystep;
+            if (fillWithTile("isodotted", this->foregroundColor1, 2 * xstep, 2 * ystep, contentXOffset - xstep / 2,
+                             contentYOffset - ystep / 2, contentXOffset - xstep / 2, contentYOffset - ystep / 2,
+                             contentWidth + xstep, lastY + ystep, drawTile)) {
+                return;
+            }
+        }
+
         auto drawDot = [&](double x, double y) {
             cairo_move_to(cr, contentXOffset + x, contentYOffset + y);
             cairo_line_to(cr, contentXOffset + x, contentYOffset + y);
@@ -30,10 +30,27 @@ const double footerSize = 20;
 const double rulingSize = 24;
 
 void LineBackgroundPainter::paintBackgroundRuled() {
-    Util::cairo_set_source_rgbi(cr, this->foregroundColor1);
-    cairo_set_line_width(cr, lineWidth * lineWidthFactor);
+    double lw = lineWidth * lineWidthFactor;
+    int numLines = static_cast<int>((height - headerSize - footerSize) / (rulingSize + lw));
+
+    if (numLines > 0 && lw < rulingSize) {
+        // The line covers the whole tile width, so the tiles connect seamlessly
+        auto drawLine = [lw, color = this->foregroundColor1](cairo_t* tileCr) {
+            Util::cairo_set_source_rgbi(tileCr, color);
+            cairo_set_line_width(tileCr, lw);
+            cairo_move_to(tileCr, 0, rulingSize / 2);
+            cairo_line_to(tileCr, rulingSize, rulingSize / 2);
+            cairo_stroke(tileCr);
+        };
+
+        if (fillWithTile("ruled", this->foregroundColor1, rulingSize, rulingSize, 0, headerSize - rulingSize / 2, 0,
+                         headerSize - rulingSize / 2, width, numLines * rulingSize, drawLine)) {
+            return;
+        }
+    }
 
-    int numLines = static_cast<int>((height - headerSize - footerSize) / (rulingSize + lineWidth * lineWidthFactor));
+    Util::cairo_set_source_rgbi(cr, this->foregroundColor1);
+    cairo_set_line_width(cr, lw);
 
     double offset = headerSize;
 
@@ -22,12 +22,29 @@ void StavesBackgroundPainter::paint() {
 
     int numStaves = static_cast<int>((height - headerSize - footerSize + lineDistance) / (lineSize));
 
+    if (numStaves > 0 && paintBackgroundStavesTiled(numStaves, lineSize)) {
+        return;
+    }
+
     for (int line = 0; line < numStaves; line++) {
         paintBackgroundStaves(offset);
         offset += lineSize;
     }
 }
 
+auto StavesBackgroundPainter::paintBackgroundStavesTiled(int numStaves, double lineSize) -> bool {
+    // A tile is a full width strip with one stave in its middle, so it ends between two staves
+    double top = (lineSize - 4 * staveDistance) / 2;
+    auto drawStave = [this, top](cairo_t* tileCr) {
+        cairo_t* pageCr = this->cr;
+        this->cr = tileCr;
+        paintBackgroundStaves(top);
+        this->cr = pageCr;
+    };
+
+    return fillWithTile("staves", this->foregroundColor1, width, lineSize, 0, headerSize - top, 0, headerSize - top,
+                        width, numStaves * lineSize, drawStave);
+}
 
 void StavesBackgroundPainter::paintBackgroundStaves(double offset) {
     Util::cairo_set_source_rgbi(cr, this->foregroundColor1);
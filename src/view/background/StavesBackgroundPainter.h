@@ -33,6 +33,12 @@ public:
 
     void paintBackgroundStaves(double offset);
 
+    /**
+     * Paints the staves with a cached tile
+     * @return false if the staves need to be painted directly
+     */
+    bool paintBackgroundStavesTiled(int numStaves, double lineSize);
+
 private:
     const double headerSize = 80;
     const double footerSize = 20;
@@ -0,0 +1,34 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <gtest/gtest.h>
+
+#include "control/xojfile/DocumentGenerator.h"
+#include "model/Document.h"
+#include "model/DocumentHandler.h"
+#include "model/Layer.h"
+#include "model/Stroke.h"
+
+TEST(ControlDocumentGenerator, testSameDocumentEverywhere) {
+    DocumentHandler handler;
+    Document doc(&handler);
+    DocumentGeneratorOptions options;
+    options.seed = 1;
+    DocumentGenerator generator(options);
+    ASSERT_TRUE(generator.generate(&doc));
+
+    // Computed from the std::mt19937 output, which is the same with every standard library
+    auto* stroke = dynamic_cast<Stroke*>((*doc.getPage(0)->getLayers())[0]->getElements().front());
+    ASSERT_NE(nullptr, stroke);
+    EXPECT_EQ(STROKE_TOOL_PEN, stroke->getToolType());
+    EXPECT_EQ(181, stroke->getPointCount());
+    EXPECT_DOUBLE_EQ(59.5684098221943, stroke->getPoint(0).x);
+}
@@ -0,0 +1,73 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <chrono>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "control/latex/LatexCache.h"
+#include "util/PathUtil.h"
+
+#include "filesystem.h"
+
+namespace {
+auto createCacheFolder(const std::string& name) -> fs::path {
+    auto folder = Util::getTmpDirSubfolder() / name;
+    fs::remove_all(folder);
+    fs::create_directories(folder);
+    return folder;
+}
+}  // namespace
+
+TEST(ControlLatexCache, testKey) {
+    std::string key = LatexCache::computeKey("pdflatex {}", "x^2");
+    EXPECT_EQ(key, LatexCache::computeKey("pdflatex {}", "x^2"));
+    EXPECT_NE(key, LatexCache::computeKey("pdflatex {}", "x^3"));
+    EXPECT_NE(key, LatexCache::computeKey("lualatex {}", "x^2"));
+    // The parts are separated
+    EXPECT_NE(LatexCache::computeKey("ab", "c"), LatexCache::computeKey("a", "bc"));
+}
+
+TEST(ControlLatexCache, testStoreAndLoad) {
+    LatexCache cache(createCacheFolder("latex-cache-test"));
+    std::string key = LatexCache::computeKey("pdflatex", "x^2");
+    EXPECT_FALSE(cache.load(key));
+
+    std::string pdf("%PDF-1.5\0binary", 15);
+    ASSERT_TRUE(cache.store(key, pdf));
+    auto loaded = cache.load(key);
+    ASSERT_TRUE(loaded);
+    EXPECT_EQ(pdf, *loaded);
+}
+
+TEST(ControlLatexCache, testPruneKeepsRecentlyUsed) {
+    auto folder = createCacheFolder("latex-cache-prune-test");
+    LatexCache cache(folder);
+    std::string pdf(100, 'x');
+    ASSERT_TRUE(cache.store("old", pdf));
+    ASSERT_TRUE(cache.store("used", pdf));
+    ASSERT_TRUE(cache.store("new", pdf));
+
+    // Make the order independent of the file system time resolution
+    auto now = fs::file_time_type::clock::now();
+    fs::last_write_time(folder / "old.pdf", now - std::chrono::hours(3));
+    fs::last_write_time(folder / "used.pdf", now - std::chrono::hours(2));
+    fs::last_write_time(folder / "new.pdf", now - std::chrono::hours(1));
+
+    // Loading marks the entry as used
+    EXPECT_TRUE(cache.load("used"));
+
+    cache.prune(250);
+    EXPECT_FALSE(cache.load("old"));
+    EXPECT_TRUE(cache.load("used"));
+    EXPECT_TRUE(cache.load("new"));
+}
@@ -0,0 +1,68 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+#include "control/MemoryReport.h"
+#include "control/xojfile/DocumentGenerator.h"
+#include "model/Document.h"
+#include "model/DocumentHandler.h"
+#include "model/Stroke.h"
+
+TEST(ControlMemoryReport, testStrokeFootprintGrowsWithPoints) {
+    Stroke stroke;
+    size_t empty = stroke.getMemoryFootprint();
+    for (int i = 0; i < 1000; i++) { stroke.addPoint(Point(i, i)); }
+    EXPECT_GE(stroke.getMemoryFootprint(), empty + 1000 * sizeof(Point));
+}
+
+TEST(ControlMemoryReport, testDocumentPerPageAndCategory) {
+    DocumentHandler handler;
+    Document doc(&handler);
+
+    DocumentGeneratorOptions options;
+    options.pages = 3;
+    options.strokesPerLayer = 50;
+    options.textsPerPage = 2;
+    DocumentGenerator generator(options);
+    ASSERT_TRUE(generator.generate(&doc));
+
+    MemoryReport report;
+    report.addDocument(&doc);
+    ASSERT_EQ(3U, report.getPageCount());
+
+    size_t pageSum = 0;
+    for (size_t p = 0; p < report.getPageCount(); p++) {
+        EXPECT_GT(report.getPageUsage(p, MemoryCategory::Strokes), 50 * options.minPoints * sizeof(Point));
+        EXPECT_GT(report.getPageUsage(p, MemoryCategory::Texts), 0U);
+        EXPECT_EQ(0U, report.getPageUsage(p, MemoryCategory::Images));
+        pageSum += report.getPageTotal(p);
+    }
+    EXPECT_EQ(report.getTotal(), pageSum);
+    EXPECT_EQ(report.getTotal(), report.getTotal(MemoryCategory::Strokes) + report.getTotal(MemoryCategory::Texts));
+
+    // Memory which does not belong to a page only shows up in the totals
+    report.add(MemoryCategory::Undo, 1000);
+    EXPECT_EQ(pageSum + 1000, report.getTotal());
+    EXPECT_EQ(pageSum, report.getPageTotal(0) + report.getPageTotal(1) + report.getPageTotal(2));
+
+    std::ostringstream json;
+    report.writeJson(json);
+    EXPECT_NE(std::string::npos, json.str().find("\"undo\": 1000"));
+}
+
+TEST(ControlMemoryReport, testFormatSize) {
+    EXPECT_EQ("512 B", MemoryReport::formatSize(512));
+    EXPECT_EQ("1.5 KiB", MemoryReport::formatSize(1536));
+    EXPECT_EQ("3.0 MiB", MemoryReport::formatSize(3 * 1024 * 1024));
+}
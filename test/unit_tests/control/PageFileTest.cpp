@@ -0,0 +1,216 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include <config-test.h>
+#include <gtest/gtest.h>
+
+#include "control/xojfile/DocumentGenerator.h"
+#include "control/xojfile/LoadHandler.h"
+#include "control/xojfile/PageFileFormat.h"
+#include "control/xojfile/PageFileReader.h"
+#include "control/xojfile/PageFileWriter.h"
+#include "control/xojfile/SaveHandler.h"
+#include "model/Document.h"
+#include "model/DocumentHandler.h"
+#include "model/Layer.h"
+#include "model/Stroke.h"
+#include "util/PathUtil.h"
+
+#include "filesystem.h"
+
+namespace {
+auto countElements(Document* doc) -> size_t {
+    size_t count = 0;
+    for (size_t p = 0; p < doc->getPageCount(); p++) {
+        for (Layer* l: *doc->getPage(p)->getLayers()) {
+            count += l->getElements().size();
+        }
+    }
+    return count;
+}
+}  // namespace
+
+TEST(ControlPageFile, testLayersAreReadOnAccess) {
+    DocumentHandler handler;
+    Document doc(&handler);
+
+    DocumentGeneratorOptions options;
+    options.pages = 50;
+    options.strokesPerLayer = 20;
+    options.pressure = true;
+    DocumentGenerator generator(options);
+    ASSERT_TRUE(generator.generate(&doc));
+
+    auto path = Util::getTmpDirSubfolder() / "pages.xopb";
+    PageFileWriter writer;
+    ASSERT_TRUE(writer.save(&doc, path)) << writer.getErrorMessage();
+
+    PageFileReader reader;
+    Document* loaded = reader.loadDocument(path);
+    ASSERT_NE(nullptr, loaded) << reader.getLastError();
+    ASSERT_EQ(doc.getPageCount(), loaded->getPageCount());
+
+    Layer* layer = (*loaded->getPage(49)->getLayers())[0];
+    EXPECT_FALSE(layer->isLoaded());
+    EXPECT_TRUE(layer->isAnnotated());
+
+    Layer* original = (*doc.getPage(49)->getLayers())[0];
+    ASSERT_EQ(original->getElements().size(), layer->getElements().size());
+    EXPECT_TRUE(layer->isLoaded());
+
+    auto* s1 = dynamic_cast<Stroke*>(original->getElements()[0]);
+    auto* s2 = dynamic_cast<Stroke*>(layer->getElements()[0]);
+    ASSERT_NE(nullptr, s2);
+    ASSERT_EQ(s1->getPointCount(), s2->getPointCount());
+    for (int i = 0; i < s1->getPointCount(); i++) {
+        EXPECT_EQ(s1->getPoint(i).x, s2->getPoint(i).x);
+        EXPECT_EQ(s1->getPoint(i).y, s2->getPoint(i).y);
+        EXPECT_EQ(s1->getPoint(i).z, s2->getPoint(i).z);
+    }
+
+    // Pages which were not accessed are still in the file
+    EXPECT_FALSE((*loaded->getPage(0)->getLayers())[0]->isLoaded());
+}
+
+TEST(ControlPageFile, testConvertFromAndToXopp) {
+    LoadHandler loadHandler;
+    Document* xopp = loadHandler.loadDocument(GET_TESTFILE("packaged_xopp/suite.xopp"));
+    ASSERT_NE(nullptr, xopp) << loadHandler.getLastError();
+    size_t elements = countElements(xopp);
+
+    auto path = Util::getTmpDirSubfolder() / "suite.xopb";
+    PageFileWriter writer;
+    ASSERT_TRUE(writer.save(xopp, path)) << writer.getErrorMessage();
+
+    PageFileReader reader;
+    Document* pageFile = reader.loadDocument(path);
+    ASSERT_NE(nullptr, pageFile) << reader.getLastError();
+    EXPECT_EQ(xopp->getPageCount(), pageFile->getPageCount());
+
+    auto xoppPath = Util::getTmpDirSubfolder() / "suite-converted.xopp";
+    SaveHandler saveHandler;
+    saveHandler.prepareSave(pageFile);
+    saveHandler.saveTo(xoppPath);
+    ASSERT_EQ("", saveHandler.getErrorMessage());
+
+    LoadHandler loadHandler2;
+    Document* converted = loadHandler2.loadDocument(xoppPath);
+    ASSERT_NE(nullptr, converted) << loadHandler2.getLastError();
+    EXPECT_EQ(xopp->getPageCount(), converted->getPageCount());
+    EXPECT_EQ(elements, countElements(converted));
+}
+
+TEST(ControlPageFile, testRejectsOtherFiles) {
+    PageFileReader reader;
+    EXPECT_EQ(nullptr, reader.loadDocument(GET_TESTFILE("packaged_xopp/suite.xopp")));
+    EXPECT_FALSE(reader.getLastError().empty());
+}
+
+TEST(ControlPageFile, testRejectsCorruptedFiles) {
+    DocumentHandler handler;
+    Document doc(&handler);
+    DocumentGeneratorOptions options;
+    options.pages = 2;
+    DocumentGenerator generator(options);
+    ASSERT_TRUE(generator.generate(&doc));
+
+    auto path = Util::getTmpDirSubfolder() / "corrupted.xopb";
+    PageFileWriter writer;
+    ASSERT_TRUE(writer.save(&doc, path)) << writer.getErrorMessage();
+
+    std::string data;
+    {
+        std::ifstream in(path, std::ios::binary);
+        data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    ASSERT_GT(data.size(), PageFileFormat::HEADER_SIZE);
+    PageFileFormat::Header header = PageFileFormat::readHeader(data.data());
+    EXPECT_EQ(PageFileFormat::VERSION, static_cast<uint32_t>(data[8]));
+    EXPECT_EQ(data.size(), header.indexOffset + header.indexLength);
+
+    auto writeFile = [&path](const std::string& content) {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(content.data(), static_cast<std::streamsize>(content.size()));
+    };
+
+    // The first layer chunk follows the header, its elements cannot be read back
+    std::string corruptedChunk = data;
+    for (size_t i = PageFileFormat::HEADER_SIZE; i < PageFileFormat::HEADER_SIZE + 16; i++) {
+        corruptedChunk[i] = static_cast<char>(0xFF);
+    }
+    writeFile(corruptedChunk);
+    {
+        PageFileReader reader;
+        Document* loaded = reader.loadDocument(path);
+        ASSERT_NE(nullptr, loaded) << reader.getLastError();
+        Layer* layer = (*loaded->getPage(0)->getLayers())[0];
+        EXPECT_TRUE(layer->getElements().empty());
+        EXPECT_TRUE(layer->hasLoadError());
+    }
+
+    writeFile(data.substr(0, header.indexOffset + header.indexLength / 2));
+    PageFileReader reader;
+    EXPECT_EQ(nullptr, reader.loadDocument(path));
+    EXPECT_FALSE(reader.getLastError().empty());
+}
+
+TEST(ControlPageFile, testSaveToLoadedFile) {
+    DocumentHandler handler;
+    Document doc(&handler);
+    DocumentGeneratorOptions options;
+    options.pages = 3;
+    options.strokesPerLayer = 10;
+    DocumentGenerator generator(options);
+    ASSERT_TRUE(generator.generate(&doc));
+
+    auto path = Util::getTmpDirSubfolder() / "resaved.xopb";
+    PageFileWriter writer;
+    ASSERT_TRUE(writer.save(&doc, path)) << writer.getErrorMessage();
+
+    PageFileReader reader;
+    Document* loaded = reader.loadDocument(path);
+    ASSERT_NE(nullptr, loaded) << reader.getLastError();
+    EXPECT_TRUE(loaded->shouldCreateBackupOnSave());
+
+    // A page which is not saved anymore, like a deleted page kept for undo
+    PageRef removed = loaded->getPage(2);
+    loaded->deletePage(2);
+
+    // Only the first page is loaded before the file is replaced
+    size_t firstCount = (*loaded->getPage(0)->getLayers())[0]->getElements().size();
+
+    PageFileWriter writer2;
+    ASSERT_TRUE(writer2.save(loaded, path)) << writer2.getErrorMessage();
+    EXPECT_FALSE(fs::exists(fs::path(path) += ".tmp"));
+
+    // The unloaded layers are copied without loading them, and read from the new file afterwards
+    Layer* layer = (*loaded->getPage(1)->getLayers())[0];
+    EXPECT_FALSE(layer->isLoaded());
+    Layer* original = (*doc.getPage(1)->getLayers())[0];
+    EXPECT_EQ(original->getElements().size(), layer->getElements().size());
+    EXPECT_FALSE(layer->hasLoadError());
+
+    // The layers which were not saved are still readable
+    Layer* removedLayer = (*removed->getLayers())[0];
+    EXPECT_EQ((*doc.getPage(2)->getLayers())[0]->getElements().size(), removedLayer->getElements().size());
+    EXPECT_FALSE(removedLayer->hasLoadError());
+
+    PageFileReader reader2;
+    Document* reloaded = reader2.loadDocument(path);
+    ASSERT_NE(nullptr, reloaded) << reader2.getLastError();
+    ASSERT_EQ(2U, reloaded->getPageCount());
+    EXPECT_EQ(firstCount, (*reloaded->getPage(0)->getLayers())[0]->getElements().size());
+    EXPECT_EQ(original->getElements().size(), (*reloaded->getPage(1)->getLayers())[0]->getElements().size());
+}
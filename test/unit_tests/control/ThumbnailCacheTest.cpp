@@ -0,0 +1,168 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <cairo.h>
+#include <gtest/gtest.h>
+
+#include "control/ThumbnailCache.h"
+#include "control/jobs/PreviewJob.h"
+#include "model/Document.h"
+#include "model/DocumentHandler.h"
+#include "model/Layer.h"
+#include "model/LineStyle.h"
+#include "model/Stroke.h"
+#include "model/XojPage.h"
+#include "util/PathUtil.h"
+
+#include "filesystem.h"
+
+namespace {
+auto createCacheFolder(const std::string& name) -> fs::path {
+    auto folder = Util::getTmpDirSubfolder() / name;
+    fs::remove_all(folder);
+    fs::create_directories(folder);
+    return folder;
+}
+
+auto addStroke(Layer* layer) -> Stroke* {
+    auto* stroke = new Stroke();
+    stroke->setWidth(2);
+    stroke->addPoint(Point(10, 10));
+    stroke->addPoint(Point(50, 80));
+    layer->addElement(stroke);
+    return stroke;
+}
+
+/**
+ * A surface which does not compress, so its size in the cache is known
+ */
+auto createNoiseSurface(int size) -> cairo_surface_t* {
+    cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, size, size);
+    cairo_surface_flush(surface);
+    unsigned char* data = cairo_image_surface_get_data(surface);
+    uint32_t state = 1;
+    for (int y = 0; y < size; y++) {
+        auto* row = reinterpret_cast<uint32_t*>(data + y * cairo_image_surface_get_stride(surface));
+        for (int x = 0; x < size; x++) {
+            state = state * 1664525U + 1013904223U;
+            row[x] = 0xff000000U | (state >> 8U);
+        }
+    }
+    cairo_surface_mark_dirty(surface);
+    return surface;
+}
+}  // namespace
+
+TEST(ControlThumbnailCache, testKeyCoversContent) {
+    DocumentHandler handler;
+    Document doc(&handler);
+    auto page = std::make_shared<XojPage>(200, 200);
+    doc.addPage(page);
+    Stroke* stroke = addStroke(page->getSelectedLayer());
+
+    std::string key = ThumbnailCache::computeKey(&doc, page, 1.0, 100, 100);
+    EXPECT_EQ(key, ThumbnailCache::computeKey(&doc, page, 1.0, 100, 100));
+    EXPECT_NE(key, ThumbnailCache::computeKey(&doc, page, 0.5, 100, 100));
+
+    stroke->setLastPoint(60, 80);
+    std::string moved = ThumbnailCache::computeKey(&doc, page, 1.0, 100, 100);
+    EXPECT_NE(key, moved);
+
+    // Dash patterns of different lengths differ from each other and from a solid line
+    LineStyle style;
+    const double shortDashes[] = {2, 2};
+    style.setDashes(shortDashes, 2);
+    stroke->setLineStyle(style);
+    std::string dashed = ThumbnailCache::computeKey(&doc, page, 1.0, 100, 100);
+    const double longDashes[] = {2, 2, 2};
+    style.setDashes(longDashes, 3);
+    stroke->setLineStyle(style);
+    std::string longDashed = ThumbnailCache::computeKey(&doc, page, 1.0, 100, 100);
+    EXPECT_NE(moved, dashed);
+    EXPECT_NE(dashed, longDashed);
+}
+
+TEST(ControlThumbnailCache, testStoreAndLookup) {
+    ThumbnailCache cache(1, createCacheFolder("thumbnail-cache-test"));
+    ASSERT_TRUE(cache.isEnabled());
+    EXPECT_EQ(nullptr, cache.lookup("key", 40, 40));
+
+    cairo_surface_t* surface = createNoiseSurface(40);
+    cache.store("key", surface);
+    cairo_surface_destroy(surface);
+
+    cairo_surface_t* cached = cache.lookup("key", 40, 40);
+    ASSERT_NE(nullptr, cached);
+    EXPECT_EQ(40, cairo_image_surface_get_width(cached));
+    cairo_surface_destroy(cached);
+
+    // A preview of another size is not used
+    EXPECT_EQ(nullptr, cache.lookup("key", 50, 40));
+}
+
+TEST(ControlThumbnailCache, testEvictsLeastRecentlyUsed) {
+    auto folder = createCacheFolder("thumbnail-cache-evict-test");
+    ThumbnailCache cache(2, folder);
+
+    // Each preview takes about 1.4 MiB, so the second one exceeds the limit
+    cairo_surface_t* surface = createNoiseSurface(600);
+    cache.store("old", surface);
+    fs::last_write_time(folder / "old.png", fs::file_time_type::clock::now() - std::chrono::hours(1));
+    cache.store("new", surface);
+    cairo_surface_destroy(surface);
+
+    EXPECT_FALSE(fs::exists(folder / "old.png"));
+    EXPECT_TRUE(fs::exists(folder / "new.png"));
+}
+
+TEST(ControlThumbnailCache, testPreviewJobUsesCache) {
+    ThumbnailCache cache(1, createCacheFolder("thumbnail-cache-preview-job"));
+    DocumentHandler handler;
+    Document doc(&handler);
+    auto page = std::make_shared<XojPage>(200, 200);
+    doc.addPage(page);
+    addStroke(page->getSelectedLayer());
+
+    int renderCount = 0;
+    auto render = [&renderCount]() {
+        renderCount++;
+        return createNoiseSurface(40);
+    };
+    auto preview = [&](bool rendered) {
+        cairo_surface_t* surface = PreviewJob::renderPreview(&cache, &doc, page, 0.2, 40, 40, rendered, render);
+        EXPECT_NE(nullptr, surface);
+        cairo_surface_destroy(surface);
+    };
+
+    // The first preview is rendered and stored, the preview of an entry shown again is taken from the cache
+    preview(false);
+    EXPECT_EQ(1, renderCount);
+    preview(false);
+    EXPECT_EQ(1, renderCount);
+
+    // Repaints of an entry which already shows a preview are rendered
+    preview(true);
+    EXPECT_EQ(2, renderCount);
+
+    // A changed page is rendered again
+    addStroke(page->getSelectedLayer());
+    preview(false);
+    EXPECT_EQ(3, renderCount);
+
+    // Without cache every preview is rendered
+    cairo_surface_destroy(PreviewJob::renderPreview(nullptr, &doc, page, 0.2, 40, 40, false, render));
+    EXPECT_EQ(4, renderCount);
+}
@@ -0,0 +1,155 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "model/AudioIndex.h"
+#include "model/Document.h"
+#include "model/DocumentHandler.h"
+#include "model/Layer.h"
+#include "model/PageStore.h"
+#include "model/Stroke.h"
+#include "model/XojPage.h"
+
+namespace {
+auto addAudioStroke(Layer* layer, const std::string& filename, size_t timestamp) -> Stroke* {
+    auto* stroke = new Stroke();
+    stroke->addPoint(Point(10, 10));
+    stroke->addPoint(Point(20, 20));
+    stroke->setAudioFilename(filename);
+    stroke->setTimestamp(timestamp);
+    layer->addElement(stroke);
+    return stroke;
+}
+
+auto addPage(Document& doc) -> Layer* {
+    auto page = std::make_shared<XojPage>(595, 842);
+    Layer* layer = page->getSelectedLayer();
+    doc.addPage(page);
+    return layer;
+}
+}  // namespace
+
+TEST(ModelAudioIndex, testFindPage) {
+    DocumentHandler handler;
+    Document doc(&handler);
+    AudioIndex index(&doc);
+    index.registerListener(&handler);
+
+    Layer* first = addPage(doc);
+    Layer* second = addPage(doc);
+    addAudioStroke(first, "rec.ogg", 1000);
+    addAudioStroke(first, "rec.ogg", 2000);
+    addAudioStroke(second, "rec.ogg", 5000);
+    addAudioStroke(second, "other.ogg", 0);
+    handler.fireDocumentChanged(DOCUMENT_CHANGE_COMPLETE);
+
+    EXPECT_EQ(4U, index.size());
+    EXPECT_EQ(0U, index.findPage("rec.ogg", 0));
+    EXPECT_EQ(0U, index.findPage("rec.ogg", 4999));
+    EXPECT_EQ(1U, index.findPage("rec.ogg", 5000));
+    EXPECT_EQ(1U, index.findPage("other.ogg", 100000));
+    EXPECT_EQ(AudioIndex::npos, index.findPage("missing.ogg", 0));
+
+    EXPECT_EQ(std::vector<size_t>({0}), index.findPages("rec.ogg", 0, 2000));
+    EXPECT_EQ(std::vector<size_t>({0, 1}), index.findPages("rec.ogg", 1500, 6000));
+    EXPECT_TRUE(index.findPages("rec.ogg", 2001, 4999).empty());
+}
+
+TEST(ModelAudioIndex, testFollowsChanges) {
+    DocumentHandler handler;
+    Document doc(&handler);
+    AudioIndex index(&doc);
+    index.registerListener(&handler);
+
+    Layer* first = addPage(doc);
+    addAudioStroke(first, "rec.ogg", 1000);
+    EXPECT_EQ(0U, index.findPage("rec.ogg", 3000));
+
+    // A new element is reported by its page
+    Layer* second = addPage(doc);
+    handler.firePageInserted(1);
+    Stroke* stroke = addAudioStroke(second, "rec.ogg", 3000);
+    doc.getPage(1)->fireElementChanged(stroke);
+    EXPECT_EQ(1U, index.findPage("rec.ogg", 3000));
+
+    // Moving the page keeps its entries
+    PageRef moved = doc.getPage(1);
+    doc.deletePage(1);
+    doc.insertPage(moved, 0);
+    handler.firePageDeleted(1);
+    handler.firePageInserted(0);
+    EXPECT_EQ(0U, index.findPage("rec.ogg", 3000));
+    EXPECT_EQ(1U, index.findPage("rec.ogg", 1000));
+
+    second->removeElement(stroke, true);
+    doc.getPage(0)->firePageChanged();
+    EXPECT_EQ(1U, index.size());
+    EXPECT_EQ(1U, index.findPage("rec.ogg", 3000));
+}
+
+TEST(ModelAudioIndex, testUnloadedLayersAreNotLoaded) {
+    DocumentHandler handler;
+    Document doc(&handler);
+    AudioIndex index(&doc);
+    index.registerListener(&handler);
+
+    Layer* first = addPage(doc);
+    Layer* second = addPage(doc);
+    addAudioStroke(first, "rec.ogg", 1000);
+    addAudioStroke(second, "rec.ogg", 5000);
+    ASSERT_TRUE(second->unload(std::make_shared<PageStore>()));
+    handler.fireDocumentChanged(DOCUMENT_CHANGE_COMPLETE);
+
+    EXPECT_EQ(1U, index.findPage("rec.ogg", 6000));
+    EXPECT_FALSE(second->isLoaded());
+}
+
+TEST(ModelAudioIndex, testFindElements) {
+    DocumentHandler handler;
+    Document doc(&handler);
+    AudioIndex index(&doc);
+    index.registerListener(&handler);
+
+    Layer* first = addPage(doc);
+    Layer* second = addPage(doc);
+    Rectangle<double> early = addAudioStroke(first, "rec.ogg", 1000)->boundingRect();
+    Stroke* late = addAudioStroke(first, "rec.ogg", 3000);
+    late->move(100, 100);
+    Rectangle<double> lateBounds = late->boundingRect();
+    addAudioStroke(first, "other.ogg", 1000);
+    Rectangle<double> unloaded = addAudioStroke(second, "rec.ogg", 2000)->boundingRect();
+    ASSERT_TRUE(second->unload(std::make_shared<PageStore>()));
+    handler.fireDocumentChanged(DOCUMENT_CHANGE_COMPLETE);
+
+    auto elements = index.findElements(doc.getPage(0), "rec.ogg", 2000, 4000);
+    ASSERT_EQ(1U, elements.size());
+    EXPECT_DOUBLE_EQ(lateBounds.x, elements[0].x);
+    EXPECT_DOUBLE_EQ(lateBounds.y, elements[0].y);
+    EXPECT_DOUBLE_EQ(lateBounds.width, elements[0].width);
+    EXPECT_DOUBLE_EQ(lateBounds.height, elements[0].height);
+    EXPECT_EQ(2U, index.findElements(doc.getPage(0), "rec.ogg", 0, 4000).size());
+    EXPECT_DOUBLE_EQ(early.x, index.findElements(doc.getPage(0), "rec.ogg", 0, 1000).at(0).x);
+
+    // The bounds of unloaded layers are kept without loading them
+    elements = index.findElements(doc.getPage(1), "rec.ogg", 0, 4000);
+    ASSERT_EQ(1U, elements.size());
+    EXPECT_DOUBLE_EQ(unloaded.x, elements[0].x);
+    EXPECT_DOUBLE_EQ(unloaded.height, elements[0].height);
+    EXPECT_FALSE(second->isLoaded());
+
+    // Hidden layers are not highlighted
+    first->setVisible(false);
+    EXPECT_TRUE(index.findElements(doc.getPage(0), "rec.ogg", 0, 4000).empty());
+}
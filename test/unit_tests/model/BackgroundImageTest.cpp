@@ -0,0 +1,99 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <gtest/gtest.h>
+#include <gtk/gtk.h>
+
+#include "model/BackgroundImage.h"
+
+namespace {
+auto loadImage(int width, int height) -> BackgroundImage {
+    GdkPixbuf* pixbuf = gdk_pixbuf_new(GDK_COLORSPACE_RGB, true, 8, width, height);
+    gdk_pixbuf_fill(pixbuf, 0x336699ffU);
+    gchar* buffer = nullptr;
+    gsize size = 0;
+    gdk_pixbuf_save_to_buffer(pixbuf, &buffer, &size, "png", nullptr, nullptr);
+    g_object_unref(pixbuf);
+
+    GInputStream* stream = g_memory_input_stream_new_from_data(buffer, static_cast<gssize>(size), g_free);
+    BackgroundImage img;
+    img.loadFile(stream, "background.png", nullptr);
+    g_object_unref(stream);
+    return img;
+}
+}  // namespace
+
+TEST(ModelBackgroundImage, testSurfaceLevels) {
+    BackgroundImage img = loadImage(1000, 600);
+
+    cairo_surface_t* full = img.getSurface(1000, 600);
+    ASSERT_NE(nullptr, full);
+    EXPECT_EQ(1000, cairo_image_surface_get_width(full));
+    EXPECT_EQ(600, cairo_image_surface_get_height(full));
+
+    // Zoomed in, the full resolution is used
+    cairo_surface_t* zoomed = img.getSurface(3000, 1800);
+    EXPECT_EQ(full, zoomed);
+
+    // The level is never smaller than the target
+    cairo_surface_t* small = img.getSurface(240, 100);
+    EXPECT_EQ(250, cairo_image_surface_get_width(small));
+    EXPECT_EQ(150, cairo_image_surface_get_height(small));
+
+    // Both dimensions have to fit
+    cairo_surface_t* narrow = img.getSurface(100, 200);
+    EXPECT_EQ(500, cairo_image_surface_get_width(narrow));
+
+    // The color is kept by the downscaling
+    cairo_surface_t* tiny = img.getSurface(1, 1);
+    EXPECT_EQ(1, cairo_image_surface_get_width(tiny));
+    cairo_surface_flush(tiny);
+    auto* pixel = reinterpret_cast<uint32_t*>(cairo_image_surface_get_data(tiny));
+    EXPECT_EQ(0xff336699U, *pixel);
+
+    for (cairo_surface_t* s: {full, zoomed, small, narrow, tiny}) {
+        cairo_surface_destroy(s);
+    }
+}
+
+TEST(ModelBackgroundImage, testCopiesShareSurfaces) {
+    BackgroundImage img = loadImage(64, 64);
+    BackgroundImage clone = img;
+
+    size_t footprint = img.getMemoryFootprint();
+    cairo_surface_t* a = img.getSurface(32, 32);
+    cairo_surface_t* b = clone.getSurface(32, 32);
+    EXPECT_EQ(a, b);
+    EXPECT_GT(clone.getMemoryFootprint(), footprint);
+
+    // The surface stays valid after the image is released
+    img.free();
+    clone.free();
+    EXPECT_EQ(32, cairo_image_surface_get_width(a));
+    cairo_surface_destroy(a);
+    cairo_surface_destroy(b);
+
+    EXPECT_EQ(nullptr, img.getSurface(10, 10));
+}
+
+TEST(ModelBackgroundImage, testCopiesShareFootprint) {
+    BackgroundImage img = loadImage(64, 64);
+    size_t single = img.getMemoryFootprint();
+    ASSERT_GT(single, 0U);
+
+    BackgroundImage clone = img;
+    BackgroundImage other = img;
+    EXPECT_EQ(single / 3, img.getMemoryFootprint());
+    EXPECT_EQ(single / 3, clone.getMemoryFootprint());
+
+    other.free();
+    EXPECT_EQ(single / 2, img.getMemoryFootprint());
+}
@@ -0,0 +1,101 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "model/Image.h"
+#include "model/Layer.h"
+#include "model/Stroke.h"
+#include "model/XojPage.h"
+
+#include "CopyOnWrite.h"
+
+namespace {
+constexpr int POINTS = 2000;
+
+auto createPage() -> std::shared_ptr<XojPage> {
+    auto page = std::make_shared<XojPage>(595, 842);
+    Layer* layer = page->getSelectedLayer();
+    for (int s = 0; s < 50; s++) {
+        auto* stroke = new Stroke();
+        for (int i = 0; i < POINTS; i++) {
+            stroke->addPoint(Point(i * 0.5, s * 10));
+        }
+        layer->addElement(stroke);
+    }
+    auto* image = new Image();
+    image->setImage(std::string(100000, 'x'));
+    layer->addElement(image);
+    return page;
+}
+}  // namespace
+
+TEST(ModelCopyOnWrite, testValue) {
+    CopyOnWrite<std::vector<int>> a;
+    EXPECT_TRUE(a->empty());
+    EXPECT_EQ(0U, a.getUseCount());
+
+    a.write().push_back(1);
+    CopyOnWrite<std::vector<int>> b = a;
+    EXPECT_TRUE(a.sharesWith(b));
+    EXPECT_EQ(2U, b.getUseCount());
+
+    b.write().push_back(2);
+    EXPECT_FALSE(a.sharesWith(b));
+    EXPECT_EQ(std::vector<int>({1}), *a);
+    EXPECT_EQ(std::vector<int>({1, 2}), *b);
+
+    // A shared reference is not a holder, but keeps its value unchanged
+    std::shared_ptr<const std::vector<int>> shared = a.share();
+    EXPECT_EQ(1U, a.getUseCount());
+    a.write().push_back(3);
+    EXPECT_EQ(std::vector<int>({1}), *shared);
+    EXPECT_EQ(std::vector<int>({1, 3}), *a);
+}
+
+TEST(ModelCopyOnWrite, testDuplicatedPages) {
+    auto page = createPage();
+    size_t single = page->getMemoryFootprint();
+    EXPECT_GT(single, 50 * POINTS * sizeof(Point));
+
+    std::vector<std::unique_ptr<XojPage>> copies;
+    for (int i = 0; i < 100; i++) {
+        copies.emplace_back(page->clone());
+    }
+
+    // The points and the image data are held once for all copies
+    size_t total = page->getMemoryFootprint();
+    for (auto& copy: copies) {
+        total += copy->getMemoryFootprint();
+    }
+    EXPECT_LT(total, 2 * single);
+
+    // Changing a copy does not change the original, and only copies the changed stroke
+    Layer* copyLayer = (*copies[0]->getLayers())[0];
+    auto* copyStroke = dynamic_cast<Stroke*>(copyLayer->getElements()[0]);
+    copyStroke->move(5, 5);
+    auto* original = dynamic_cast<Stroke*>((*page->getLayers())[0]->getElements()[0]);
+    EXPECT_DOUBLE_EQ(0, original->getPoint(0).x);
+    EXPECT_DOUBLE_EQ(5, copyStroke->getPoint(0).x);
+    EXPECT_NE(original->getPoints(), copyStroke->getPoints());
+
+    auto* otherCopyStroke = dynamic_cast<Stroke*>(copyLayer->getElements()[1]);
+    auto* otherOriginal = dynamic_cast<Stroke*>((*page->getLayers())[0]->getElements()[1]);
+    EXPECT_EQ(otherOriginal->getPoints(), otherCopyStroke->getPoints());
+
+    auto* copyImage = dynamic_cast<Image*>(copyLayer->getElements().back());
+    auto* originalImage = dynamic_cast<Image*>((*page->getLayers())[0]->getElements().back());
+    EXPECT_EQ(&originalImage->getEncodedData(), &copyImage->getEncodedData());
+}
@@ -0,0 +1,56 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "model/Layer.h"
+#include "model/Stroke.h"
+
+TEST(ModelLayerBulk, testAddAndRemoveElements) {
+    Layer layer;
+    auto* first = new Stroke();
+    layer.addElement(first);
+
+    // Enough elements that a quadratic implementation would stall the test
+    std::vector<Element*> strokes;
+    for (int i = 0; i < 100000; i++) {
+        auto* stroke = new Stroke();
+        stroke->addPoint(Point(i, 0));
+        stroke->addPoint(Point(i, 10));
+        strokes.push_back(stroke);
+    }
+
+    layer.addElements(strokes);
+    ASSERT_EQ(100001U, layer.getElements().size());
+    EXPECT_EQ(first, layer.getElements().front());
+    EXPECT_EQ(strokes.back(), layer.getElements().back());
+
+    std::vector<Element*> removed;
+    for (size_t i = 0; i < strokes.size(); i += 2) {
+        removed.push_back(strokes[i]);
+    }
+    EXPECT_EQ(removed.size(), layer.removeElements(removed));
+    ASSERT_EQ(50001U, layer.getElements().size());
+
+    // The order of the remaining elements is kept
+    EXPECT_EQ(first, layer.getElements()[0]);
+    EXPECT_EQ(strokes[1], layer.getElements()[1]);
+    EXPECT_EQ(strokes[3], layer.getElements()[2]);
+
+    // Elements which are not on the layer are ignored
+    EXPECT_EQ(0U, layer.removeElements(removed));
+
+    for (Element* e: removed) {
+        delete e;
+    }
+}
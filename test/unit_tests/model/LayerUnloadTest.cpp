@@ -0,0 +1,108 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "model/Layer.h"
+#include "model/PageStore.h"
+#include "model/Stroke.h"
+#include "model/Text.h"
+#include "model/XojPage.h"
+
+namespace {
+/**
+ * A store whose entries cannot be read back, like a temporary file which was deleted
+ */
+class UnreadablePageStore: public PageStore {
+public:
+    bool read(const Entry& entry, std::string& data) override { return false; }
+};
+}  // namespace
+
+TEST(ModelLayerUnload, testRoundTrip) {
+    auto store = std::make_shared<PageStore>();
+    Layer layer;
+
+    auto* stroke = new Stroke();
+    for (int i = 0; i < 100; i++) { stroke->addPoint(Point(i, 2 * i, 0.5)); }
+    stroke->setWidth(3.5);
+    layer.addElement(stroke);
+
+    auto* text = new Text();
+    text->setText("unloaded");
+    layer.addElement(text);
+
+    ASSERT_TRUE(layer.unload(store));
+    EXPECT_FALSE(layer.isLoaded());
+    EXPECT_TRUE(layer.isAnnotated());
+    EXPECT_GT(store->getStoredSize(), 0U);
+
+    // Accessing the elements loads them again and frees the stored entry
+    const auto& elements = layer.getElements();
+    EXPECT_TRUE(layer.isLoaded());
+    EXPECT_EQ(0U, store->getStoredSize());
+    ASSERT_EQ(2U, elements.size());
+
+    auto* s = dynamic_cast<Stroke*>(elements[0]);
+    ASSERT_NE(nullptr, s);
+    ASSERT_EQ(100, s->getPointCount());
+    EXPECT_DOUBLE_EQ(3.5, s->getWidth());
+    EXPECT_DOUBLE_EQ(198, s->getPoint(99).y);
+
+    auto* t = dynamic_cast<Text*>(elements[1]);
+    ASSERT_NE(nullptr, t);
+    EXPECT_EQ("unloaded", t->getText());
+}
+
+TEST(ModelLayerUnload, testEmptyLayerIsNotUnloaded) {
+    auto store = std::make_shared<PageStore>();
+    Layer layer;
+    EXPECT_FALSE(layer.unload(store));
+    EXPECT_TRUE(layer.isLoaded());
+}
+
+TEST(ModelLayerUnload, testLoadErrorKeepsEntry) {
+    auto store = std::make_shared<UnreadablePageStore>();
+    Layer layer;
+    layer.addElement(new Stroke());
+    ASSERT_TRUE(layer.unload(store));
+
+    EXPECT_TRUE(layer.getElements().empty());
+    EXPECT_TRUE(layer.hasLoadError());
+    EXPECT_FALSE(layer.isLoaded());
+    EXPECT_TRUE(layer.isAnnotated());
+    EXPECT_GT(store->getStoredSize(), 0U);
+
+    // New elements are not mixed into the layer
+    auto stroke = std::make_unique<Stroke>();
+    layer.addElement(stroke.get());
+    EXPECT_TRUE(layer.getElements().empty());
+}
+
+TEST(ModelLayerUnload, testPinnedPageIsNotUnloaded) {
+    auto store = std::make_shared<PageStore>();
+    XojPage page(100, 100);
+    page.getSelectedLayer()->addElement(new Stroke());
+
+    page.pinContents();
+    page.pinContents();
+    EXPECT_FALSE(page.unloadContents(store));
+    page.unpinContents();
+    EXPECT_FALSE(page.unloadContents(store));
+    EXPECT_TRUE(page.isLoaded());
+
+    page.unpinContents();
+    EXPECT_TRUE(page.unloadContents(store));
+    EXPECT_FALSE(page.isLoaded());
+}
@@ -0,0 +1,255 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include <cairo-pdf.h>
+#include <gtest/gtest.h>
+#include <poppler.h>
+
+#include "model/Document.h"
+#include "model/DocumentHandler.h"
+#include "model/Layer.h"
+#include "model/Stroke.h"
+#include "pdf/base/PdfFile.h"
+#include "pdf/base/PdfOverlayMerger.h"
+#include "pdf/base/XojPdfExport.h"
+#include "pdf/base/XojPdfExportFactory.h"
+#include "util/PageRange.h"
+#include "util/PathUtil.h"
+
+#include "filesystem.h"
+
+namespace {
+constexpr int WIDTH = 300;
+constexpr int HEIGHT = 200;
+
+void createSourcePdf(const fs::path& path, int pages) {
+    cairo_surface_t* surface = cairo_pdf_surface_create(path.u8string().c_str(), WIDTH, HEIGHT);
+    cairo_t* cr = cairo_create(surface);
+    for (int i = 0; i < pages; i++) {
+        cairo_move_to(cr, 20, 40);
+        cairo_set_font_size(cr, 20);
+        cairo_show_text(cr, ("Original page " + std::to_string(i + 1)).c_str());
+        cairo_show_page(cr);
+    }
+    cairo_destroy(cr);
+    cairo_surface_destroy(surface);
+}
+
+auto readFile(const fs::path& path) -> std::string {
+    gchar* contents = nullptr;
+    gsize length = 0;
+    g_file_get_contents(path.u8string().c_str(), &contents, &length, nullptr);
+    std::string data(contents, length);
+    g_free(contents);
+    return data;
+}
+
+void writeFile(const fs::path& path, const std::string& data) {
+    ASSERT_TRUE(g_file_set_contents(path.u8string().c_str(), data.data(), static_cast<gssize>(data.size()), nullptr));
+}
+
+auto openPdf(const fs::path& path) -> PopplerDocument* {
+    std::string uri = "file://" + path.u8string();
+    return poppler_document_new_from_file(uri.c_str(), nullptr, nullptr);
+}
+
+auto getPageText(PopplerDocument* pdf, int nr) -> std::string {
+    PopplerPage* page = poppler_document_get_page(pdf, nr);
+    gchar* text = poppler_page_get_text(page);
+    std::string result = text ? text : "";
+    g_free(text);
+    g_object_unref(page);
+    return result;
+}
+
+void addStroke(Document& doc, size_t page) {
+    auto* stroke = new Stroke();
+    stroke->setColor(Color{0xFF0000U});
+    stroke->setWidth(10);
+    stroke->addPoint(Point(50, 150));
+    stroke->addPoint(Point(250, 150));
+    doc.getPage(page)->getSelectedLayer()->addElement(stroke);
+}
+
+/**
+ * @return The pixel at the position, rendered on white
+ */
+auto renderPixel(PopplerPage* page, int x, int y) -> uint32_t {
+    cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, WIDTH, HEIGHT);
+    cairo_t* cr = cairo_create(surface);
+    cairo_set_source_rgb(cr, 1, 1, 1);
+    cairo_paint(cr);
+    poppler_page_render(page, cr);
+    cairo_destroy(cr);
+    cairo_surface_flush(surface);
+    auto* row = cairo_image_surface_get_data(surface) + y * cairo_image_surface_get_stride(surface);
+    uint32_t pixel = reinterpret_cast<uint32_t*>(row)[x];
+    cairo_surface_destroy(surface);
+    return pixel;
+}
+}  // namespace
+
+TEST(PdfPassThroughExport, testAnnotationsOnOriginalPages) {
+    fs::path folder = Util::getTmpDirSubfolder("pass-through-test");
+    fs::path sourcePath = folder / "source.pdf";
+    fs::path exportPath = folder / "export.pdf";
+    createSourcePdf(sourcePath, 2);
+
+    DocumentHandler handler;
+    Document doc(&handler);
+    ASSERT_TRUE(doc.readPdf(sourcePath, true, false)) << doc.getLastErrorMsg();
+    ASSERT_EQ(2U, doc.getPageCount());
+
+    addStroke(doc, 0);
+
+    // A page without PDF is inserted between the PDF pages
+    auto blank = std::make_shared<XojPage>(WIDTH, HEIGHT);
+    blank->getSelectedLayer();  // Creates an empty layer
+    doc.insertPage(blank, 1);
+
+    std::unique_ptr<XojPdfExport> pdfe(XojPdfExportFactory::createExport(&doc, nullptr, true));
+    ASSERT_TRUE(pdfe->createPdf(exportPath, false)) << pdfe->getLastError();
+
+    // The source file is kept as it is, the annotations are appended
+    std::string source = readFile(sourcePath);
+    std::string exported = readFile(exportPath);
+    ASSERT_GT(exported.size(), source.size());
+    EXPECT_EQ(source, exported.substr(0, source.size()));
+
+    PopplerDocument* pdf = openPdf(exportPath);
+    ASSERT_NE(nullptr, pdf);
+    ASSERT_EQ(3, poppler_document_get_n_pages(pdf));
+
+    const char* expectedText[] = {"Original page 1", "", "Original page 2"};
+    for (int i = 0; i < 3; i++) {
+        EXPECT_NE(std::string::npos, getPageText(pdf, i).find(expectedText[i])) << "page " << i;
+    }
+
+    // The stroke is drawn on the first page only
+    PopplerPage* page = poppler_document_get_page(pdf, 0);
+    EXPECT_EQ(0xffff0000U, renderPixel(page, 150, 150));
+    EXPECT_EQ(0xffffffffU, renderPixel(page, 150, 100));
+    g_object_unref(page);
+    page = poppler_document_get_page(pdf, 2);
+    EXPECT_EQ(0xffffffffU, renderPixel(page, 150, 150));
+    g_object_unref(page);
+
+    g_object_unref(pdf);
+}
+
+TEST(PdfPassThroughExport, testSubsetIsDrawn) {
+    fs::path folder = Util::getTmpDirSubfolder("pass-through-test");
+    fs::path sourcePath = folder / "subset-source.pdf";
+    fs::path exportPath = folder / "subset-export.pdf";
+    createSourcePdf(sourcePath, 3);
+
+    DocumentHandler handler;
+    Document doc(&handler);
+    ASSERT_TRUE(doc.readPdf(sourcePath, true, false)) << doc.getLastErrorMsg();
+    addStroke(doc, 1);
+
+    std::unique_ptr<XojPdfExport> pdfe(XojPdfExportFactory::createExport(&doc, nullptr, true));
+    PageRangeVector range = {new PageRangeEntry(1, 1)};
+    ASSERT_TRUE(pdfe->createPdf(exportPath, range, false)) << pdfe->getLastError();
+    for (PageRangeEntry* e: range) { delete e; }
+
+    // A copy of the source would keep the pages which are not exported
+    std::string source = readFile(sourcePath);
+    std::string exported = readFile(exportPath);
+    EXPECT_NE(source, exported.substr(0, source.size()));
+
+    PopplerDocument* pdf = openPdf(exportPath);
+    ASSERT_NE(nullptr, pdf);
+    ASSERT_EQ(1, poppler_document_get_n_pages(pdf));
+    EXPECT_NE(std::string::npos, getPageText(pdf, 0).find("Original page 2"));
+    PopplerPage* page = poppler_document_get_page(pdf, 0);
+    EXPECT_EQ(0xffff0000U, renderPixel(page, 150, 150));
+    g_object_unref(page);
+    g_object_unref(pdf);
+}
+
+TEST(PdfPassThroughExport, testDamagedSourceIsDrawn) {
+    fs::path folder = Util::getTmpDirSubfolder("pass-through-test");
+    fs::path sourcePath = folder / "damaged-source.pdf";
+    fs::path exportPath = folder / "damaged-export.pdf";
+    createSourcePdf(sourcePath, 2);
+
+    // Points startxref to the start of the file, Poppler reconstructs the cross reference
+    std::string source = readFile(sourcePath);
+    size_t pos = source.rfind("startxref");
+    ASSERT_NE(std::string::npos, pos);
+    for (pos += 9; pos < source.size() && !g_ascii_isdigit(source[pos]); pos++) {}
+    for (; pos < source.size() && g_ascii_isdigit(source[pos]); pos++) { source[pos] = '0'; }
+    writeFile(sourcePath, source);
+
+    DocumentHandler handler;
+    Document doc(&handler);
+    ASSERT_TRUE(doc.readPdf(sourcePath, true, false)) << doc.getLastErrorMsg();
+    ASSERT_EQ(2U, doc.getPageCount());
+    addStroke(doc, 0);
+
+    std::unique_ptr<XojPdfExport> pdfe(XojPdfExportFactory::createExport(&doc, nullptr, true));
+    ASSERT_TRUE(pdfe->createPdf(exportPath, false)) << pdfe->getLastError();
+
+    std::string exported = readFile(exportPath);
+    EXPECT_NE(source, exported.substr(0, source.size()));
+
+    PopplerDocument* pdf = openPdf(exportPath);
+    ASSERT_NE(nullptr, pdf);
+    ASSERT_EQ(2, poppler_document_get_n_pages(pdf));
+    EXPECT_NE(std::string::npos, getPageText(pdf, 1).find("Original page 2"));
+    PopplerPage* page = poppler_document_get_page(pdf, 0);
+    EXPECT_EQ(0xffff0000U, renderPixel(page, 150, 150));
+    g_object_unref(page);
+    g_object_unref(pdf);
+}
+
+TEST(PdfPassThroughExport, testEncryptedSourceIsRejected) {
+    fs::path path = Util::getTmpDirSubfolder("pass-through-test") / "encrypted-source.pdf";
+    createSourcePdf(path, 1);
+    std::string data = readFile(path);
+
+    // Adds /Encrypt to the trailer, or to the dictionary of the cross reference stream
+    std::string encrypted = data;
+    size_t trailer = encrypted.rfind("trailer");
+    size_t pos = trailer != std::string::npos ? encrypted.find("<<", trailer) : encrypted.rfind("/Type /XRef");
+    ASSERT_NE(std::string::npos, pos);
+    encrypted.insert(pos + 2, " /Encrypt 1 0 R ");
+
+    PdfFile source(encrypted.data(), encrypted.size());
+    EXPECT_TRUE(source.isEncrypted());
+    PdfFile overlay(data.data(), data.size());
+    EXPECT_FALSE(overlay.isEncrypted());
+
+    PdfOverlayMerger merger(source, overlay);
+    EXPECT_THROW(merger.merge({0}), PdfFormatException);
+}
+
+TEST(PdfPassThroughExport, testMalformedNumbersAreRejected) {
+    const char* files[] = {
+            // startxref does not fit into 64 bits
+            "%PDF-1.4\nxref\n0 1\n0000000000 65535 f \ntrailer\n<< /Size 1 >>\nstartxref\n"
+            "99999999999999999999999\n%%EOF\n",
+            // An object offset behind the end of the file
+            "%PDF-1.4\nxref\n0 2\n0000000000 65535 f \n9999999999 00000 n \ntrailer\n<< /Size 2 >>\n"
+            "startxref\n9\n%%EOF\n",
+            // A reference with an object number out of range
+            "%PDF-1.4\nxref\n0 1\n0000000000 65535 f \ntrailer\n<< /Size 1 /Root 4294967296 0 R >>\n"
+            "startxref\n9\n%%EOF\n",
+    };
+    for (const char* file: files) {
+        EXPECT_THROW(PdfFile(file, std::strlen(file)), PdfFormatException) << file;
+    }
+}
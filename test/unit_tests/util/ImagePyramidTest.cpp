@@ -0,0 +1,71 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <gtest/gtest.h>
+
+#include "model/Image.h"
+
+#include "ImagePyramid.h"
+
+TEST(UtilImagePyramid, testLevels) {
+    cairo_surface_t* original = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 4000, 3000);
+    ImagePyramid pyramid;
+
+    // Drawn larger than the original
+    cairo_surface_t* level = pyramid.getLevel(original, 8000, 6000);
+    EXPECT_EQ(original, level);
+    cairo_surface_destroy(level);
+    EXPECT_EQ(0U, pyramid.getMemoryFootprint());
+
+    level = pyramid.getLevel(original, 900, 700);
+    EXPECT_EQ(1000, cairo_image_surface_get_width(level));
+    EXPECT_EQ(750, cairo_image_surface_get_height(level));
+    cairo_surface_destroy(level);
+    size_t footprint = pyramid.getMemoryFootprint();
+    EXPECT_GT(footprint, 0U);
+
+    // The levels are created once
+    cairo_surface_t* first = pyramid.getLevel(original, 1500, 1000);
+    cairo_surface_t* second = pyramid.getLevel(original, 1800, 1400);
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(2000, cairo_image_surface_get_width(first));
+    EXPECT_EQ(footprint, pyramid.getMemoryFootprint());
+    cairo_surface_destroy(first);
+    cairo_surface_destroy(second);
+
+    pyramid.clear();
+    EXPECT_EQ(0U, pyramid.getMemoryFootprint());
+    cairo_surface_destroy(original);
+}
+
+TEST(UtilImagePyramid, testImageClonesShareLevels) {
+    Image img;
+    img.setImage(cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 1024, 1024));
+    img.setWidth(100);
+    img.setHeight(100);
+
+    cairo_surface_t* scaled = img.getScaledImage(100, 100);
+    EXPECT_EQ(128, cairo_image_surface_get_width(scaled));
+
+    Element* clone = img.clone();
+    cairo_surface_t* cloneScaled = dynamic_cast<Image*>(clone)->getScaledImage(100, 100);
+    EXPECT_EQ(scaled, cloneScaled);
+    cairo_surface_destroy(cloneScaled);
+    delete clone;
+
+    // The levels of a replaced image are not used
+    img.setImage(cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 1024, 1024));
+    cairo_surface_t* replaced = img.getScaledImage(100, 100);
+    EXPECT_NE(scaled, replaced);
+    EXPECT_EQ(1024, cairo_image_surface_get_width(img.getImage()));
+    cairo_surface_destroy(replaced);
+    cairo_surface_destroy(scaled);
+}
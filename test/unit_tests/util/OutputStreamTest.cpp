@@ -0,0 +1,131 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <array>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <zlib.h>
+
+#include "util/OutputStream.h"
+#include "util/Util.h"
+
+#include "filesystem.h"
+
+class StringOutputStream: public BufferedOutputStream {
+public:
+    explicit StringOutputStream(size_t bufferSize): BufferedOutputStream(bufferSize) {}
+
+    void close() override { flush(); }
+
+    std::string str;
+    int blocks = 0;
+
+protected:
+    void writeBuffer(const char* data, size_t len) override {
+        str.append(data, len);
+        blocks++;
+    }
+};
+
+TEST(UtilOutputStream, testBufferedWrites) {
+    StringOutputStream out(16);
+    out.write("<");
+    out.write(std::string("stroke"));
+    out.write(">");
+    EXPECT_EQ(0, out.blocks);
+
+    // Fills the buffer, the rest stays buffered
+    out.write("0123456789ab");
+    EXPECT_EQ(1, out.blocks);
+
+    // Larger than the whole buffer
+    out.write("0123456789abcdefghij");
+    EXPECT_EQ(2, out.blocks);
+
+    out.write("</stroke>");
+    EXPECT_EQ(3, out.blocks);
+    out.close();
+    EXPECT_EQ(4, out.blocks);
+    EXPECT_EQ("<stroke>0123456789ab0123456789abcdefghij</stroke>", out.str);
+}
+
+TEST(UtilOutputStream, testFormatDoubleMatchesPrintf) {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dist(-5000.0, 5000.0);
+
+    std::vector<double> values = {0.0, -0.0, 1.0, 0.5, 1e-9, 5e-9, 123456.123456785, 1e20, -1e20};
+    for (int i = 0; i < 10000; i++) { values.push_back(dist(gen)); }
+
+    for (double v: values) {
+        std::array<char, G_ASCII_DTOSTR_BUF_SIZE> expected{};
+        g_ascii_formatd(expected.data(), expected.size(), Util::PRECISION_FORMAT_STRING, v);
+
+        std::array<char, G_ASCII_DTOSTR_BUF_SIZE> actual{};
+        size_t len = Util::formatDouble(actual.data(), actual.size(), v);
+        EXPECT_EQ(std::string(expected.data()), std::string(actual.data(), len));
+    }
+}
+
+TEST(UtilOutputStream, testWriteCoordinateString) {
+    StringOutputStream out(64);
+    Util::writeCoordinateString(&out, 12.5, -0.125);
+    out.write(" ");
+    Util::writeDouble(&out, 3);
+    out.close();
+    EXPECT_EQ("12.50000000 -0.12500000 3.00000000", out.str);
+}
+
+TEST(UtilOutputStream, testGzOutputStreamRoundtrip) {
+    std::mt19937 gen(7);
+    std::string data;
+    while (data.size() < 5 * GzOutputStream::BLOCK_SIZE + 1234) {
+        data += std::to_string(gen() % 100000);
+        data += gen() % 8 ? " " : "\n";
+    }
+
+    for (int threads: {1, 4}) {
+        auto path = fs::temp_directory_path() / ("xournalpp-gz-test-" + std::to_string(threads) + ".gz");
+        {
+            GzOutputStream out(path, Z_BEST_SPEED, threads);
+            ASSERT_TRUE(out.getLastError().empty());
+            for (size_t pos = 0; pos < data.size(); pos += 1000) {
+                out.write(data.substr(pos, 1000));
+            }
+            out.close();
+            EXPECT_TRUE(out.getLastError().empty());
+        }
+
+        // Read back with stock zlib, which also verifies the CRC and length of the gzip trailer
+        gzFile fp = gzopen(path.u8string().c_str(), "r");
+        ASSERT_NE(nullptr, fp);
+        std::string read(data.size() + 1, '\0');
+        int len = gzread(fp, read.data(), static_cast<unsigned>(read.size()));
+        EXPECT_EQ(Z_OK, gzclose(fp));
+        read.resize(std::max(len, 0));
+        EXPECT_EQ(data, read);
+
+        fs::remove(path);
+    }
+}
+
+TEST(UtilOutputStream, testGzOutputStreamOpenError) {
+    auto path = fs::temp_directory_path() / "xournalpp-gz-test-missing" / "file.gz";
+    GzOutputStream out(path, Z_BEST_SPEED, 4);
+    EXPECT_FALSE(out.getLastError().empty());
+
+    // Writing and closing the failed stream does nothing
+    out.write(std::string(GzOutputStream::BLOCK_SIZE * 2, 'x'));
+    out.close();
+    EXPECT_FALSE(fs::exists(path));
+}
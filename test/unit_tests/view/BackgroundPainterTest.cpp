@@ -0,0 +1,135 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+#include <cairo.h>
+#include <gtest/gtest.h>
+
+#include "model/PageType.h"
+#include "model/XojPage.h"
+#include "view/background/BackgroundTileCache.h"
+#include "view/background/MainBackgroundPainter.h"
+
+namespace {
+constexpr double PAGE_WIDTH = 300;
+constexpr double PAGE_HEIGHT = 400;
+
+/**
+ * Coverage of the tile edges is rounded separately from the direct painting, which may differ by a level or two
+ */
+constexpr int MAX_CHANNEL_DIFFERENCE = 2;
+
+void paintBackground(cairo_t* cr, const PageType& pt, double zoom, double offsetX, double offsetY) {
+    auto page = std::make_shared<XojPage>(PAGE_WIDTH, PAGE_HEIGHT);
+    page->setBackgroundType(pt);
+
+    cairo_translate(cr, offsetX, offsetY);
+    cairo_scale(cr, zoom, zoom);
+    MainBackgroundPainter painter;
+    painter.paint(pt, cr, page);
+}
+
+auto createSurface(double zoom) -> cairo_surface_t* {
+    return cairo_image_surface_create(CAIRO_FORMAT_ARGB32, static_cast<int>(PAGE_WIDTH * zoom) + 2,
+                                      static_cast<int>(PAGE_HEIGHT * zoom) + 2);
+}
+
+/**
+ * Paints with tiles on an image surface
+ */
+auto paintTiled(const PageType& pt, double zoom, double offsetX, double offsetY) -> cairo_surface_t* {
+    cairo_surface_t* surface = createSurface(zoom);
+    cairo_t* cr = cairo_create(surface);
+    paintBackground(cr, pt, zoom, offsetX, offsetY);
+    cairo_destroy(cr);
+    return surface;
+}
+
+/**
+ * Paints every line directly, tiles are never used for a recording surface
+ */
+auto paintDirect(const PageType& pt, double zoom, double offsetX, double offsetY) -> cairo_surface_t* {
+    cairo_surface_t* recording = cairo_recording_surface_create(CAIRO_CONTENT_COLOR_ALPHA, nullptr);
+    cairo_t* cr = cairo_create(recording);
+    paintBackground(cr, pt, zoom, offsetX, offsetY);
+    cairo_destroy(cr);
+
+    cairo_surface_t* surface = createSurface(zoom);
+    cr = cairo_create(surface);
+    cairo_set_source_surface(cr, recording, 0, 0);
+    cairo_paint(cr);
+    cairo_destroy(cr);
+    cairo_surface_destroy(recording);
+    return surface;
+}
+
+auto maxDifference(cairo_surface_t* a, cairo_surface_t* b) -> int {
+    cairo_surface_flush(a);
+    cairo_surface_flush(b);
+    int stride = cairo_image_surface_get_stride(a);
+    int width = cairo_image_surface_get_width(a);
+    int height = cairo_image_surface_get_height(a);
+    unsigned char* dataA = cairo_image_surface_get_data(a);
+    unsigned char* dataB = cairo_image_surface_get_data(b);
+
+    int difference = 0;
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width * 4; x++) {
+            difference = std::max(difference, std::abs(dataA[y * stride + x] - dataB[y * stride + x]));
+        }
+    }
+    return difference;
+}
+
+auto createPageType(PageTypeFormat format, const std::string& config) -> PageType {
+    PageType pt(format);
+    pt.config = config;
+    return pt;
+}
+}  // namespace
+
+TEST(ViewBackgroundPainter, testTilesLookLikeDirectPainting) {
+    const PageType types[] = {
+            createPageType(PageTypeFormat::Ruled, ""),        createPageType(PageTypeFormat::Lined, ""),
+            createPageType(PageTypeFormat::Graph, "r1=10"),   createPageType(PageTypeFormat::Dotted, "r1=10"),
+            createPageType(PageTypeFormat::Staves, ""),       createPageType(PageTypeFormat::IsoDotted, ""),
+    };
+    const double zooms[] = {1, 2};
+    const double offsets[][2] = {{0, 0}, {0.3, 0.6}};
+
+    for (const PageType& pt: types) {
+        for (double zoom: zooms) {
+            for (const auto& offset: offsets) {
+                cairo_surface_t* tiled = paintTiled(pt, zoom, offset[0], offset[1]);
+                cairo_surface_t* direct = paintDirect(pt, zoom, offset[0], offset[1]);
+
+                EXPECT_LE(maxDifference(tiled, direct), MAX_CHANNEL_DIFFERENCE)
+                        << "format " << static_cast<int>(pt.format) << ", zoom " << zoom << ", offset " << offset[0];
+
+                cairo_surface_destroy(tiled);
+                cairo_surface_destroy(direct);
+            }
+        }
+    }
+}
+
+TEST(ViewBackgroundPainter, testRuledUsesTiles) {
+    BackgroundTileCache::getInstance().clear();
+
+    cairo_surface_t* tiled = paintTiled(PageType(PageTypeFormat::Ruled), 1, 0, 0);
+    cairo_surface_destroy(tiled);
+
+    EXPECT_GT(BackgroundTileCache::getInstance().getTileCount(), 0U);
+}
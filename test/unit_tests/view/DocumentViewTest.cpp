@@ -0,0 +1,246 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+
+#include <cairo-pdf.h>
+#include <cairo-svg.h>
+#include <gtest/gtest.h>
+#include <gtk/gtk.h>
+
+#include "model/Image.h"
+#include "model/Layer.h"
+#include "model/Stroke.h"
+#include "model/XojPage.h"
+#include "util/PathUtil.h"
+#include "view/DocumentView.h"
+#include "view/StrokeView.h"
+
+namespace {
+constexpr int SIZE = 200;
+
+auto addHighlighter(Layer* layer, double x, double y, Color color) -> Stroke* {
+    auto* stroke = new Stroke();
+    stroke->setToolType(STROKE_TOOL_HIGHLIGHTER);
+    stroke->setColor(color);
+    stroke->setWidth(12);
+    stroke->setFill(128);
+    // Self overlapping, which is what the mask is for
+    stroke->addPoint(Point(x, y));
+    stroke->addPoint(Point(x + 60, y));
+    stroke->addPoint(Point(x + 30, y + 4));
+    layer->addElement(stroke);
+    return stroke;
+}
+
+auto createSurface() -> cairo_surface_t* {
+    cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, SIZE, SIZE);
+    cairo_t* cr = cairo_create(surface);
+    cairo_set_source_rgb(cr, 1, 1, 1);
+    cairo_paint(cr);
+    cairo_destroy(cr);
+    return surface;
+}
+
+auto equalPixels(cairo_surface_t* a, cairo_surface_t* b) -> bool {
+    cairo_surface_flush(a);
+    cairo_surface_flush(b);
+    size_t size = static_cast<size_t>(cairo_image_surface_get_stride(a)) * SIZE;
+    return std::memcmp(cairo_image_surface_get_data(a), cairo_image_surface_get_data(b), size) == 0;
+}
+
+auto writeToString(std::string* data, const unsigned char* buffer, unsigned int length) -> cairo_status_t {
+    data->append(reinterpret_cast<const char*>(buffer), length);
+    return CAIRO_STATUS_SUCCESS;
+}
+
+/**
+ * Pixels which do not compress, so the size of the output shows how often an image is embedded
+ */
+auto createNoisePixbuf(int size) -> GdkPixbuf* {
+    GdkPixbuf* pixbuf = gdk_pixbuf_new(GDK_COLORSPACE_RGB, false, 8, size, size);
+    guchar* pixels = gdk_pixbuf_get_pixels(pixbuf);
+    uint32_t state = 1;
+    for (int y = 0; y < size; y++) {
+        guchar* row = pixels + y * gdk_pixbuf_get_rowstride(pixbuf);
+        for (int x = 0; x < size * 3; x++) {
+            state = state * 1664525U + 1013904223U;
+            row[x] = static_cast<guchar>(state >> 24U);
+        }
+    }
+    return pixbuf;
+}
+
+auto encodePixbuf(GdkPixbuf* pixbuf, const char* type) -> std::string {
+    gchar* buffer = nullptr;
+    gsize size = 0;
+    gdk_pixbuf_save_to_buffer(pixbuf, &buffer, &size, type, nullptr, nullptr);
+    std::string data(buffer, size);
+    g_free(buffer);
+    return data;
+}
+
+auto exportPage(const PageRef& page, bool svg) -> std::string {
+    std::string data;
+    auto write = reinterpret_cast<cairo_write_func_t>(&writeToString);
+    cairo_surface_t* surface = svg ? cairo_svg_surface_create_for_stream(write, &data, SIZE, SIZE) :
+                                     cairo_pdf_surface_create_for_stream(write, &data, SIZE, SIZE);
+    cairo_t* cr = cairo_create(surface);
+    DocumentView view;
+    view.drawPage(page, cr, true);
+    cairo_destroy(cr);
+    cairo_surface_destroy(surface);
+    return data;
+}
+
+/**
+ * A page with separately decoded copies of the same PNG image, like images pasted more than once
+ */
+auto createImagePage(const std::string& png, int images) -> PageRef {
+    auto page = std::make_shared<XojPage>(SIZE, SIZE);
+    Layer* layer = page->getSelectedLayer();
+    for (int i = 0; i < images; i++) {
+        auto* image = new Image();
+        image->setImage(std::string(png));
+        image->setX(i * 10);
+        image->setY(i * 10);
+        image->setWidth(50);
+        image->setHeight(50);
+        layer->addElement(image);
+    }
+    return page;
+}
+
+void writeFile(const fs::path& path, const std::string& data) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(data.data(), static_cast<std::streamsize>(data.size()));
+}
+}  // namespace
+
+TEST(ViewDocumentView, testSharedMaskLooksLikeSingleMasks) {
+    auto page = std::make_shared<XojPage>(SIZE, SIZE);
+    Layer* layer = page->getSelectedLayer();
+
+    // Separate strokes share a mask, overlapping ones and other colors do not
+    addHighlighter(layer, 20, 20, Color{0xFFFF00U});
+    addHighlighter(layer, 20, 50, Color{0xFFFF00U});
+    addHighlighter(layer, 100, 20, Color{0xFFFF00U});
+    addHighlighter(layer, 50, 22, Color{0xFFFF00U});
+    addHighlighter(layer, 20, 100, Color{0x00FF00U});
+    addHighlighter(layer, 20, 130, Color{0x00FF00U});
+
+    cairo_surface_t* batched = createSurface();
+    cairo_t* cr = cairo_create(batched);
+    DocumentView view;
+    view.initDrawing(page, cr, true);
+    view.drawLayer(cr, layer);
+    view.finializeDrawing();
+    cairo_destroy(cr);
+
+    cairo_surface_t* single = createSurface();
+    cr = cairo_create(single);
+    for (Element* e: layer->getElements()) {
+        StrokeView(cr, dynamic_cast<Stroke*>(e)).paint(true, false);
+    }
+    cairo_destroy(cr);
+
+    EXPECT_TRUE(equalPixels(batched, single));
+
+    cairo_surface_destroy(batched);
+    cairo_surface_destroy(single);
+}
+
+TEST(ViewDocumentView, testSharedMaskLooksLikeSingleMasksZoomedOut) {
+    auto page = std::make_shared<XojPage>(SIZE, SIZE);
+    Layer* layer = page->getSelectedLayer();
+
+    // The bounds are 1.5 units apart, which is less than a device pixel at this zoom
+    constexpr double ZOOM = 0.25;
+    for (int i = 0; i < 10; i++) {
+        addHighlighter(layer, 20, 20 + i * 17.5, Color{0xFFFF00U});
+    }
+
+    cairo_surface_t* batched = createSurface();
+    cairo_t* cr = cairo_create(batched);
+    cairo_scale(cr, ZOOM, ZOOM);
+    DocumentView view;
+    view.initDrawing(page, cr, true);
+    view.drawLayer(cr, layer);
+    view.finializeDrawing();
+    cairo_destroy(cr);
+
+    cairo_surface_t* single = createSurface();
+    cr = cairo_create(single);
+    cairo_scale(cr, ZOOM, ZOOM);
+    for (Element* e: layer->getElements()) {
+        StrokeView(cr, dynamic_cast<Stroke*>(e)).paint(true, false);
+    }
+    cairo_destroy(cr);
+
+    EXPECT_TRUE(equalPixels(batched, single));
+
+    cairo_surface_destroy(batched);
+    cairo_surface_destroy(single);
+}
+
+TEST(ViewDocumentView, testExportEmbedsImagesOnce) {
+    GdkPixbuf* pixbuf = createNoisePixbuf(128);
+    std::string png = encodePixbuf(pixbuf, "png");
+    g_object_unref(pixbuf);
+
+    size_t single = exportPage(createImagePage(png, 1), false).size();
+    size_t tenCopies = exportPage(createImagePage(png, 10), false).size();
+    EXPECT_GT(single, png.size() / 2);
+    EXPECT_LT(tenCopies, single + png.size() / 2);
+
+    // SVG gets the PNG file as it is
+    gchar* base64 = g_base64_encode(reinterpret_cast<const guchar*>(png.data()), png.size());
+    std::string svg = exportPage(createImagePage(png, 10), true);
+    EXPECT_NE(std::string::npos, svg.find(base64));
+    g_free(base64);
+}
+
+TEST(ViewDocumentView, testExportEmbedsOriginalJpeg) {
+    GdkPixbuf* pixbuf = createNoisePixbuf(128);
+    std::string jpeg = encodePixbuf(pixbuf, "jpeg");
+    g_object_unref(pixbuf);
+    ASSERT_FALSE(jpeg.empty());
+
+    auto path = Util::getTmpDirSubfolder() / "background.jpg";
+    writeFile(path, jpeg);
+    BackgroundImage img;
+    img.loadFile(path, nullptr);
+    ASSERT_FALSE(img.isEmpty());
+
+    auto page = std::make_shared<XojPage>(SIZE, SIZE);
+    page->setBackgroundType(PageType(PageTypeFormat::Image));
+    page->setBackgroundImage(img);
+
+    // Embedded without decoding and encoding it again
+    std::string pdf = exportPage(page, false);
+    EXPECT_NE(std::string::npos, pdf.find(jpeg));
+
+    // The file is only read for the export, the surface drawn on screen does not keep it
+    const unsigned char* mime = nullptr;
+    unsigned long length = 0;
+    cairo_surface_get_mime_data(img.getSurface(SIZE, SIZE), CAIRO_MIME_TYPE_JPEG, &mime, &length);
+    EXPECT_EQ(nullptr, mime);
+
+    // A file changed after loading does not match the decoded image any more
+    std::string changed = jpeg;
+    changed.append(16, '\0');
+    writeFile(path, changed);
+    pdf = exportPage(page, false);
+    EXPECT_EQ(std::string::npos, pdf.find(jpeg));
+}
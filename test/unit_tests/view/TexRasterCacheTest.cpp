@@ -0,0 +1,122 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <string>
+
+#include <cairo-pdf.h>
+#include <gtest/gtest.h>
+
+#include "model/TexImage.h"
+#include "view/TexRasterCache.h"
+
+namespace {
+auto writeToString(std::string* data, const unsigned char* buffer, unsigned int length) -> cairo_status_t {
+    data->append(reinterpret_cast<const char*>(buffer), length);
+    return CAIRO_STATUS_SUCCESS;
+}
+
+/**
+ * A one page PDF with a filled square, in place of a LaTeX render
+ */
+auto createPdf() -> std::string {
+    std::string data;
+    cairo_surface_t* surface =
+            cairo_pdf_surface_create_for_stream(reinterpret_cast<cairo_write_func_t>(&writeToString), &data, 40, 20);
+    cairo_t* cr = cairo_create(surface);
+    cairo_rectangle(cr, 0, 0, 20, 20);
+    cairo_fill(cr);
+    cairo_destroy(cr);
+    cairo_surface_destroy(surface);
+    return data;
+}
+}  // namespace
+
+TEST(ViewTexRasterCache, testRasterFollowsZoom) {
+    auto& cache = TexRasterCache::getInstance();
+    cache.clear();
+
+    TexImage img;
+    ASSERT_TRUE(img.loadData(createPdf()));
+
+    cairo_surface_t* raster = cache.get(&img, 80, 40);
+    ASSERT_NE(nullptr, raster);
+    EXPECT_EQ(80, cairo_image_surface_get_width(raster));
+    EXPECT_EQ(40, cairo_image_surface_get_height(raster));
+
+    // The left half is black, the right half transparent
+    cairo_surface_flush(raster);
+    auto* data = cairo_image_surface_get_data(raster);
+    int stride = cairo_image_surface_get_stride(raster);
+    EXPECT_EQ(0xff000000U, *reinterpret_cast<uint32_t*>(data + 20 * stride + 10 * 4));
+    EXPECT_EQ(0U, *reinterpret_cast<uint32_t*>(data + 20 * stride + 70 * 4));
+
+    // Slightly smaller, the raster is used again
+    cairo_surface_t* same = cache.get(&img, 70, 35);
+    EXPECT_EQ(raster, same);
+    cairo_surface_destroy(same);
+
+    // Zoomed in, e.g. in the page view while the sidebar shows the small one, both are kept
+    size_t size = cache.getSize();
+    cairo_surface_t* larger = cache.get(&img, 160, 80);
+    EXPECT_NE(raster, larger);
+    EXPECT_EQ(160, cairo_image_surface_get_width(larger));
+    EXPECT_EQ(size + static_cast<size_t>(cairo_image_surface_get_stride(larger)) * 80, cache.getSize());
+    cairo_surface_t* small = cache.get(&img, 80, 40);
+    EXPECT_EQ(raster, small);
+    cairo_surface_destroy(small);
+    cairo_surface_destroy(larger);
+    cairo_surface_destroy(raster);
+
+    // Only the last few scales are kept, the least recently used one is replaced
+    for (int width = 320; width <= 1280; width *= 2) {
+        cairo_surface_destroy(cache.get(&img, width, width / 2));
+    }
+    cairo_surface_t* rendered = cache.get(&img, 160, 80);
+    cairo_surface_t* again = cache.get(&img, 160, 80);
+    EXPECT_EQ(rendered, again);
+    cairo_surface_destroy(rendered);
+    cairo_surface_destroy(again);
+    // The four most recent scales are cached, not the first one
+    size_t expected = 0;
+    for (int width = 160; width <= 1280; width *= 2) {
+        cairo_surface_t* s = cache.get(&img, width, width / 2);
+        expected += static_cast<size_t>(cairo_image_surface_get_stride(s)) * (width / 2);
+        cairo_surface_destroy(s);
+    }
+    EXPECT_EQ(expected, cache.getSize());
+
+    // New data is rendered again
+    cairo_surface_t* first = cache.get(&img, 160, 80);
+    ASSERT_TRUE(img.loadData(createPdf()));
+    cairo_surface_t* second = cache.get(&img, 160, 80);
+    EXPECT_NE(first, second);
+    cairo_surface_destroy(first);
+    cairo_surface_destroy(second);
+
+    cache.clear();
+    EXPECT_EQ(0U, cache.getSize());
+}
+
+TEST(ViewTexRasterCache, testSizeLimit) {
+    auto& cache = TexRasterCache::getInstance();
+    cache.clear();
+
+    TexImage img;
+    ASSERT_TRUE(img.loadData(createPdf()));
+
+    // Too large for the cache, drawn as vectors
+    EXPECT_EQ(nullptr, cache.get(&img, 8000, 4000));
+
+    // Without a PDF there is nothing to render
+    TexImage empty;
+    EXPECT_EQ(nullptr, cache.get(&empty, 80, 40));
+    EXPECT_EQ(0U, cache.getSize());
+}
@@ -0,0 +1,62 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <string>
+
+#include <gtest/gtest.h>
+#include <gtk/gtk.h>
+
+#include "model/Text.h"
+#include "view/TextView.h"
+
+TEST(ViewTextView, testCachedLayoutFollowsChanges) {
+    Text text;
+    text.setText("cached layout");
+    double width = text.getElementWidth();
+    double height = text.getElementHeight();
+    EXPECT_GT(width, 0);
+
+    // An equal text which was shaped on its own has the same size
+    Text other;
+    other.setText("cached layout");
+    EXPECT_DOUBLE_EQ(width, other.getElementWidth());
+    EXPECT_DOUBLE_EQ(height, other.getElementHeight());
+
+    text.setText("cached layout, longer");
+    EXPECT_GT(text.getElementWidth(), width);
+
+    // The font is changed through the reference, the size is only calculated again on request
+    text.getFont().setSize(24);
+    double w = 0;
+    double h = 0;
+    TextView::calcSize(&text, w, h);
+    EXPECT_GT(h, height);
+}
+
+TEST(ViewTextView, testFindTextAfterChange) {
+    Text text;
+    text.setText("one two one");
+    std::string search = "ONE";
+    EXPECT_EQ(2U, TextView::findText(&text, search).size());
+
+    text.setText("two");
+    EXPECT_TRUE(TextView::findText(&text, search).empty());
+
+    // Drawing uses the same layout
+    cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 100, 100);
+    cairo_t* cr = cairo_create(surface);
+    TextView::drawText(cr, &text);
+    cairo_destroy(cr);
+    cairo_surface_destroy(surface);
+
+    search = "two";
+    EXPECT_EQ(1U, TextView::findText(&text, search).size());
+}